@@ -0,0 +1,255 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Directory stream internals.
+*/
+
+#include <aros/debug.h>
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <dos/dosextens.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include "__posixc_intbase.h"
+#include "__dirdesc.h"
+
+/* Length of the directory part of a path without a trailing '/',
+   unless the '/' itself means the parent directory */
+static size_t __dir_pathlen(const char *path, size_t len)
+{
+    if (len > 1 && path[len - 1] == '/'
+        && path[len - 2] != '/' && path[len - 2] != ':')
+        len--;
+
+    return len;
+}
+
+int __dir_setup(DIR *dir, const char *aname)
+{
+    size_t len = __dir_pathlen(aname, strlen(aname));
+
+    dir->eac = AllocDosObject(DOS_EXALLCONTROL, NULL);
+    dir->buffer = AllocVec(DIR_BUFSIZE, MEMF_ANY);
+    dir->name = AllocVec(len + 1, MEMF_ANY);
+    if (!dir->eac || !dir->buffer || !dir->name)
+    {
+        if (dir->eac)
+            FreeDosObject(DOS_EXALLCONTROL, dir->eac);
+        FreeVec(dir->buffer);
+        FreeVec(dir->name);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    CopyMem(aname, dir->name, len);
+    dir->name[len] = '\0';
+
+    dir->cwd = ((struct Process *)FindTask(NULL))->pr_CurrentDir;
+    dir->fullname = NULL;
+    dir->blksize = 0;
+    dir->type = ED_OWNER;
+    dir->batch = dir->next = NULL;
+    dir->started = dir->more = FALSE;
+    dir->error = 0;
+
+    return 0;
+}
+
+void __dir_cleanup(DIR *dir, BPTR lock)
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+
+    if (PosixCBase->dircache == dir)
+        PosixCBase->dircache = NULL;
+
+    if (dir->started && dir->more)
+        ExAllEnd(lock, dir->buffer, DIR_BUFSIZE, dir->type, dir->eac);
+
+    if (dir->eac)
+        FreeDosObject(DOS_EXALLCONTROL, dir->eac);
+    FreeVec(dir->buffer);
+    FreeVec(dir->name);
+    FreeVec(dir->fullname);
+}
+
+void __dir_rewind(DIR *dir, BPTR lock)
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+
+    if (PosixCBase->dircache == dir)
+        PosixCBase->dircache = NULL;
+
+    if (dir->started && dir->more)
+        ExAllEnd(lock, dir->buffer, DIR_BUFSIZE, dir->type, dir->eac);
+
+    /* The ExAllControl can not be reused once ExAll() was called */
+    if (dir->started && dir->eac)
+    {
+        FreeDosObject(DOS_EXALLCONTROL, dir->eac);
+        dir->eac = AllocDosObject(DOS_EXALLCONTROL, NULL);
+    }
+
+    dir->batch = dir->next = NULL;
+    dir->started = dir->more = FALSE;
+    dir->error = 0;
+
+    if (!dir->eac)
+    {
+        /* Make __dir_next() report the error */
+        dir->started = TRUE;
+        dir->error = ENOMEM;
+    }
+}
+
+/* Next entry of the directory, NULL at the end or on error with errno set */
+struct ExAllData *__dir_next(DIR *dir, BPTR lock)
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+    struct ExAllData *ed;
+    LONG err;
+
+    while (!dir->next)
+    {
+        if (dir->started && !dir->more)
+        {
+            if (dir->error)
+            {
+                errno = dir->error;
+                dir->error = 0;
+            }
+            return NULL;
+        }
+
+        dir->more = ExAll(lock, dir->buffer, DIR_BUFSIZE, dir->type, dir->eac);
+        if (!dir->more)
+        {
+            err = IoErr();
+
+            /* The handler does not give all the information, ask for less */
+            if (err == ERROR_BAD_NUMBER && !dir->started && dir->type > ED_TYPE)
+            {
+                dir->type--;
+                continue;
+            }
+
+            if (err != ERROR_NO_MORE_ENTRIES)
+                dir->error = __stdc_ioerr2errno(err);
+        }
+        dir->started = TRUE;
+
+        D(bug("[posixc] __dir_next: %u entries\n", dir->eac->eac_Entries));
+
+        dir->batch = dir->next = dir->eac->eac_Entries ? dir->buffer : NULL;
+        PosixCBase->dircache = dir;
+    }
+
+    ed = dir->next;
+    dir->next = ed->ed_Next;
+
+    return ed;
+}
+
+/* d_type of a dirent, the same file type as stat() reports */
+unsigned char __dir_type(LONG type)
+{
+    switch (type)
+    {
+    case ST_FILE:
+    case ST_LINKFILE:
+        return DT_REG;
+    case ST_ROOT:
+    case ST_USERDIR:
+    case ST_LINKDIR:
+        return DT_DIR;
+    case ST_SOFTLINK:
+        return DT_LNK;
+    case ST_PIPEFILE:
+        return DT_CHR;
+    default:
+        return DT_UNKNOWN;
+    }
+}
+
+/* The entry of the cached batch the path refers to, if there is one.
+   Without links, soft links are not returned as they have to be
+   followed. */
+struct ExAllData *__dir_lookup(const char *path, BOOL links, DIR **dirp)
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+    DIR *dir = PosixCBase->dircache;
+    struct ExAllData *ed;
+    const char *file;
+    size_t len;
+
+    if (!dir || !dir->batch || dir->type < ED_OWNER)
+        return NULL;
+
+    file = FilePart(path);
+    if (!*file)
+        return NULL;
+
+    len = __dir_pathlen(path, file - path);
+    if (strncmp(path, dir->name, len) != 0 || dir->name[len] != '\0')
+        return NULL;
+
+    /* A relative path has to be relative to the same directory */
+    if (!strchr(dir->name, ':')
+        && dir->cwd != ((struct Process *)FindTask(NULL))->pr_CurrentDir)
+        return NULL;
+
+    for (ed = dir->batch; ed; ed = ed->ed_Next)
+    {
+        if (strcmp((const char *)ed->ed_Name, file) == 0)
+            break;
+    }
+
+    /* Hard links are examined through the lock of their target */
+    if (!ed
+        || ed->ed_Type == ST_LINKFILE || ed->ed_Type == ST_LINKDIR
+        || (!links && ed->ed_Type == ST_SOFTLINK))
+        return NULL;
+
+    *dirp = dir;
+
+    return ed;
+}
+
+/* Full name of the directory, as NameFromLock() gives for its entries */
+const char *__dir_fullname(DIR *dir, BPTR lock)
+{
+    int size = 256;
+
+    while (!dir->fullname)
+    {
+        if (!(dir->fullname = AllocVec(size, MEMF_ANY)))
+            return NULL;
+
+        if (NameFromLock(lock, dir->fullname, size))
+            break;
+
+        FreeVec(dir->fullname);
+        dir->fullname = NULL;
+
+        if (IoErr() != ERROR_LINE_TOO_LONG)
+            return NULL;
+
+        size *= 2;
+    }
+
+    return dir->fullname;
+}
+
+void __dir_dropcache(void)
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+
+    PosixCBase->dircache = NULL;
+}
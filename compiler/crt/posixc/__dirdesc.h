@@ -1,17 +1,56 @@
 #ifndef __DIRDESC_H
 #define __DIRDESC_H
 
+/*
+    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
+
+    Directory streams read the entries with ExAll() in batches of
+    DIR_BUFSIZE bytes. The batch of the stream read last is also used
+    by stat() and lstat() for the entries in it, so the common loop of
+    readdir() followed by stat() of each entry does not have to go to
+    the handler again. The cached batch is dropped when the stream is
+    closed or rewound and by the posixc functions that change files.
+*/
+
+#include <dos/dos.h>
+#include <dos/exall.h>
 #include <dirent.h>
 
 #include <aros/types/off_t.h>
 
+#define DIR_BUFSIZE 8192
+
 struct __dirdesc
 {
    int                  fd;
-   void                 *priv;
    struct dirent        ent;
    struct dirent64      ent64;
    off_t                pos;
+
+   /* ExAll() state */
+   struct ExAllControl  *eac;
+   struct ExAllData     *buffer;
+   struct ExAllData     *batch;     /* First entry of the batch or NULL */
+   struct ExAllData     *next;      /* Next entry to return */
+   LONG                 type;       /* ED_xxx ExAll() is called with */
+   BOOL                 started;    /* ExAll() has been called */
+   BOOL                 more;       /* ExAll() has more entries */
+   int                  error;      /* errno to report after the batch */
+
+   /* Needed to find the entries of the batch by path */
+   char                 *name;      /* Amiga path the stream was opened with */
+   BPTR                 cwd;        /* Current dir when it was opened */
+   char                 *fullname;  /* NameFromLock() of the dir, on demand */
+   LONG                 blksize;    /* Info() of the dir, 0 until needed */
 };
 
+int __dir_setup(DIR *dir, const char *aname);
+void __dir_cleanup(DIR *dir, BPTR lock);
+void __dir_rewind(DIR *dir, BPTR lock);
+struct ExAllData *__dir_next(DIR *dir, BPTR lock);
+unsigned char __dir_type(LONG type);
+struct ExAllData *__dir_lookup(const char *path, BOOL links, DIR **dirp);
+const char *__dir_fullname(DIR *dir, BPTR lock);
+void __dir_dropcache(void);
+
 #endif /* __DIRDESC_H */
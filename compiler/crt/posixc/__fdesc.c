@@ -24,6 +24,7 @@
 
 #include "__fdesc.h"
 #include "__upath.h"
+#include "__dirdesc.h"
 
 /* TODO: Add locking to make filedesc usage thread safe
    Using vfork()+exec*() filedescriptors may be shared between different
@@ -196,6 +197,10 @@ int __open(int wanted_fd, const char *pathname, int flags, int mode)
 
     pathname = __path_u2a(pathname);
     if (!pathname) return -1;
+
+    /* Cached directory entries may change */
+    if (flags & (O_WRONLY | O_RDWR | O_CREAT | O_TRUNC))
+        __dir_dropcache();
     
     D(bug("__open: entering, wanted fd = %d, path = %s, flags = %d, mode = %d\n", wanted_fd, pathname, flags, mode));
 
@@ -573,6 +578,7 @@ void __close_on_exec_fdescs(void)
 }
 
 #include <stdio.h>
+#include "__stdio.h"
 
 void __updatestdio(void)
 {
@@ -595,6 +601,12 @@ void __updatestdio(void)
 
     fcb = PosixCBase->fd_array[STDERR_FILENO]->fcb;
     stderrlogic(me, fcb);
+
+    /* The new handles decide again whether stdio buffers the streams */
+    __stdio_freebuf(((struct PosixCBase *)PosixCBase)->_stdin);
+    ((struct PosixCBase *)PosixCBase)->_stdin->flags &= ~(__POSIXC_STDIO_NOBUF | __POSIXC_STDIO_BUFCHECKED);
+    __stdio_freebuf(((struct PosixCBase *)PosixCBase)->_stdout);
+    ((struct PosixCBase *)PosixCBase)->_stdout->flags &= ~(__POSIXC_STDIO_NOBUF | __POSIXC_STDIO_BUFCHECKED);
 }
 
 ADD2OPENLIB(__init_fd, 2);
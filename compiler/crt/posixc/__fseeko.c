@@ -50,6 +50,9 @@ int __fseeko (
 
     fh = fdesc->fcb->handle;
 
+    if (__stdio_sync(stream) == EOF)
+        return -1;
+
     /* This is buffered IO, flush the buffer before any Seek */
     Flush (fh);
 
@@ -177,6 +180,9 @@ int __fseeko64 (
 
     fh = fdesc->fcb->handle;
 
+    if (__stdio_sync(stream) == EOF)
+        return -1;
+
     /* This is buffered IO, flush the buffer before any Seek */
     Flush (fh);
 
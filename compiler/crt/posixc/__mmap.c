@@ -0,0 +1,424 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Memory mapped file internals.
+*/
+
+#include <aros/debug.h>
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/kernel.h>
+#include <aros/kernel.h>
+#include <aros/symbolsets.h>
+#include <exec/memory.h>
+#include <dos/dosextens.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "__posixc_intbase.h"
+#include "__mmap.h"
+
+size_t __mmap_round(struct __mmap_cache *cache, size_t len)
+{
+    return (len + cache->pagesize - 1) & ~(cache->pagesize - 1);
+}
+
+/* len has to be a multiple of cache->pagesize */
+BOOL __mmap_alloc(struct __mmap_cache *cache, struct __mmap_mem *mem, size_t len, BOOL exec)
+{
+    APTR KernelBase = cache->KernelBase;
+
+    /* Only whole pages from the kernel can be protected */
+    if (cache->mmu)
+    {
+        mem->alloc = KrnAllocPages(NULL, len, MEMF_PUBLIC);
+        if (mem->alloc)
+        {
+            mem->mem = mem->alloc;
+            mem->alloclen = len;
+            mem->pages = TRUE;
+
+            return TRUE;
+        }
+    }
+
+    mem->alloclen = len + cache->pagesize - 1;
+    mem->alloc = AllocMem(mem->alloclen, exec ? MEMF_PUBLIC | MEMF_EXECUTABLE : MEMF_PUBLIC);
+    if (!mem->alloc)
+        return FALSE;
+
+    mem->mem = (APTR)(((IPTR)mem->alloc + cache->pagesize - 1) & ~((IPTR)cache->pagesize - 1));
+    mem->pages = FALSE;
+
+    return TRUE;
+}
+
+void __mmap_free(struct __mmap_cache *cache, struct __mmap_mem *mem)
+{
+    APTR KernelBase = cache->KernelBase;
+
+    if (mem->pages)
+    {
+        KrnSetProtection(mem->mem, mem->alloclen, MAP_Readable | MAP_Writable);
+        KrnFreePages(mem->alloc, mem->alloclen);
+    }
+    else
+        FreeMem(mem->alloc, mem->alloclen);
+}
+
+void __mmap_protect(struct __mmap_cache *cache, struct __mmap_mem *mem, size_t len, int prot)
+{
+    APTR KernelBase = cache->KernelBase;
+    KRN_MapAttr flags = 0;
+
+    if (!mem->pages)
+        return;
+
+    if (prot & PROT_READ)
+        flags |= MAP_Readable;
+    if (prot & PROT_WRITE)
+        flags |= MAP_Writable;
+    if (prot & PROT_EXEC)
+        flags |= MAP_Executable;
+
+    KrnSetProtection(mem->mem, len, flags);
+}
+
+/* Finds the entry of the file open as fh or adds a new one */
+struct __mmap_file *__mmap_getfile(struct __mmap_cache *cache, BPTR fh)
+{
+    struct FileInfoBlock *fib;
+    struct __mmap_file *file;
+    char *path;
+    int pathsize = 256;
+
+    fib = AllocDosObject(DOS_FIB, NULL);
+    if (!fib)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    if (!ExamineFH(fh, fib))
+    {
+        FreeDosObject(DOS_FIB, fib);
+        errno = ENODEV;
+        return NULL;
+    }
+
+    do
+    {
+        if (!(path = AllocVec(pathsize, MEMF_PUBLIC)))
+        {
+            FreeDosObject(DOS_FIB, fib);
+            errno = ENOMEM;
+            return NULL;
+        }
+
+        if (NameFromFH(fh, path, pathsize))
+            break;
+
+        FreeVec(path);
+        if (IoErr() != ERROR_LINE_TOO_LONG)
+        {
+            FreeDosObject(DOS_FIB, fib);
+            errno = ENODEV;
+            return NULL;
+        }
+        pathsize *= 2;
+    }
+    while (TRUE);
+
+    ForeachNode(&cache->files, file)
+    {
+        if (file->size == fib->fib_Size
+            && CompareDates(&file->date, &fib->fib_Date) == 0
+            && strcmp(file->path, path) == 0)
+        {
+            FreeVec(path);
+            FreeDosObject(DOS_FIB, fib);
+
+            return file;
+        }
+    }
+
+    file = AllocMem(sizeof(struct __mmap_file), MEMF_PUBLIC | MEMF_CLEAR);
+    if (!file)
+    {
+        FreeVec(path);
+        FreeDosObject(DOS_FIB, fib);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    file->path = path;
+    file->size = fib->fib_Size;
+    file->date = fib->fib_Date;
+    NEWLIST(&file->extents);
+    AddTail((struct List *)&cache->files, (struct Node *)file);
+    FreeDosObject(DOS_FIB, fib);
+
+    D(bug("[mmap] New file %s, %ld bytes\n", file->path, (long)file->size));
+
+    return file;
+}
+
+/* Frees the entry of a file without extents */
+void __mmap_putfile(struct __mmap_cache *cache, struct __mmap_file *file)
+{
+    if (!IsListEmpty((struct List *)&file->extents))
+        return;
+
+    Remove((struct Node *)file);
+    FreeVec(file->path);
+    FreeMem(file, sizeof(struct __mmap_file));
+}
+
+/* Reads a part of the file without moving the file position, the bytes
+   after the end of the file are zero. Data written to the shared
+   writable extents of the file that is not written back yet is used
+   instead of what is in the file.
+*/
+int __mmap_fill(struct __mmap_file *file, BPTR fh, off_t offset, char *buf, size_t len)
+{
+    struct __mmap_extent *ext;
+    LONG oldpos, got = 0;
+    off_t start, end;
+
+    if (offset < file->size)
+    {
+        oldpos = Seek(fh, offset, OFFSET_BEGINNING);
+        if (oldpos == -1)
+        {
+            errno = __stdc_ioerr2errno(IoErr());
+            return -1;
+        }
+        got = Read(fh, buf, len);
+        Seek(fh, oldpos, OFFSET_BEGINNING);
+        if (got == -1)
+        {
+            errno = __stdc_ioerr2errno(IoErr());
+            return -1;
+        }
+    }
+    memset(buf + got, 0, len - got);
+
+    ForeachNode(&file->extents, ext)
+    {
+        if (ext->writers == 0)
+            continue;
+
+        start = offset > ext->offset ? offset : ext->offset;
+        end = offset + len < ext->offset + ext->len ? offset + len : ext->offset + ext->len;
+        if (start < end)
+            CopyMem((char *)ext->mem.mem + (start - ext->offset), buf + (start - offset), end - start);
+    }
+
+    return 0;
+}
+
+/* Finds an extent that covers the range or reads a new one, with a new
+   reference to it. len has to be a multiple of cache->pagesize.
+*/
+struct __mmap_extent *__mmap_getextent(struct __mmap_cache *cache, struct __mmap_file *file,
+                                       BPTR fh, off_t offset, size_t len)
+{
+    struct __mmap_extent *ext;
+
+    ForeachNode(&file->extents, ext)
+    {
+        if (ext->offset <= offset && offset + len <= ext->offset + ext->len)
+        {
+            ext->refcount++;
+            return ext;
+        }
+    }
+
+    ext = AllocMem(sizeof(struct __mmap_extent), MEMF_PUBLIC | MEMF_CLEAR);
+    if (!ext)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+    if (!__mmap_alloc(cache, &ext->mem, len, FALSE))
+    {
+        FreeMem(ext, sizeof(struct __mmap_extent));
+        errno = ENOMEM;
+        return NULL;
+    }
+    if (__mmap_fill(file, fh, offset, ext->mem.mem, len) != 0)
+    {
+        __mmap_free(cache, &ext->mem);
+        FreeMem(ext, sizeof(struct __mmap_extent));
+        return NULL;
+    }
+
+    ext->file = file;
+    ext->offset = offset;
+    ext->len = len;
+    ext->refcount = 1;
+    AddTail((struct List *)&file->extents, (struct Node *)ext);
+    __mmap_protect(cache, &ext->mem, len, PROT_READ);
+
+    D(bug("[mmap] New extent of %s at %ld, %lu bytes\n",
+          file->path, (long)offset, (unsigned long)len));
+
+    return ext;
+}
+
+/* Writes a part of a shared writable mapping to its file */
+int __mmap_writeback(struct __mmap_map *map, char *addr, size_t len)
+{
+    struct __mmap_extent *ext = map->extent;
+    struct __mmap_file *file = ext->file;
+    struct FileInfoBlock *fib;
+    off_t offset = ext->offset + (addr - (char *)ext->mem.mem);
+    BPTR fh, lock;
+    LONG ioerr = 0;
+
+    /* The file is not made longer */
+    if (offset >= file->size)
+        return 0;
+    if (offset + len > file->size)
+        len = file->size - offset;
+
+    fh = Open(file->path, MODE_OLDFILE);
+    if (!fh)
+    {
+        errno = __stdc_ioerr2errno(IoErr());
+        return -1;
+    }
+    if (Seek(fh, offset, OFFSET_BEGINNING) == -1 || Write(fh, addr, len) != (LONG)len)
+        ioerr = IoErr();
+    Close(fh);
+
+    if (ioerr)
+    {
+        errno = __stdc_ioerr2errno(ioerr);
+        return -1;
+    }
+
+    /* The new date keeps later mmap() calls using the extents */
+    if ((fib = AllocDosObject(DOS_FIB, NULL)))
+    {
+        if ((lock = Lock(file->path, SHARED_LOCK)))
+        {
+            if (Examine(lock, fib))
+                file->date = fib->fib_Date;
+            UnLock(lock);
+        }
+        FreeDosObject(DOS_FIB, fib);
+    }
+
+    return 0;
+}
+
+/* Removes a mapping, shared writable ones are written back first */
+void __mmap_release(struct __mmap_cache *cache, struct __mmap_map *map)
+{
+    struct __mmap_extent *ext = map->extent;
+    struct __mmap_file *file;
+
+    D(bug("[mmap] Releasing 0x%p, %lu bytes\n", map->addr, (unsigned long)map->len));
+
+    Remove((struct Node *)map);
+
+    if (ext)
+    {
+        if ((map->flags & MAP_SHARED) && (map->prot & PROT_WRITE))
+        {
+            __mmap_writeback(map, map->addr, map->len);
+            if (--ext->writers == 0)
+                __mmap_protect(cache, &ext->mem, ext->len, PROT_READ);
+        }
+
+        if (--ext->refcount == 0)
+        {
+            file = ext->file;
+            Remove((struct Node *)ext);
+            __mmap_free(cache, &ext->mem);
+            FreeMem(ext, sizeof(struct __mmap_extent));
+            __mmap_putfile(cache, file);
+        }
+    }
+    else
+        __mmap_free(cache, &map->mem);
+
+    FreeMem(map, sizeof(struct __mmap_map));
+}
+
+/* The cache is allocated for the root libbase and its pointer is copied
+   into the per task libbases, as the memory is shared between processes.
+*/
+int __init_mmap(struct PosixCIntBase *PosixCBase)
+{
+    struct __mmap_cache *cache;
+    APTR KernelBase;
+
+    cache = AllocMem(sizeof(struct __mmap_cache), MEMF_PUBLIC | MEMF_CLEAR);
+    if (!cache)
+        return 0;
+
+    InitSemaphore(&cache->sem);
+    NEWLIST(&cache->files);
+    NEWLIST(&cache->maps);
+    cache->pagesize = PAGESIZE;
+
+    KernelBase = OpenResource("kernel.resource");
+    cache->KernelBase = KernelBase;
+#if defined(KrnStatMemory)
+    if (KernelBase)
+    {
+        ULONG page;
+
+        if (KrnStatMemory(0, KMS_PageSize, &page, TAG_DONE))
+        {
+            cache->mmu = TRUE;
+            if (page > cache->pagesize)
+                cache->pagesize = page;
+        }
+    }
+#endif
+
+    D(bug("[mmap] Page size %lu, MMU %d\n", (unsigned long)cache->pagesize, cache->mmu));
+
+    PosixCBase->mmapcache = cache;
+
+    return 1;
+}
+
+/* Mappings are not inherited, they go away with the process */
+void __exit_mmap(struct PosixCIntBase *PosixCBase)
+{
+    struct __mmap_cache *cache = PosixCBase->mmapcache;
+    struct __mmap_map *map, *tmp;
+
+    ObtainSemaphore(&cache->sem);
+    ForeachNodeSafe(&cache->maps, map, tmp)
+    {
+        if (map->owner == PosixCBase)
+            __mmap_release(cache, map);
+    }
+    ReleaseSemaphore(&cache->sem);
+}
+
+/* Called when no program has posixc.library open any more */
+void __expunge_mmap(struct PosixCIntBase *PosixCBase)
+{
+    struct __mmap_cache *cache = PosixCBase->mmapcache;
+    struct __mmap_map *map;
+
+    while ((map = (struct __mmap_map *)GetHead((struct List *)&cache->maps)))
+        __mmap_release(cache, map);
+
+    FreeMem(cache, sizeof(struct __mmap_cache));
+    PosixCBase->mmapcache = NULL;
+}
+
+ADD2INITLIB(__init_mmap, 1);
+ADD2CLOSELIB(__exit_mmap, 0);
+ADD2EXPUNGELIB(__expunge_mmap, 1);
@@ -0,0 +1,92 @@
+#ifndef __MMAP_H
+#define __MMAP_H
+
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Memory mapped files. The contents of a file are read into memory
+    once and the memory is shared by all the mappings of that part of
+    the file that do not need a private copy, also between processes.
+    The cache is global, like the flock() locks: it is allocated for the
+    root libbase and its pointer is copied into every per task libbase.
+    Everything in it is protected by its semaphore. An extent is read
+    only unless a MAP_SHARED|PROT_WRITE mapping uses it, and then it is
+    writable for all the mappings that use it.
+*/
+
+#include <exec/lists.h>
+#include <exec/semaphores.h>
+#include <dos/dos.h>
+
+#include <aros/types/off_t.h>
+#include <aros/types/size_t.h>
+
+struct PosixCIntBase;
+
+/* A page aligned block of memory */
+struct __mmap_mem
+{
+    APTR                    mem;        /* Page aligned start */
+    APTR                    alloc;      /* What was allocated */
+    IPTR                    alloclen;
+    BOOL                    pages;      /* From KrnAllocPages() */
+};
+
+/* A file with mapped extents, found again by its path, size and date */
+struct __mmap_file
+{
+    struct MinNode          node;
+    char                    *path;      /* NameFromFH() of the file */
+    off_t                   size;
+    struct DateStamp        date;
+    struct MinList          extents;
+};
+
+/* A part of a file in memory, shared by the mappings that cover it */
+struct __mmap_extent
+{
+    struct MinNode          node;
+    struct __mmap_file      *file;
+    off_t                   offset;
+    size_t                  len;
+    struct __mmap_mem       mem;
+    int                     refcount;   /* Mappings using the extent */
+    int                     writers;    /* Of them MAP_SHARED|PROT_WRITE */
+};
+
+/* A range returned by mmap() */
+struct __mmap_map
+{
+    struct MinNode          node;
+    struct PosixCIntBase    *owner;     /* Unmapped when it closes posixc */
+    char                    *addr;
+    size_t                  len;
+    int                     prot;
+    int                     flags;
+    struct __mmap_extent    *extent;    /* NULL for private memory */
+    struct __mmap_mem       mem;        /* The private memory */
+};
+
+struct __mmap_cache
+{
+    struct SignalSemaphore  sem;
+    struct MinList          files;
+    struct MinList          maps;
+    APTR                    KernelBase;
+    size_t                  pagesize;   /* Allocation granularity */
+    BOOL                    mmu;        /* KrnAllocPages() is available */
+};
+
+size_t __mmap_round(struct __mmap_cache *cache, size_t len);
+BOOL __mmap_alloc(struct __mmap_cache *cache, struct __mmap_mem *mem, size_t len, BOOL exec);
+void __mmap_free(struct __mmap_cache *cache, struct __mmap_mem *mem);
+void __mmap_protect(struct __mmap_cache *cache, struct __mmap_mem *mem, size_t len, int prot);
+struct __mmap_file *__mmap_getfile(struct __mmap_cache *cache, BPTR fh);
+void __mmap_putfile(struct __mmap_cache *cache, struct __mmap_file *file);
+int __mmap_fill(struct __mmap_file *file, BPTR fh, off_t offset, char *buf, size_t len);
+struct __mmap_extent *__mmap_getextent(struct __mmap_cache *cache, struct __mmap_file *file,
+                                       BPTR fh, off_t offset, size_t len);
+int __mmap_writeback(struct __mmap_map *map, char *addr, size_t len);
+void __mmap_release(struct __mmap_cache *cache, struct __mmap_map *map);
+
+#endif /* __MMAP_H */
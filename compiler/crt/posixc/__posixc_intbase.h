@@ -25,6 +25,8 @@ struct __random_state;
 struct __env_item;
 struct _fdesc;
 struct vfork_data;
+struct __dirdesc;
+struct __mmap_cache;
 
 struct PosixCIntBase
 {
@@ -76,6 +78,9 @@ struct PosixCIntBase
     /* __vfork.c */
     struct vfork_data *vfork_data;
 
+    /* __dirdesc.c */
+    struct __dirdesc *dircache; /* Stream with the ExAll() batch for stat() */
+
     /* chdir.c/fchdir.c */
     int cd_changed;
     BPTR cd_lock;
@@ -83,6 +88,9 @@ struct PosixCIntBase
     /* flock.c */
     struct MinList _file_locks, *file_locks;
 
+    /* __mmap.c */
+    struct __mmap_cache *mmapcache; /* Global, shared by all libbases */
+
     /* umask */
     mode_t umask;
 
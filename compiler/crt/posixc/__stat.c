@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
 */
 
 #include <dos/dos.h>
@@ -14,11 +14,14 @@
 
 #include "__stat.h"
 #include "__posixc_time.h"
+#include "__fdesc.h"
+#include "__dirdesc.h"
 
 #include <sys/stat.h>
 #include <aros/debug.h>
 
 
+static LONG __blksize(BPTR lock);
 static mode_t __prot_a2u(ULONG protect);
 static uid_t  __id_a2u(UWORD id);
 static void hashlittle2(const void *key, size_t length,
@@ -28,13 +31,15 @@ static void __fill_statbuffer(
     char                 *buffer,
     struct FileInfoBlock *fib,
     int                  fallback_to_defaults,
-    BPTR                 lock);
+    BPTR                 lock,
+    LONG                 blksize);
 static void __fill_stat64buffer(
     struct stat64          *sb,
     char                 *buffer,
     struct FileInfoBlock *fib,
     int                  fallback_to_defaults,
-    BPTR                 lock);
+    BPTR                 lock,
+    LONG                 blksize);
 
 int __stat(BPTR lock, struct stat *sb, BOOL filehandle)
 {
@@ -117,12 +122,12 @@ int __stat(BPTR lock, struct stat *sb, BOOL filehandle)
     if (filehandle)
     {
         BPTR filelock = DupLockFromFH(lock);
-        __fill_statbuffer(sb, (char*) buffer, fib, fallback_to_defaults, filelock);
+        __fill_statbuffer(sb, (char*) buffer, fib, fallback_to_defaults, filelock, 0);
         UnLock(filelock);
     }
     else
     {
-        __fill_statbuffer(sb, (char*) buffer, fib, fallback_to_defaults, lock);
+        __fill_statbuffer(sb, (char*) buffer, fib, fallback_to_defaults, lock, 0);
     }
 
     FreeVec(buffer);
@@ -212,12 +217,12 @@ int __stat64(BPTR lock, struct stat64 *sb, BOOL filehandle)
     if (filehandle)
     {
         BPTR filelock = DupLockFromFH(lock);
-        __fill_stat64buffer(sb, (char*) buffer, fib, fallback_to_defaults, filelock);
+        __fill_stat64buffer(sb, (char*) buffer, fib, fallback_to_defaults, filelock, 0);
         UnLock(filelock);
     }
     else
     {
-        __fill_stat64buffer(sb, (char*) buffer, fib, fallback_to_defaults, lock);
+        __fill_stat64buffer(sb, (char*) buffer, fib, fallback_to_defaults, lock, 0);
     }
 
     FreeVec(buffer);
@@ -328,7 +333,7 @@ int __stat_from_path(const char *path, struct stat *sb)
     }
 
     if (*filepart == '\0' || fallback_to_defaults)
-        __fill_statbuffer(sb, abspath, fib, fallback_to_defaults, lock);
+        __fill_statbuffer(sb, abspath, fib, fallback_to_defaults, lock, 0);
     else
         /* examine entries of parent directory until we find the object to stat */
         do
@@ -339,7 +344,7 @@ int __stat_from_path(const char *path, struct stat *sb)
             {
                 if (stricmp(fib->fib_FileName, filepart) == 0)
                 {
-                    __fill_statbuffer(sb, abspath, fib, 0, lock);
+                    __fill_statbuffer(sb, abspath, fib, 0, lock, 0);
                     res = 0;
                     break;
                 }
@@ -474,7 +479,7 @@ int __stat64_from_path(const char *path, struct stat64 *sb)
     }
 
     if (*filepart == '\0' || fallback_to_defaults)
-        __fill_stat64buffer(sb, abspath, fib, fallback_to_defaults, lock);
+        __fill_stat64buffer(sb, abspath, fib, fallback_to_defaults, lock, 0);
     else
         /* examine entries of parent directory until we find the object to stat */
         do
@@ -485,7 +490,7 @@ int __stat64_from_path(const char *path, struct stat64 *sb)
             {
                 if (stricmp(fib->fib_FileName, filepart) == 0)
                 {
-                    __fill_stat64buffer(sb, abspath, fib, 0, lock);
+                    __fill_stat64buffer(sb, abspath, fib, 0, lock, 0);
                     res = 0;
                     break;
                 }
@@ -518,6 +523,93 @@ out:
     return res;
 }
 
+/* Fill in a FileInfoBlock and the full name of an entry of the batch of a
+   directory stream. Returns the lock of the directory or BNULL */
+static BPTR __dircache_examine(
+    const char           *path,
+    BOOL                 links,
+    struct FileInfoBlock *fib,
+    char                 **name,
+    LONG                 *blksize)
+{
+    struct ExAllData *ed;
+    const char *dirname;
+    fdesc *desc;
+    DIR *dir;
+    int len;
+
+    if (!(ed = __dir_lookup(path, links, &dir))
+        || !(desc = __getfdesc(dir->fd))
+        || !(dirname = __dir_fullname(dir, desc->fcb->handle)))
+        return BNULL;
+
+    len = strlen(dirname) + 1 + strlen((const char *)ed->ed_Name) + 1;
+    if (!(*name = AllocVec(len, MEMF_ANY)))
+        return BNULL;
+    strcpy(*name, dirname);
+    AddPart(*name, (CONST_STRPTR)ed->ed_Name, len);
+
+    if (!dir->blksize)
+        dir->blksize = __blksize(desc->fcb->handle);
+    *blksize = dir->blksize;
+
+    fib->fib_DirEntryType = fib->fib_EntryType = ed->ed_Type;
+    fib->fib_Size = ed->ed_Size;
+    fib->fib_NumBlocks = 0;
+    fib->fib_Protection = ed->ed_Prot;
+    fib->fib_Date.ds_Days = ed->ed_Days;
+    fib->fib_Date.ds_Minute = ed->ed_Mins;
+    fib->fib_Date.ds_Tick = ed->ed_Ticks;
+    fib->fib_OwnerUID = ed->ed_OwnerUID;
+    fib->fib_OwnerGID = ed->ed_OwnerGID;
+
+    return desc->fcb->handle;
+}
+
+int __stat_from_dircache(const char *path, struct stat *sb, BOOL links)
+{
+    struct FileInfoBlock fib;
+    char *name;
+    LONG blksize;
+    BPTR lock;
+
+    if (!(lock = __dircache_examine(path, links, &fib, &name, &blksize)))
+        return -1;
+
+    __fill_statbuffer(sb, name, &fib, 0, lock, blksize);
+    FreeVec(name);
+
+    return 0;
+}
+
+int __stat64_from_dircache(const char *path, struct stat64 *sb, BOOL links)
+{
+    struct FileInfoBlock fib;
+    char *name;
+    LONG blksize;
+    BPTR lock;
+
+    if (!(lock = __dircache_examine(path, links, &fib, &name, &blksize)))
+        return -1;
+
+    __fill_stat64buffer(sb, name, &fib, 0, lock, blksize);
+    FreeVec(name);
+
+    return 0;
+}
+
+static LONG __blksize(BPTR lock)
+{
+    struct InfoData info;
+
+    if (lock && Info(lock, &info))
+        return info.id_BytesPerBlock;
+
+    /* The st_blksize is just a guideline anyway, so we set it
+       to 1024 in case Info() didn't succeed */
+    return 1024;
+}
+
 static mode_t __prot_a2u(ULONG protect)
 {
     mode_t uprot = 0000;
@@ -794,7 +886,8 @@ static void __fill_statbuffer(
     char                 *buffer,
     struct FileInfoBlock *fib,
     int                  fallback_to_defaults,
-    BPTR                 lock)
+    BPTR                 lock,
+    LONG                 blksize)
 {
     uint64_t hash;
     uint32_t pc = 1, pb = 1; /* initial hash values */
@@ -834,20 +927,7 @@ static void __fill_statbuffer(
     sb->st_gid     = __id_a2u(fib->fib_OwnerGID);
     sb->st_mode    = __prot_a2u(fib->fib_Protection);
 
-    {
-        struct InfoData info;
-
-        if (lock && Info(lock, &info))
-        {
-            sb->st_blksize = info.id_BytesPerBlock;
-        }
-        else
-        {
-            /* The st_blksize is just a guideline anyway, so we set it
-               to 1024 in case Info() didn't succeed */
-            sb->st_blksize = 1024;
-        }
-    }
+    sb->st_blksize = blksize ? blksize : __blksize(lock);
     if(fib->fib_Size > 0 && sb->st_blksize > 0)
         sb->st_blocks =
             (1 + ((long) fib->fib_Size - 1) / sb->st_blksize) *
@@ -887,7 +967,8 @@ static void __fill_stat64buffer(
     char                 *buffer,
     struct FileInfoBlock *fib,
     int                  fallback_to_defaults,
-    BPTR                 lock)
+    BPTR                 lock,
+    LONG                 blksize)
 {
     uint64_t hash;
     uint32_t pc = 1, pb = 1; /* initial hash values */
@@ -928,20 +1009,7 @@ static void __fill_stat64buffer(
     sb->st_gid     = __id_a2u(fib->fib_OwnerGID);
     sb->st_mode    = __prot_a2u(fib->fib_Protection);
 
-    {
-        struct InfoData info;
-
-        if (lock && Info(lock, &info))
-        {
-            sb->st_blksize = info.id_BytesPerBlock;
-        }
-        else
-        {
-            /* The st_blksize is just a guideline anyway, so we set it
-               to 1024 in case Info() didn't succeed */
-            sb->st_blksize = 1024;
-        }
-    }
+    sb->st_blksize = blksize ? blksize : __blksize(lock);
     if(fib->fib_Size > 0 && sb->st_blksize > 0)
         sb->st_blocks =
             (1 + ((long) fib->fib_Size - 1) / sb->st_blksize) *
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2013, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
 
     Desc: stdio internals
 */
@@ -14,11 +14,14 @@
 
 #include <exec/lists.h>
 #include <dos/dos.h>
+#include <dos/dosextens.h>
 #include <proto/exec.h>
 #include <proto/dos.h>
 #include <aros/symbolsets.h>
 #include <aros/debug.h>
 #include "__stdio.h"
+#include "__fdesc.h"
+#include "__dirdesc.h"
 
 int __smode2oflags(const char *mode)
 {
@@ -122,7 +125,205 @@ int __init_stdio(struct PosixCIntBase *PosixCIntBase)
         return 0;
     }
 
+    /* stderr is never buffered by stdio */
+    PosixCBase->_stderr->flags |= __POSIXC_STDIO_NOBUF | __POSIXC_STDIO_BUFCHECKED;
+
+    return 1;
+}
+
+/* Runs before __exit_fd() closes the file descriptors */
+static void __exit_stdio(struct PosixCIntBase *PosixCIntBase)
+{
+    FILENODE *fn;
+
+    ForeachNode (&PosixCIntBase->stdio_files, fn)
+    {
+        __stdio_sync(FILENODE2FILE(fn));
+        __stdio_freebuf(FILENODE2FILE(fn));
+    }
+}
+
+/*
+    The stdio buffer works as the one of stdc.library streams: fgetc() and
+    fputc() fill and drain it for the getc() and putc() macros, and the
+    other functions call __stdio_sync() before they use the file
+    descriptor. It is allocated with AllocVec() as vfork() switches
+    internalpool while the parent's streams stay in use.
+*/
+
+static BOOL __stdio_getbuf(FILE *stream, fdesc *fdesc)
+{
+    if (stream->buf)
+        return TRUE;
+
+    if (!(stream->flags & __POSIXC_STDIO_BUFCHECKED))
+    {
+        stream->flags |= __POSIXC_STDIO_BUFCHECKED;
+        if ((fdesc->fcb->privflags & _FCB_ISDIR) || IsInteractive(fdesc->fcb->handle))
+            stream->flags |= __POSIXC_STDIO_NOBUF;
+    }
+
+    if (stream->flags & __POSIXC_STDIO_NOBUF)
+        return FALSE;
+
+    stream->buf = AllocVec(__POSIXC_BUFSIZE, MEMF_ANY);
+    if (!stream->buf)
+    {
+        stream->flags |= __POSIXC_STDIO_NOBUF;
+        return FALSE;
+    }
+
+    D(bug("[posixc] %s: stream 0x%p, buf @ 0x%p\n", __func__, stream, stream->buf));
+
+    return TRUE;
+}
+
+/*
+    Reads up to len bytes, but no more than a single Read() returns, so
+    that pipes and sockets don't block until the whole buffer is filled.
+    dos.library fills its own buffer while fetching the first byte, the
+    rest of that buffer is then copied without another Read().
+*/
+static LONG __stdio_readbuffered(BPTR fh, unsigned char *buf, LONG len)
+{
+    struct FileHandle *fhp = BADDR(fh);
+    LONG cnt, avail;
+
+    cnt = FRead(fh, buf, 1, 1);
+    if (cnt == 1)
+    {
+        avail = fhp->fh_End - fhp->fh_Pos;
+        if (avail > len - 1)
+            avail = len - 1;
+        if (avail > 0)
+            cnt += FRead(fh, buf + 1, 1, avail);
+    }
+
+    return cnt;
+}
+
+/* Refills the buffer and returns its first character, EOF or __POSIXC_NOBUF */
+int __stdio_fill(FILE *stream)
+{
+    fdesc *fdesc = __getfdesc(stream->fd);
+    LONG cnt, ioerr;
+
+    if (stream->wpos && __stdio_sync(stream) == EOF)
+        return EOF;
+
+    if (!fdesc || !__stdio_getbuf(stream, fdesc))
+        return __POSIXC_NOBUF;
+
+    /* The first byte is kept free for ungetc() */
+    cnt = __stdio_readbuffered(fdesc->fcb->handle, stream->buf + 1, __POSIXC_BUFSIZE - 1);
+
+    stream->rpos = stream->buf + 1;
+    stream->rend = stream->rpos + (cnt > 0 ? cnt : 0);
+
+    if (cnt <= 0)
+    {
+        ioerr = IoErr();
+
+        if (cnt < 0 && ioerr)
+        {
+            errno = __stdc_ioerr2errno(ioerr);
+            stream->flags |= __POSIXC_STDIO_ERROR;
+        }
+        else
+            stream->flags |= __POSIXC_STDIO_EOF;
+
+        return EOF;
+    }
+
+    return *stream->rpos++;
+}
+
+/* Makes the buffer ready for output, returns 1, 0 if the stream has no
+   buffer or EOF on error */
+int __stdio_wbuf(FILE *stream)
+{
+    fdesc *fdesc = __getfdesc(stream->fd);
+
+    if (__stdio_sync(stream) == EOF)
+        return EOF;
+
+    if (!fdesc || !__stdio_getbuf(stream, fdesc))
+        return 0;
+
+    stream->wpos = stream->buf;
+    stream->wend = stream->buf + __POSIXC_BUFSIZE;
+
     return 1;
 }
 
+/* Writes the buffered output or gives back the input that was read ahead */
+int __stdio_sync(FILE *stream)
+{
+    fdesc *fdesc = __getfdesc(stream->fd);
+    unsigned char *rpos;
+    LONG cnt, done, len;
+
+    if (stream->wpos)
+    {
+        cnt = stream->wpos - stream->buf;
+        stream->wpos = stream->wend = NULL;
+
+        if (cnt > 0)
+        {
+            if (!fdesc)
+            {
+                errno = EBADF;
+                stream->flags |= __POSIXC_STDIO_ERROR;
+                return EOF;
+            }
+
+            /* Cached directory entries may change */
+            __dir_dropcache();
+
+            /* Output written with dos.library calls goes first */
+            if (!Flush(fdesc->fcb->handle))
+                goto error;
+
+            for (done = 0; done < cnt; done += len)
+            {
+                len = Write(fdesc->fcb->handle, stream->buf + done, cnt - done);
+                if (len <= 0)
+                    goto error;
+            }
+        }
+    }
+    else if (stream->rpos)
+    {
+        rpos = stream->rpos;
+        cnt = stream->rend - rpos;
+        stream->rpos = stream->rend = NULL;
+
+        if (cnt > 0 && (!fdesc || Seek(fdesc->fcb->handle, -cnt, OFFSET_CURRENT) < 0))
+        {
+            /* Not seekable, keep the input for the reading functions */
+            stream->rpos = rpos;
+            stream->rend = rpos + cnt;
+            errno = fdesc ? __stdc_ioerr2errno(IoErr()) : EBADF;
+            return EOF;
+        }
+    }
+
+    return 0;
+
+error:
+    errno = __stdc_ioerr2errno(IoErr());
+    stream->flags |= __POSIXC_STDIO_ERROR;
+    return EOF;
+}
+
+void __stdio_freebuf(FILE *stream)
+{
+    FreeVec(stream->buf);
+
+    stream->buf = NULL;
+    stream->rpos = stream->rend = NULL;
+    stream->wpos = stream->wend = NULL;
+}
+
 ADD2OPENLIB(__init_stdio, 5);
+ADD2CLOSELIB(__exit_stdio, 5);
@@ -25,6 +25,14 @@
 #define __POSIXC_STDIO_READ   0x0008L
 #define __POSIXC_STDIO_RDWR   __POSIXC_STDIO_WRITE | __POSIXC_STDIO_READ
 #define __POSIXC_STDIO_APPEND 0x0010L
+#define __POSIXC_STDIO_NOBUF  0x0020L   /* Not buffered by stdio, see __stdio.c */
+#define __POSIXC_STDIO_BUFCHECKED 0x0040L /* __POSIXC_STDIO_NOBUF has been decided */
+
+/* Size of the stdio buffer of a stream */
+#define __POSIXC_BUFSIZE      4096
+
+/* __stdio_fill() result for streams without a stdio buffer */
+#define __POSIXC_NOBUF        (-2)
 
 typedef struct
 {
@@ -38,6 +46,11 @@ typedef struct
 extern int __smode2oflags(const char *mode);
 extern int __oflags2sflags(int oflags);
 
+extern int __stdio_fill(FILE *stream);
+extern int __stdio_wbuf(FILE *stream);
+extern int __stdio_sync(FILE *stream);
+extern void __stdio_freebuf(FILE *stream);
+
 #if !defined(POSIXC_NOSTDIO_DECL)
 extern FILE * __fopen (const char * pathname, const char * mode, int    large);
 extern int __fseeko (FILE * stream, off_t  offset, int    whence);
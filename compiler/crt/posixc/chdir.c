@@ -12,6 +12,7 @@
 #include <aros/symbolsets.h>
 #include <errno.h>
 #include "__upath.h"
+#include "__dirdesc.h"
 
 /*****************************************************************************
 
@@ -58,6 +59,9 @@
     BPTR oldlock;
     BPTR newlock;
     
+    /* Relative paths of cached directory entries change meaning */
+    __dir_dropcache();
+
     path = __path_u2a(path);
     
     if (path == NULL)
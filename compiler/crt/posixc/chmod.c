@@ -9,6 +9,7 @@
 #include <sys/types.h>
 
 #include "__upath.h"
+#include "__dirdesc.h"
 
 ULONG prot_u2a(mode_t protect);
 
@@ -75,6 +76,9 @@ ULONG prot_u2a(mode_t protect);
 
 ******************************************************************************/
 {
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     if (!path) /*safety check */
     {
         errno = EFAULT;
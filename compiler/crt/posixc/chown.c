@@ -12,6 +12,7 @@
 
 #include "__posixc_intbase.h"
 #include "__upath.h"
+#include "__dirdesc.h"
 
 /*****************************************************************************
 
@@ -58,6 +59,9 @@
     struct FileInfoBlock *fib    = NULL;
     BOOL                 changed = TRUE;
 
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     /* check for empty path before potential conversion from "." to "" */
     if (PosixCBase->doupath && path && *path == '\0')
     {
@@ -62,6 +62,9 @@
         return -1;
     }
 
+    /* Needs the lock to end an unfinished ExAll() */
+    __dir_cleanup(dir, desc->fcb->handle);
+
     if (--desc->fcb->opencount == 0)
     {
         UnLock(desc->fcb->handle);
@@ -70,7 +73,6 @@
     __free_fdesc(desc);
     __setfdesc(dir->fd, NULL);
 
-    FreeDosObject(DOS_FIB, dir->priv);
     free(dir);
 
     return 0;
@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include "__upath.h"
+#include "__dirdesc.h"
 #include <aros/debug.h>
 
 /*****************************************************************************
@@ -57,6 +58,10 @@
     BPTR handle = BNULL;
 
     fdesc *fdc = __getfdesc(fd);
+
+    /* Relative paths of cached directory entries change meaning */
+    __dir_dropcache();
+
     if (!(fdc->fcb->privflags & _FCB_ISDIR))
     {
         errno = ENOTDIR;
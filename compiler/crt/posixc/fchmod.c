@@ -14,6 +14,7 @@
 
 #include "__fdesc.h"
 #include "__upath.h"
+#include "__dirdesc.h"
 
 /* The following function is located in chmod.c */
 ULONG prot_u2a(mode_t protect);
@@ -59,6 +60,9 @@ ULONG prot_u2a(mode_t protect);
     UBYTE *buffer;
     int buffersize = 256;
 
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     if (!(fdesc = __getfdesc(filedes)))
     {
         errno = EBADF;
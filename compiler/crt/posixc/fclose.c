@@ -49,6 +49,12 @@
     struct PosixCIntBase *PosixCBase =
         (struct PosixCIntBase *)__aros_getbase_PosixCBase();
     FILENODE * fn;
+    int ret = 0;
+
+    /* Input read ahead from a stream that can't seek back is dropped */
+    if (__stdio_sync(stream) == EOF && !stream->rpos)
+        ret = EOF;
+    __stdio_freebuf(stream);
 
     if (close(stream->fd) == -1)
         return EOF;
@@ -58,6 +64,6 @@
 
     FreePooled(PosixCBase->internalpool, fn, sizeof(FILENODE));
 
-    return 0;
+    return ret;
 } /* fclose */
 
@@ -103,6 +103,8 @@
 
     fn->File.flags = __oflags2sflags(oflags);
     fn->File.fd    = filedes;
+    fn->File.buf   = fn->File.rpos = fn->File.rend = NULL;
+    fn->File.wpos  = fn->File.wend = NULL;
 
     return FILENODE2FILE(fn);
 }
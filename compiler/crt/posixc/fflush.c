@@ -59,6 +59,10 @@
 
         ForeachNode (&PosixCBase->stdio_files, fn)
         {
+            /* Input read ahead from a stream that can't seek back stays buffered */
+            if (__stdio_sync(FILENODE2FILE(fn)) == EOF && !fn->File.rpos)
+                return EOF;
+
             if (fn->File.flags & __POSIXC_STDIO_WRITE)
             {
                 fdesc *fdesc = __getfdesc(fn->File.fd);
@@ -81,6 +85,9 @@
     {
         fdesc *fdesc = __getfdesc(stream->fd);
 
+        if (__stdio_sync(stream) == EOF && !stream->rpos)
+            return EOF;
+
         if (!fdesc || !(stream->flags & __POSIXC_STDIO_WRITE))
         {
             errno = EBADF;
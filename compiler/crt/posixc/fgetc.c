@@ -51,8 +51,12 @@
 int  fgetc (   FILE * stream)
 {
     int c;
-    fdesc *fdesc = __getfdesc(stream->fd);
+    fdesc *fdesc;
 
+    if (stream->rpos < stream->rend)
+        return *stream->rpos++;
+
+    fdesc = __getfdesc(stream->fd);
     if (!fdesc)
     {
         errno = EBADF;
@@ -60,6 +64,15 @@ int  fgetc (   FILE * stream)
         return EOF;
     }
 
+    FLUSHONREADCHECK
+
+    if (stream->flags & __POSIXC_STDIO_READ)
+    {
+        c = __stdio_fill(stream);
+        if (c != __POSIXC_NOBUF)
+            return c;
+    }
+
 /* include the common posixc getc code */
 #define getcstream stream
 #include "__getc.c"
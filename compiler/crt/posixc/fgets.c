@@ -62,6 +62,7 @@
 ******************************************************************************/
 {
     fdesc *fdesc = __getfdesc(stream->fd);
+    char *s = buffer;
 
     if (!fdesc)
     {
@@ -73,7 +74,44 @@
 
     FLUSHONREADCHECK
 
-    buffer = FGets (fdesc->fcb->handle, buffer, size);
+    if (stream->wpos && __stdio_sync(stream) == EOF)
+        return NULL;
+
+    /* Input fgetc() has read ahead comes first */
+    if (stream->rpos < stream->rend && size > 1)
+    {
+        unsigned char *nl;
+        int len = stream->rend - stream->rpos;
+
+        if (len > size - 1)
+            len = size - 1;
+        if ((nl = memchr(stream->rpos, '\n', len)))
+            len = nl - stream->rpos + 1;
+
+        memcpy(s, stream->rpos, len);
+        stream->rpos += len;
+        s += len;
+        size -= len;
+
+        if (nl || size == 1)
+        {
+            *s = '\0';
+            return buffer;
+        }
+    }
+
+    if (!FGets (fdesc->fcb->handle, s, size))
+    {
+        /* Return the part of the line from the buffer */
+        if (s != buffer)
+        {
+            *s = '\0';
+            if (!IoErr())
+                stream->flags |= __POSIXC_STDIO_EOF;
+            return buffer;
+        }
+        buffer = NULL;
+    }
 
     if (!buffer)
     {
@@ -89,8 +127,8 @@
     }
     else
     {
-        int bsize = strlen(buffer);
-        if ((bsize + 1 < size) && (buffer[bsize - 1] != '\n'))
+        int bsize = strlen(s);
+        if ((bsize + 1 < size) && (bsize == 0 || s[bsize - 1] != '\n'))
             stream->flags |= __POSIXC_STDIO_EOF;
     }
 
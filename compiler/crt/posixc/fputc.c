@@ -45,8 +45,19 @@
 
 ******************************************************************************/
 {
-    fdesc *fdesc = __getfdesc(stream->fd);
+    fdesc *fdesc;
+    int res;
 
+    if (stream->wpos < stream->wend)
+        return *stream->wpos++ = (unsigned char)c;
+
+    res = (stream->flags & __POSIXC_STDIO_WRITE) ? __stdio_wbuf(stream) : 0;
+    if (res == EOF)
+        return EOF;
+    if (res)
+        return *stream->wpos++ = (unsigned char)c;
+
+    fdesc = __getfdesc(stream->fd);
     if (!fdesc)
     {
         errno = EBADF;
@@ -6,6 +6,7 @@
 
 #include <proto/dos.h>
 #include <errno.h>
+#include <string.h>
 #include "__fdesc.h"
 #include "__stdio.h"
 
@@ -53,6 +54,22 @@
 
     if (!str) str = "(null)";
 
+    /* Short strings go to the buffer fputc() writes to */
+    if (stream->wpos)
+    {
+        size_t len = strlen(str);
+
+        if (len <= stream->wend - stream->wpos)
+        {
+            memcpy(stream->wpos, str, len);
+            stream->wpos += len;
+            return 0;
+        }
+    }
+
+    if (__stdio_sync(stream) == EOF)
+        return EOF;
+
     if (FPuts(fdesc->fcb->handle, str) == -1)
     {
         errno = __stdc_ioerr2errno(IoErr());
@@ -5,6 +5,7 @@
 */
 
 #include <errno.h>
+#include <string.h>
 #include <dos/dos.h>
 #include <dos/dosextens.h>
 #include <proto/exec.h>
@@ -52,7 +53,7 @@
 
 ******************************************************************************/
 {
-    size_t cnt;
+    size_t cnt, len;
     fdesc *fdesc;
 
     if (size == 0 || nblocks == 0)
@@ -69,7 +70,28 @@
 
     FLUSHONREADCHECK
 
-    cnt = FRead (fdesc->fcb->handle, buf, size, nblocks);
+    if (stream->wpos && __stdio_sync(stream) == EOF)
+        return 0;
+
+    /* Input fgetc() has read ahead comes first, the rest is read as
+       bytes as a block may start in the buffer */
+    if (stream->rpos < stream->rend)
+    {
+        len = stream->rend - stream->rpos;
+        if (len > size * nblocks)
+            len = size * nblocks;
+
+        memcpy(buf, stream->rpos, len);
+        stream->rpos += len;
+
+        cnt = (len < size * nblocks)
+            ? FRead (fdesc->fcb->handle, (UBYTE *)buf + len, 1, size * nblocks - len)
+            : 0;
+        if (cnt != -1)
+            cnt = (len + cnt) / size;
+    }
+    else
+        cnt = FRead (fdesc->fcb->handle, buf, size, nblocks);
 
     if (cnt == -1)
     {
@@ -62,6 +62,9 @@
         return NULL;
     }
 
+    __stdio_sync(stream);
+    __stdio_freebuf(stream);
+
     oflags = __smode2oflags(mode);
     fd = __open(stream->fd, path, oflags, 644);
 
@@ -80,6 +80,9 @@
 
     fh = fdesc->fcb->handle;
 
+    if (__stdio_sync(stream) == EOF)
+        return -1;
+
     /* This is buffered IO, flush the buffer before any Seek */
     Flush (fh);
 
@@ -61,11 +61,17 @@
 
     fh = fdesc->fcb->handle;
 
+    if (stream->wpos && __stdio_sync(stream) == EOF)
+        return -1;
+
     Flush (fh);
     cnt = Seek (fh, 0, OFFSET_CURRENT);
 
     if (cnt == -1)
         errno = __stdc_ioerr2errno (IoErr ());
+    else if (stream->rpos)
+        /* Input read ahead by fgetc() hasn't been seen yet */
+        cnt -= stream->rend - stream->rpos;
 
     return cnt;
 } /* ftell */
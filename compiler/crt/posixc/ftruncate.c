@@ -9,6 +9,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include "__fdesc.h"
+#include "__dirdesc.h"
 
 /*****************************************************************************
 
@@ -54,6 +55,9 @@
     ULONG oldpos;
     size_t size;
 
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     fdesc *fdesc = __getfdesc(fd);
 
     if (!fdesc)
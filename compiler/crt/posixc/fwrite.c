@@ -12,9 +12,11 @@
 #include <proto/dos.h>
 
 #include <errno.h>
+#include <string.h>
 
 #include "__stdio.h"
 #include "__fdesc.h"
+#include "__dirdesc.h"
 
 /*****************************************************************************
 
@@ -49,6 +51,9 @@
 {
     size_t cnt;
 
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     D(bug("[fwrite]: buf=%p, size=%d, nblocks=%d, stream=%p\n",
           buf, size, nblocks, stream
     ));
@@ -62,6 +67,17 @@
         return 0;
     }
 
+    /* Small writes go to the buffer fputc() writes to */
+    if (stream->wpos && size * nblocks <= stream->wend - stream->wpos)
+    {
+        memcpy(stream->wpos, buf, size * nblocks);
+        stream->wpos += size * nblocks;
+        return nblocks;
+    }
+
+    if (__stdio_sync(stream) == EOF)
+        return 0;
+
     if (nblocks > 0 && size > 0)
         cnt = FWrite (fdesc->fcb->handle, (CONST APTR)buf, size, nblocks);
     else
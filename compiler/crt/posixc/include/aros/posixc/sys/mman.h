@@ -0,0 +1,42 @@
+#ifndef _POSIXC_SYS_MMAN_H_
+#define _POSIXC_SYS_MMAN_H_
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: POSIX.1-2008 header file <sys/mman.h>
+*/
+
+#include <aros/system.h>
+
+#include <aros/types/size_t.h>
+#include <aros/types/off_t.h>
+
+/* Protection of the mapped pages */
+#define PROT_NONE       0x00
+#define PROT_READ       0x01
+#define PROT_WRITE      0x02
+#define PROT_EXEC       0x04
+
+/* Type of the mapping */
+#define MAP_SHARED      0x0001
+#define MAP_PRIVATE     0x0002
+#define MAP_FIXED       0x0010
+#define MAP_ANONYMOUS   0x0020
+#define MAP_ANON        MAP_ANONYMOUS
+
+#define MAP_FAILED      ((void *)-1)
+
+/* msync() flags */
+#define MS_ASYNC        0x0001
+#define MS_INVALIDATE   0x0002
+#define MS_SYNC         0x0004
+
+__BEGIN_DECLS
+
+void *mmap(void *addr, size_t len, int prot, int flags, int fd, off_t off);
+int msync(void *addr, size_t len, int flags);
+int munmap(void *addr, size_t len);
+
+__END_DECLS
+
+#endif /* _POSIXC_SYS_MMAN_H_ */
@@ -73,6 +73,10 @@ static BPTR __lock(
     if (path == NULL)
         return -1;
 
+    /* An entry readdir() has just returned */
+    if (__stat_from_dircache(path, sb, TRUE) == 0)
+        return 0;
+
     lock = __lock(path, SHARED_LOCK);
     if (!lock)
     {
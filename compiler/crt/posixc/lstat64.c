@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 2020-2025, The AROS Development Team. All rights reserved.
 */
 
 #include <aros/debug.h>
@@ -73,6 +73,10 @@ static BPTR __lock(
     if (path == NULL)
         return -1;
 
+    /* An entry readdir() has just returned */
+    if (__stat64_from_dircache(path, sb, TRUE) == 0)
+        return 0;
+
     lock = __lock(path, SHARED_LOCK);
     if (!lock)
     {
@@ -0,0 +1,228 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    POSIX.1-2008 function mmap().
+*/
+
+#include <aros/debug.h>
+
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <exec/memory.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+
+#include "__fdesc.h"
+#include "__posixc_intbase.h"
+#include "__mmap.h"
+
+/*****************************************************************************
+
+    NAME */
+#include <sys/mman.h>
+
+        void *mmap (
+
+/*  SYNOPSIS */
+        void *addr,
+        size_t len,
+        int prot,
+        int flags,
+        int fd,
+        off_t off)
+
+/*  FUNCTION
+        Maps len bytes of the file open as fd, starting at offset off,
+        into memory.
+
+        prot is PROT_NONE or an OR of PROT_READ, PROT_WRITE and PROT_EXEC.
+        flags has to contain one of MAP_SHARED and MAP_PRIVATE. Changes to
+        a MAP_SHARED mapping are written to the file and seen by the other
+        shared mappings of it, changes to a MAP_PRIVATE mapping only by
+        the caller. With MAP_ANONYMOUS no file is used and the memory is
+        filled with zeros, fd is then ignored.
+
+    INPUTS
+        addr - Ignored, the address of the mapping is always chosen by
+            the system.
+        len - Number of bytes to map.
+        prot - Allowed accesses to the memory.
+        flags - Type of the mapping.
+        fd - File descriptor of the file to map.
+        off - Offset in the file, has to be a multiple of PAGESIZE.
+
+    RESULT
+        The address of the mapping or MAP_FAILED with errno set.
+
+    NOTES
+        Bytes of the last page that are past the end of the file are zero
+        and are not written to the file.
+
+        The mapping stays after fd is closed, it is removed by munmap() or
+        when the program exits.
+
+    EXAMPLE
+
+    BUGS
+        MAP_FIXED is not supported.
+
+        The file is read when it is mapped and written back by msync() and
+        munmap() only. Changes made to the file with write() while it is
+        mapped are not seen in the mapping.
+
+        Where the MMU can not be used the protection of the memory is not
+        enforced. Where it can be used, PROT_READ is not enforced for the
+        mappings that share memory with a MAP_SHARED mapping with
+        PROT_WRITE, also the ones of other processes. They can be written
+        for as long as the writable mapping exists.
+
+    SEE ALSO
+        munmap(), msync()
+
+    INTERNALS
+        The file is read when the mapping is made, AROS has no way to fill
+        the pages when they are first touched. Mappings of the same file
+        that can share the memory, the ones that are not writable and the
+        MAP_SHARED ones, use one copy of the file as long as it is not
+        changed. This copy is shared between processes. Writable
+        MAP_PRIVATE and PROT_EXEC mappings get their own copy.
+
+******************************************************************************/
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+    struct __mmap_cache *cache = PosixCBase->mmapcache;
+    struct __mmap_file *file = NULL;
+    struct __mmap_extent *ext;
+    struct __mmap_map *map;
+    fdesc *fdesc;
+    BPTR fh = BNULL;
+    size_t alen;
+
+    D(bug("mmap(0x%p, %lu, %d, %d, %d, %ld)\n",
+          addr, (unsigned long)len, prot, flags, fd, (long)off));
+
+    if (len == 0 || off < 0 || (off & (PAGESIZE - 1)) != 0
+        || (prot & ~(PROT_READ | PROT_WRITE | PROT_EXEC)) != 0
+        || ((flags & (MAP_SHARED | MAP_PRIVATE)) != MAP_SHARED
+            && (flags & (MAP_SHARED | MAP_PRIVATE)) != MAP_PRIVATE))
+    {
+        errno = EINVAL;
+        return MAP_FAILED;
+    }
+
+    if (flags & MAP_FIXED)
+    {
+        errno = ENOTSUP;
+        return MAP_FAILED;
+    }
+
+    if (!(flags & MAP_ANONYMOUS))
+    {
+        fdesc = __getfdesc(fd);
+        if (!fdesc)
+        {
+            errno = EBADF;
+            return MAP_FAILED;
+        }
+        if (fdesc->fcb->privflags & _FCB_ISDIR)
+        {
+            errno = ENODEV;
+            return MAP_FAILED;
+        }
+        if (!(fdesc->fcb->flags & O_RDONLY)
+            || ((flags & MAP_SHARED) && (prot & PROT_WRITE) && !(fdesc->fcb->flags & O_WRONLY)))
+        {
+            errno = EACCES;
+            return MAP_FAILED;
+        }
+
+        FLUSHONREADCHECK
+        fh = fdesc->fcb->handle;
+    }
+
+    alen = __mmap_round(cache, len);
+    if (alen < len)
+    {
+        errno = ENOMEM;
+        return MAP_FAILED;
+    }
+
+    map = AllocMem(sizeof(struct __mmap_map), MEMF_PUBLIC | MEMF_CLEAR);
+    if (!map)
+    {
+        errno = ENOMEM;
+        return MAP_FAILED;
+    }
+    map->owner = PosixCBase;
+    map->len = alen;
+    map->prot = prot;
+    map->flags = flags;
+
+    ObtainSemaphore(&cache->sem);
+
+    if (fh && !(file = __mmap_getfile(cache, fh)))
+        goto fail;
+
+    if (fh && !(prot & PROT_EXEC) && (!(prot & PROT_WRITE) || (flags & MAP_SHARED)))
+    {
+        ext = __mmap_getextent(cache, file, fh, off, alen);
+        if (!ext)
+        {
+            __mmap_putfile(cache, file);
+            goto fail;
+        }
+
+        /* The changes have to be seen by the other mappings of the range,
+           so they share the memory and lose their write protection too */
+        if ((flags & MAP_SHARED) && (prot & PROT_WRITE) && ext->writers++ == 0)
+            __mmap_protect(cache, &ext->mem, ext->len, PROT_READ | PROT_WRITE);
+
+        map->extent = ext;
+        map->addr = (char *)ext->mem.mem + (off - ext->offset);
+    }
+    else
+    {
+        if (!__mmap_alloc(cache, &map->mem, alen, (prot & PROT_EXEC) != 0))
+        {
+            if (file)
+                __mmap_putfile(cache, file);
+            errno = ENOMEM;
+            goto fail;
+        }
+
+        if (file)
+        {
+            int ret = __mmap_fill(file, fh, off, map->mem.mem, alen);
+
+            __mmap_putfile(cache, file);
+            if (ret != 0)
+            {
+                __mmap_free(cache, &map->mem);
+                goto fail;
+            }
+        }
+        else
+            memset(map->mem.mem, 0, alen);
+
+        __mmap_protect(cache, &map->mem, alen, prot);
+        map->addr = map->mem.mem;
+    }
+
+    AddTail((struct List *)&cache->maps, (struct Node *)map);
+
+    ReleaseSemaphore(&cache->sem);
+
+    D(bug("[mmap] Mapped at 0x%p\n", map->addr));
+
+    return map->addr;
+
+fail:
+    ReleaseSemaphore(&cache->sem);
+    FreeMem(map, sizeof(struct __mmap_map));
+
+    return MAP_FAILED;
+}
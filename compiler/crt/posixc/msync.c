@@ -0,0 +1,103 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    POSIX.1-2008 function msync().
+*/
+
+#include <aros/debug.h>
+
+#include <proto/exec.h>
+
+#include <errno.h>
+#include <limits.h>
+
+#include "__posixc_intbase.h"
+#include "__mmap.h"
+
+/*****************************************************************************
+
+    NAME */
+#include <sys/mman.h>
+
+        int msync (
+
+/*  SYNOPSIS */
+        void *addr,
+        size_t len,
+        int flags)
+
+/*  FUNCTION
+        Writes the changes made to the MAP_SHARED mappings in the range of
+        len bytes starting at addr to their files.
+
+    INPUTS
+        addr - Start of the range, has to be a multiple of PAGESIZE.
+        len - Length of the range.
+        flags - One of MS_ASYNC and MS_SYNC, optionally ORed with
+            MS_INVALIDATE.
+
+    RESULT
+        0 on success, -1 on error with errno set. ENOMEM is returned when
+        nothing is mapped in the range.
+
+    NOTES
+        The data is always written before msync() returns, also with
+        MS_ASYNC. MS_INVALIDATE does nothing as the shared mappings of
+        a file use the same memory.
+
+    EXAMPLE
+
+    BUGS
+
+    SEE ALSO
+        mmap(), munmap()
+
+    INTERNALS
+
+******************************************************************************/
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+    struct __mmap_cache *cache = PosixCBase->mmapcache;
+    struct __mmap_map *map;
+    char *start = addr, *end = start + len, *from, *to;
+    BOOL found = FALSE;
+    int ret = 0;
+
+    D(bug("msync(0x%p, %lu, %d)\n", addr, (unsigned long)len, flags));
+
+    if (((IPTR)addr & (PAGESIZE - 1)) != 0
+        || (flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) != 0
+        || (flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ObtainSemaphore(&cache->sem);
+
+    ForeachNode(&cache->maps, map)
+    {
+        if (map->addr >= end || map->addr + map->len <= start)
+            continue;
+
+        found = TRUE;
+        if (map->extent && (map->flags & MAP_SHARED) && (map->prot & PROT_WRITE))
+        {
+            from = start > map->addr ? start : map->addr;
+            to = end < map->addr + map->len ? end : map->addr + map->len;
+            if (__mmap_writeback(map, from, to - from) != 0)
+                ret = -1;
+        }
+    }
+
+    ReleaseSemaphore(&cache->sem);
+
+    if (!found)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    return ret;
+}
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    POSIX.1-2008 function munmap().
+*/
+
+#include <aros/debug.h>
+
+#include <proto/exec.h>
+
+#include <errno.h>
+#include <limits.h>
+
+#include "__posixc_intbase.h"
+#include "__mmap.h"
+
+/*****************************************************************************
+
+    NAME */
+#include <sys/mman.h>
+
+        int munmap (
+
+/*  SYNOPSIS */
+        void *addr,
+        size_t len)
+
+/*  FUNCTION
+        Removes the mapping made by mmap() that starts at addr. The changes
+        to a MAP_SHARED mapping are written to its file first.
+
+    INPUTS
+        addr - Address returned by mmap().
+        len - Length given to mmap().
+
+    RESULT
+        0 on success, -1 on error with errno set.
+
+    NOTES
+        Each call removes one mapping. Other mappings that lie in the range
+        stay, as mappings of parts of the same file range can share memory.
+
+    EXAMPLE
+
+    BUGS
+        Parts of a mapping can not be unmapped. A range that does not start
+        at a mapping fails with EINVAL.
+
+    SEE ALSO
+        mmap(), msync()
+
+    INTERNALS
+        Mappings of the same part of a file can have the same address. The
+        one with the same length is removed, or if there is none the last
+        one made at addr that is not longer than len.
+
+******************************************************************************/
+{
+    struct PosixCIntBase *PosixCBase =
+        (struct PosixCIntBase *)__aros_getbase_PosixCBase();
+    struct __mmap_cache *cache = PosixCBase->mmapcache;
+    struct __mmap_map *map, *found = NULL;
+    size_t alen;
+
+    D(bug("munmap(0x%p, %lu)\n", addr, (unsigned long)len));
+
+    if (len == 0 || ((IPTR)addr & (PAGESIZE - 1)) != 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    alen = __mmap_round(cache, len);
+
+    ObtainSemaphore(&cache->sem);
+
+    ForeachNode(&cache->maps, map)
+    {
+        if (map->owner != PosixCBase || map->addr != (char *)addr || map->len > alen)
+            continue;
+
+        /* Keep looking for an exact match, later ones win */
+        if (!found || found->len != alen || map->len == alen)
+            found = map;
+    }
+
+    if (found)
+        __mmap_release(cache, found);
+
+    ReleaseSemaphore(&cache->sem);
+
+    if (!found)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2021, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
 
     POSIX.1-2008 function opendir().
 */
@@ -52,6 +52,7 @@
         telldir()
 
     INTERNALS
+        The entries are read in batches with ExAll(), see __dirdesc.h.
 
 ******************************************************************************/
 {
@@ -60,6 +61,7 @@
     fcb *cblock;
     fdesc *desc;
     BPTR lock;
+    struct FileInfoBlock *fib;
     const char *aname;
 #ifndef ExNext_IS_WORKING_WITHOUT_ASSIGN
     char assign[32];
@@ -78,8 +80,8 @@
         goto err1;
     }
 
-    dir->priv = AllocDosObject(DOS_FIB, NULL);
-    if (!dir->priv)
+    fib = AllocDosObject(DOS_FIB, NULL);
+    if (!fib)
     {
         errno = ENOMEM;
         goto err2;
@@ -87,6 +89,8 @@
 
     /* Lock is used instead of open to allow opening "" */
     aname = __path_u2a(name);
+    if (!aname)
+        goto err3;
     lock = Lock(aname, SHARED_LOCK);
     if (!lock)
     {
@@ -108,23 +112,26 @@
     AssignLock(assign, BNULL);
 #endif
 
-    if (!Examine(lock, dir->priv))
+    if (!Examine(lock, fib))
     {
         errno = __stdc_ioerr2errno(IoErr());
         goto err4;
     }
 
-    if (((struct FileInfoBlock *)dir->priv)->fib_DirEntryType<=0)
+    if (fib->fib_DirEntryType<=0)
     {
         errno = ENOTDIR;
         goto err4;
     }
 
+    if (__dir_setup(dir, aname) != 0)
+        goto err4;
+
     cblock = AllocVec(sizeof(fcb), MEMF_ANY | MEMF_CLEAR);
     if(!cblock)
     {
         errno = ENOMEM;
-        goto err4;
+        goto err6;
     }
     desc = __alloc_fdesc();
     if(!desc)
@@ -146,15 +153,19 @@
     dir->pos = 0;
     dir->ent.d_name[NAME_MAX] = '\0';
 
+    FreeDosObject(DOS_FIB, fib);
+
     D(bug("opendir(%s) fd=%d\n", name, fd));
     return dir;
 
 err5:
     FreeVec(cblock);
+err6:
+    __dir_cleanup(dir, lock);
 err4:
     UnLock(lock);
 err3:
-    FreeDosObject(DOS_FIB, dir->priv);
+    FreeDosObject(DOS_FIB, fib);
 err2:
     free(dir);
 err1:
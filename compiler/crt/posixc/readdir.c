@@ -58,6 +58,9 @@
         telldir()
 
     INTERNALS
+        The entries are read in batches with ExAll(), see __dirdesc.h.
+        d_type is filled in, so callers only need stat() for more than
+        the type of an entry.
 
 ******************************************************************************/
 {
@@ -101,66 +104,28 @@
     }
     else
     {
-        struct FileInfoBlock *fib = (struct FileInfoBlock *)dir->priv;
+        struct ExAllData *ed;
 
-        if (!ExNext(desc->fcb->handle, fib))
+        /* The handler may return "." and "..", they have been given above */
+        do
         {
-            dir->pos--;
-            if (IoErr() != ERROR_NO_MORE_ENTRIES)
+            ed = __dir_next(dir, desc->fcb->handle);
+            if (!ed)
             {
-                errno = __stdc_ioerr2errno(IoErr());
-                D(bug(") errno=%d\n", (int)errno));
+                D(bug("end) errno=%d\n", (int)errno));
+                return NULL;
             }
-            D(else
-                bug("NO_MORE_ENTRIES)\n"));
-            return NULL;
-        }
-
-        CONST_STRPTR name = fib->fib_FileName;
-        while (TRUE)
-        {
-
-            if (PosixCBase->doupath && name[0] == '.')
-            {
-                if (name[1] == '.')
-                {
-                    if (name[2] == '\0')
-                        continue;
-                }
-                else
-                if (name[1] == '\0')
-                    continue;
-            }
-          
-            strncpy(dir->ent.d_name, name, max);
-            dir->ent.d_reclen = strlen(name);
-
-            switch (fib->fib_DirEntryType)
-            {
-            case ST_FILE:
-              dir->ent.d_type = DT_REG;
-              break;
-            case ST_ROOT:
-            case ST_USERDIR:
-              dir->ent.d_type = DT_DIR;
-              break;
-            case ST_SOFTLINK:
-            case ST_LINKFILE:
-            case ST_LINKDIR:
-              dir->ent.d_type = DT_LNK;
-              break;
-            case ST_PIPEFILE:
-              dir->ent.d_type = DT_FIFO;
-              break;
-            default:
-              dir->ent.d_type = DT_UNKNOWN;
-              break;
-            }
-            
-            break;
         }
+        while (PosixCBase->doupath && ed->ed_Name[0] == '.'
+               && (ed->ed_Name[1] == '\0'
+                   || (ed->ed_Name[1] == '.' && ed->ed_Name[2] == '\0')));
+
+        strncpy(dir->ent.d_name, (const char *)ed->ed_Name, max);
+        dir->ent.d_name[max] = '\0';
+        dir->ent.d_reclen = strlen(dir->ent.d_name);
+        dir->ent.d_type = __dir_type(ed->ed_Type);
     }
-   
+
     D(bug("%s) d_type=%d\n", dir->ent.d_name, (int)dir->ent.d_type));
     dir->pos++;
     return &(dir->ent);
@@ -0,0 +1,581 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    A lazily built DFA for regexec().  This file is #included by regexec.c
+    after the large version of engine.c, whose step() it uses to compute
+    the transitions.
+
+    A DFA state is a set of strip positions, as in the large engine, plus
+    what kind of character came before it, which is all that is needed to
+    handle ^, $ and the word boundaries.  States and transitions are only
+    made when a string needs them and are kept with the compiled RE, so a
+    pattern that is run over many lines costs one table lookup per
+    character after a short warm up.  Characters are mapped to classes
+    first, characters that all parts of the RE treat alike share a class.
+
+    fast() and slow() are simulated exactly, including the places where
+    the engine notes the start of a match, so the results are the same as
+    with the engine.  REs with back references do not get a DFA.
+*/
+
+/* what came before a state */
+#define	CTX_OUTBOL	0	/* start of string, ^ may match */
+#define	CTX_OUT		1	/* start of string with REG_NOTBOL */
+#define	CTX_NL		2	/* newline with REG_NEWLINE */
+#define	CTX_WORD	3	/* word character */
+#define	CTX_OTHER	4	/* any other character */
+#define	NCTX		5
+
+#define	DFA_HASHSIZE	256	/* power of two */
+#define	DFA_MAXMEM	(256*1024)	/* cache is flushed beyond this */
+#define	DFA_MAXFLUSH	8	/* give up after this many flushes */
+
+struct dfastate {
+	struct dfastate *hnext;	/* hash chain */
+	unsigned hash;
+	int index;		/* in re_dfa.dstates */
+	int ctx;		/* CTX_xxx of the character before */
+	int anchored;		/* no new match may start, see slow() */
+	int fresh;		/* no match underway, see fast() */
+	int dead;		/* no match possible any more */
+	char *set;		/* -> char [nstates] */
+	int trans[1];		/* actually [nclasses], (next<<1)|hit or -1 */
+};
+
+struct re_dfa {
+	struct SignalSemaphore lock;
+	int usectx;		/* RE has ^, $ or word boundaries */
+	int small;		/* regexec() would use smatcher() */
+	int prefix;		/* first character of every match or -1 */
+	int nclasses;
+	uch classes[NC];	/* character -> class */
+	uch classctx[NC];	/* class -> CTX_xxx */
+	size_t statesize;	/* bytes per dfastate */
+	size_t mem;		/* bytes of all states */
+	int flushes;
+	int off;		/* too many states, use the engine */
+	int nstates;
+	int maxstates;
+	struct dfastate **dstates;
+	struct dfastate *hash[DFA_HASHSIZE];
+	struct dfastate *fresh[NCTX];	/* start states of fast() */
+	struct dfastate *start[NCTX];	/* start states of slow() */
+	char *freshset;		/* start set of both */
+	char *tmp;		/* scratch sets */
+	char *aft;
+	char *bef;
+};
+
+static void dfaflush(struct re_dfa *d);
+
+/*
+ - ctxof - context for the state after a character
+ */
+static int
+ctxof(
+    struct re_guts *g,
+    int c)
+{
+	if (c == '\n' && (g->cflags&REG_NEWLINE))
+		return(CTX_NL);
+	if (ISWORD(c))
+		return(CTX_WORD);
+	return(CTX_OTHER);
+}
+
+/*
+ - dfaflag - step(st, flagch, st) as the engine regexec() picks does it
+ *
+ * The small engine passes the states before by value, so one step only
+ * gets past one ^ or $ in a row.  In the large one they are the same
+ * array and a step can get past several.
+ */
+static void
+dfaflag(
+    struct re_guts *g,
+    struct re_dfa *d,
+    char *st,
+    int flagch)
+{
+	const sopno gf = g->firststate+1;
+	const sopno gl = g->laststate;
+
+	if (d->small) {
+		memcpy(d->bef, st, (size_t)g->nstates);
+		lstep(g, gf, gl, d->bef, flagch, st);
+	} else
+		lstep(g, gf, gl, st, flagch, st);
+}
+
+/*
+ - dfaflags - do the ^, $ and word boundary steps between ctx and c,
+ - which is a character or OUT for the end of the string
+ */
+static void
+dfaflags(
+    struct re_guts *g,
+    struct re_dfa *d,
+    char *st,
+    int ctx,
+    int c,
+    int eflags)
+{
+	int bol;
+	int eol;
+	int flagch;
+	int i;
+
+	bol = (ctx == CTX_OUTBOL || ctx == CTX_NL);
+	if (c == OUT)
+		eol = !(eflags&REG_NOTEOL);
+	else
+		eol = (c == '\n' && (g->cflags&REG_NEWLINE));
+
+	flagch = '\0';
+	i = 0;
+	if (bol) {
+		flagch = BOL;
+		i = g->nbol;
+	}
+	if (eol) {
+		flagch = (flagch == BOL) ? BOLEOL : EOL;
+		i += g->neol;
+	}
+	for (; i > 0; i--)
+		dfaflag(g, d, st, flagch);
+
+	/* same tests as in fast() and slow() */
+	if ((flagch == BOL || (ctx != CTX_OUTBOL && ctx != CTX_OUT &&
+				ctx != CTX_WORD)) && c != OUT && ISWORD(c))
+		flagch = BOW;
+	if (ctx == CTX_WORD && (flagch == EOL || (c != OUT && !ISWORD(c))))
+		flagch = EOW;
+	if (flagch == BOW || flagch == EOW)
+		dfaflag(g, d, st, flagch);
+}
+
+/*
+ - dfastate - find or make the state for a set
+ */
+static struct dfastate *	/* NULL if out of memory */
+dfastate(
+    struct re_guts *g,
+    struct re_dfa *d,
+    const char *set,
+    int ctx,
+    int anchored)
+{
+	struct dfastate *s;
+	struct dfastate **ns;
+	unsigned hash;
+	sopno i;
+	int dead;
+	int fresh;
+
+	hash = 2166136261U ^ (unsigned)(ctx*2 + anchored);
+	for (i = 0; i < g->nstates; i++)
+		hash = (hash ^ (uch)set[i]) * 16777619U;
+
+	for (s = d->hash[hash&(DFA_HASHSIZE-1)]; s != NULL; s = s->hnext)
+		if (s->hash == hash && s->ctx == ctx &&
+				s->anchored == anchored &&
+				memcmp(s->set, set, (size_t)g->nstates) == 0)
+			return(s);
+
+	if (d->mem + d->statesize > DFA_MAXMEM)
+		dfaflush(d);
+
+	if (d->nstates == d->maxstates) {
+		ns = realloc(d->dstates, (d->maxstates*2 + 16) *
+						sizeof(struct dfastate *));
+		if (ns == NULL)
+			return(NULL);
+		d->dstates = ns;
+		d->maxstates = d->maxstates*2 + 16;
+	}
+	s = malloc(d->statesize);
+	if (s == NULL)
+		return(NULL);
+	d->mem += d->statesize;
+
+	dead = 1;
+	for (i = 0; i < g->nstates; i++)
+		if (set[i])
+			dead = 0;
+	fresh = !anchored &&
+			memcmp(set, d->freshset, (size_t)g->nstates) == 0;
+
+	s->hash = hash;
+	s->index = d->nstates;
+	s->ctx = ctx;
+	s->anchored = anchored;
+	s->fresh = fresh;
+	s->dead = dead;
+	s->set = (char *)&s->trans[d->nclasses];
+	memcpy(s->set, set, (size_t)g->nstates);
+	memset(s->trans, -1, d->nclasses * sizeof(int));
+	s->hnext = d->hash[hash&(DFA_HASHSIZE-1)];
+	d->hash[hash&(DFA_HASHSIZE-1)] = s;
+	d->dstates[d->nstates++] = s;
+
+	return(s);
+}
+
+/*
+ - dfaflush - forget all states to keep the memory use bounded
+ */
+static void
+dfaflush(
+    struct re_dfa *d)
+{
+	int i;
+
+	for (i = 0; i < d->nstates; i++)
+		free(d->dstates[i]);
+	d->nstates = 0;
+	d->mem = 0;
+	memset(d->hash, 0, sizeof(d->hash));
+	memset(d->fresh, 0, sizeof(d->fresh));
+	memset(d->start, 0, sizeof(d->start));
+
+	/* the states do not get reused, the engine is faster then */
+	if (++d->flushes > DFA_MAXFLUSH)
+		d->off = 1;
+}
+
+/*
+ - dfastart - the state fast() (anchored == 0) or slow() start in
+ */
+static struct dfastate *
+dfastart(
+    struct re_guts *g,
+    struct re_dfa *d,
+    int ctx,
+    int anchored)
+{
+	struct dfastate **sp;
+
+	if (!d->usectx)
+		ctx = CTX_OTHER;
+	sp = anchored ? &d->start[ctx] : &d->fresh[ctx];
+	if (*sp == NULL)
+		*sp = dfastate(g, d, d->freshset, ctx, anchored);
+	return(*sp);
+}
+
+/*
+ - dfanext - make the transition of a state for a character
+ *
+ * The states may get flushed to make room, s is not valid afterwards.
+ */
+static int			/* (next<<1)|hit or -1 if out of memory */
+dfanext(
+    struct re_guts *g,
+    struct re_dfa *d,
+    struct dfastate *s,
+    int c)
+{
+	const sopno gf = g->firststate+1;
+	const sopno gl = g->laststate;
+	struct dfastate *n;
+	int cls = d->classes[(uch)c];
+	int hit;
+	int flushes = d->flushes;
+
+	memcpy(d->tmp, s->set, (size_t)g->nstates);
+	if (d->usectx)
+		dfaflags(g, d, d->tmp, s->ctx, c, 0);
+	hit = d->tmp[gl] != 0;
+
+	if (s->anchored)
+		memset(d->aft, 0, (size_t)g->nstates);
+	else
+		memcpy(d->aft, d->freshset, (size_t)g->nstates);
+	lstep(g, gf, gl, d->tmp, c, d->aft);
+
+	n = dfastate(g, d, d->aft, d->classctx[cls], s->anchored);
+	if (n == NULL)
+		return(-1);
+	if (d->flushes == flushes)
+		s->trans[cls] = (n->index<<1) | hit;
+	return((n->index<<1) | hit);
+}
+
+/*
+ - dfaend - does a match end at the end of the string
+ */
+static int
+dfaend(
+    struct re_guts *g,
+    struct re_dfa *d,
+    struct dfastate *s,
+    int eflags)
+{
+	if (s->dead)
+		return(0);
+	memcpy(d->tmp, s->set, (size_t)g->nstates);
+	if (d->usectx)
+		dfaflags(g, d, d->tmp, s->ctx, OUT, eflags);
+	return(d->tmp[g->laststate] != 0);
+}
+
+/*
+ - dfactx - context at p
+ */
+static int
+dfactx(
+    struct re_guts *g,
+    const char *p,
+    const char *beginp,
+    int eflags)
+{
+	if (p == beginp)
+		return((eflags&REG_NOTBOL) ? CTX_OUT : CTX_OUTBOL);
+	return(ctxof(g, p[-1]));
+}
+
+/*
+ - dfafast - fast() with the DFA
+ */
+static int			/* 0 match, REG_NOMATCH or REG_DFAOFF */
+dfafast(
+    struct re_guts *g,
+    struct re_dfa *d,
+    const char *start,
+    const char *stop,
+    int eflags,
+    const char **coldpp)
+{
+	struct dfastate *s;
+	const char *p = start;
+	const char *q;
+	const char *coldp = start;
+	int t;
+
+	s = dfastart(g, d, dfactx(g, start, start, eflags), 0);
+	if (s == NULL)
+		return(REG_DFAOFF);
+	for (;;) {
+		if (s->fresh) {
+			coldp = p;
+			/*
+			 * Nothing happens in the fresh state until the first
+			 * character of a match turns up, let memchr() look.
+			 */
+			if (d->prefix >= 0 && p != stop &&
+					(uch)*p != d->prefix) {
+				q = memchr(p, d->prefix, (size_t)(stop - p));
+				if (q == NULL)
+					return(REG_NOMATCH);
+				p = coldp = q;
+				s = dfastart(g, d,
+					dfactx(g, p, start, eflags), 0);
+				if (s == NULL)
+					return(REG_DFAOFF);
+			}
+		}
+		if (p == stop) {
+			if (!dfaend(g, d, s, eflags))
+				return(REG_NOMATCH);
+			break;
+		}
+		t = s->trans[d->classes[(uch)*p]];
+		if (t < 0 && (t = dfanext(g, d, s, *p)) < 0)
+			return(REG_DFAOFF);
+		if (t&1)
+			break;
+		s = d->dstates[t>>1];
+		p++;
+	}
+
+	*coldpp = coldp;
+	return(0);
+}
+
+/*
+ - dfaslow - slow() with the DFA
+ */
+static int			/* 0 or REG_DFAOFF */
+dfaslow(
+    struct re_guts *g,
+    struct re_dfa *d,
+    const char *start,
+    const char *stop,
+    const char *beginp,
+    int eflags,
+    const char **matchpp)
+{
+	struct dfastate *s;
+	const char *p = start;
+	const char *matchp = NULL;
+	int t;
+
+	s = dfastart(g, d, dfactx(g, start, beginp, eflags), 1);
+	if (s == NULL)
+		return(REG_DFAOFF);
+	while (!s->dead) {
+		if (p == stop) {
+			if (dfaend(g, d, s, eflags))
+				matchp = p;
+			break;
+		}
+		t = s->trans[d->classes[(uch)*p]];
+		if (t < 0 && (t = dfanext(g, d, s, *p)) < 0)
+			return(REG_DFAOFF);
+		if (t&1)
+			matchp = p;
+		s = d->dstates[t>>1];
+		p++;
+	}
+
+	*matchpp = matchp;
+	return(0);
+}
+
+/*
+ - __regdfa_exec - find a match with the DFA
+ *
+ * Sets *coldpp and *endpp to the leftmost longest match if findstart is
+ * set, like fast() and slow() do in matcher().  The DFA may be in use by
+ * another task, then the engine has to do it.
+ */
+int				/* 0, REG_NOMATCH or REG_DFAOFF */
+__regdfa_exec(
+    struct re_guts *g,
+    const char *start,
+    const char *stop,
+    int eflags,
+    int findstart,
+    const char **coldpp,
+    const char **endpp)
+{
+	struct re_dfa *d = g->dfa;
+	const char *coldp;
+	const char *endp;
+	int error;
+
+	if (d == NULL || d->off || (eflags&(REG_LARGE|REG_BACKR|REG_TRACE)))
+		return(REG_DFAOFF);
+	if (!AttemptSemaphore(&d->lock))
+		return(REG_DFAOFF);
+
+	error = dfafast(g, d, start, stop, eflags, &coldp);
+	if (error == 0 && findstart) {
+		for (;;) {
+			error = dfaslow(g, d, coldp, stop, start, eflags,
+									&endp);
+			if (error != 0 || endp != NULL)
+				break;
+			assert(coldp < stop);
+			coldp++;
+		}
+		*coldpp = coldp;
+		*endpp = endp;
+	}
+
+	ReleaseSemaphore(&d->lock);
+	return(error);
+}
+
+/*
+ - __regdfa_new - set up the DFA of a compiled RE, no states are made yet
+ */
+void
+__regdfa_new(
+    struct re_guts *g)
+{
+	struct re_dfa *d;
+	int keyclass[NC*NCTX];
+	int key;
+	int ctx;
+	int i;
+	int c;
+	sopno pc;
+	sop s;
+
+	g->dfa = NULL;
+	if (g->backrefs || (g->iflags&BAD))
+		return;
+
+	d = calloc(1, sizeof(struct re_dfa));
+	if (d == NULL)
+		return;
+	d->freshset = calloc(4, (size_t)g->nstates);
+	if (d->freshset == NULL) {
+		free(d);
+		return;
+	}
+	d->tmp = d->freshset + g->nstates;
+	d->aft = d->tmp + g->nstates;
+	d->bef = d->aft + g->nstates;
+	d->small = g->nstates <= CHAR_BIT*sizeof(states1);
+	InitSemaphore(&d->lock);
+
+	/* the start set, as in fast() */
+	d->freshset[g->firststate+1] = 1;
+	lstep(g, g->firststate+1, g->laststate, d->freshset, NOTHING,
+								d->freshset);
+
+	d->usectx = g->nbol > 0 || g->neol > 0;
+	d->prefix = -1;
+	for (pc = g->firststate+1; pc < g->laststate; pc++) {
+		s = g->strip[pc];
+		if (OP(s) == OBOW || OP(s) == OEOW)
+			d->usectx = 1;
+	}
+
+	/*
+	 * A match has to start with the first character if the RE starts
+	 * with one, maybe inside parentheses or a +.
+	 */
+	for (pc = g->firststate+1; pc < g->laststate; pc++) {
+		s = g->strip[pc];
+		if (OP(s) == OCHAR) {
+			d->prefix = (uch)OPND(s);
+			break;
+		}
+		if (OP(s) != OLPAREN && OP(s) != ORPAREN && OP(s) != OPLUS_)
+			break;
+	}
+
+	/* characters of the same category and context share a class */
+	for (i = 0; i < NC*NCTX; i++)
+		keyclass[i] = -1;
+	for (i = 0; i < NC; i++) {
+		c = (char)i;
+		ctx = d->usectx ? ctxof(g, c) : CTX_OTHER;
+		key = g->categories[c] * NCTX + ctx;
+		if (keyclass[key] < 0) {
+			keyclass[key] = d->nclasses++;
+			d->classctx[keyclass[key]] = ctx;
+		}
+		d->classes[i] = keyclass[key];
+	}
+
+	d->statesize = sizeof(struct dfastate) +
+		(d->nclasses - 1) * sizeof(int) + (size_t)g->nstates;
+	d->statesize = (d->statesize + sizeof(void *) - 1) &
+						~(sizeof(void *) - 1);
+	if (d->statesize > DFA_MAXMEM / 16) {	/* huge RE, not worth it */
+		__regdfa_free(d);
+		return;
+	}
+
+	g->dfa = d;
+}
+
+/*
+ - __regdfa_free - free the DFA of a compiled RE
+ */
+void
+__regdfa_free(
+    struct re_dfa *d)
+{
+	int i;
+
+	for (i = 0; i < d->nstates; i++)
+		free(d->dstates[i]);
+	free(d->dstates);
+	free(d->freshset);
+	free(d);
+}
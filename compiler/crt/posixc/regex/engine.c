@@ -211,10 +211,13 @@ matcher(
 
 	/* prescreening; this does wonders for this rather slow code */
 	if (g->must != NULL) {
-		for (dp = start; dp < stop; dp++)
-			if (*dp == g->must[0] && stop - dp >= g->mlen &&
-				memcmp(dp, g->must, (size_t)g->mlen) == 0)
+		for (dp = start; dp < stop; dp++) {
+			dp = memchr(dp, g->must[0], (size_t)(stop - dp));
+			if (dp == NULL || stop - dp < g->mlen)
+				return(REG_NOMATCH);	/* no g->must */
+			if (memcmp(dp, g->must, (size_t)g->mlen) == 0)
 				break;
+		}
 		if (dp == stop)		/* we didn't find g->must */
 			return(REG_NOMATCH);
 	}
@@ -234,6 +237,29 @@ matcher(
 	SETUP(m->empty);
 	CLEAR(m->empty);
 
+	/* the DFA does the work of fast() and slow() if it can */
+	i = __regdfa_exec(g, start, stop, eflags, nmatch > 0, &m->coldp, &endp);
+	if (i == REG_NOMATCH) {
+		error = REG_NOMATCH;
+		goto done;
+	}
+	if (i == 0) {
+		if (nmatch > 1) {
+			m->pmatch = (regmatch_t *)malloc((m->g->nsub + 1) *
+							sizeof(regmatch_t));
+			if (m->pmatch == NULL) {
+				error = REG_ESPACE;
+				goto done;
+			}
+			for (i = 1; i <= m->g->nsub; i++)
+				m->pmatch[i].rm_so = m->pmatch[i].rm_eo =
+								(regoff_t)-1;
+			NOTE("dissecting");
+			dp = dissect(m, m->coldp, endp, gf, gl);
+		}
+		goto found;
+	}
+
 	/* this loop does only one repetition except for backrefs */
 	for (;;) {
 		endp = fast(m, start, stop, gf, gl);
@@ -314,6 +340,7 @@ matcher(
 		assert(start <= stop);
 	}
 
+found:
 	/* fill in the details if requested */
 	if (nmatch > 0) {
 		assert(pmatch != NULL);
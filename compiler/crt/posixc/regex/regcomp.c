@@ -295,6 +295,7 @@ regcomp(
 	g->categories = &g->catspace[-(CHAR_MIN)];
 	(void) memset((char *)g->catspace, 0, NC*sizeof(cat_t));
 	g->backrefs = 0;
+	g->dfa = NULL;
 
 	/* do it */
 	EMIT(OEND, 0);
@@ -313,6 +314,8 @@ regcomp(
 	stripsnug(p, g);
 	findmust(p, g);
 	g->nplus = pluscount(p, g);
+	if (p->error == 0)
+		__regdfa_new(g);
 	g->magic = MAGIC2;
 	preg->re_nsub = g->nsub;
 	preg->re_g = g;
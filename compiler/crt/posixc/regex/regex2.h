@@ -200,10 +200,18 @@ struct re_guts {
 	sopno nsub;		/* copy of re_nsub */
 	int backrefs;		/* does it use back references? */
 	sopno nplus;		/* how deep does it nest +s? */
+	struct re_dfa *dfa;	/* lazily built DFA, see dfa.c */
 	/* catspace must be last */
 	cat_t catspace[1];	/* actually [NC] */
 };
 
+/* the DFA, in regexec.c */
+#define	REG_DFAOFF	(-1)	/* __regdfa_exec() can't be used */
+void __regdfa_new(struct re_guts *g);
+void __regdfa_free(struct re_dfa *d);
+int __regdfa_exec(struct re_guts *g, const char *start, const char *stop,
+    int eflags, int findstart, const char **coldpp, const char **endpp);
+
 /* misc utilities */
 #define	OUT	(CHAR_MAX+1)	/* a non-character value */
 #define	ISWORD(c)	(isalnum((unsigned char)c) || (c) == '_')
@@ -101,6 +101,9 @@ __RCSID("$NetBSD: regexec.c,v 1.20 2007/02/09 23:44:18 junyoung Exp $");
 #include <string.h>
 #include <regex.h>
 
+#include <proto/exec.h>
+#include <exec/semaphores.h>
+
 #ifdef __weak_alias
 __weak_alias(regexec,_regexec)
 #endif
@@ -187,6 +190,9 @@ __weak_alias(regexec,_regexec)
 
 #include "engine.c"
 
+/* the DFA uses the large representation of the state sets */
+#include "dfa.c"
+
 /*
  - regexec - interface for matching
  = extern int regexec(const regex_t *, const char *, size_t, \
@@ -128,5 +128,7 @@ regfree(
 		free(g->setbits);
 	if (g->must != NULL)
 		free(g->must);
+	if (g->dfa != NULL)
+		__regdfa_free(g->dfa);
 	free(g);
 }
@@ -7,6 +7,7 @@
 #include <proto/dos.h>
 #include <errno.h>
 #include "__upath.h"
+#include "__dirdesc.h"
 
 extern int __stdcio_remove(const char *);
 
@@ -44,6 +45,9 @@ int remove (
 
 ******************************************************************************/
 {
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     return __stdcio_remove(__path_u2a(pathname));
 } /* remove */
 
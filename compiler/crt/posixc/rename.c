@@ -13,6 +13,7 @@
 #include <errno.h>
 
 #include "__upath.h"
+#include "__dirdesc.h"
 
 extern int __stdcio_rename(const char *, const char *);
 
@@ -67,6 +68,9 @@ int rename (
     CONST_STRPTR anewpath = __path_u2a(newpath);
     int ret;
 
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     /* __path_u2a has resolved paths like /toto/../a */
     if (anewpath[0] == '.')
     {
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 1995-2012, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
 */
 
 #include <dos/dos.h>
@@ -37,21 +37,14 @@
 
 ******************************************************************************/
 {
-    int pos = offset;
     fdesc *desc = __getfdesc(dir->fd);
     if (!desc)
         return;
 
-    if (!Examine(desc->fcb->handle, dir->priv))
-        return;
+    /* Start a new ExAll() scan and skip the entries in front of offset */
+    __dir_rewind(dir, desc->fcb->handle);
+    dir->pos = 0;
 
-    if (offset > 1)
-        for
-        (
-            pos = 2;
-            (pos <= offset) && ExNext(desc->fcb->handle, dir->priv);
-            pos++
-        );
-    dir->pos = pos;
+    while (dir->pos < offset && readdir(dir))
+        ;
 }
-
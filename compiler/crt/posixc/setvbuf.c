@@ -106,6 +106,14 @@
         return EOF;
     }
 
+    /* Only fully buffered streams get a stdio buffer on top of the dos one */
+    __stdio_sync(stream);
+    __stdio_freebuf(stream);
+    if (mode == BUF_FULL)
+        stream->flags &= ~(__POSIXC_STDIO_NOBUF | __POSIXC_STDIO_BUFCHECKED);
+    else
+        stream->flags |= __POSIXC_STDIO_NOBUF | __POSIXC_STDIO_BUFCHECKED;
+
     return SetVBuf(desc->fcb->handle, buf, mode, size ? size : -1);
 } /* setvbuf */
 
@@ -89,6 +89,10 @@
     path = __path_u2a(path);
     if (path == NULL)
         return -1;
+
+    /* An entry readdir() has just returned */
+    if (__stat_from_dircache(path, sb, FALSE) == 0)
+        return 0;
         
     lock = Lock(path, SHARED_LOCK);
     if (!lock)
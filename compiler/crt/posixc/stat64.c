@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 2020-2025, The AROS Development Team. All rights reserved.
 */
 
 #include <dos/dos.h>
@@ -89,6 +89,10 @@
     path = __path_u2a(path);
     if (path == NULL)
         return -1;
+
+    /* An entry readdir() has just returned */
+    if (__stat64_from_dircache(path, sb, FALSE) == 0)
+        return 0;
         
     lock = Lock(path, SHARED_LOCK);
     if (!lock)
@@ -65,6 +65,20 @@
     if (c < -1)
         c = (unsigned int)c;
 
+    /* Input read with fgetc() is pushed back into the buffer, which keeps
+       room for one character */
+    if (stream->rpos > stream->buf && c != EOF)
+    {
+        *--stream->rpos = (unsigned char)c;
+        stream->flags &= ~__POSIXC_STDIO_EOF;
+        return (unsigned char)c;
+    }
+    if (stream->rpos)
+        return EOF;
+
+    if (stream->wpos && __stdio_sync(stream) == EOF)
+        return EOF;
+
     if (!UnGetC (fdesc->fcb->handle, c))
     {
         errno = __stdc_ioerr2errno (IoErr ());
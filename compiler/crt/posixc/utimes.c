@@ -10,6 +10,7 @@
 #include <errno.h>
 
 #include "__upath.h"
+#include "__dirdesc.h"
 
 /*****************************************************************************
 
@@ -56,6 +57,9 @@
 {
     struct DateStamp ds;
 
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     if (!file) /*safety check */
     {
         errno = EFAULT;
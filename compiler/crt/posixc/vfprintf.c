@@ -12,8 +12,6 @@
 #include "__fdesc.h"
 #include "__stdio.h"
 
-static int __putc(int c, void *fh);
-
 /*****************************************************************************
 
     NAME */
@@ -63,10 +61,9 @@ static int __putc(int c, void *fh);
 
     INTERNALS
         - Retrieves the file descriptor wrapper via `__getfdesc()`.
-        - Uses an AROS-specific `__vcformat()` function with `__putc()` as a
-          character output callback.
-        - `__putc()` uses `FPutC()` on the AROS file handle, converting AROS I/O
-          errors via `__stdc_ioerr2errno()`.
+        - Uses an AROS-specific `__vcformat()` function with `fputc()` as a
+          character output callback, so the output goes to the stdio buffer
+          of the stream.
 
 ******************************************************************************/
 {
@@ -78,18 +75,5 @@ static int __putc(int c, void *fh);
         return 0;
     }
 
-    return __vcformat ((void *)BADDR(fdesc->fcb->handle), __putc, format, args);
+    return __vcformat (stream, (int (*)(int, void *))fputc, format, args);
 } /* vfprintf */
-
-
-static int __putc(int c, void *fhp)
-{
-    BPTR fh = MKBADDR(fhp);
-    if (FPutC(fh, c) == EOF)
-    {
-        errno = __stdc_ioerr2errno(IoErr());
-        return EOF;
-    }
-
-    return c;
-}
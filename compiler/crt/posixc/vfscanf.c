@@ -15,10 +15,11 @@
 /*
 ** If the VFSCANF_DIRECT_DOS define is set to 1, dos.library functions FGetC()
 ** and UnGetC() are used directly, for possibly better speed. Otherwise
-** the clib functions fgetc/ungetc are used.
+** the clib functions fgetc/ungetc are used. These read from the stdio
+** buffer of the stream, which the dos.library functions can't see.
 */
  
-#define VFSCANF_DIRECT_DOS 1
+#define VFSCANF_DIRECT_DOS 0
 
 #if VFSCANF_DIRECT_DOS
 
@@ -126,9 +127,11 @@ static int __ungetc(int c, void *_h);
         return 0;
     }
 
+    if (stream->wpos)
+        __stdio_sync(stream);
     Flush (fdesc->fcb->handle);
     
-    return __vcscan (stream,  __posixc_fgetc, ungetc, format, args);
+    return __vcscan (stream, (int (*)(void *))fgetc, (int (*)(int, void *))ungetc, format, args);
        
 #endif
 } /* vfscanf */
@@ -10,6 +10,7 @@
 #include <proto/exec.h>
 #include <proto/dos.h>
 #include "__fdesc.h"
+#include "__dirdesc.h"
 
 /*****************************************************************************
 
@@ -48,6 +49,9 @@
 {
     ssize_t cnt;
 
+    /* Cached directory entries may change */
+    __dir_dropcache();
+
     fdesc *fdesc = __getfdesc(fd);
     if (!fdesc)
     {
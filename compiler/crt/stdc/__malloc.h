@@ -0,0 +1,147 @@
+#ifndef ___MALLOC_H
+#define ___MALLOC_H
+
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Internal definitions for the malloc() family.
+
+    Every block starts with a size_t header holding the size asked for,
+    the caller gets the memory right after it. Blocks up to
+    MALLOC_MAXBLOCK bytes including the header are rounded up to one of
+    MALLOC_CLASSES size classes: 16 byte steps up to 128 bytes, then
+    four steps per power of two. They are carved from MALLOC_SLABSIZE
+    slabs allocated from StdCBase->mempool and never go back to the pool
+    before the library is closed; freed blocks are kept on free lists.
+
+    Each task has its own cache of free blocks for every class so the
+    common malloc()/free() does not take any lock. A cache that runs
+    empty takes a batch of blocks from the central lists, one that grows
+    beyond its limit gives half of them back.
+
+    Larger blocks are allocated with AllocMem() and kept on a list so
+    they can be freed when the library is closed.
+*/
+
+#include <exec/lists.h>
+#include <exec/semaphores.h>
+#include <exec/tasks.h>
+#include <aros/cpu.h>
+#include <proto/exec.h>
+
+#include "__stdc_intbase.h"
+
+#define MALLOC_HDRSIZE      AROS_ALIGN(sizeof(size_t))
+#define MALLOC_MAXBLOCK     16384
+#define MALLOC_MAXSMALL     (MALLOC_MAXBLOCK - MALLOC_HDRSIZE)
+#define MALLOC_CLASSES      36
+#define MALLOC_SLABSIZE     32768
+
+/* Bytes of free blocks of one class a task cache holds at most */
+#define MALLOC_CACHEBYTES   16384
+#define MALLOC_CACHEMAX     64
+
+#define MALLOC_CACHEHASH    32
+
+struct __malloc_cache
+{
+    struct __malloc_cache   *mc_Next;
+    struct Task             *mc_Task;
+    void                    *mc_Free[MALLOC_CLASSES];
+    UWORD                   mc_Count[MALLOC_CLASSES];
+
+    /* Statistics, only updated by the owner */
+    unsigned long           mc_Mallocs;
+    unsigned long           mc_Frees;
+    unsigned long           mc_Hits;
+    unsigned long           mc_Refills;
+    unsigned long           mc_Flushes;
+    size_t                  mc_Allocated;
+    size_t                  mc_Released;
+};
+
+struct __malloc_state
+{
+    struct SignalSemaphore  ms_Lock;        /* Protects all but the caches */
+    APTR                    ms_Pool;
+    struct __malloc_cache   *ms_Caches[MALLOC_CACHEHASH];
+    void                    *ms_Free[MALLOC_CLASSES];
+    ULONG                   ms_FreeCount[MALLOC_CLASSES];
+    struct MinList          ms_Large;
+    size_t                  ms_SlabBytes;
+    size_t                  ms_LargeBytes;
+    ULONG                   ms_LargeBlocks;
+    ULONG                   ms_Threads;
+
+    /* Frees of tasks that could not get a cache */
+    unsigned long           ms_Frees;
+    size_t                  ms_Released;
+};
+
+struct __malloc_large
+{
+    struct MinNode          ml_Node;
+    size_t                  ml_Size;        /* As passed to AllocMem() */
+};
+
+#define MALLOC_LARGEHDRSIZE (AROS_ALIGN(sizeof(struct __malloc_large)) + MALLOC_HDRSIZE)
+
+/* Size class of a block of the given size, header included */
+static inline int __malloc_class(size_t block)
+{
+    unsigned int k;
+
+    if (block <= 128)
+        return block ? (block - 1) >> 4 : 0;
+
+    k = 31 - __builtin_clz((unsigned int)(block - 1));
+
+    return 8 + ((k - 7) << 2) + (((block - 1) >> (k - 2)) & 3);
+}
+
+/* Size of the blocks of a class */
+static inline size_t __malloc_classsize(int cls)
+{
+    if (cls < 8)
+        return (cls + 1) << 4;
+
+    return (size_t)(5 + ((cls - 8) & 3)) << (7 + ((cls - 8) >> 2) - 2);
+}
+
+/* How many free blocks of a class a task cache may hold */
+static inline UWORD __malloc_cachelimit(int cls)
+{
+    size_t n = MALLOC_CACHEBYTES / __malloc_classsize(cls);
+
+    if (n < 2)
+        n = 2;
+    else if (n > MALLOC_CACHEMAX)
+        n = MALLOC_CACHEMAX;
+
+    return n;
+}
+
+struct __malloc_cache *__malloc_newcache(struct __malloc_state *ms, struct Task *task);
+void *__malloc_refill(struct __malloc_state *ms, struct __malloc_cache *mc, int cls);
+void __malloc_flush(struct __malloc_state *ms, struct __malloc_cache *mc, int cls);
+void __malloc_release(struct __malloc_state *ms, void *block, int cls);
+void *__malloc_large(struct __malloc_state *ms, size_t size);
+void __malloc_freelarge(struct __malloc_state *ms, void *mem);
+
+/* The calling task's cache, created on first use */
+static inline struct __malloc_cache *__malloc_getcache(struct __malloc_state *ms)
+{
+    struct Task *task = FindTask(NULL);
+    struct __malloc_cache *mc;
+
+    /* Caches are only ever added at the head, so no lock is needed */
+    for (mc = ms->ms_Caches[((IPTR)task >> 4) & (MALLOC_CACHEHASH - 1)]; mc; mc = mc->mc_Next)
+    {
+        if (mc->mc_Task == task)
+            return mc;
+    }
+
+    return __malloc_newcache(ms, task);
+}
+
+#endif /* ___MALLOC_H */
@@ -24,6 +24,7 @@
 
 /* Some structs that are defined privately */
 struct signal_func_data;
+struct __malloc_state;
 
 struct StdCIntBase
 {
@@ -42,6 +43,7 @@ struct StdCIntBase
 
     /* stdlib.h */
     APTR                        mempool;
+    struct __malloc_state       *mallocstate;
     unsigned int                srand_seed;
 
     /* time.h and it's functions */
@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Internal stdc function to get malloc() statistics
+*/
+
+#include <proto/exec.h>
+
+#include <string.h>
+
+#include "__stdc_intbase.h"
+#include "__malloc.h"
+
+/*****************************************************************************
+
+    NAME */
+#include <libraries/stdc.h>
+
+        void __stdc_malloc_getstats (
+
+/*  SYNOPSIS */
+        struct __stdc_mallocstats *stats)
+
+/*  FUNCTION
+        Get the state of the memory managed by malloc() and friends.
+
+    INPUTS
+        stats - Filled in with the statistics.
+
+    RESULT
+
+    NOTES
+        The caches of other tasks are read without stopping them, so the
+        numbers may be slightly off while they allocate memory.
+
+    EXAMPLE
+
+    BUGS
+
+    SEE ALSO
+        malloc_stats()
+
+    INTERNALS
+
+******************************************************************************/
+{
+    struct StdCIntBase *StdCBase =
+        (struct StdCIntBase *)__aros_getbase_StdCBase();
+    struct __malloc_state *ms = StdCBase->mallocstate;
+    struct __malloc_cache *mc;
+    size_t allocated = 0, released;
+    int i, cls;
+
+    memset(stats, 0, sizeof(struct __stdc_mallocstats));
+
+    ObtainSemaphoreShared(&ms->ms_Lock);
+
+    stats->ms_SlabBytes = ms->ms_SlabBytes;
+    stats->ms_LargeBytes = ms->ms_LargeBytes;
+    stats->ms_LargeBlocks = ms->ms_LargeBlocks;
+    stats->ms_Threads = ms->ms_Threads;
+    stats->ms_Frees = ms->ms_Frees;
+    released = ms->ms_Released;
+
+    for (i = 0; i < MALLOC_CACHEHASH; i++)
+    {
+        for (mc = ms->ms_Caches[i]; mc; mc = mc->mc_Next)
+        {
+            stats->ms_Mallocs += mc->mc_Mallocs;
+            stats->ms_Frees += mc->mc_Frees;
+            stats->ms_CacheHits += mc->mc_Hits;
+            stats->ms_Refills += mc->mc_Refills;
+            stats->ms_Flushes += mc->mc_Flushes;
+            allocated += mc->mc_Allocated;
+            released += mc->mc_Released;
+
+            for (cls = 0; cls < MALLOC_CLASSES; cls++)
+                stats->ms_CachedBytes += mc->mc_Count[cls] * __malloc_classsize(cls);
+        }
+    }
+
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    /* Blocks may be freed by another task than the one that allocated them */
+    stats->ms_InUseBytes = allocated - released;
+}
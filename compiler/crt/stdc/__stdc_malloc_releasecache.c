@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Internal stdc function to give back the malloc() cache of a task
+*/
+
+#include <proto/exec.h>
+
+#include "__stdc_intbase.h"
+#include "__malloc.h"
+
+/*****************************************************************************
+
+    NAME */
+#include <libraries/stdc.h>
+
+        void __stdc_malloc_releasecache (
+
+/*  SYNOPSIS */
+        void)
+
+/*  FUNCTION
+        Give the free blocks cached for the calling task back to the
+        central free lists, and make its cache available to other tasks.
+
+    INPUTS
+
+    RESULT
+
+    NOTES
+        To be called by a task that shares the library base with others,
+        like a thread, just before it exits. The cache would otherwise
+        stay around with its blocks until the library is closed.
+        Calling malloc() or free() afterwards gives the task a new cache.
+
+    EXAMPLE
+
+    BUGS
+
+    SEE ALSO
+        malloc(), free()
+
+    INTERNALS
+        The cache is not unlinked as other tasks look for their own cache
+        without taking the lock. It is marked as unused and handed to the
+        next task whose address hashes to the same chain.
+
+******************************************************************************/
+{
+    struct StdCIntBase *StdCBase =
+        (struct StdCIntBase *)__aros_getbase_StdCBase();
+    struct __malloc_state *ms = StdCBase->mallocstate;
+    struct Task *task = FindTask(NULL);
+    struct __malloc_cache *mc;
+    void **last;
+    int cls;
+
+    if (!ms)
+        return;
+
+    for (mc = ms->ms_Caches[((IPTR)task >> 4) & (MALLOC_CACHEHASH - 1)]; mc; mc = mc->mc_Next)
+    {
+        if (mc->mc_Task == task)
+            break;
+    }
+    if (!mc)
+        return;
+
+    ObtainSemaphore(&ms->ms_Lock);
+
+    for (cls = 0; cls < MALLOC_CLASSES; cls++)
+    {
+        if (!mc->mc_Free[cls])
+            continue;
+
+        for (last = mc->mc_Free[cls]; *last; last = *last)
+            ;
+        *last = ms->ms_Free[cls];
+        ms->ms_Free[cls] = mc->mc_Free[cls];
+        ms->ms_FreeCount[cls] += mc->mc_Count[cls];
+
+        mc->mc_Free[cls] = NULL;
+        mc->mc_Count[cls] = 0;
+    }
+
+    /* The statistics stay, they still count for the totals */
+    mc->mc_Task = NULL;
+    ms->ms_Threads--;
+
+    ReleaseSemaphore(&ms->ms_Lock);
+}
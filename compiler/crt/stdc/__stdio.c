@@ -7,9 +7,11 @@
 #include <aros/symbolsets.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <proto/alib.h>
 #include <proto/exec.h>
 #include <proto/dos.h>
+#include <dos/dosextens.h>
 
 #include "__stdio.h"
 #include "__stdcio_intbase.h"
@@ -59,6 +61,9 @@ static int __init_stdio(struct StdCIOIntBase *StdCIOBase)
     D(bug("[%s] %s: intstderr.fh = 0x%p\n", STDCNAME, __func__, StdCIOBase->intstderr.fh));
     StdCIOBase->StdCIOBase._stderr = &StdCIOBase->intstderr;
 
+    /* stderr is never buffered by stdio */
+    StdCIOBase->intstderr.flags |= __STDCIO_STDIO_NOBUF | __STDCIO_STDIO_BUFCHECKED;
+
     return 1;
 }
 
@@ -70,6 +75,9 @@ static int __close_stdio(struct StdCIOIntBase *StdCIOBase)
 
     D(bug("[%s] %s: StdCIOBase = 0x%p, DOSBase = 0x%p\n", STDCNAME, __func__, StdCIOBase, DOSBase));
 
+    __stdcio_sync(StdCIOBase->StdCIOBase._stdout);
+    __stdcio_sync(StdCIOBase->StdCIOBase._stderr);
+
     if (StdCIOBase->intstdout.fh)
     {
         _fh = BADDR(StdCIOBase->intstdout.fh);
@@ -95,5 +103,196 @@ static int __close_stdio(struct StdCIOIntBase *StdCIOBase)
     return 1;
 }
 
+/*
+    The stdio buffer
+
+    fgetc() and fputc() move the characters through a buffer of the
+    stream, so getc() and putc() in <stdio.h> can work on it without a
+    function call. The buffer is either reading, rpos to rend is the input
+    that was read ahead, or writing, buf to wpos is the output that has
+    not been written yet. The other functions either use it directly or
+    call __stdcio_sync() first, which leaves the file at the position the
+    user of the stream sees.
+
+    Interactive streams are left to the line based buffering of
+    dos.library. Input is taken with FRead(), so what dos.library has
+    buffered for the handle, like injected arguments, is still read first.
+*/
+
+static BOOL __stdcio_getbuf(FILE *stream)
+{
+    struct StdCIOIntBase *StdCIOBase =
+        (struct StdCIOIntBase *)__aros_getbase_StdCIOBase();
+
+    if (stream->buf)
+        return TRUE;
+
+    if (!(stream->flags & __STDCIO_STDIO_BUFCHECKED))
+    {
+        stream->flags |= __STDCIO_STDIO_BUFCHECKED;
+        if (IsInteractive(stream->fh))
+            stream->flags |= __STDCIO_STDIO_NOBUF;
+    }
+
+    if (stream->flags & __STDCIO_STDIO_NOBUF)
+        return FALSE;
+
+    if (!StdCIOBase->streampool)
+        StdCIOBase->streampool = CreatePool(MEMF_ANY, 20*sizeof(FILE), 2*sizeof(FILE));
+    if (StdCIOBase->streampool)
+        stream->buf = AllocPooled(StdCIOBase->streampool, __STDCIO_BUFSIZE);
+
+    if (!stream->buf)
+    {
+        stream->flags |= __STDCIO_STDIO_NOBUF;
+        return FALSE;
+    }
+
+    D(bug("[%s] %s: stream 0x%p, buf @ 0x%p\n", STDCNAME, __func__, stream, stream->buf));
+
+    return TRUE;
+}
+
+/*
+    Reads up to len bytes without waiting for more input than the next
+    read returns: FRead() would keep reading until it has all of them,
+    which blocks line oriented readers of pipes. One byte is fetched
+    through dos.library, which fills its buffer with a single Read(),
+    and whatever that left in the buffer is taken as well.
+*/
+static LONG __stdcio_readbuffered(BPTR fh, unsigned char *buf, LONG len)
+{
+    struct FileHandle *fhp = BADDR(fh);
+    LONG cnt, avail;
+
+    cnt = FRead(fh, buf, 1, 1);
+    if (cnt == 1)
+    {
+        avail = fhp->fh_End - fhp->fh_Pos;
+        if (avail > len - 1)
+            avail = len - 1;
+        if (avail > 0)
+            cnt += FRead(fh, buf + 1, 1, avail);
+    }
+
+    return cnt;
+}
+
+/* Refills the buffer and returns its first character, EOF or __STDCIO_NOBUF */
+int __stdcio_fill(FILE *stream)
+{
+    LONG cnt, ioerr;
+
+    if (stream->wpos && __stdcio_sync(stream) == EOF)
+        return EOF;
+
+    if (!__stdcio_getbuf(stream))
+        return __STDCIO_NOBUF;
+
+    /* The first byte is kept free for ungetc() */
+    cnt = __stdcio_readbuffered(stream->fh, stream->buf + 1, __STDCIO_BUFSIZE - 1);
+
+    stream->rpos = stream->buf + 1;
+    stream->rend = stream->rpos + (cnt > 0 ? cnt : 0);
+
+    if (cnt <= 0)
+    {
+        ioerr = IoErr();
+
+        if (cnt < 0 && ioerr)
+        {
+            errno = __stdc_ioerr2errno(ioerr);
+            stream->flags |= __STDCIO_STDIO_ERROR;
+        }
+        else
+            stream->flags |= __STDCIO_STDIO_EOF;
+
+        return EOF;
+    }
+
+    return *stream->rpos++;
+}
+
+/* Makes the buffer ready for output, returns 1, 0 if the stream has no
+   buffer or EOF on error */
+int __stdcio_wbuf(FILE *stream)
+{
+    if (__stdcio_sync(stream) == EOF)
+        return EOF;
+
+    if (!__stdcio_getbuf(stream))
+        return 0;
+
+    stream->wpos = stream->buf;
+    stream->wend = stream->buf + __STDCIO_BUFSIZE;
+
+    return 1;
+}
+
+/* Writes the buffered output or gives back the input that was read ahead */
+int __stdcio_sync(FILE *stream)
+{
+    unsigned char *rpos;
+    LONG cnt, done, len;
+
+    if (stream->wpos)
+    {
+        cnt = stream->wpos - stream->buf;
+        stream->wpos = stream->wend = NULL;
+
+        if (cnt > 0)
+        {
+            /* Output written with dos.library calls goes first */
+            if (!Flush(stream->fh))
+                goto error;
+
+            if ((stream->flags & __STDCIO_STDIO_APPEND))
+                Seek(stream->fh, 0, OFFSET_END);
+
+            for (done = 0; done < cnt; done += len)
+            {
+                len = Write(stream->fh, stream->buf + done, cnt - done);
+                if (len <= 0)
+                    goto error;
+            }
+        }
+    }
+    else if (stream->rpos)
+    {
+        rpos = stream->rpos;
+        cnt = stream->rend - rpos;
+        stream->rpos = stream->rend = NULL;
+
+        if (cnt > 0 && Seek(stream->fh, -cnt, OFFSET_CURRENT) < 0)
+        {
+            /* Not seekable, keep the input for the reading functions */
+            stream->rpos = rpos;
+            stream->rend = rpos + cnt;
+            errno = __stdc_ioerr2errno(IoErr());
+            return EOF;
+        }
+    }
+
+    return 0;
+
+error:
+    errno = __stdc_ioerr2errno(IoErr());
+    stream->flags |= __STDCIO_STDIO_ERROR;
+    return EOF;
+}
+
+void __stdcio_freebuf(FILE *stream)
+{
+    struct StdCIOIntBase *StdCIOBase =
+        (struct StdCIOIntBase *)__aros_getbase_StdCIOBase();
+
+    if (stream->buf)
+        FreePooled(StdCIOBase->streampool, stream->buf, __STDCIO_BUFSIZE);
+
+    stream->buf = NULL;
+    stream->rpos = stream->rend = NULL;
+    stream->wpos = stream->wend = NULL;
+}
+
 ADD2OPENLIB(__init_stdio, 0)
 ADD2CLOSELIB(__close_stdio, 0)
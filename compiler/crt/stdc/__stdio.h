@@ -9,6 +9,7 @@
     Lang: English
 */
 
+#include <stdio.h>
 #include <dos/dos.h>
 #include <aros/types/file_s.h>
 
@@ -24,6 +25,19 @@
 #define __STDCIO_STDIO_FLUSHONREAD  0x0100L
 #define __STDCIO_STDIO_WIDE         0x0200L   /* Stream is wide-oriented */
 #define __STDCIO_STDIO_UNGETWC      0x0400L   /* ungetwc_char contains a pushed-back wide char */
+#define __STDCIO_STDIO_NOBUF        0x0800L   /* Not buffered by stdio, see __stdio.c */
+#define __STDCIO_STDIO_BUFCHECKED   0x1000L   /* __STDCIO_STDIO_NOBUF has been decided */
+
+/* Size of the stdio buffer of a stream */
+#define __STDCIO_BUFSIZE            4096
+
+/* __stdcio_fill() result for streams without a stdio buffer */
+#define __STDCIO_NOBUF              (-2)
+
+int __stdcio_fill(FILE *stream);
+int __stdcio_wbuf(FILE *stream);
+int __stdcio_sync(FILE *stream);
+void __stdcio_freebuf(FILE *stream);
 
 #endif /* ___STDIO_H */
 
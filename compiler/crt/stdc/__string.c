@@ -0,0 +1,43 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Selection of the string function implementations.
+*/
+
+#include <aros/symbolsets.h>
+
+#include "__string.h"
+
+#if defined(__STRING_AVX2)
+
+int __string_avx2 = 0;
+
+static int __string_init(struct Library *StdCBase)
+{
+    ULONG eax, ebx, ecx, edx;
+    ULONG xcr0, xcr0hi;
+
+    __asm__ volatile ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(0));
+    if (eax < 7)
+        return 1;
+
+    /* AVX and XSAVE enabled by the kernel (OSXSAVE) */
+    __asm__ volatile ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1));
+    if ((ecx & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28)))
+        return 1;
+
+    /* ... and the YMM registers are saved on task switches */
+    __asm__ volatile ("xgetbv" : "=a"(xcr0), "=d"(xcr0hi) : "c"(0));
+    if ((xcr0 & 6) != 6)
+        return 1;
+
+    __asm__ volatile ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(7), "c"(0));
+    if (ebx & (1 << 5))
+        __string_avx2 = 1;
+
+    return 1;
+}
+
+ADD2INITLIB(__string_init, 0);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef ___STRING_H
+#define ___STRING_H
+
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Internal helpers for the string and memory functions.
+
+    The generic versions work a machine word at a time. A word is only
+    ever read from an address aligned to its size, so it never crosses
+    a page boundary and reading past the end of a string can not fault.
+    The same holds for the SSE2, AVX2 and NEON loops: they align the
+    pointer down to the vector size and mask off the bytes in front of
+    the start.
+
+    SSE2 and NEON are used when the compiler targets them. AVX2 is
+    only used by stdc.library, which checks for it when it is
+    initialised, see __string.c.
+*/
+
+#include <exec/types.h>
+#include <limits.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define __STRING_NEON
+#endif
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(STDC_STATIC) \
+    && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#include <immintrin.h>
+#define __STRING_AVX2
+#define __STRING_AVX2_FUNC __attribute__((target("avx2")))
+#endif
+
+/* Words are read from char arrays, so they may alias anything */
+typedef IPTR __attribute__((__may_alias__)) __strword;
+
+#define __STRWORD_SIZE  sizeof(__strword)
+#define __STRWORD_MASK  (__STRWORD_SIZE - 1)
+#define __STRWORD_ONES  ((__strword)-1 / UCHAR_MAX)
+#define __STRWORD_HIGHS (__STRWORD_ONES * (UCHAR_MAX / 2 + 1))
+
+/* Non zero if one of the bytes in x is 0 */
+#define __STRWORD_HASZERO(x) (((x) - __STRWORD_ONES) & ~(x) & __STRWORD_HIGHS)
+
+/* Smallest MMU page of the CPUs with vector units, for unaligned loads */
+#define __STRING_PAGESIZE 4096
+
+/* Non zero if an unaligned load of size bytes at p may cross a page */
+#define __STRING_PAGECROSS(p, size) \
+    (((IPTR)(p) & (__STRING_PAGESIZE - 1)) > __STRING_PAGESIZE - (size))
+
+/* The byte c in every byte of a word */
+static inline __strword __strword_splat(int c)
+{
+    return __STRWORD_ONES * (unsigned char)c;
+}
+
+#if defined(__SSE2__)
+/* One bit per byte of the 16 byte block at p equal to c, p is aligned */
+static inline unsigned int __sse2_match(const void *p, __m128i c)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)p), c));
+}
+#endif
+
+#if defined(__STRING_NEON)
+/* Non zero if one of the bytes of v is set */
+static inline int __neon_any(uint8x16_t v)
+{
+#if defined(__aarch64__)
+    return vmaxvq_u8(v) != 0;
+#else
+    uint8x8_t r = vorr_u8(vget_low_u8(v), vget_high_u8(v));
+
+    r = vpmax_u8(r, r);
+    return vget_lane_u32(vreinterpret_u32_u8(r), 0) != 0;
+#endif
+}
+#endif
+
+#if defined(__STRING_AVX2)
+/* Set at library init when the CPU and the kernel support AVX2 */
+extern int __string_avx2;
+#endif
+
+#endif /* ___STRING_H */
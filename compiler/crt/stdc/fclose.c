@@ -70,13 +70,17 @@
         }
     }
 
+    /* Input read ahead from a stream that can't seek back is dropped */
+    if (__stdcio_sync(stream) == EOF && !stream->rpos)
+        ret = EOF;
+    __stdcio_freebuf(stream);
+
     if (!(stream->flags & __STDCIO_STDIO_DONTCLOSE))
     {
         BOOL closed = Close(stream->fh);
         if (closed)
         {
             D(bug("[%s] %s: closed succesfully\n", STDCNAME, __func__));
-            ret = 0;
         }
         else
         {
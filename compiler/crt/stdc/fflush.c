@@ -56,9 +56,17 @@
             if (fflush(f) == EOF)
                 return EOF;
         }
+
+        /* The standard streams are not in the list */
+        if (__stdcio_sync(StdCIOBase->StdCIOBase._stdout) == EOF)
+            return EOF;
     }
     else
     {
+        /* Input read ahead from a stream that can't seek back stays buffered */
+        if (__stdcio_sync(stream) == EOF && !stream->rpos)
+            return EOF;
+
         if (!Flush(stream->fh))
         {
             errno = __stdc_ioerr2errno(IoErr());
@@ -47,6 +47,9 @@
 {
     LONG c, ioerr;
 
+    if (stream->rpos < stream->rend)
+        return *stream->rpos++;
+
     if (!(stream->flags & __STDCIO_STDIO_READ))
     {
         SetIoErr(ERROR_READ_PROTECTED);
@@ -61,6 +64,10 @@
         stream->flags &= ~__STDCIO_STDIO_FLUSHONREAD;
     }
 
+    c = __stdcio_fill(stream);
+    if (c != __STDCIO_NOBUF)
+        return (int)c;
+
     c = FGetC (stream->fh);
     if (c == EOF)
     {
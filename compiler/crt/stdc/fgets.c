@@ -5,6 +5,7 @@
 */
 #include <proto/dos.h>
 #include <errno.h>
+#include <string.h>
 
 #include "__stdio.h"
 
@@ -56,6 +57,8 @@
 
 ******************************************************************************/
 {
+    char *s = buffer;
+
     if (!(stream->flags & __STDCIO_STDIO_READ))
     {
         SetIoErr(ERROR_READ_PROTECTED);
@@ -64,7 +67,44 @@
         return NULL;
     }
 
-    buffer = FGets (stream->fh, buffer, size);
+    if (stream->wpos && __stdcio_sync(stream) == EOF)
+        return NULL;
+
+    /* Input fgetc() has read ahead comes first */
+    if (stream->rpos < stream->rend && size > 1)
+    {
+        unsigned char *nl;
+        int len = stream->rend - stream->rpos;
+
+        if (len > size - 1)
+            len = size - 1;
+        if ((nl = memchr(stream->rpos, '\n', len)))
+            len = nl - stream->rpos + 1;
+
+        memcpy(s, stream->rpos, len);
+        stream->rpos += len;
+        s += len;
+        size -= len;
+
+        if (nl || size == 1)
+        {
+            *s = '\0';
+            return buffer;
+        }
+    }
+
+    if (!FGets (stream->fh, s, size))
+    {
+        /* Return the part of the line from the buffer */
+        if (s != buffer)
+        {
+            *s = '\0';
+            if (!IoErr())
+                stream->flags |= __STDCIO_STDIO_EOF;
+            return buffer;
+        }
+        buffer = NULL;
+    }
 
     if (!buffer)
     {
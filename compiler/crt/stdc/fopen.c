@@ -112,6 +112,8 @@
         goto error;
     }
     file->fh = (BPTR)NULL;
+    file->buf = file->rpos = file->rend = NULL;
+    file->wpos = file->wend = NULL;
 
     switch(mode[0])
     {
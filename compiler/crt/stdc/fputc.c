@@ -42,6 +42,11 @@
 
 ******************************************************************************/
 {
+    int res;
+
+    if (stream->wpos < stream->wend)
+        return *stream->wpos++ = (unsigned char)c;
+
     if (!(stream->flags & __STDCIO_STDIO_WRITE))
     {
         SetIoErr(ERROR_WRITE_PROTECTED);
@@ -50,6 +55,12 @@
         return EOF;
     }
 
+    res = __stdcio_wbuf(stream);
+    if (res == EOF)
+        return EOF;
+    if (res)
+        return *stream->wpos++ = (unsigned char)c;
+
     if ((stream->flags & __STDCIO_STDIO_APPEND))
         Seek(stream->fh, 0, OFFSET_END);
 
@@ -5,6 +5,7 @@
 */
 #include <proto/dos.h>
 #include <errno.h>
+#include <string.h>
 
 #include "__stdio.h"
 
@@ -50,11 +51,27 @@
         return EOF;
     }
 
+    if (!str) str = "(null)";
+
+    /* Short strings go to the buffer fputc() writes to */
+    if (stream->wpos)
+    {
+        size_t len = strlen(str);
+
+        if (len <= stream->wend - stream->wpos)
+        {
+            memcpy(stream->wpos, str, len);
+            stream->wpos += len;
+            return 0;
+        }
+    }
+
+    if (__stdcio_sync(stream) == EOF)
+        return EOF;
+
     if ((stream->flags & __STDCIO_STDIO_APPEND))
         Seek(stream->fh, 0, OFFSET_END);
 
-    if (!str) str = "(null)";
-
     if (FPuts(stream->fh, str) == -1)
     {
         errno = __stdc_ioerr2errno(IoErr());
@@ -69,9 +69,6 @@
         return WEOF;
     }
 
-    if ((stream->flags & __STDCIO_STDIO_APPEND))
-        Seek(stream->fh, 0, OFFSET_END);
-
     mb = AllocVec(StdCBase->__locale_cur->__lc_mb_max, MEMF_ANY);
     len = wcrtomb(mb, wc, &stream->mbs);
     if (len < 0)
@@ -82,12 +79,11 @@
         return WEOF;
     }
 
+    /* fputc() takes care of appending, the stream buffer and the error flag */
     for (int i = 0; i < len; ++i)
     {
-        if (FPutC(stream->fh, (UBYTE)mb[i]) == EOF)
+        if (fputc((UBYTE)mb[i], stream) == EOF)
         {
-            errno = __stdc_ioerr2errno(IoErr());
-            stream->flags |= __STDCIO_STDIO_ERROR;
             FreeVec(mb);
             return WEOF;
         }
@@ -5,6 +5,7 @@
 */
 #include <proto/dos.h>
 #include <errno.h>
+#include <string.h>
 
 #include "__stdio.h"
 
@@ -48,7 +49,7 @@
 
 ******************************************************************************/
 {
-    LONG cnt;
+    LONG cnt, len;
 
     if (size == 0 || nblocks == 0)
         return 0;
@@ -61,7 +62,28 @@
         return 0;
     }
 
-    cnt = FRead (stream->fh, buf, size, nblocks);
+    if (stream->wpos && __stdcio_sync(stream) == EOF)
+        return 0;
+
+    /* Input fgetc() has read ahead comes first, the rest is read as
+       bytes as a block may start in the buffer */
+    if (stream->rpos < stream->rend)
+    {
+        len = stream->rend - stream->rpos;
+        if (len > size * nblocks)
+            len = size * nblocks;
+
+        memcpy(buf, stream->rpos, len);
+        stream->rpos += len;
+
+        cnt = (len < size * nblocks)
+            ? FRead (stream->fh, (UBYTE *)buf + len, 1, size * nblocks - len)
+            : 0;
+        if (cnt != -1)
+            cnt = (len + cnt) / size;
+    }
+    else
+        cnt = FRead (stream->fh, buf, size, nblocks);
 
     if (cnt == -1)
     {
@@ -1,11 +1,12 @@
 /*
-    Copyright (C) 1995-2024, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
 
     C99 function free().
 */
 
 #include "__stdc_intbase.h"
 #include "__memalign.h"
+#include "__malloc.h"
 
 #include <exec/memory.h>
 #include <proto/exec.h>
@@ -47,22 +48,40 @@
     if (memory)
     {
         struct StdCIntBase *StdCBase = (struct StdCIntBase *)__aros_getbase_StdCBase();
+        struct __malloc_state *ms = StdCBase->mallocstate;
+        struct __malloc_cache *mc;
 
         unsigned char *mem;
         size_t         size;
+        int            cls;
 
-        mem = ((UBYTE *)memory) - AROS_ALIGN(sizeof(size_t));
+        mem = ((UBYTE *)memory) - MALLOC_HDRSIZE;
 
         size = *((size_t *) mem);
         if (size == MEMALIGN_MAGIC) {
             mem -= AROS_ALIGN(sizeof(void *));
             free(((void **) mem)[0]);
         }
+        else if (size > MALLOC_MAXSMALL) {
+            __malloc_freelarge(ms, memory);
+        }
         else {
-            size += AROS_ALIGN(sizeof(size_t));
-            FreePooled (StdCBase->mempool, mem, size);
+            cls = __malloc_class(size + MALLOC_HDRSIZE);
+
+            mc = __malloc_getcache(ms);
+            if (!mc) {
+                __malloc_release(ms, mem, cls);
+                return;
+            }
+
+            *((void **) mem) = mc->mc_Free[cls];
+            mc->mc_Free[cls] = mem;
+            mc->mc_Frees++;
+            mc->mc_Released += __malloc_classsize(cls);
+
+            if (++mc->mc_Count[cls] > __malloc_cachelimit(cls))
+                __malloc_flush(ms, mc, cls);
         }
     }
 
 } /* free */
-
@@ -55,6 +55,9 @@
     if (!stream)
         return NULL;
 
+    __stdcio_sync(stream);
+    __stdcio_freebuf(stream);
+
     if (path != NULL)
     {
         if (!(stream->flags & __STDCIO_STDIO_DONTCLOSE))
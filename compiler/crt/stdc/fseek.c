@@ -86,6 +86,9 @@
         return -1;
     }
 
+    if (__stdcio_sync(stream) == EOF)
+        return -1;
+
     if (Seek(fh, offset, mode) < 0)
     {
         D(bug("[%s] %s: Failed (IoErr()=%d)\n", STDCNAME, __func__, IoErr()));
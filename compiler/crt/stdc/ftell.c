@@ -51,11 +51,17 @@
 
     D(bug("[%s] %s: Entering\n", STDCNAME, __func__));
 
+    if (stream->wpos && __stdcio_sync(stream) == EOF)
+        return -1;
+
     Flush (fh);
     cnt = Seek (fh, 0, OFFSET_CURRENT);
 
     if (cnt == -1)
         errno = __stdc_ioerr2errno (IoErr ());
+    else if (stream->rpos)
+        /* Input read ahead by fgetc() hasn't been seen yet */
+        cnt -= stream->rend - stream->rpos;
 
     D(bug("[%s] %s: Leaving cnt=%d\n", STDCNAME, __func__, cnt));
 
@@ -5,6 +5,7 @@
 */
 #include <proto/dos.h>
 #include <errno.h>
+#include <string.h>
 
 #include "__stdio.h"
 
@@ -52,6 +53,17 @@
         return 0;
     }
 
+    /* Small writes go to the buffer fputc() writes to */
+    if (stream->wpos && size * nblocks <= stream->wend - stream->wpos)
+    {
+        memcpy(stream->wpos, buf, size * nblocks);
+        stream->wpos += size * nblocks;
+        return nblocks;
+    }
+
+    if (__stdcio_sync(stream) == EOF)
+        return 0;
+
     if ((stream->flags & __STDCIO_STDIO_APPEND))
         Seek(stream->fh, 0, OFFSET_END);
 
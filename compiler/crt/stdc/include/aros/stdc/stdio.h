@@ -125,6 +125,30 @@ void perror(const char *s);
 /* AROS specific function */
 void updatestdio(void);
 
+/* The start of struct __sFILE, getc() and putc() work on the stdio buffer
+   of the stream directly and only call fgetc() and fputc() when it is
+   empty or full.
+*/
+struct __sFILE_buf
+{
+    void            *__node[2];
+    unsigned char   *__rpos, *__rend;
+    unsigned char   *__wpos, *__wend;
+};
+
+#if !defined(STDC_NOINLINE) && !defined(STDC_NOINLINE_STDIO)
+#define getc(stream)                                                        \
+    ((((struct __sFILE_buf *)(stream))->__rpos                              \
+      < ((struct __sFILE_buf *)(stream))->__rend)                           \
+     ? (int)*((struct __sFILE_buf *)(stream))->__rpos++                     \
+     : fgetc(stream))
+#define putc(c, stream)                                                     \
+    ((((struct __sFILE_buf *)(stream))->__wpos                              \
+      < ((struct __sFILE_buf *)(stream))->__wend)                           \
+     ? (int)(*((struct __sFILE_buf *)(stream))->__wpos++ = (unsigned char)(c)) \
+     : fputc((c), stream))
+#endif
+
 __END_DECLS
 
 #endif /* _STDC_STDIO_H_ */
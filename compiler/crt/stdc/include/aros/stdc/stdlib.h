@@ -119,6 +119,7 @@ void *aligned_alloc(size_t alignment, size_t size);
 
 /* AROS-specific extensions */
 void *realloc_nocopy(void *oldmem, size_t newsize);
+void malloc_stats(void);
 int on_exit(void (*func)(int, void *), void *);
 
 __END_DECLS
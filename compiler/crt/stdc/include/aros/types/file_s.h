@@ -13,9 +13,15 @@
 #include <dos/bptr.h>
 #include <exec/lists.h>
 
+/* The members up to wend must match struct __sFILE_buf in <stdio.h> */
 struct __sFILE
 {
     struct MinNode  node;
+    unsigned char   *rpos;      /* next buffered input char, NULL if not reading */
+    unsigned char   *rend;
+    unsigned char   *wpos;      /* next free byte of the output buffer, NULL if not writing */
+    unsigned char   *wend;
+    unsigned char   *buf;       /* stdio buffer, allocated on first fgetc()/fputc() */
     union {
         BPTR fh;
         int fd;
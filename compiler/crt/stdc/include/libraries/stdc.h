@@ -12,6 +12,7 @@
 #include <exec/libraries.h>
 
 #include <setjmp.h>
+#include <aros/types/size_t.h>
 
 struct StdCBase
 {
@@ -35,6 +36,22 @@ struct StdCBase
     unsigned char sigrunning, sigpending;
 };
 
+/* Filled in by __stdc_malloc_getstats(), see malloc_stats() */
+struct __stdc_mallocstats
+{
+    size_t ms_SlabBytes;        /* Memory divided into size classes */
+    size_t ms_InUseBytes;       /* Small blocks allocated */
+    size_t ms_CachedBytes;      /* Free small blocks in task caches */
+    size_t ms_LargeBytes;       /* Memory in large blocks */
+    unsigned long ms_LargeBlocks;
+    unsigned long ms_Threads;   /* Tasks that have a cache */
+    unsigned long ms_Mallocs;   /* Small block allocations */
+    unsigned long ms_Frees;
+    unsigned long ms_CacheHits; /* Allocations done from the task cache */
+    unsigned long ms_Refills;   /* Batches taken from the central lists */
+    unsigned long ms_Flushes;   /* Batches given back to them */
+};
+
 __BEGIN_DECLS
 
 struct StdCBase *__aros_getbase_StdCBase(void);
@@ -49,6 +66,8 @@ void __stdc_jmp2exit(int normal, int returncode) __noreturn;
 void *__stdc_set_fpuprivate(void *fpuprivate);
 void *__stdc_get_fpuprivate(void);
 int __stdc_mb_cur_max(void);
+void __stdc_malloc_getstats(struct __stdc_mallocstats *stats);
+void __stdc_malloc_releasecache(void);
 
 __END_DECLS
 
@@ -1,12 +1,14 @@
 /*
-    Copyright (C) 1995-2020, The AROS Development Team. All rights reserved.
+    Copyright (C) 1995-2025, The AROS Development Team. All rights reserved.
 
     C99 function malloc().
 */
 
 #include "__stdc_intbase.h"
+#include "__malloc.h"
 
 #include <errno.h>
+#include <string.h>
 #include <dos/dos.h>
 #include <exec/memory.h>
 #include <proto/exec.h>
@@ -47,52 +49,286 @@
         free()
 
     INTERNALS
+        Small blocks come from a per-task cache of size classes, so
+        most calls do not have to take a lock. See __malloc.h.
 
 ******************************************************************************/
 {
     struct StdCIntBase *StdCBase = (struct StdCIntBase *)__aros_getbase_StdCBase();
-    UBYTE *mem = NULL;
+    struct __malloc_state *ms = StdCBase->mallocstate;
+    struct __malloc_cache *mc;
+    void **block;
+    int cls;
 
-    /* Allocate the memory */
-    mem = AllocPooled (StdCBase->mempool, size + AROS_ALIGN(sizeof(size_t)));
-    if (mem)
+    if (size > MALLOC_MAXSMALL)
+        return __malloc_large(ms, size);
+
+    cls = __malloc_class(size + MALLOC_HDRSIZE);
+
+    mc = __malloc_getcache(ms);
+    if (!mc)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    /* Take a block from our own cache, or get a new batch */
+    block = mc->mc_Free[cls];
+    if (block)
     {
-        *((size_t *)mem) = size;
-        mem += AROS_ALIGN(sizeof(size_t));
+        mc->mc_Free[cls] = *block;
+        mc->mc_Count[cls]--;
+        mc->mc_Hits++;
     }
-    else
+    else if (!(block = __malloc_refill(ms, mc, cls)))
+    {
         errno = ENOMEM;
+        return NULL;
+    }
 
-    return mem;
+    mc->mc_Mallocs++;
+    mc->mc_Allocated += __malloc_classsize(cls);
+
+    *((size_t *)block) = size;
+
+    return (UBYTE *)block + MALLOC_HDRSIZE;
 
 } /* malloc */
 
 
+struct __malloc_cache *__malloc_newcache(struct __malloc_state *ms, struct Task *task)
+{
+    struct __malloc_cache *mc;
+    int bucket = ((IPTR)task >> 4) & (MALLOC_CACHEHASH - 1);
+
+    ObtainSemaphore(&ms->ms_Lock);
+
+    /*
+     * A cache left behind by a task that has exited is taken over by the
+     * next task at the same address. One given back with
+     * __stdc_malloc_releasecache() is reused by any task of the chain.
+     */
+    for (mc = ms->ms_Caches[bucket]; mc; mc = mc->mc_Next)
+    {
+        if (!mc->mc_Task)
+        {
+            mc->mc_Task = task;
+            ms->ms_Threads++;
+            break;
+        }
+    }
+
+    if (!mc)
+    {
+        mc = AllocPooled(ms->ms_Pool, sizeof(struct __malloc_cache));
+        if (mc)
+        {
+            memset(mc, 0, sizeof(struct __malloc_cache));
+            mc->mc_Task = task;
+            mc->mc_Next = ms->ms_Caches[bucket];
+            ms->ms_Caches[bucket] = mc;
+            ms->ms_Threads++;
+        }
+    }
+
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    D(bug("[%s] %s: task(0x%p), cache(0x%p)\n", STDCNAME, __func__, task, mc));
+
+    return mc;
+}
+
+
+/* Returns one block of the class and puts up to half a cache full in mc */
+void *__malloc_refill(struct __malloc_state *ms, struct __malloc_cache *mc, int cls)
+{
+    size_t size = __malloc_classsize(cls);
+    UWORD batch = __malloc_cachelimit(cls) / 2;
+    void **block;
+
+    ObtainSemaphore(&ms->ms_Lock);
+
+    if (!ms->ms_Free[cls])
+    {
+        UBYTE *slab = AllocPooled(ms->ms_Pool, MALLOC_SLABSIZE);
+
+        if (slab)
+        {
+            ULONG n = MALLOC_SLABSIZE / size;
+
+            /* Link from the end, so blocks are handed out in address order */
+            while (n--)
+            {
+                block = (void **)(slab + n * size);
+                *block = ms->ms_Free[cls];
+                ms->ms_Free[cls] = block;
+                ms->ms_FreeCount[cls]++;
+            }
+            ms->ms_SlabBytes += MALLOC_SLABSIZE;
+        }
+    }
+
+    block = ms->ms_Free[cls];
+    if (block)
+    {
+        ms->ms_Free[cls] = *block;
+        ms->ms_FreeCount[cls]--;
+
+        while (batch-- && ms->ms_Free[cls])
+        {
+            void **next = ms->ms_Free[cls];
+
+            ms->ms_Free[cls] = *next;
+            ms->ms_FreeCount[cls]--;
+            *next = mc->mc_Free[cls];
+            mc->mc_Free[cls] = next;
+            mc->mc_Count[cls]++;
+        }
+        mc->mc_Refills++;
+    }
+
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    return block;
+}
+
+
+/* Gives all but half a cache full of blocks back to the central list */
+void __malloc_flush(struct __malloc_state *ms, struct __malloc_cache *mc, int cls)
+{
+    UWORD keep = __malloc_cachelimit(cls) / 2;
+    ULONG n = mc->mc_Count[cls] - keep;
+    void **last = mc->mc_Free[cls], **first;
+
+    /* The most recently freed blocks are at the head, keep those */
+    while (--keep)
+        last = *last;
+    first = *last;
+    *last = NULL;
+
+    for (last = first; *last; last = *last)
+        ;
+
+    mc->mc_Count[cls] -= n;
+    mc->mc_Flushes++;
+
+    ObtainSemaphore(&ms->ms_Lock);
+    *last = ms->ms_Free[cls];
+    ms->ms_Free[cls] = first;
+    ms->ms_FreeCount[cls] += n;
+    ReleaseSemaphore(&ms->ms_Lock);
+}
+
+
+/* Frees a block straight to the central list */
+void __malloc_release(struct __malloc_state *ms, void *block, int cls)
+{
+    ObtainSemaphore(&ms->ms_Lock);
+    *((void **)block) = ms->ms_Free[cls];
+    ms->ms_Free[cls] = block;
+    ms->ms_FreeCount[cls]++;
+    ms->ms_Frees++;
+    ms->ms_Released += __malloc_classsize(cls);
+    ReleaseSemaphore(&ms->ms_Lock);
+}
+
+
+void *__malloc_large(struct __malloc_state *ms, size_t size)
+{
+    struct __malloc_large *ml = NULL;
+    size_t total = size + MALLOC_LARGEHDRSIZE;
+    UBYTE *mem;
+
+    if (total > size)
+        ml = AllocMem(total, MEMF_ANY);
+    if (!ml)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+    ml->ml_Size = total;
+
+    ObtainSemaphore(&ms->ms_Lock);
+    AddTail((struct List *)&ms->ms_Large, (struct Node *)&ml->ml_Node);
+    ms->ms_LargeBytes += total;
+    ms->ms_LargeBlocks++;
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    mem = (UBYTE *)ml + MALLOC_LARGEHDRSIZE;
+    *((size_t *)(mem - MALLOC_HDRSIZE)) = size;
+
+    return mem;
+}
+
+
+void __malloc_freelarge(struct __malloc_state *ms, void *mem)
+{
+    struct __malloc_large *ml =
+        (struct __malloc_large *)((UBYTE *)mem - MALLOC_LARGEHDRSIZE);
+
+    ObtainSemaphore(&ms->ms_Lock);
+    Remove((struct Node *)&ml->ml_Node);
+    ms->ms_LargeBytes -= ml->ml_Size;
+    ms->ms_LargeBlocks--;
+    ReleaseSemaphore(&ms->ms_Lock);
+
+    FreeMem(ml, ml->ml_Size);
+}
+
+
 int __init_memstuff(struct StdCIntBase *StdCBase)
 {
+    struct __malloc_state *ms;
+    APTR pool;
+
     D(bug("[%s] %s: task(0x%p), StdCBase(0x%p)\n", STDCNAME, __func__,
           FindTask(NULL), StdCBase
     ));
 
-    StdCBase->mempool = CreatePool(MEMF_ANY | MEMF_SEM_PROTECTED, 65536L, 4096L);
+    /* Only used with ms_Lock held, so it needs no semaphore of its own */
+    pool = CreatePool(MEMF_ANY, 4 * MALLOC_SLABSIZE, MALLOC_SLABSIZE);
 
-    D(bug("[%s] %s: StdCBase->mempool(0x%p)\n", STDCNAME, __func__, StdCBase->mempool));
+    D(bug("[%s] %s: pool(0x%p)\n", STDCNAME, __func__, pool));
 
-    if (!StdCBase->mempool)
+    if (!pool)
     {
         return 0;
     }
 
+    ms = AllocPooled(pool, sizeof(struct __malloc_state));
+    if (!ms)
+    {
+        DeletePool(pool);
+        return 0;
+    }
+
+    memset(ms, 0, sizeof(struct __malloc_state));
+    InitSemaphore(&ms->ms_Lock);
+    NEWLIST(&ms->ms_Large);
+    ms->ms_Pool = pool;
+
+    StdCBase->mempool = pool;
+    StdCBase->mallocstate = ms;
+
     return 1;
 }
 
 
 void __exit_memstuff(struct StdCIntBase *StdCBase)
 {
+    struct __malloc_state *ms = StdCBase->mallocstate;
+    struct __malloc_large *ml;
+
     D(bug("[%s] %s: task(0x%p), StdCBase(0x%p), acb_mempool(0x%p)\n", STDCNAME, __func__,
           FindTask(NULL), StdCBase, StdCBase->mempool
     ));
 
+    if (ms)
+    {
+        while ((ml = (struct __malloc_large *)RemHead((struct List *)&ms->ms_Large)))
+            FreeMem(ml, ml->ml_Size);
+    }
+
     if (StdCBase->mempool)
     {
         DeletePool(StdCBase->mempool);
@@ -0,0 +1,63 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    AROS-specific function malloc_stats().
+*/
+
+#include <stdio.h>
+#include <libraries/stdc.h>
+
+/*****************************************************************************
+
+    NAME */
+#include <stdlib.h>
+
+        void malloc_stats (
+
+/*  SYNOPSIS */
+        void)
+
+/*  FUNCTION
+        Print statistics about the memory allocated with malloc() and
+        related functions to the standard error stream.
+
+    INPUTS
+
+    RESULT
+
+    NOTES
+        This function is AROS specific, the output is similar to the one
+        of glibc's malloc_stats(). "system bytes" is the memory obtained
+        from exec for blocks up to 16kB, "in use bytes" the part of it
+        handed out, "cached bytes" the free blocks held by the caches of
+        the tasks.
+
+    EXAMPLE
+
+    BUGS
+
+    SEE ALSO
+        malloc(), free()
+
+    INTERNALS
+        Uses __stdc_malloc_getstats() of stdc.library.
+
+******************************************************************************/
+{
+    struct __stdc_mallocstats stats;
+
+    __stdc_malloc_getstats(&stats);
+
+    fprintf(stderr, "system bytes     = %10lu\n", (unsigned long)stats.ms_SlabBytes);
+    fprintf(stderr, "in use bytes     = %10lu\n", (unsigned long)stats.ms_InUseBytes);
+    fprintf(stderr, "cached bytes     = %10lu\n", (unsigned long)stats.ms_CachedBytes);
+    fprintf(stderr, "large blocks     = %10lu\n", stats.ms_LargeBlocks);
+    fprintf(stderr, "large bytes      = %10lu\n", (unsigned long)stats.ms_LargeBytes);
+    fprintf(stderr, "threads          = %10lu\n", stats.ms_Threads);
+    fprintf(stderr, "mallocs          = %10lu\n", stats.ms_Mallocs);
+    fprintf(stderr, "frees            = %10lu\n", stats.ms_Frees);
+    fprintf(stderr, "cache hits       = %10lu\n", stats.ms_CacheHits);
+    fprintf(stderr, "refills          = %10lu\n", stats.ms_Refills);
+    fprintf(stderr, "flushes          = %10lu\n", stats.ms_Flushes);
+
+} /* malloc_stats */
@@ -4,6 +4,35 @@
     C99 function memchr().
 */
 
+#include "__string.h"
+
+#if defined(__STRING_AVX2)
+static __STRING_AVX2_FUNC void *memchr_avx2(const unsigned char *ptr, int c, size_t n)
+{
+    const unsigned char *p = (const unsigned char *)((IPTR)ptr & ~(IPTR)31);
+    size_t left = n + (ptr - p);
+    __m256i v = _mm256_set1_epi8(c);
+    unsigned int mask;
+
+    if (left < n)
+        left = ~(size_t)0;
+
+    mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), v));
+    mask &= ~0U << ((IPTR)ptr & 31);
+
+    while (!mask)
+    {
+        if (left <= 32)
+            return NULL;
+        left -= 32;
+        p += 32;
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), v));
+    }
+
+    return (__builtin_ctz(mask) < left) ? (void *)(p + __builtin_ctz(mask)) : NULL;
+}
+#endif
+
 /*****************************************************************************
 
     NAME */
@@ -37,11 +66,88 @@
     SEE ALSO
 
     INTERNALS
+        Checks 16 or 32 bytes at a time with SSE2/AVX2 or NEON and a
+        machine word at a time otherwise. The vector loads are aligned,
+        so the bytes read behind mem + n are always on the same page.
 
 ******************************************************************************/
 {
     /* unsigned char to compare chars > 127 */
     const unsigned char * ptr = (unsigned char *)mem;
+#if defined(__SSE2__)
+    const unsigned char * p;
+    __m128i v = _mm_set1_epi8(c);
+    unsigned int mask;
+    size_t left;
+
+    if (!n)
+        return NULL;
+
+#if defined(__STRING_AVX2)
+    if (__string_avx2)
+        return memchr_avx2(ptr, c, n);
+#endif
+
+    p = (const unsigned char *)((IPTR)ptr & ~(IPTR)15);
+    left = n + (ptr - p);
+    if (left < n)
+        left = ~(size_t)0;
+
+    mask = __sse2_match(p, v) & (~0U << ((IPTR)ptr & 15));
+
+    while (!mask)
+    {
+        if (left <= 16)
+            return NULL;
+        left -= 16;
+        p += 16;
+        mask = __sse2_match(p, v);
+    }
+
+    return (__builtin_ctz(mask) < left) ? (void *)(p + __builtin_ctz(mask)) : NULL;
+#else
+#if defined(__STRING_NEON)
+    uint8x16_t v = vdupq_n_u8(c);
+
+    while (n && ((IPTR)ptr & 15))
+    {
+        if (*ptr == (unsigned char)c)
+            return ((void *)ptr);
+
+        n --;
+        ptr ++;
+    }
+
+    while (n >= 16 && !__neon_any(vceqq_u8(vld1q_u8(ptr), v)))
+    {
+        n -= 16;
+        ptr += 16;
+    }
+#else
+    const __strword * wptr;
+    __strword cc = __strword_splat(c);
+
+    while (n && ((IPTR)ptr & __STRWORD_MASK))
+    {
+        if (*ptr == (unsigned char)c)
+            return ((void *)ptr);
+
+        n --;
+        ptr ++;
+    }
+
+    for (wptr = (const __strword *)ptr; n >= __STRWORD_SIZE; wptr ++)
+    {
+        __strword w = *wptr ^ cc;
+
+        if (__STRWORD_HASZERO(w))
+            break;
+
+        n -= __STRWORD_SIZE;
+    }
+
+    ptr = (const unsigned char *)wptr;
+#endif
 
     while (n)
     {
@@ -53,4 +159,5 @@
     }
 
     return NULL;
+#endif
 } /* memchr */
@@ -6,6 +6,8 @@
 
 #include <exec/types.h>
 
+#include "__string.h"
+
 /*****************************************************************************
 
     NAME */
@@ -43,6 +45,9 @@
         strcmp(), strncmp(), strcasecmp(), strncasecmp()
 
     INTERNALS
+        Compares 16 bytes at a time with SSE2 or NEON. Otherwise areas
+        with the same alignment are compared a machine word at a time.
+        Only the bytes inside the areas are read.
 
 ******************************************************************************/
 {
@@ -54,6 +59,56 @@
     str1 = s1;
     str2 = s2;
 
+#if defined(__SSE2__)
+    while (n >= 16)
+    {
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i *)str1),
+            _mm_loadu_si128((const __m128i *)str2)));
+
+        if (mask != 0xFFFF)
+        {
+            mask = __builtin_ctz(~mask);
+            return str1[mask] - str2[mask];
+        }
+
+        str1 += 16;
+        str2 += 16;
+        n -= 16;
+    }
+#elif defined(__STRING_NEON)
+    while (n >= 16)
+    {
+        if (__neon_any(veorq_u8(vld1q_u8(str1), vld1q_u8(str2))))
+            break;
+
+        str1 += 16;
+        str2 += 16;
+        n -= 16;
+    }
+#else
+    if (!(((IPTR)str1 ^ (IPTR)str2) & __STRWORD_MASK))
+    {
+        while (n && ((IPTR)str1 & __STRWORD_MASK))
+        {
+            if ((diff = *str1 - *str2))
+                return diff;
+
+            str1 ++;
+            str2 ++;
+            n --;
+        }
+
+        while (n >= __STRWORD_SIZE
+            && *(const __strword *)str1 == *(const __strword *)str2)
+        {
+            str1 += __STRWORD_SIZE;
+            str2 += __STRWORD_SIZE;
+            n -= __STRWORD_SIZE;
+        }
+    }
+#endif
+
     while (n && !(diff = *str1 - *str2))
     {
         str1 ++;
@@ -38,15 +38,23 @@
 static char sccsid[] = "@(#)bcopy.c	8.1 (Berkeley) 6/4/93";
 #endif /* LIBC_SCCS and not lint */
 
+#include <exec/types.h>
+
 /*
  * sizeof(word) MUST BE A POWER OF TWO
  * SO THAT wmask BELOW IS ALL ONES
  */
-typedef	int word;		/* "word" used for optimal copy speed */
+typedef	IPTR word __attribute__((__may_alias__));	/* "word" used for optimal copy speed */
 
 #define	wsize	sizeof(word)
 #define	wmask	(wsize - 1)
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#define	SSE2_MIN	64	/* smallest length worth the 16 byte loop */
+#endif
+
 /*
  * Copy a block of memory, handling overlap.
  */
@@ -103,6 +111,25 @@ typedef	int word;		/* "word" used for optimal copy speed */
 		/*
 		 * Copy forward.
 		 */
+#if defined(__SSE2__)
+		/*
+		 * Large blocks: align dst, then move 16 bytes at a
+		 * time whatever the alignment of src is.  Each block
+		 * is loaded before it is stored, so overlap is fine.
+		 */
+		if (length >= SSE2_MIN) {
+			t = -(unsigned long)dst & 15;
+			length -= t;
+			TLOOP(*dst++ = *src++);
+			t = length / 16;
+			TLOOP1(_mm_store_si128((__m128i *)dst,
+			    _mm_loadu_si128((const __m128i *)src));
+			    src += 16; dst += 16);
+			length &= 15;
+			if (length == 0)
+				goto done;
+		}
+#endif
 		t = (unsigned long)src;	/* only need low bits */
 		if ((t | (unsigned long)dst) & wmask) {
 			/*
@@ -131,6 +158,20 @@ typedef	int word;		/* "word" used for optimal copy speed */
 		 */
 		src += length;
 		dst += length;
+#if defined(__SSE2__)
+		if (length >= SSE2_MIN) {
+			t = (unsigned long)dst & 15;
+			length -= t;
+			TLOOP(*--dst = *--src);
+			t = length / 16;
+			TLOOP1(src -= 16; dst -= 16;
+			    _mm_store_si128((__m128i *)dst,
+			    _mm_loadu_si128((const __m128i *)src)));
+			length &= 15;
+			if (length == 0)
+				goto done;
+		}
+#endif
 		t = (unsigned long)src;
 		if ((t | (unsigned long)dst) & wmask) {
 			if ((t ^ (unsigned long)dst) & wmask || length <= wsize)
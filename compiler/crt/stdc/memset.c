@@ -6,6 +6,8 @@
 
 #include <proto/exec.h>
 
+#include "__string.h"
+
 /*****************************************************************************
 
     NAME */
@@ -39,33 +41,51 @@
         memmove(), memcpy()
 
     INTERNALS
+        Fills 16 bytes at a time with SSE2 and a machine word at a time
+        otherwise.
 
 ******************************************************************************/
 {
     UBYTE * ptr = dest;
 
-    while (((IPTR)ptr)&(AROS_LONGALIGN-1) && count)
+    while (((IPTR)ptr)&(__STRWORD_MASK) && count)
     {
         *ptr ++ = c;
         count --;
     }
 
-    if (count > sizeof(ULONG))
+    if (count >= __STRWORD_SIZE)
     {
-        ULONG * ulptr = (ULONG *)ptr;
-        ULONG fill;
+        __strword * wptr = (__strword *)ptr;
+        __strword fill = __strword_splat(c);
 
-        fill = (ULONG)(c & 0xFF);
-        fill = (fill <<  8) | fill;
-        fill = (fill << 16) | fill;
+#if defined(__SSE2__)
+        if (count >= 64)
+        {
+            __m128i vfill = _mm_set1_epi8(c);
+
+            while (((IPTR)wptr) & 15)
+            {
+                *wptr ++ = fill;
+                count -= __STRWORD_SIZE;
+            }
+
+            while (count >= 16)
+            {
+                _mm_store_si128((__m128i *)wptr, vfill);
+                wptr += 16 / __STRWORD_SIZE;
+                count -= 16;
+            }
+        }
+#endif
 
-        while (count > sizeof(ULONG))
+        while (count >= __STRWORD_SIZE)
         {
-            *ulptr ++ = fill;
-            count -= sizeof(ULONG);
+            *wptr ++ = fill;
+            count -= __STRWORD_SIZE;
         }
 
-        ptr = (UBYTE *)ulptr;
+        ptr = (UBYTE *)wptr;
     }
 
     while (count --)
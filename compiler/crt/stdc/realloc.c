@@ -7,6 +7,8 @@
 #include <aros/cpu.h>
 #include <proto/exec.h>
 
+#include "__malloc.h"
+
 /*****************************************************************************
 
     NAME */
@@ -54,9 +56,17 @@
     if (!oldmem)
         return malloc (size);
 
-    mem = (UBYTE *)oldmem - AROS_ALIGN(sizeof(size_t));
+    mem = (UBYTE *)oldmem - MALLOC_HDRSIZE;
     oldsize = *((size_t *)mem);
 
+    /* Grow in place as long as the block stays in its size class */
+    if (size > oldsize && size <= MALLOC_MAXSMALL
+        && __malloc_class(size + MALLOC_HDRSIZE) == __malloc_class(oldsize + MALLOC_HDRSIZE))
+    {
+        *((size_t *)mem) = size;
+        return oldmem;
+    }
+
     /* Reduce or enlarge the memory ? */
     if (size < oldsize)
     {
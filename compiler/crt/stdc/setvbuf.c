@@ -98,6 +98,14 @@
         return EOF;
     }
 
+    /* Only fully buffered streams get a stdio buffer on top of the dos one */
+    __stdcio_sync(stream);
+    __stdcio_freebuf(stream);
+    if (mode == BUF_FULL)
+        stream->flags &= ~(__STDCIO_STDIO_NOBUF | __STDCIO_STDIO_BUFCHECKED);
+    else
+        stream->flags |= __STDCIO_STDIO_NOBUF | __STDCIO_STDIO_BUFCHECKED;
+
     retval = (int)SetVBuf(stream->fh, filebuf, mode, bufsize ? bufsize : -1);
 
     return retval;
@@ -7,6 +7,8 @@
 #include <aros/macros.h>
 #include <stdio.h>
 
+#include "__string.h"
+
 /*****************************************************************************
 
     NAME */
@@ -48,9 +50,75 @@
         strrchr()
 
     INTERNALS
+        Looks for c and the end of the string at the same time, 16 bytes
+        at a time with SSE2 or NEON and a machine word at a time
+        otherwise. All loads are aligned.
 
 ******************************************************************************/
 {
+#if defined(__SSE2__)
+    const char * p = (const char *)((IPTR)str & ~(IPTR)15);
+    __m128i v = _mm_set1_epi8(c);
+    __m128i zero = _mm_setzero_si128();
+    unsigned int mask;
+
+    mask = (__sse2_match(p, v) | __sse2_match(p, zero)) & (~0U << ((IPTR)str & 15));
+
+    while (!mask)
+    {
+        p += 16;
+        mask = __sse2_match(p, v) | __sse2_match(p, zero);
+    }
+
+    p += __builtin_ctz(mask);
+
+    return ((unsigned char)*p == (unsigned char)c) ? (char *)p : NULL;
+#else
+#if defined(__STRING_NEON)
+    uint8x16_t v = vdupq_n_u8(c);
+    uint8x16_t zero = vdupq_n_u8(0);
+    uint8x16_t data;
+
+    while ((IPTR)str & 15)
+    {
+        if ((unsigned char)*str == (unsigned char)c)
+            return ((char *)str);
+        if (!*str)
+            return NULL;
+        str ++;
+    }
+
+    for (;;)
+    {
+        data = vld1q_u8((const uint8_t *)str);
+        if (__neon_any(vorrq_u8(vceqq_u8(data, v), vceqq_u8(data, zero))))
+            break;
+        str += 16;
+    }
+#else
+    const __strword * wptr;
+    __strword cc = __strword_splat(c);
+
+    while ((IPTR)str & __STRWORD_MASK)
+    {
+        if ((unsigned char)*str == (unsigned char)c)
+            return ((char *)str);
+        if (!*str)
+            return NULL;
+        str ++;
+    }
+
+    for (wptr = (const __strword *)str; ; wptr ++)
+    {
+        __strword w = *wptr;
+
+        if (__STRWORD_HASZERO(w) || __STRWORD_HASZERO(w ^ cc))
+            break;
+    }
+
+    str = (const char *)wptr;
+#endif
+
     do
     {
         /* those casts are needed to compare chars > 127 */
@@ -59,4 +127,5 @@
     } while (*(str++));
 
     return NULL;
+#endif
 } /* strchr */
@@ -4,6 +4,8 @@
     C99 function strcmp().
 */
 
+#include "__string.h"
+
 /*****************************************************************************
 
     NAME */
@@ -37,11 +39,94 @@
     SEE ALSO
 
     INTERNALS
+        Compares 16 bytes at a time with SSE2 or NEON. As the strings
+        usually are not aligned the same way, unaligned loads are used
+        and single bytes are compared when a load could reach into the
+        next page. Otherwise strings with the same alignment are
+        compared a machine word at a time.
 
 ******************************************************************************/
 {
     int diff;
 
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+
+    for (;;)
+    {
+        __m128i a, b;
+        unsigned int mask;
+
+        if (__STRING_PAGECROSS(str1, 16) || __STRING_PAGECROSS(str2, 16))
+        {
+            if ((diff = *(unsigned char*) str1 - *(unsigned char*) str2) || !*str1)
+                return diff;
+
+            str1 ++;
+            str2 ++;
+            continue;
+        }
+
+        a = _mm_loadu_si128((const __m128i *)str1);
+        b = _mm_loadu_si128((const __m128i *)str2);
+        mask = (~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFFFF)
+            | _mm_movemask_epi8(_mm_cmpeq_epi8(a, zero));
+
+        if (mask)
+        {
+            mask = __builtin_ctz(mask);
+            return ((unsigned char *)str1)[mask] - ((unsigned char *)str2)[mask];
+        }
+
+        str1 += 16;
+        str2 += 16;
+    }
+#elif defined(__STRING_NEON)
+    for (;;)
+    {
+        uint8x16_t a, b;
+
+        if (__STRING_PAGECROSS(str1, 16) || __STRING_PAGECROSS(str2, 16))
+        {
+            if ((diff = *(unsigned char*) str1 - *(unsigned char*) str2) || !*str1)
+                return diff;
+
+            str1 ++;
+            str2 ++;
+            continue;
+        }
+
+        a = vld1q_u8((const uint8_t *)str1);
+        b = vld1q_u8((const uint8_t *)str2);
+
+        /* The difference is in these 16 bytes, find it below */
+        if (__neon_any(vorrq_u8(veorq_u8(a, b), vceqq_u8(a, vdupq_n_u8(0)))))
+            break;
+
+        str1 += 16;
+        str2 += 16;
+    }
+#else
+    if (!(((IPTR)str1 ^ (IPTR)str2) & __STRWORD_MASK))
+    {
+        while ((IPTR)str1 & __STRWORD_MASK)
+        {
+            if ((diff = *(unsigned char*) str1 - *(unsigned char*) str2) || !*str1)
+                return diff;
+
+            str1 ++;
+            str2 ++;
+        }
+
+        while (*(const __strword *)str1 == *(const __strword *)str2
+            && !__STRWORD_HASZERO(*(const __strword *)str1))
+        {
+            str1 += __STRWORD_SIZE;
+            str2 += __STRWORD_SIZE;
+        }
+    }
+#endif
+
     /* No need to check *str2 since: a) str1 is equal str2 (both are 0),
         then *str1 will terminate the loop b) str1 and str2 are not equal
         (eg. *str2 is 0), then the diff part will be FALSE. I calculate
@@ -4,6 +4,28 @@
     C99 function strlen().
 */
 
+#include "__string.h"
+
+#if defined(__STRING_AVX2)
+static __STRING_AVX2_FUNC size_t strlen_avx2(const char *ptr)
+{
+    const char *p = (const char *)((IPTR)ptr & ~(IPTR)31);
+    __m256i zero = _mm256_setzero_si256();
+    unsigned int mask;
+
+    mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), zero));
+    mask &= ~0U << ((IPTR)ptr & 31);
+
+    while (!mask)
+    {
+        p += 32;
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), zero));
+    }
+
+    return p + __builtin_ctz(mask) - ptr;
+}
+#endif
+
 /*****************************************************************************
 
     NAME */
@@ -32,13 +54,62 @@
     SEE ALSO
 
     INTERNALS
+        Checks 16 or 32 bytes at a time with SSE2/AVX2 or NEON and a
+        machine word at a time otherwise. All loads are aligned, so they
+        never cross into a page behind the end of the string.
 
 ******************************************************************************/
 {
     const char * start = ptr;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    unsigned int mask;
+
+#if defined(__STRING_AVX2)
+    if (__string_avx2)
+        return strlen_avx2(ptr);
+#endif
+
+    ptr = (const char *)((IPTR)start & ~(IPTR)15);
+    mask = __sse2_match(ptr, zero) & (~0U << ((IPTR)start & 15));
+
+    while (!mask)
+    {
+        ptr += 16;
+        mask = __sse2_match(ptr, zero);
+    }
+
+    return ptr + __builtin_ctz(mask) - start;
+#else
+#if defined(__STRING_NEON)
+    while ((IPTR)ptr & 15)
+    {
+        if (!*ptr)
+            return ptr - start;
+        ptr ++;
+    }
+
+    while (!__neon_any(vceqq_u8(vld1q_u8((const uint8_t *)ptr), vdupq_n_u8(0))))
+        ptr += 16;
+#else
+    const __strword * wptr;
+
+    while ((IPTR)ptr & __STRWORD_MASK)
+    {
+        if (!*ptr)
+            return ptr - start;
+        ptr ++;
+    }
+
+    for (wptr = (const __strword *)ptr; !__STRWORD_HASZERO(*wptr); wptr ++)
+        ;
+
+    ptr = (const char *)wptr;
+#endif
 
     while (*ptr) ptr ++;
 
     return (((long)ptr) - ((long)start));
+#endif
 } /* strlen */
 
@@ -55,6 +55,20 @@
     if (c < -1)
         c = (unsigned int)c;
 
+    /* Input read with fgetc() is pushed back into the buffer, which keeps
+       room for one character */
+    if (stream->rpos > stream->buf && c != EOF)
+    {
+        *--stream->rpos = (unsigned char)c;
+        stream->flags &= ~__STDCIO_STDIO_EOF;
+        return (unsigned char)c;
+    }
+    if (stream->rpos)
+        return EOF;
+
+    if (stream->wpos && __stdcio_sync(stream) == EOF)
+        return EOF;
+
     if (!UnGetC (stream->fh, c))
     {
         LONG ioerr = IoErr();
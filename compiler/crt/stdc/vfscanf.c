@@ -45,6 +45,8 @@
 
 ******************************************************************************/
 {
+    if (stream->wpos)
+        __stdcio_sync(stream);
     Flush (stream->fh);
     
     return __vcscan (stream, (int (*)(void *))fgetc, (int (*)(int, void *))ungetc, format, args);
@@ -56,6 +56,8 @@
 {
     D(bug("[%s] %s(0x%p, 0x%p)\n", STDCNAME, __func__, stream, format));
 
+    if (stream->wpos)
+        __stdcio_sync(stream);
     Flush (stream->fh);
 
     return __vwscanf(stream, (wint_t (*)(void *))fgetwc, (int (*)(wint_t,  void *))ungetwc, format, arg);
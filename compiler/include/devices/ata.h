@@ -9,6 +9,7 @@
     Lang: english
 */
 
+#include <exec/types.h>
 #include <devices/smart.h>
 
 #define HD_SMARTCMD				(CMD_NONSTD + 22)
@@ -20,4 +21,15 @@
 #define SMART_MAGIC_ID 			0x534D5254				/* SMRT */
 #define TRIM_MAGIC_ID 			0x5452494D				/* TRIM */
 
+/*
+ * HD_TRIMCMD: io_Data points to an array of TRIMRange entries and
+ * io_Length holds the size of the array in bytes. Only whole sectors
+ * inside a range are discarded.
+ */
+struct TRIMRange
+{
+    UQUAD   tr_Offset;                                      /* Byte offset */
+    UQUAD   tr_Length;                                      /* Length in bytes */
+};
+
 #endif /* DEVICES_ATA_H */
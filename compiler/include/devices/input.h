@@ -22,6 +22,7 @@
 #define IND_SETMTRIG	(CMD_NONSTD + 7)
 
 #define IND_ADDEVENT	(CMD_NONSTD + 15) /* V50! */
+#define IND_GETSTATS	(CMD_NONSTD + 16) /* AROS-specific */
 
 /* The following is AROS-specific, experimental and subject to change */
 struct InputDevice
@@ -32,4 +33,22 @@ struct InputDevice
 
 #define IDF_SWAP_BUTTONS 0x0001
 
+/*
+ * Returned by IND_GETSTATS. io_Length gives the size of the buffer in
+ * io_Data, io_Actual the number of bytes filled in. Times are in
+ * microseconds.
+ */
+struct InputStatistics
+{
+    ULONG ist_Events;		/* Events passed to the handlers */
+    ULONG ist_Coalesced;	/* Pointer moves merged into a queued one */
+    ULONG ist_Batches;		/* Runs of the handler chain */
+    ULONG ist_MaxBatch;		/* Most events passed in one run */
+    ULONG ist_LastTime;		/* Time the last run took */
+    ULONG ist_MaxTime;		/* Longest run */
+    UQUAD ist_TotalTime;	/* Time spent in the handlers */
+    ULONG ist_LastDelay;	/* Oldest event's wait for the last run */
+    ULONG ist_MaxDelay;		/* Longest wait of an event */
+};
+
 #endif /* DEVICES_INPUT_H */
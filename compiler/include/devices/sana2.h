@@ -24,6 +24,7 @@
 #define SANA2IOB_MCAST                  5
 #if !defined(_NO_AROS_SANA_EXTRA)
 #define SANA2IOB_CRC                    4
+#define SANA2IOB_CSUM                   3
 #endif
 
 #define SANA2IOF_RAW                    (1 << SANA2IOB_RAW)
@@ -31,6 +32,7 @@
 #define SANA2IOF_MCAST                  (1 << SANA2IOB_MCAST)
 #if !defined(_NO_AROS_SANA_EXTRA)
 #define SANA2IOF_CRC                    (1 << SANA2IOB_CRC)
+#define SANA2IOF_CSUM                   (1 << SANA2IOB_CSUM)
 #endif
 
 #define SANA2OPB_PROM                   1
@@ -152,8 +154,23 @@ struct Sana2DeviceQuery
    ULONG MTU;
    ULONG BPS;
    ULONG HardwareType;
+#if !defined(_NO_AROS_SANA_EXTRA)
+   ULONG RawMTU;
+   ULONG Capabilities;     /* Only valid if SizeSupplied covers it */
+#endif
 };
 
+#if !defined(_NO_AROS_SANA_EXTRA)
+/* Sana2DeviceQuery Capabilities */
+#define S2CAPB_RXCSUM                   0  /* Verifies IP/TCP/UDP checksums,
+                                              reported with SANA2IOF_CSUM */
+#define S2CAPB_TXCSUM                   1  /* Fills in the TCP/UDP checksum of
+                                              writes with SANA2IOF_CSUM set */
+
+#define S2CAPF_RXCSUM                   (1 << S2CAPB_RXCSUM)
+#define S2CAPF_TXCSUM                   (1 << S2CAPB_TXCSUM)
+#endif
+
 struct Sana2PacketTypeStats
 {
    ULONG PacketsSent;
@@ -95,6 +95,124 @@ pthread_t GetThreadId(struct Task *task)
     return i;
 }
 
+//
+// Futex style wait queues
+//
+// A thread sleeps on the address of a word for as long as the word has
+// the value it expects, the checks and the queues are protected by
+// Forbid(). Wait() breaks the Forbid() while the thread sleeps, so a
+// wakeup can not get lost between the check and the Wait().
+//
+
+#define FUTEX_QUEUES 64
+
+static struct MinList futex_queues[FUTEX_QUEUES];
+
+static struct MinList *FutexQueue(volatile int *addr)
+{
+    struct MinList *queue = &futex_queues[((IPTR)addr >> 2) % FUTEX_QUEUES];
+
+    // called in Forbid(), set the queue up on first use
+    if (queue->mlh_TailPred == NULL)
+        NEWLIST((struct List *)queue);
+
+    return queue;
+}
+
+ULONG _futex_wait(volatile int *addr, int val, ULONG sigmask)
+{
+    FutexWaiter waiter;
+    ULONG sigs = 0;
+
+    DB2(bug("%s(%p, %d, %08x)\n", __FUNCTION__, addr, val, sigmask));
+
+    Forbid();
+    if (*addr == val)
+    {
+        waiter.addr = addr;
+        waiter.task = GET_THIS_TASK;
+        SetSignal(0, SIGF_SINGLE);
+        AddTail((struct List *)FutexQueue(addr), (struct Node *)&waiter);
+
+        sigs = Wait(SIGF_SINGLE | sigmask);
+
+        // still queued if we were not woken up
+        if (waiter.addr)
+            Remove((struct Node *)&waiter);
+    }
+    Permit();
+
+    return sigs;
+}
+
+int _futex_wake(volatile int *addr, int count)
+{
+    struct MinList *queue;
+    FutexWaiter *waiter, *next;
+    int woken = 0;
+
+    DB2(bug("%s(%p, %d)\n", __FUNCTION__, addr, count));
+
+    Forbid();
+    queue = FutexQueue(addr);
+    for (waiter = (FutexWaiter *)queue->mlh_Head;
+        woken < count && (next = (FutexWaiter *)waiter->node.mln_Succ);
+        waiter = next)
+    {
+        if (waiter->addr == addr)
+        {
+            Remove((struct Node *)waiter);
+            waiter->addr = NULL;
+            Signal(waiter->task, SIGF_SINGLE);
+            woken++;
+        }
+    }
+    Permit();
+
+    return woken;
+}
+
+// Wakes up to count waiters on addr and moves the others to addr2
+int _futex_requeue(volatile int *addr, int count, volatile int *addr2)
+{
+    struct MinList *queue, *queue2;
+    FutexWaiter *waiter, *next;
+    int woken = 0;
+
+    DB2(bug("%s(%p, %d, %p)\n", __FUNCTION__, addr, count, addr2));
+
+    Forbid();
+    queue = FutexQueue(addr);
+    queue2 = FutexQueue(addr2);
+    for (waiter = (FutexWaiter *)queue->mlh_Head;
+        (next = (FutexWaiter *)waiter->node.mln_Succ);
+        waiter = next)
+    {
+        if (waiter->addr != addr)
+            continue;
+
+        if (woken < count)
+        {
+            Remove((struct Node *)waiter);
+            waiter->addr = NULL;
+            Signal(waiter->task, SIGF_SINGLE);
+            woken++;
+        }
+        else
+        {
+            waiter->addr = addr2;
+            if (queue2 != queue)
+            {
+                Remove((struct Node *)waiter);
+                AddTail((struct List *)queue2, (struct Node *)waiter);
+            }
+        }
+    }
+    Permit();
+
+    return woken;
+}
+
 #if defined __mc68000__
 /* No CAS instruction on m68k */
 static int __m68k_sync_val_compare_and_swap(int *v, int o, int n)
@@ -323,6 +441,12 @@ static int _obtain_sema_timed(struct SignalSemaphore *sema, const struct timespe
 
 int pthread_mutex_timedlock(pthread_mutex_t *mutex, const struct timespec *abstime)
 {
+    struct MsgPort timermp;
+    struct timerequest timerio;
+    struct timeval tvabstime, starttime;
+    struct Task *task;
+    ULONG timersig;
+    BOOL timedout;
     int result;
 
     D(bug("%s(%p, %p)\n", __FUNCTION__, mutex, abstime));
@@ -336,16 +460,62 @@ int pthread_mutex_timedlock(pthread_mutex_t *mutex, const struct timespec *absti
         return EINVAL;
 
     result = pthread_mutex_trylock(mutex);
-    if (result != 0)
+    if (result != EBUSY)
+        return result;
+
+    task = GET_THIS_TASK;
+
+    // pthread_mutex_trylock returns EBUSY when a deadlock would occur
+    if (mutex->kind != PTHREAD_MUTEX_RECURSIVE && mutex->owner == task)
+        return EDEADLK;
+
+    if (!OpenTimerDevice((struct IORequest *)&timerio, &timermp, task))
+    {
+        CloseTimerDevice((struct IORequest *)&timerio);
+        return EINVAL;
+    }
+
+    // absolute time has to be converted to relative
+    // GetSysTime can't be used due to the timezone offset in abstime
+    TIMESPEC_TO_TIMEVAL(&tvabstime, abstime);
+    gettimeofday(&starttime, NULL);
+    timersub(&tvabstime, &starttime, &tvabstime);
+    if (!timerisset(&tvabstime) || tvabstime.tv_sec < 0)
+    {
+        CloseTimerDevice((struct IORequest *)&timerio);
+        return ETIMEDOUT;
+    }
+
+    timerio.tr_node.io_Command = TR_ADDREQUEST;
+    timerio.tr_node.io_Flags = 0;
+    timerio.tr_time.tv_secs = tvabstime.tv_sec;
+    timerio.tr_time.tv_micro = tvabstime.tv_usec;
+    timersig = 1 << timermp.mp_SigBit;
+    SendIO((struct IORequest *)&timerio);
+
+    // after a timeout try once more, we may have been woken up as well
+    result = 0;
+    timedout = FALSE;
+    while (_atomic_xchg(&mutex->lock, 2) != 0)
+    {
+        if (timedout)
+        {
+            result = ETIMEDOUT;
+            break;
+        }
+        if (_futex_wait(&mutex->lock, 2, timersig) & timersig)
+            timedout = TRUE;
+    }
+
+    CloseTimerDevice((struct IORequest *)&timerio);
+
+    if (result == 0 && mutex->kind != PTHREAD_MUTEX_NORMAL)
     {
-        // pthread_mutex_trylock returns EBUSY when a deadlock would occur
-        if (result != EBUSY)
-            return result;
-        else if (mutex->kind != PTHREAD_MUTEX_RECURSIVE && SemaphoreIsMine(&mutex->semaphore))
-            return EDEADLK;
+        mutex->owner = task;
+        mutex->count = 1;
     }
 
-    return _obtain_sema_timed(&mutex->semaphore, abstime, SM_EXCLUSIVE);
+    return result;
 }
 
 //
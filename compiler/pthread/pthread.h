@@ -150,10 +150,14 @@ struct pthread_mutexattr
 
 typedef struct pthread_mutexattr pthread_mutexattr_t;
 
+// lock is 0 when free, 1 when locked and 2 when locked with possible
+// waiters; only owner and count are used by the non-normal kinds
 struct pthread_mutex
 {
     int kind;
-    struct SignalSemaphore semaphore;
+    volatile int lock;
+    struct Task *owner;
+    int count;
     int incond;
 };
 
@@ -169,9 +173,9 @@ typedef struct pthread_mutex pthread_mutex_t;
 #define NULL_SEMAPHOREREQUEST {NULL_MINNODE, 0}
 #define NULL_SEMAPHORE {NULL_NODE, 0, NULL_MINLIST, NULL_SEMAPHOREREQUEST, 0, 0}
 
-#define PTHREAD_MUTEX_INITIALIZER {PTHREAD_MUTEX_NORMAL, NULL_SEMAPHORE, 0}
-#define PTHREAD_RECURSIVE_MUTEX_INITIALIZER {PTHREAD_MUTEX_RECURSIVE, NULL_SEMAPHORE, 0}
-#define PTHREAD_ERRORCHECK_MUTEX_INITIALIZER {PTHREAD_MUTEX_ERRORCHECK, NULL_SEMAPHORE, 0}
+#define PTHREAD_MUTEX_INITIALIZER {PTHREAD_MUTEX_NORMAL, 0, NULL, 0, 0}
+#define PTHREAD_RECURSIVE_MUTEX_INITIALIZER {PTHREAD_MUTEX_RECURSIVE, 0, NULL, 0, 0}
+#define PTHREAD_ERRORCHECK_MUTEX_INITIALIZER {PTHREAD_MUTEX_ERRORCHECK, 0, NULL, 0, 0}
 
 //
 // Condition variables
@@ -184,16 +188,17 @@ struct pthread_condattr
 
 typedef struct pthread_condattr pthread_condattr_t;
 
+// seq changes with every signal, waiters sleep on it until it does
 struct pthread_cond
 {
-    int pad1;
-    struct SignalSemaphore semaphore;
-    struct MinList waiters;
+    volatile int seq;
+    volatile int waiters;
+    pthread_mutex_t *mutex;
 };
 
 typedef struct pthread_cond pthread_cond_t;
 
-#define PTHREAD_COND_INITIALIZER {0, NULL_SEMAPHORE, NULL_MINLIST}
+#define PTHREAD_COND_INITIALIZER {0, 0, NULL}
 
 //
 // Barriers
@@ -411,6 +416,18 @@ int pthread_getname_np(pthread_t thread, char *name, size_t len);
 int pthread_cond_timedwait_relative_np(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *reltime);
 int pthread_getattr_np(pthread_t thread, pthread_attr_t *attr);
 
+//
+// Thread pool, non-portable
+//
+
+typedef struct pthread_future pthread_future_t;
+
+int pthread_pool_size_np(void);
+int pthread_pool_submit_np(pthread_future_t **future, void *(*func)(void *), void *arg);
+int pthread_future_done_np(pthread_future_t *future);
+int pthread_future_wait_np(pthread_future_t *future, void **value);
+int pthread_parallel_for_np(long first, long last, long grain, void (*func)(long first, long last, void *arg), void *arg);
+
 //
 // Cancellation cleanup
 //
@@ -25,25 +25,26 @@
 
 int _pthread_cond_broadcast(pthread_cond_t *cond, BOOL onlyfirst)
 {
-    CondWaiter *waiter;
+    pthread_mutex_t *mutex;
 
     DB2(bug("%s(%p, %d)\n", __FUNCTION__, cond, onlyfirst));
 
     if (cond == NULL)
         return EINVAL;
 
-    // initialize static conditions
-    if (SemaphoreIsInvalid(&cond->semaphore))
-        pthread_cond_init(cond, NULL);
-
-    // signal the waiting threads 
-    ObtainSemaphore(&cond->semaphore);
-    ForeachNode(&cond->waiters, waiter)
-    {
-        Signal(waiter->task, 1 << waiter->sigbit);
-        if (onlyfirst) break;
-    }
-    ReleaseSemaphore(&cond->semaphore);
+    // waiters count themselves before they look at seq, so either they
+    // see the new value or we see them
+    _atomic_add(&cond->seq, 1);
+    if (cond->waiters == 0)
+        return 0;
+
+    // wake one waiter, on a broadcast move the rest over to the mutex
+    // so they are woken one by one as it gets unlocked
+    mutex = cond->mutex;
+    if (onlyfirst || mutex == NULL)
+        _futex_wake(&cond->seq, onlyfirst ? 1 : INT_MAX);
+    else
+        _futex_requeue(&cond->seq, 1, &mutex->lock);
 
     return 0;
 }
@@ -31,24 +31,9 @@ int pthread_cond_destroy(pthread_cond_t *cond)
     if (cond == NULL)
         return EINVAL;
 
-    // probably a statically allocated condition
-    if (SemaphoreIsInvalid(&cond->semaphore))
-        return 0;
-
-    if (AttemptSemaphore(&cond->semaphore) == FALSE)
-        return EBUSY;
-
-#ifdef __AROS__
-    if (!IsMinListEmpty(&cond->waiters))
-#else
-    if (!IsListEmpty((struct List *)&cond->waiters))
-#endif
-    {
-        ReleaseSemaphore(&cond->semaphore);
+    if (cond->waiters != 0)
         return EBUSY;
-    }
 
-    ReleaseSemaphore(&cond->semaphore);
     memset(cond, 0, sizeof(pthread_cond_t));
 
     return 0;
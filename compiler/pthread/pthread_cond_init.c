@@ -30,8 +30,9 @@ int pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr)
     if (cond == NULL)
         return EINVAL;
 
-    InitSemaphore(&cond->semaphore);
-    NEWLIST((struct List *)&cond->waiters);
+    cond->seq = 0;
+    cond->waiters = 0;
+    cond->mutex = NULL;
 
     return 0;
 }
@@ -28,22 +28,18 @@
 
 int _pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime, BOOL relative)
 {
-    CondWaiter waiter;
-    BYTE signal;
     ULONG sigs = SIGBREAKF_CTRL_C;
+    ULONG timersig = 0;
     struct MsgPort timermp;
     struct timerequest timerio;
     struct Task *task;
+    int seq;
 
     DB2(bug("%s(%p, %p, %p, %d)\n", __FUNCTION__, cond, mutex, abstime, relative));
 
     if (cond == NULL || mutex == NULL)
         return EINVAL;
 
-    // initialize static conditions
-    if (SemaphoreIsInvalid(&cond->semaphore))
-        pthread_cond_init(cond, NULL);
-
     task = GET_THIS_TASK;
 
     if (abstime)
@@ -75,40 +71,34 @@ int _pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const
         }
         timerio.tr_time.tv_secs = tvabstime.tv_sec;
         timerio.tr_time.tv_micro = tvabstime.tv_usec;
-        sigs |= (1 << timermp.mp_SigBit);
+        timersig = 1 << timermp.mp_SigBit;
+        sigs |= timersig;
         SendIO((struct IORequest *)&timerio);
     }
 
-    // prepare a waiter node
-    waiter.task = task;
-    signal = AllocSignal(-1);
-    if (signal == -1)
-    {
-        signal = SIGB_COND_FALLBACK;
-        SetSignal(SIGF_COND_FALLBACK, 0);
-    }
-    waiter.sigbit = signal;
-    sigs |= 1 << waiter.sigbit;
-
-    // add it to the end of the list
-    ObtainSemaphore(&cond->semaphore);
-    AddTail((struct List *)&cond->waiters, (struct Node *)&waiter);
-    ReleaseSemaphore(&cond->semaphore);
+    // count ourselves before taking the sequence number, see
+    // _pthread_cond_broadcast()
+    _atomic_add(&cond->waiters, 1);
+    seq = cond->seq;
+    cond->mutex = mutex;
 
     // wait for the condition to be signalled or the timeout
     mutex->incond++;
     pthread_mutex_unlock(mutex);
-    sigs = Wait(sigs);
-    pthread_mutex_lock(mutex);
-    mutex->incond--;
+    sigs = _futex_wait(&cond->seq, seq, sigs);
 
-    // remove the node from the list
-    ObtainSemaphore(&cond->semaphore);
-    Remove((struct Node *)&waiter);
-    ReleaseSemaphore(&cond->semaphore);
+    // a broadcast may have moved other waiters over to the mutex, so
+    // always lock it as contended to make sure they are woken up
+    while (_atomic_xchg(&mutex->lock, 2) != 0)
+        _futex_wait(&mutex->lock, 2, 0);
+    if (mutex->kind != PTHREAD_MUTEX_NORMAL)
+    {
+        mutex->owner = task;
+        mutex->count = 1;
+    }
+    mutex->incond--;
 
-    if (waiter.sigbit != SIGB_COND_FALLBACK)
-        FreeSignal(waiter.sigbit);
+    _atomic_add(&cond->waiters, -1);
 
     if (abstime)
     {
@@ -116,17 +106,13 @@ int _pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const
         CloseTimerDevice((struct IORequest *)&timerio);
 
         // did we timeout?
-        if (sigs & (1 << timermp.mp_SigBit))
+        if ((sigs & timersig) && !(sigs & SIGF_SINGLE))
             return ETIMEDOUT;
-        else if (sigs & SIGBREAKF_CTRL_C)
-            pthread_testcancel();
-    }
-    else
-    {
-        if (sigs & SIGBREAKF_CTRL_C)
-            pthread_testcancel();
     }
 
+    if (sigs & SIGBREAKF_CTRL_C)
+        pthread_testcancel();
+
     return 0;
 }
 
@@ -25,6 +25,9 @@
 
 #include <stdio.h>
 #include <string.h>
+#ifdef __AROS__
+#include <libraries/stdc.h>
+#endif
 
 #include "pthread_intern.h"
 #include "debug.h"
@@ -130,6 +133,11 @@ static void StarterFunc(void)
     }
     ReleaseSemaphore(&tls_sem);
 
+#ifdef __AROS__
+    // give the memory malloc() keeps cached for this thread back to the C library
+    __stdc_malloc_releasecache();
+#endif
+
     if (!inf->detached)
     {
         // tell the parent thread that we are done
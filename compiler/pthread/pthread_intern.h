@@ -39,6 +39,7 @@
 #endif
 
 #include <setjmp.h>
+#include <limits.h>
 #include <string.h>
 #include <stdio.h>
 #include <signal.h>
@@ -86,9 +87,9 @@
 typedef struct
 {
     struct MinNode node;
+    volatile int *addr;
     struct Task *task;
-    UBYTE sigbit;
-} CondWaiter;
+} FutexWaiter;
 
 typedef struct
 {
@@ -133,6 +134,11 @@ extern int SemaphoreIsMine(struct SignalSemaphore *sem);
 extern ThreadInfo *GetThreadInfo(pthread_t thread);
 extern pthread_t GetThreadId(struct Task *task);
 
+/* .c */
+extern ULONG _futex_wait(volatile int *addr, int val, ULONG sigmask);
+extern int _futex_wake(volatile int *addr, int count);
+extern int _futex_requeue(volatile int *addr, int count, volatile int *addr2);
+
 /* .c */
 extern int _pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime, BOOL relative);
 
@@ -142,6 +148,99 @@ extern int _pthread_cond_broadcast(pthread_cond_t *cond, BOOL onlyfirst);
 /* .c */
 extern int _pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr, BOOL staticinit);
 
+//
+// Atomic operations on the futex words
+//
+
+#if defined __mc68000__
+/* No CAS instruction on m68k */
+static inline int _atomic_cas(volatile int *v, int o, int n)
+{
+    int ret;
+
+    Disable();
+    ret = *v;
+    if (ret == o)
+        *v = n;
+    Enable();
+
+    return ret;
+}
+
+static inline int _atomic_xchg(volatile int *v, int n)
+{
+    int ret;
+
+    Disable();
+    ret = *v;
+    *v = n;
+    Enable();
+
+    return ret;
+}
+
+static inline int _atomic_add(volatile int *v, int n)
+{
+    int ret;
+
+    Disable();
+    ret = *v;
+    *v = ret + n;
+    Enable();
+
+    return ret;
+}
+
+static inline int _atomic_load(volatile int *v)
+{
+    return *v;
+}
+#else
+static inline int _atomic_cas(volatile int *v, int o, int n)
+{
+    __atomic_compare_exchange_n(v, &o, n, FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+
+    return o;
+}
+
+static inline int _atomic_xchg(volatile int *v, int n)
+{
+    return __atomic_exchange_n(v, n, __ATOMIC_ACQ_REL);
+}
+
+static inline int _atomic_add(volatile int *v, int n)
+{
+    return __atomic_fetch_add(v, n, __ATOMIC_ACQ_REL);
+}
+
+static inline int _atomic_load(volatile int *v)
+{
+    return __atomic_load_n(v, __ATOMIC_ACQUIRE);
+}
+#endif
+
+//
+// Mutex lock word: 0 free, 1 locked, 2 locked and there may be waiters
+//
+
+static inline void _mutex_acquire(pthread_mutex_t *mutex)
+{
+    // uncontended case, no exec call
+    if (_atomic_cas(&mutex->lock, 0, 1) == 0)
+        return;
+
+    // mark the mutex contended and sleep until it is released
+    while (_atomic_xchg(&mutex->lock, 2) != 0)
+        _futex_wait(&mutex->lock, 2, 0);
+}
+
+static inline void _mutex_release(pthread_mutex_t *mutex)
+{
+    // wake one waiter if there may be any
+    if (_atomic_xchg(&mutex->lock, 0) == 2)
+        _futex_wake(&mutex->lock, 1);
+}
+
 /* .c */
 extern BOOL OpenTimerDevice(struct IORequest *io, struct MsgPort *mp, struct Task *task);
 extern void CloseTimerDevice(struct IORequest *io);
@@ -34,7 +34,9 @@ int _pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr,
         mutex->kind = attr->kind;
     else if (!staticinit)
         mutex->kind = PTHREAD_MUTEX_DEFAULT;
-    InitSemaphore(&mutex->semaphore);
+    mutex->lock = 0;
+    mutex->owner = NULL;
+    mutex->count = 0;
     mutex->incond = 0;
 
     return 0;
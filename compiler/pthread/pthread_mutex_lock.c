@@ -25,32 +25,34 @@
 
 int pthread_mutex_lock(pthread_mutex_t *mutex)
 {
-    struct SignalSemaphore *sem;
+    struct Task *task = NULL;
 
     D(bug("%s(%p)\n", __FUNCTION__, mutex));
 
     if (mutex == NULL)
         return EINVAL;
 
-    sem = &mutex->semaphore;
-
-    // initialize static mutexes
-    if (SemaphoreIsInvalid(sem))
-        _pthread_mutex_init(mutex, NULL, TRUE);
-
-    // normal mutexes would simply deadlock here
-    if (mutex->kind == PTHREAD_MUTEX_ERRORCHECK && SemaphoreIsMine(sem))
-        return EDEADLK;
+    // normal mutexes don't track their owner and would simply deadlock
+    if (mutex->kind != PTHREAD_MUTEX_NORMAL)
+    {
+        task = GET_THIS_TASK;
+        if (mutex->owner == task)
+        {
+            if (mutex->kind == PTHREAD_MUTEX_ERRORCHECK)
+                return EDEADLK;
+
+            mutex->count++;
+            return 0;
+        }
+    }
 
-    ObtainSemaphore(sem);
+    _mutex_acquire(mutex);
 
-#if 0 // let's just deadlock here, to be compatible with normal mutexes on other platforms
-    if (mutex->kind == PTHREAD_MUTEX_NORMAL && sem->ss_NestCount > 1) {
-        // should have blocked - fix this
-        ReleaseSemaphore(sem);
-        return EDEADLK;
+    if (task)
+    {
+        mutex->owner = task;
+        mutex->count = 1;
     }
-#endif
 
     return 0;
 }
@@ -25,21 +25,34 @@
 
 int pthread_mutex_trylock(pthread_mutex_t *mutex)
 {
-    ULONG ret;
+    struct Task *task = NULL;
 
     D(bug("%s(%p)\n", __FUNCTION__, mutex));
 
     if (mutex == NULL)
         return EINVAL;
 
-    // initialize static mutexes
-    if (SemaphoreIsInvalid(&mutex->semaphore))
-        _pthread_mutex_init(mutex, NULL, TRUE);
+    if (mutex->kind != PTHREAD_MUTEX_NORMAL)
+    {
+        task = GET_THIS_TASK;
+        if (mutex->owner == task)
+        {
+            if (mutex->kind != PTHREAD_MUTEX_RECURSIVE)
+                return EBUSY;
 
-    if (mutex->kind != PTHREAD_MUTEX_RECURSIVE && SemaphoreIsMine(&mutex->semaphore))
+            mutex->count++;
+            return 0;
+        }
+    }
+
+    if (_atomic_cas(&mutex->lock, 0, 1) != 0)
         return EBUSY;
 
-    ret = AttemptSemaphore(&mutex->semaphore);
+    if (task)
+    {
+        mutex->owner = task;
+        mutex->count = 1;
+    }
 
-    return (ret == TRUE) ? 0 : EBUSY;
+    return 0;
 }
@@ -30,14 +30,18 @@ int pthread_mutex_unlock(pthread_mutex_t *mutex)
     if (mutex == NULL)
         return EINVAL;
 
-    // initialize static mutexes
-    if (SemaphoreIsInvalid(&mutex->semaphore))
-        _pthread_mutex_init(mutex, NULL, TRUE);
+    if (mutex->kind != PTHREAD_MUTEX_NORMAL)
+    {
+        if (mutex->owner != GET_THIS_TASK)
+            return EPERM;
 
-    if (mutex->kind != PTHREAD_MUTEX_NORMAL && !SemaphoreIsMine(&mutex->semaphore))
-        return EPERM;
+        if (--mutex->count > 0)
+            return 0;
 
-    ReleaseSemaphore(&mutex->semaphore);
+        mutex->owner = NULL;
+    }
+
+    _mutex_release(mutex);
 
     return 0;
 }
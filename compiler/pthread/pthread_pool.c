@@ -0,0 +1,556 @@
+/*
+  Copyright (C) 2025, The AROS Development Team
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <proto/exec.h>
+#ifdef __AROS__
+#include <proto/kernel.h>
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+
+#include "pthread_intern.h"
+#include "debug.h"
+
+//
+// Process wide thread pool
+//
+// The pool has one worker thread per CPU, started by the first call that
+// needs it. Each worker has its own job queue. A job submitted by a worker
+// goes to the tail of its own queue and the worker takes its jobs from the
+// tail again, so nested jobs run while their data is still in the cache.
+// Idle workers steal from the head of the other queues. Jobs submitted by
+// other tasks, pthreads or plain exec tasks, go to a global queue. Jobs
+// are allocated with AllocVec(), as a plain task has no C library context.
+//
+// Idle workers sleep on the futex word pool.seq, which is bumped after
+// every submission. A worker reads it, registers as a sleeper and checks
+// the queues once more before it goes to sleep, so a job pushed in between
+// either is found or changes the word. Submitting makes no exec call
+// unless there are sleeping workers.
+//
+
+#define POOL_MAXWORKERS 64
+#define POOL_STACKSIZE (128 * 1024)
+
+enum
+{
+    POOL_NONE,
+    POOL_STARTING,
+    POOL_READY,
+    POOL_FAILED
+};
+
+enum
+{
+    FUTURE_PENDING,
+    FUTURE_WAITING,
+    FUTURE_DONE
+};
+
+struct pthread_future
+{
+    struct MinNode node;
+    void *(*func)(void *);
+    void *arg;
+    void *value;
+    volatile int state;
+    int detached;
+};
+
+typedef struct
+{
+    struct MinList jobs;
+    pthread_mutex_t lock;
+    volatile int count;
+} JobQueue;
+
+typedef struct
+{
+    JobQueue queue;
+    pthread_t thread;
+    struct Task *task;
+} PoolWorker;
+
+static struct
+{
+    volatile int state;
+    volatile int seq;
+    volatile int sleepers;
+    volatile int shutdown;
+    volatile int nworkers;
+    JobQueue global;
+    PoolWorker workers[POOL_MAXWORKERS];
+} pool;
+
+typedef struct
+{
+    void (*func)(long first, long last, void *arg);
+    void *arg;
+    long first;
+    long last;
+    long grain;
+    int nchunks;
+    volatile int next;
+    volatile int done;
+    volatile int refs;
+} ParallelFor;
+
+//
+// Job queues
+//
+
+static void InitQueue(JobQueue *q)
+{
+    NEWLIST((struct List *)&q->jobs);
+    q->lock.lock = 0;
+    q->count = 0;
+}
+
+static void PushJob(JobQueue *q, pthread_future_t *job)
+{
+    _mutex_acquire(&q->lock);
+    AddTail((struct List *)&q->jobs, (struct Node *)&job->node);
+    _atomic_add(&q->count, 1);
+    _mutex_release(&q->lock);
+}
+
+static pthread_future_t *PopJob(JobQueue *q, BOOL tail)
+{
+    pthread_future_t *job = NULL;
+
+    // don't take the lock of an empty queue
+    if (_atomic_load(&q->count) == 0)
+        return NULL;
+
+    _mutex_acquire(&q->lock);
+    if (q->count > 0)
+    {
+        if (tail)
+            job = (pthread_future_t *)RemTail((struct List *)&q->jobs);
+        else
+            job = (pthread_future_t *)RemHead((struct List *)&q->jobs);
+        _atomic_add(&q->count, -1);
+    }
+    _mutex_release(&q->lock);
+
+    return job;
+}
+
+static int CurrentWorker(void)
+{
+    struct Task *task;
+    int i, n;
+
+    task = GET_THIS_TASK;
+    n = _atomic_load(&pool.nworkers);
+    for (i = 0; i < n; i++)
+    {
+        if (pool.workers[i].task == task)
+            return i;
+    }
+
+    return -1;
+}
+
+static pthread_future_t *FindJob(int self)
+{
+    pthread_future_t *job = NULL;
+    int i, n;
+
+    if (self >= 0)
+        job = PopJob(&pool.workers[self].queue, TRUE);
+
+    if (job == NULL)
+        job = PopJob(&pool.global, FALSE);
+
+    if (job == NULL)
+    {
+        // steal the oldest job of another worker, starting with the next one
+        n = _atomic_load(&pool.nworkers);
+        for (i = 1; job == NULL && i <= n; i++)
+        {
+            if (self < 0 || i < n)
+                job = PopJob(&pool.workers[(self + i) % n].queue, FALSE);
+        }
+    }
+
+    return job;
+}
+
+static void RunJob(pthread_future_t *job)
+{
+    DB2(bug("%s(%p)\n", __FUNCTION__, job));
+
+    job->value = job->func(job->arg);
+
+    if (job->detached)
+    {
+        FreeVec(job);
+        return;
+    }
+
+    // the waiter may free the future as soon as it is done, the wake up
+    // only uses its address
+    if (_atomic_xchg(&job->state, FUTURE_DONE) == FUTURE_WAITING)
+        _futex_wake(&job->state, INT_MAX);
+}
+
+static void WakeWorkers(int count)
+{
+    _atomic_add(&pool.seq, 1);
+    // read-modify-write, so it can't be ordered before the increment above
+    if (_atomic_add(&pool.sleepers, 0) > 0)
+        _futex_wake(&pool.seq, count);
+}
+
+//
+// Workers
+//
+
+static void *PoolWorkerFunc(void *arg)
+{
+    int self = (int)(IPTR)arg;
+    pthread_future_t *job;
+    int seq;
+
+    D(bug("%s(%d)\n", __FUNCTION__, self));
+
+    pool.workers[self].task = GET_THIS_TASK;
+
+    for (;;)
+    {
+        job = FindJob(self);
+        if (job == NULL)
+        {
+            seq = _atomic_load(&pool.seq);
+            _atomic_add(&pool.sleepers, 1);
+            job = FindJob(self);
+            if (job == NULL && !_atomic_load(&pool.shutdown))
+                _futex_wait(&pool.seq, seq, 0);
+            _atomic_add(&pool.sleepers, -1);
+        }
+
+        if (job != NULL)
+            RunJob(job);
+        else if (_atomic_load(&pool.shutdown))
+            break;
+    }
+
+    return NULL;
+}
+
+static int CPUCount(void)
+{
+#ifdef __AROS__
+    APTR KernelBase = OpenResource("kernel.resource");
+
+    if (KernelBase)
+        return KrnGetCPUCount();
+#endif
+
+    return 1;
+}
+
+static int StartPool(void)
+{
+    pthread_attr_t attr;
+    char name[NAMELEN];
+    size_t stacksize;
+    int state, i, n;
+
+    // someone else may be starting it
+    for (;;)
+    {
+        state = _atomic_cas(&pool.state, POOL_NONE, POOL_STARTING);
+        if (state != POOL_STARTING)
+            break;
+        _futex_wait(&pool.state, POOL_STARTING, 0);
+    }
+
+    if (state == POOL_READY)
+        return 0;
+    if (state == POOL_FAILED)
+        return EAGAIN;
+
+    D(bug("%s()\n", __FUNCTION__));
+
+    n = CPUCount();
+    if (n < 1)
+        n = 1;
+    if (n > POOL_MAXWORKERS)
+        n = POOL_MAXWORKERS;
+
+    InitQueue(&pool.global);
+    for (i = 0; i < n; i++)
+        InitQueue(&pool.workers[i].queue);
+
+    // the starting task may be a plain exec task with a small stack
+    pthread_attr_init(&attr);
+    if (pthread_attr_getstacksize(&attr, &stacksize) == 0 && stacksize < POOL_STACKSIZE)
+        pthread_attr_setstacksize(&attr, POOL_STACKSIZE);
+
+    for (i = 0; i < n; i++)
+    {
+        if (pthread_create(&pool.workers[i].thread, &attr, PoolWorkerFunc, (void *)(IPTR)i) != 0)
+            break;
+        snprintf(name, sizeof(name), "pthread pool %d", i);
+        pthread_setname_np(pool.workers[i].thread, name);
+        _atomic_add(&pool.nworkers, 1);
+    }
+
+    pthread_attr_destroy(&attr);
+
+    D(bug("%s() started %d of %d workers\n", __FUNCTION__, i, n));
+
+    _atomic_xchg(&pool.state, i > 0 ? POOL_READY : POOL_FAILED);
+    _futex_wake(&pool.state, INT_MAX);
+
+    return i > 0 ? 0 : EAGAIN;
+}
+
+//
+// Non-portable thread pool functions
+//
+
+int pthread_pool_size_np(void)
+{
+    D(bug("%s()\n", __FUNCTION__));
+
+    if (StartPool() != 0)
+        return 0;
+
+    return _atomic_load(&pool.nworkers);
+}
+
+int pthread_pool_submit_np(pthread_future_t **future, void *(*func)(void *), void *arg)
+{
+    pthread_future_t *job;
+    int self;
+
+    D(bug("%s(%p, %p, %p)\n", __FUNCTION__, future, func, arg));
+
+    if (func == NULL)
+        return EINVAL;
+
+    job = AllocVec(sizeof(pthread_future_t), MEMF_ANY);
+    if (job == NULL)
+        return ENOMEM;
+
+    job->func = func;
+    job->arg = arg;
+    job->value = NULL;
+    job->state = FUTURE_PENDING;
+    job->detached = (future == NULL);
+
+    if (future != NULL)
+        *future = job;
+
+    // without workers the job runs right away
+    if (StartPool() != 0 || _atomic_load(&pool.shutdown))
+    {
+        RunJob(job);
+        return 0;
+    }
+
+    self = CurrentWorker();
+    PushJob(self >= 0 ? &pool.workers[self].queue : &pool.global, job);
+    WakeWorkers(1);
+
+    return 0;
+}
+
+int pthread_future_done_np(pthread_future_t *future)
+{
+    D(bug("%s(%p)\n", __FUNCTION__, future));
+
+    if (future == NULL)
+        return 0;
+
+    return _atomic_load(&future->state) == FUTURE_DONE;
+}
+
+int pthread_future_wait_np(pthread_future_t *future, void **value)
+{
+    pthread_future_t *job;
+    int self;
+
+    D(bug("%s(%p, %p)\n", __FUNCTION__, future, value));
+
+    if (future == NULL)
+        return EINVAL;
+
+    self = CurrentWorker();
+
+    while (_atomic_load(&future->state) != FUTURE_DONE)
+    {
+        // a worker runs other jobs instead of blocking, other tasks may
+        // not have the stack for them
+        if (self >= 0 && (job = FindJob(self)) != NULL)
+        {
+            RunJob(job);
+            continue;
+        }
+
+        if (_atomic_cas(&future->state, FUTURE_PENDING, FUTURE_WAITING) != FUTURE_DONE)
+            _futex_wait(&future->state, FUTURE_WAITING, 0);
+    }
+
+    if (value != NULL)
+        *value = future->value;
+
+    FreeVec(future);
+
+    return 0;
+}
+
+//
+// Parallel loops
+//
+
+static void RunChunks(ParallelFor *pf)
+{
+    long first, last;
+    int chunk, ran = 0;
+
+    while ((chunk = _atomic_add(&pf->next, 1)) < pf->nchunks)
+    {
+        first = (long)((unsigned long)pf->first + (unsigned long)chunk * pf->grain);
+        last = (chunk == pf->nchunks - 1) ? pf->last : first + pf->grain;
+        pf->func(first, last, pf->arg);
+        ran++;
+    }
+
+    if (ran > 0 && _atomic_add(&pf->done, ran) + ran == pf->nchunks)
+        _futex_wake(&pf->done, 1);
+}
+
+static void ReleaseParallelFor(ParallelFor *pf)
+{
+    if (_atomic_add(&pf->refs, -1) == 1)
+        FreeVec(pf);
+}
+
+static void *ParallelForJob(void *arg)
+{
+    ParallelFor *pf = arg;
+
+    RunChunks(pf);
+    ReleaseParallelFor(pf);
+
+    return NULL;
+}
+
+int pthread_parallel_for_np(long first, long last, long grain, void (*func)(long first, long last, void *arg), void *arg)
+{
+    ParallelFor *pf;
+    unsigned long count, chunks;
+    int workers, helpers, done, i;
+
+    D(bug("%s(%ld, %ld, %ld, %p, %p)\n", __FUNCTION__, first, last, grain, func, arg));
+
+    if (func == NULL || grain < 0)
+        return EINVAL;
+
+    if (last <= first)
+        return 0;
+
+    count = (unsigned long)last - (unsigned long)first;
+    workers = pthread_pool_size_np();
+
+    // a few chunks per thread evens out chunks of different cost
+    if (grain == 0)
+        grain = (count + (workers + 1) * 4 - 1) / ((workers + 1) * 4);
+    if (count / grain >= INT_MAX)
+        grain = count / (INT_MAX - 1) + 1;
+    chunks = (count + grain - 1) / grain;
+
+    if (workers == 0 || chunks == 1)
+    {
+        for (; count > (unsigned long)grain; count -= grain, first += grain)
+            func(first, first + grain, arg);
+        func(first, last, arg);
+        return 0;
+    }
+
+    pf = AllocVec(sizeof(ParallelFor), MEMF_ANY);
+    if (pf == NULL)
+        return ENOMEM;
+
+    helpers = (chunks - 1 < workers) ? chunks - 1 : workers;
+
+    pf->func = func;
+    pf->arg = arg;
+    pf->first = first;
+    pf->last = last;
+    pf->grain = grain;
+    pf->nchunks = chunks;
+    pf->next = 0;
+    pf->done = 0;
+    pf->refs = helpers + 1;
+
+    // the helpers that find no chunk left just drop their reference
+    for (i = 0; i < helpers; i++)
+    {
+        if (pthread_pool_submit_np(NULL, ParallelForJob, pf) != 0)
+            _atomic_add(&pf->refs, -1);
+    }
+
+    RunChunks(pf);
+
+    while ((done = _atomic_load(&pf->done)) != pf->nchunks)
+        _futex_wait(&pf->done, done, 0);
+
+    ReleaseParallelFor(pf);
+
+    return 0;
+}
+
+//
+// Exit function
+//
+
+static void __pthread_pool_Exit_Func(void)
+{
+    int i, n;
+
+    DB2(bug("%s()\n", __FUNCTION__));
+
+    if (pool.state != POOL_READY)
+        return;
+
+    // the workers finish the queued jobs before they exit
+    n = _atomic_load(&pool.nworkers);
+    _atomic_xchg(&pool.shutdown, 1);
+    WakeWorkers(n);
+
+    for (i = 0; i < n; i++)
+        pthread_join(pool.workers[i].thread, NULL);
+}
+
+// runs before __pthread_Exit_Func(), which waits for all threads
+#if defined(__AROS__) || (defined(__AMIGA__) && !defined(__MORPHOS__))
+ADD2EXIT(__pthread_pool_Exit_Func, 1);
+#else
+static DESTRUCTOR_P(__pthread_pool_Exit_Func, 101)
+{
+    __pthread_pool_Exit_Func();
+}
+#endif
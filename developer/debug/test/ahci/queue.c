@@ -0,0 +1,317 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Test of the ahci.device request queue against a simulated port
+*/
+
+/*
+ * The queue code is built into this program, and the functions it uses
+ * to talk to the port are replaced by a simulation that hands out a
+ * given set of command slots and records the commands issued to them.
+ * Commands only complete when the test says so, which lets it check the
+ * order requests are taken in, how they are merged, and that no more
+ * commands are issued than there are free slots.
+ */
+
+#include "ahci_queue.c"
+
+#include <dos/dos.h>
+
+#include <string.h>
+
+#define SIM_SECTOR      512
+#define SIM_SLOTS       4
+#define SIM_REQUESTS    24
+#define SIM_COMMANDS    64
+
+static struct ahci_port sim_port;
+static struct ata_port sim_at;
+static struct ahci_ccb sim_ccb[SIM_SLOTS];
+static struct ata_fis_h2d sim_fis[SIM_SLOTS];
+static ULONG sim_free;                  /* Slots the port may hand out */
+static u_int64_t sim_lba[SIM_SLOTS];
+static u_int32_t sim_count[SIM_SLOTS];
+static int sim_order[SIM_COMMANDS];     /* Slots in the order commands were issued */
+static int sim_issued, sim_seen;
+
+static struct cam_sim sim_unit;
+static struct MsgPort *sim_reply;
+static struct IOStdReq sim_io[SIM_REQUESTS];
+static UBYTE sim_buffer[SIM_SECTOR];
+
+#define CHECK(x) \
+    do { \
+        if (!(x)) { \
+            printf("%s, line %d: %s failed\n", __FILE__, __LINE__, #x); \
+            return FALSE; \
+        } \
+    } while (0)
+
+#define CHECK_CMD(tag, dir, lba, count, nsg) \
+    CHECK((tag) >= 0 && \
+          (sim_ccb[tag].ccb_xa.flags & (ATA_F_READ | ATA_F_WRITE)) == (dir) && \
+          sim_lba[tag] == (lba) && sim_count[tag] == (count) && \
+          sim_ccb[tag].ccb_nsg == (nsg))
+
+/*** Simulated port *********************************************************/
+
+struct ata_xfer *ahci_ata_get_xfer(struct ahci_port *ap, struct ata_port *at)
+{
+    struct ahci_ccb *ccb;
+    int slot;
+
+    for (slot = 0; slot < SIM_SLOTS; slot++) {
+        if (sim_free & (1 << slot))
+            break;
+    }
+    if (slot == SIM_SLOTS)
+        return NULL;
+    sim_free &= ~(1 << slot);
+
+    ccb = &sim_ccb[slot];
+    memset(&sim_fis[slot], 0, sizeof(sim_fis[slot]));
+    ccb->ccb_xa.fis = &sim_fis[slot];
+    ccb->ccb_xa.tag = slot;
+    ccb->ccb_xa.at = at;
+    ccb->ccb_xa.state = ATA_S_SETUP;
+    ccb->ccb_nsg = 0;
+
+    return &ccb->ccb_xa;
+}
+
+void ahci_ata_put_xfer(struct ata_xfer *xa)
+{
+    sim_free |= 1 << xa->tag;
+}
+
+void ahci_ata_rw_fis(struct ata_xfer *xa, u_int64_t lba, u_int32_t count)
+{
+    sim_lba[xa->tag] = lba;
+    sim_count[xa->tag] = count;
+}
+
+int ahci_ata_cmd(struct ata_xfer *xa)
+{
+    xa->state = ATA_S_PENDING;
+    if (sim_issued < SIM_COMMANDS)
+        sim_order[sim_issued++] = xa->tag;
+
+    return ATA_S_PENDING;
+}
+
+void ahci_os_lock_port(struct ahci_port *ap)
+{
+}
+
+void ahci_os_unlock_port(struct ahci_port *ap)
+{
+}
+
+/*** Helpers ****************************************************************/
+
+/* Queue a request for a number of sectors, like BeginIO() does */
+static void sim_queue(int i, UWORD cmd, UQUAD lba, ULONG sectors)
+{
+    struct IOStdReq *io = &sim_io[i];
+
+    memset(io, 0, sizeof(*io));
+    io->io_Message.mn_ReplyPort = sim_reply;
+    io->io_Message.mn_Length = sizeof(*io);
+    io->io_Unit = (struct Unit *)&sim_unit;
+    io->io_Command = cmd;
+    io->io_Data = sim_buffer;
+    io->io_Length = sectors * SIM_SECTOR;
+
+    ObtainSemaphore(&sim_unit.sim_Lock);
+    AddTail(&sim_unit.sim_IOs, &io->io_Message.mn_Node);
+    ReleaseSemaphore(&sim_unit.sim_Lock);
+
+    ahci_queue_rw((struct IORequest *)io, lba * SIM_SECTOR);
+}
+
+/* Slot of the next command issued to the port, or -1 if there is none */
+static int sim_next(void)
+{
+    if (sim_seen == sim_issued)
+        return -1;
+    return sim_order[sim_seen++];
+}
+
+/* Finish the command in a slot, as the port interrupt would */
+static void sim_complete(int tag, int state)
+{
+    struct ata_xfer *xa = &sim_ccb[tag].ccb_xa;
+
+    xa->state = state;
+    xa->complete(xa);
+}
+
+/* Number of replied requests, or -1 if one has an unexpected result */
+static int sim_replies(BYTE error)
+{
+    struct IOStdReq *io;
+    int count = 0;
+
+    while ((io = (struct IOStdReq *)GetMsg(sim_reply))) {
+        if (io->io_Error != error)
+            return -1;
+        if (io->io_Actual != (error ? 0 : io->io_Length))
+            return -1;
+        count++;
+    }
+
+    return count;
+}
+
+/*** Tests ******************************************************************/
+
+static BOOL test_order(void)
+{
+    int t1, t2, t3, t4;
+
+    /* Everything waits while the port is busy */
+    sim_free = 0;
+    sim_queue(0, CMD_READ, 100, 8);
+    sim_queue(1, CMD_READ, 10, 8);
+    sim_queue(2, CMD_READ, 50, 8);
+    sim_queue(3, CMD_READ, 18, 8);
+    sim_queue(4, CMD_WRITE, 26, 8);
+    sim_queue(5, TD_READ64, 200, 8);
+    CHECK(sim_next() == -1);
+
+    /* Two slots: the adjacent reads are merged, the write is not */
+    sim_free = (1 << 0) | (1 << 1);
+    ahci_queue_dispatch(&sim_unit);
+    t1 = sim_next();
+    CHECK_CMD(t1, ATA_F_READ, 10, 16, 2);
+    t2 = sim_next();
+    CHECK_CMD(t2, ATA_F_WRITE, 26, 8, 1);
+    CHECK(sim_next() == -1);
+
+    /* Each completion frees a slot for the next request upwards */
+    sim_complete(t1, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 2);
+    t3 = sim_next();
+    CHECK_CMD(t3, ATA_F_READ, 50, 8, 1);
+
+    sim_complete(t2, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 1);
+    t4 = sim_next();
+    CHECK_CMD(t4, ATA_F_READ, 100, 8, 1);
+
+    /* A request behind the elevator waits for the sweep to wrap */
+    sim_queue(6, CMD_READ, 5, 1);
+    CHECK(sim_next() == -1);
+
+    sim_complete(t3, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 1);
+    t1 = sim_next();
+    CHECK_CMD(t1, ATA_F_READ, 200, 8, 1);
+
+    sim_complete(t4, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 1);
+    t2 = sim_next();
+    CHECK_CMD(t2, ATA_F_READ, 5, 1, 1);
+
+    sim_complete(t1, ATA_S_COMPLETE);
+    sim_complete(t2, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 2);
+    CHECK(sim_next() == -1);
+    CHECK(IsListEmpty(&sim_unit.sim_Queue));
+    CHECK(sim_free == ((1 << 0) | (1 << 1)));
+
+    return TRUE;
+}
+
+static BOOL test_limits(void)
+{
+    int i, t;
+
+    /* No more buffers than a CCB's scatter list holds */
+    sim_free = 0;
+    for (i = 19; i >= 0; i--)
+        sim_queue(i, CMD_READ, 1000 + i, 1);
+
+    sim_free = 1 << 0;
+    ahci_queue_dispatch(&sim_unit);
+    t = sim_next();
+    CHECK_CMD(t, ATA_F_READ, 1000, AHCI_MAX_SGMERGE, AHCI_MAX_SGMERGE);
+    CHECK(sim_next() == -1);
+
+    sim_complete(t, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == AHCI_MAX_SGMERGE);
+    t = sim_next();
+    CHECK_CMD(t, ATA_F_READ, 1000 + AHCI_MAX_SGMERGE, 20 - AHCI_MAX_SGMERGE,
+              20 - AHCI_MAX_SGMERGE);
+
+    sim_complete(t, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 20 - AHCI_MAX_SGMERGE);
+
+    /* No more sectors than one command can transfer */
+    sim_free = 0;
+    sim_queue(0, CMD_READ, 0x20000, 0xFFF0);
+    sim_queue(1, CMD_READ, 0x20000 + 0xFFF0, 0x20);
+
+    sim_free = 1 << 0;
+    ahci_queue_dispatch(&sim_unit);
+    t = sim_next();
+    CHECK_CMD(t, ATA_F_READ, 0x20000, 0xFFF0, 1);
+
+    sim_complete(t, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 1);
+    t = sim_next();
+    CHECK_CMD(t, ATA_F_READ, 0x20000 + 0xFFF0, 0x20, 1);
+
+    sim_complete(t, ATA_S_COMPLETE);
+    CHECK(sim_replies(0) == 1);
+    CHECK(sim_next() == -1);
+
+    return TRUE;
+}
+
+static BOOL test_error(void)
+{
+    int t;
+
+    /* A failed command fails every request merged into it */
+    sim_free = 0;
+    sim_queue(0, CMD_WRITE, 300, 2);
+    sim_queue(1, CMD_WRITE, 302, 2);
+
+    sim_free = 1 << 0;
+    ahci_queue_dispatch(&sim_unit);
+    t = sim_next();
+    CHECK_CMD(t, ATA_F_WRITE, 300, 4, 2);
+
+    sim_complete(t, ATA_S_ERROR);
+    CHECK(sim_replies(TDERR_SeekError) == 2);
+    CHECK(sim_next() == -1);
+    CHECK(sim_free == (1 << 0));
+
+    return TRUE;
+}
+
+int main(void)
+{
+    BOOL ok;
+
+    sim_reply = CreateMsgPort();
+    if (!sim_reply)
+        return RETURN_FAIL;
+
+    sim_at.at_type = ATA_PORT_T_DISK;
+    sim_at.at_ahci_port = &sim_port;
+    sim_at.at_identify.sector_size = SIM_SECTOR;
+    sim_port.ap_ata[0] = &sim_at;
+
+    sim_unit.sim_Port = &sim_port;
+    InitSemaphore(&sim_unit.sim_Lock);
+    NEWLIST(&sim_unit.sim_IOs);
+    ahci_queue_init(&sim_unit);
+
+    ok = test_order() && test_limits() && test_error();
+
+    DeleteMsgPort(sim_reply);
+
+    return ok ? RETURN_OK : RETURN_FAIL;
+}
@@ -0,0 +1,162 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+*/
+
+#include <sys/time.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <exec/types.h>
+
+#define COUNT       1000000
+#define SLOTS       1024
+#define THREADS     4
+
+static double elapsed(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.0;
+}
+
+static void report(const char *name, struct timeval *start, struct timeval *end, long count)
+{
+    double secs = elapsed(start, end);
+
+    printf
+    (
+        "%s\n"
+        "Elapsed time:            %f seconds\n"
+        "Operations per second:   %f\n\n",
+        name, secs, (double) count / secs
+    );
+}
+
+/* Simple pseudo random sizes, biased towards small blocks */
+static size_t next_size(unsigned int *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+
+    switch ((*seed >> 16) & 7)
+    {
+    case 0:
+        return (*seed >> 8) % 4096;
+    case 1:
+        return (*seed >> 8) % 1024;
+    default:
+        return (*seed >> 8) % 128;
+    }
+}
+
+/* malloc()/free() of the same size in a tight loop */
+static void bench_pair(void)
+{
+    struct timeval tv_start, tv_end;
+    int i;
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < COUNT; i++)
+        free(malloc(64));
+    gettimeofday(&tv_end, NULL);
+
+    report("malloc(64)/free()", &tv_start, &tv_end, COUNT);
+}
+
+/* Random sizes, blocks live for a while before being freed */
+static void *bench_mixed(void *arg)
+{
+    void **slots = calloc(SLOTS, sizeof(void *));
+    unsigned int seed = (unsigned int)(IPTR)arg;
+    int i, slot;
+
+    for (i = 0; i < COUNT; i++)
+    {
+        slot = (seed >> 4) % SLOTS;
+        free(slots[slot]);
+        slots[slot] = malloc(next_size(&seed));
+    }
+
+    for (i = 0; i < SLOTS; i++)
+        free(slots[i]);
+    free(slots);
+
+    return NULL;
+}
+
+/* Growing buffers, like a string builder */
+static void bench_realloc(void)
+{
+    struct timeval tv_start, tv_end;
+    char *buf;
+    int i, j;
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < COUNT / 1000; i++)
+    {
+        buf = NULL;
+        for (j = 1; j <= 1000; j++)
+            buf = realloc(buf, j * 8);
+        free(buf);
+    }
+    gettimeofday(&tv_end, NULL);
+
+    report("realloc() in 8 byte steps", &tv_start, &tv_end, COUNT);
+}
+
+/* Blocks are allocated in one thread and freed in another */
+static void *producer_consumer(void *arg)
+{
+    void **ring = arg;
+    int i;
+
+    for (i = 0; i < COUNT; i++)
+    {
+        void *old = __atomic_exchange_n(&ring[i % SLOTS], malloc(48), __ATOMIC_ACQ_REL);
+
+        free(old);
+    }
+
+    return NULL;
+}
+
+int main()
+{
+    struct timeval tv_start, tv_end;
+    pthread_t threads[THREADS];
+    void **ring;
+    int i;
+
+    bench_pair();
+
+    gettimeofday(&tv_start, NULL);
+    bench_mixed((void *)1);
+    gettimeofday(&tv_end, NULL);
+    report("Random sizes, 1 thread", &tv_start, &tv_end, COUNT);
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < THREADS; i++)
+        pthread_create(&threads[i], NULL, bench_mixed, (void *)(IPTR)(i + 1));
+    for (i = 0; i < THREADS; i++)
+        pthread_join(threads[i], NULL);
+    gettimeofday(&tv_end, NULL);
+    report("Random sizes, 4 threads", &tv_start, &tv_end, (long)COUNT * THREADS);
+
+    bench_realloc();
+
+    ring = calloc(SLOTS, sizeof(void *));
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < 2; i++)
+        pthread_create(&threads[i], NULL, producer_consumer, ring);
+    for (i = 0; i < 2; i++)
+        pthread_join(threads[i], NULL);
+    gettimeofday(&tv_end, NULL);
+    report("Cross-thread free, 2 threads", &tv_start, &tv_end, (long)COUNT * 2);
+    for (i = 0; i < SLOTS; i++)
+        free(ring[i]);
+    free(ring);
+
+    malloc_stats();
+
+    return 0;
+}
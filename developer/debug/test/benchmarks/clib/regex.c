@@ -0,0 +1,113 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+*/
+
+#include <sys/time.h>
+#include <regex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOGSIZE     (4 * 1024 * 1024)
+#define PASSES      4
+
+static const char *patterns[] =
+{
+    "timeout",
+    "error|warning",
+    "^[0-9]+:[0-9]+ .*failed",
+    "(read|write)[0-9]{2,3}$",
+    "[[:<:]]disk[0-9][[:>:]]",
+};
+
+static double elapsed(struct timeval *start, struct timeval *end)
+{
+    return ((double)(((end->tv_sec * 1000000) + end->tv_usec)
+            - ((start->tv_sec * 1000000) + start->tv_usec)))/1000000.0;
+}
+
+static void report(const char *name, struct timeval *start, struct timeval *end, long bytes, int lines)
+{
+    double secs = elapsed(start, end);
+
+    printf
+    (
+        "%s\n"
+        "Matching lines:          %d\n"
+        "Elapsed time:            %f seconds\n"
+        "Megabytes per second:    %f\n\n",
+        name, lines, secs, (double) bytes / secs / (1024 * 1024)
+    );
+}
+
+/* A log with lines of random text and a few words the patterns look for */
+static char *make_log(void)
+{
+    static const char *words[] = { "timeout", "error", "disk0", "write12", "failed" };
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789 :.,";
+    char *log = malloc(LOGSIZE + 1);
+    unsigned int seed = 1;
+    int pos = 0, len, i;
+
+    if (log == NULL)
+        return NULL;
+
+    while (pos < LOGSIZE - 200)
+    {
+        seed = seed * 1103515245 + 12345;
+        len = 40 + (seed >> 8) % 60;
+        pos += sprintf(log + pos, "%u:%u ", (seed >> 8) % 24, (seed >> 12) % 60);
+        for (i = 0; i < len; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            log[pos++] = alphabet[(seed >> 8) % (sizeof(alphabet) - 1)];
+        }
+        if ((seed >> 16) % 50 == 0)
+            pos += sprintf(log + pos, " %s", words[(seed >> 4) % 5]);
+        log[pos++] = '\n';
+    }
+    log[pos] = '\0';
+
+    return log;
+}
+
+int main()
+{
+    struct timeval tv_start, tv_end;
+    regmatch_t match;
+    regex_t re;
+    char *log = make_log(), *line, *eol;
+    int i, pass, lines;
+
+    if (log == NULL)
+        return 1;
+
+    for (i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+    {
+        if (regcomp(&re, patterns[i], REG_EXTENDED | REG_NEWLINE | REG_NOSUB) != 0)
+            return 1;
+
+        /* Line by line, like grep */
+        gettimeofday(&tv_start, NULL);
+        for (pass = 0; pass < PASSES; pass++)
+        {
+            lines = 0;
+            for (line = log; *line; line = eol + 1)
+            {
+                eol = strchr(line, '\n');
+                match.rm_so = 0;
+                match.rm_eo = eol - line;
+                if (regexec(&re, line, 0, &match, REG_STARTEND) == 0)
+                    lines++;
+            }
+        }
+        gettimeofday(&tv_end, NULL);
+        report(patterns[i], &tv_start, &tv_end, (long)strlen(log) * PASSES, lines);
+
+        regfree(&re);
+    }
+
+    free(log);
+
+    return 0;
+}
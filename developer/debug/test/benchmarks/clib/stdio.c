@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2008, The AROS Development Team. All rights reserved.
+    Copyright (C) 2008-2025, The AROS Development Team. All rights reserved.
 */
 
 #include "benchmark.h"
@@ -64,6 +64,24 @@ int main() {
         remove("T:__test__");
     }
 
+    if((file = fopen("T:__test__", "w+")))
+    {
+        printf("Benchmarking getc()/putc() ...\n");
+
+        #define BENCHMARK(z, n, c) putc('a' + n, file);
+        BENCHMARK_OPERATION(putc,10000000);
+        #undef BENCHMARK
+
+        fseek(file, 0, SEEK_SET);
+
+        #define BENCHMARK(z, n, c) getc(file);
+        BENCHMARK_OPERATION(getc,10000000);
+        #undef BENCHMARK
+
+        fclose(file);
+        remove("T:__test__");
+    }
+
     if (buffer)
         free(buffer);
 
@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2008-2014, The AROS Development Team. All rights reserved.
+    Copyright (C) 2008-2025, The AROS Development Team. All rights reserved.
 */
 
 #include "benchmark.h"
@@ -43,6 +43,26 @@ int main()
     BENCHMARK_BUFFER(strlen,1000, BUFSIZE);
     #undef BENCHMARK
     
+    #define BENCHMARK(z, n, c) do { char *res ## n = strchr(dst, 'b'); res ## n = NULL; (void)res ## n; } while (0);
+    BENCHMARK_BUFFER(strchr,1000, BUFSIZE);
+    #undef BENCHMARK
+    
+    #define BENCHMARK(z, n, c) do { int res ## n = strcmp(dst, src); res ## n = 0; (void)res ## n; } while (0);
+    memset(src, 'a', BUFSIZE);
+    src[BUFSIZE - 1] = '\0';
+    BENCHMARK_BUFFER(strcmp,1000, BUFSIZE);
+    #undef BENCHMARK
+    
+    /* Short strings at odd addresses, the common case */
+    #define BENCHMARK(z, n, c) do { int res ## n = strlen(dst + 1 + (n & 7)); res ## n = 0; (void)res ## n; } while (0);
+    dst[24] = '\0';
+    BENCHMARK_OPERATION(strlen_short,10000000);
+    #undef BENCHMARK
+    
+    #define BENCHMARK(z, n, c) do { int res ## n = memcmp(dst + 1, src + 3, 20); res ## n = 0; (void)res ## n; } while (0);
+    BENCHMARK_OPERATION(memcmp_short,10000000);
+    #undef BENCHMARK
+    
     #define BENCHMARK(z, n, c) strncpy(dst, src, BUFSIZE);
     memset(src, 'a', BUFSIZE);
     memset(dst, 'a', BUFSIZE);
@@ -0,0 +1,175 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Overhead of the ways to call a method of an OOP object, for the
+          single interface (HIDD) and the multiple interface metaclass.
+*/
+
+#include <sys/time.h>
+#include <stdio.h>
+
+#include <exec/types.h>
+#include <oop/oop.h>
+#include <utility/tagitem.h>
+
+#include <proto/exec.h>
+#include <proto/oop.h>
+
+#define IID_SITest      "Benchmark.SITest"
+#define IID_MITest      "Benchmark.MITest"
+
+struct Test_DATA
+{
+    ULONG td_Dummy1,
+          td_Dummy2;
+};
+
+struct Library *OOPBase;
+
+static IPTR Test__Dummy(OOP_Class *cl, OOP_Object *o, OOP_Msg msg)
+{
+    struct Test_DATA *data = OOP_INST_DATA(cl, o);
+
+    /*
+        Need to do *something* so that the compiler doesn't optimize away
+        this function call completely...
+    */
+    data->td_Dummy1 += data->td_Dummy2;
+
+    return TRUE;
+}
+
+static const struct OOP_MethodDescr Test_mdescr[] =
+{
+    { Test__Dummy, 0 },
+    { NULL       , 0 }
+};
+
+static OOP_Class *MakeClass(CONST_STRPTR meta, CONST_STRPTR iid)
+{
+    OOP_AttrBase MetaAttrBase = OOP_ObtainAttrBase(IID_Meta);
+    struct OOP_InterfaceDescr ifdescr[] =
+    {
+        { Test_mdescr, iid , 1 },
+        { NULL       , NULL, 0 }
+    };
+    struct TagItem tags[] =
+    {
+        { aMeta_SuperID       , (IPTR)CLID_Root                },
+        { aMeta_InterfaceDescr, (IPTR)ifdescr                  },
+        { aMeta_InstSize      , (IPTR)sizeof(struct Test_DATA) },
+        { TAG_DONE            , 0                              }
+    };
+    OOP_Class *cl;
+
+    if (!MetaAttrBase)
+        return NULL;
+
+    cl = OOP_NewObject(NULL, meta, tags);
+
+    OOP_ReleaseAttrBase(IID_Meta);
+
+    return cl;
+}
+
+static void Report(const char *what, struct timeval *tv_start, struct timeval *tv_end, int count)
+{
+    double elapsed;
+
+    elapsed = ((double)(((tv_end->tv_sec * 1000000) + tv_end->tv_usec)
+            - ((tv_start->tv_sec * 1000000) + tv_start->tv_usec)))/1000000.0;
+
+    printf
+    (
+        "%s\n"
+        "    Elapsed time:          %f seconds\n"
+        "    Calls per second:      %f\n"
+        "    Nanoseconds per call:  %f\n",
+        what, elapsed, (double) count / elapsed, (double) elapsed * 1000000000.0 / count
+    );
+}
+
+static void Run(const char *name, OOP_Class *cl, CONST_STRPTR iid)
+{
+    struct timeval          tv_start,
+                            tv_end;
+    int                     count   = 10000000;
+    OOP_Object             *object;
+    OOP_MethodID            mid;
+    OOP_MethodFunc          func;
+    OOP_Class              *funccl;
+    struct OOP_MethodCache  cache   = { 0 };
+    char                    what[80];
+    int                     i;
+
+    object = OOP_NewObject(cl, NULL, NULL);
+    if (!object)
+    {
+        printf("Could not create %s object\n", name);
+        return;
+    }
+    mid = OOP_GetMethodID(iid, 0);
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < count; i++)
+    {
+        OOP_DoMethod(object, &mid);
+    }
+    gettimeofday(&tv_end, NULL);
+    snprintf(what, sizeof(what), "%s, OOP_DoMethod():", name);
+    Report(what, &tv_start, &tv_end, count);
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < count; i++)
+    {
+        OOP_DoCachedMethod(&cache, object, &mid);
+    }
+    gettimeofday(&tv_end, NULL);
+    snprintf(what, sizeof(what), "%s, OOP_DoCachedMethod():", name);
+    Report(what, &tv_start, &tv_end, count);
+
+    func = OOP_GetMethod(object, mid, &funccl);
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < count; i++)
+    {
+        func(funccl, object, &mid);
+    }
+    gettimeofday(&tv_end, NULL);
+    snprintf(what, sizeof(what), "%s, OOP_GetMethod() pointer:", name);
+    Report(what, &tv_start, &tv_end, count);
+
+    OOP_DisposeObject(object);
+}
+
+/*** Main *******************************************************************/
+int main()
+{
+    OOP_Class *sicl, *micl;
+
+    OOPBase = OpenLibrary("oop.library", 44);
+    if (!OOPBase)
+    {
+        printf("Could not open oop.library v44\n");
+        return 20;
+    }
+
+    sicl = MakeClass(CLID_SIMeta, IID_SITest);
+    micl = MakeClass(CLID_MIMeta, IID_MITest);
+
+    if (sicl && micl)
+    {
+        Run("Single interface class", sicl, IID_SITest);
+        Run("Multiple interface class", micl, IID_MITest);
+    }
+    else
+        printf("Could not create Test classes!\n");
+
+    if (sicl)
+        OOP_DisposeObject((OOP_Object *)sicl);
+    if (micl)
+        OOP_DisposeObject((OOP_Object *)micl);
+
+    CloseLibrary(OOPBase);
+
+    return 0;
+}
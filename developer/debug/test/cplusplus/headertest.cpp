@@ -155,6 +155,7 @@
 #include <aros/posixc/stdio.h>
 #include <aros/posixc/stdlib.h>
 #include <aros/posixc/string.h>
+#include <aros/posixc/sys/mman.h>
 #include <aros/posixc/sys/mount.h>
 #include <aros/posixc/sys/param.h>
 #include <aros/posixc/sys/resource.h>
@@ -0,0 +1,127 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Maps a file in the different ways mmap() supports and checks
+          which changes are seen by the other mappings and in the file.
+*/
+
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "test.h"
+
+#define FILENAME    "T:mmap.dat"
+#define FILESIZE    (3 * PAGESIZE + 100)
+
+static int fd = -1;
+static char data[FILESIZE];
+
+/* Checks the file contents at offset through the file descriptor */
+static int filehas(off_t offset, const char *str)
+{
+    char buf[10];
+    int len = strlen(str);
+
+    return lseek(fd, offset, SEEK_SET) == offset
+        && read(fd, buf, len) == len
+        && memcmp(buf, str, len) == 0;
+}
+
+int main(void)
+{
+    char *ro, *ro2, *ro3, *shared, *priv, *anon, *sub;
+    int i;
+
+    for (i = 0; i < FILESIZE; i++)
+        data[i] = 'a' + i % 26;
+
+    fd = open(FILENAME, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    TEST(fd != -1);
+    TEST(write(fd, data, FILESIZE) == FILESIZE);
+    TEST(lseek(fd, 10, SEEK_SET) == 10);
+
+    /* Read only mappings of the same range share the memory */
+    ro = mmap(NULL, FILESIZE, PROT_READ, MAP_SHARED, fd, 0);
+    TEST(ro != MAP_FAILED);
+    TEST(memcmp(ro, data, FILESIZE) == 0);
+    for (i = FILESIZE; i < 4 * PAGESIZE; i++)
+        TESTFALSE(ro[i] == 0);
+    ro2 = mmap(NULL, PAGESIZE, PROT_READ, MAP_PRIVATE, fd, PAGESIZE);
+    TEST(ro2 == ro + PAGESIZE);
+    ro3 = mmap(NULL, PAGESIZE, PROT_READ, MAP_SHARED, fd, PAGESIZE);
+    TEST(ro3 == ro2);
+    TEST(munmap(ro3, PAGESIZE) == 0);
+    TEST(memcmp(ro2, data + PAGESIZE, PAGESIZE) == 0);
+    TEST(lseek(fd, 0, SEEK_CUR) == 10);
+
+    /* Changes to a shared mapping are seen by the others and written back */
+    shared = mmap(NULL, 2 * PAGESIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, PAGESIZE);
+    TEST(shared != MAP_FAILED);
+    memcpy(shared + 5, "SHARED", 6);
+    TEST(memcmp(ro2 + 5, "SHARED", 6) == 0);
+    TEST(msync(shared, PAGESIZE, MS_SYNC) == 0);
+    TEST(filehas(PAGESIZE + 5, "SHARED"));
+    TEST(lseek(fd, 10, SEEK_SET) == 10);
+
+    /* Private writable mappings are copies */
+    priv = mmap(NULL, PAGESIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, PAGESIZE);
+    TEST(priv != MAP_FAILED && priv != ro2);
+    TEST(memcmp(priv + 5, "SHARED", 6) == 0);
+    memcpy(priv, "PRIVATE", 7);
+    TEST(memcmp(ro2, data + PAGESIZE, 5) == 0);
+    TEST(munmap(priv, PAGESIZE) == 0);
+
+    /* The mappings stay after the file is closed. Unmapping the writable
+       mapping at the address of ro2 writes it back and leaves ro2 alone */
+    TEST(close(fd) == 0);
+    fd = -1;
+    memcpy(shared + PAGESIZE, "AGAIN", 5);
+    TEST(munmap(shared, 2 * PAGESIZE) == 0);
+    fd = open(FILENAME, O_RDONLY);
+    TEST(fd != -1);
+    TEST(filehas(2 * PAGESIZE, "AGAIN"));
+    TEST(memcmp(ro + 2 * PAGESIZE, "AGAIN", 5) == 0);
+    TEST(munmap(ro2, PAGESIZE) == 0);
+    TEST(munmap(ro2, PAGESIZE) == -1 && errno == EINVAL);
+
+    /* A mapping inside another one is not removed with it */
+    sub = mmap(NULL, PAGESIZE, PROT_READ, MAP_SHARED, fd, PAGESIZE);
+    TEST(sub == ro + PAGESIZE);
+    TEST(munmap(ro, FILESIZE) == 0);
+    TEST(memcmp(sub + 5, "SHARED", 6) == 0);
+    TEST(munmap(sub, PAGESIZE) == 0);
+    TEST(munmap(sub, PAGESIZE) == -1 && errno == EINVAL);
+    TEST(msync(ro, PAGESIZE, MS_ASYNC) == -1 && errno == ENOMEM);
+
+    /* Errors */
+    TEST(mmap(NULL, PAGESIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) == MAP_FAILED && errno == EACCES);
+    TEST(mmap(NULL, PAGESIZE, PROT_READ, MAP_SHARED, fd, 1) == MAP_FAILED && errno == EINVAL);
+    TEST(mmap(NULL, 0, PROT_READ, MAP_SHARED, fd, 0) == MAP_FAILED && errno == EINVAL);
+    TEST(mmap(NULL, PAGESIZE, PROT_READ, MAP_SHARED | MAP_PRIVATE, fd, 0) == MAP_FAILED && errno == EINVAL);
+    TEST(mmap(NULL, PAGESIZE, PROT_READ, MAP_SHARED, 1000, 0) == MAP_FAILED && errno == EBADF);
+    TEST(msync(ro + 1, PAGESIZE, MS_SYNC) == -1 && errno == EINVAL);
+
+    /* Anonymous memory */
+    anon = mmap(NULL, 10000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    TEST(anon != MAP_FAILED && ((unsigned long)anon & (PAGESIZE - 1)) == 0);
+    for (i = 0; i < 10000; i++)
+        TESTFALSE(anon[i] == 0);
+    memset(anon, 1, 10000);
+    TEST(munmap(anon, 10000) == 0);
+
+    cleanup();
+
+    return OK;
+}
+
+void cleanup(void)
+{
+    if (fd != -1)
+        close(fd);
+    fd = -1;
+    unlink(FILENAME);
+}
@@ -0,0 +1,145 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Reads a directory with more entries than fit in one ExAll() batch
+    and checks d_type, stat() of the entries while the stream is open,
+    telldir() and seekdir().
+*/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "test.h"
+
+#define TESTDIR     "RAM:T/readdirtest"
+#define FILES       300
+
+static DIR *dir;
+static struct stat cached[FILES + 1];
+static char names[FILES + 1][32];
+
+static void makename(char *buf, int i)
+{
+    if (i == FILES)
+        sprintf(buf, "%s/subdir", TESTDIR);
+    else
+        sprintf(buf, "%s/file%03d", TESTDIR, i);
+}
+
+int main()
+{
+    struct dirent *de;
+    struct stat sb;
+    char path[64];
+    int i, fd, count, entry;
+    long pos = -1;
+
+    cleanup();
+    TEST(mkdir(TESTDIR, 0777) == 0);
+    for (i = 0; i < FILES; i++)
+    {
+        makename(path, i);
+        fd = open(path, O_WRONLY | O_CREAT, 0666);
+        TESTFALSE(fd >= 0);
+        /* Every file gets a different size */
+        TESTFALSE(write(fd, path, i % 20) == i % 20);
+        close(fd);
+    }
+    makename(path, FILES);
+    TEST(mkdir(path, 0777) == 0);
+
+    dir = opendir(TESTDIR);
+    TEST(dir != NULL);
+
+    count = 0;
+    while ((de = readdir(dir)) != NULL)
+    {
+        TESTFALSE(count <= FILES);
+
+        if (strcmp(de->d_name, "subdir") == 0)
+        {
+            TESTFALSE(de->d_type == DT_DIR);
+            entry = FILES;
+        }
+        else
+        {
+            TESTFALSE(de->d_type == DT_REG);
+            TESTFALSE(sscanf(de->d_name, "file%d", &entry) == 1);
+        }
+
+        /* Served from the batch the entry came from */
+        sprintf(path, "%s/%s", TESTDIR, de->d_name);
+        TESTFALSE(stat(path, &cached[entry]) == 0);
+        strcpy(names[entry], de->d_name);
+
+        if (count == FILES / 2)
+            pos = telldir(dir);
+        count++;
+    }
+    TEST(count == FILES + 1);
+
+    /* seekdir() goes back to the entry after the one telldir() was called
+       for, the entries after it are the same */
+    seekdir(dir, pos);
+    TEST(telldir(dir) == pos);
+    count = 0;
+    while (readdir(dir) != NULL)
+        count++;
+    TEST(count == FILES - FILES / 2);
+
+    rewinddir(dir);
+    count = 0;
+    while (readdir(dir) != NULL)
+        count++;
+    TEST(count == FILES + 1);
+
+    closedir(dir);
+    dir = NULL;
+
+    /* Without the stream stat() has to ask the handler, the result must
+       be the same */
+    for (i = 0; i <= FILES; i++)
+    {
+        makename(path, i);
+        TESTFALSE(names[i][0] != '\0');
+        TESTFALSE(stat(path, &sb) == 0);
+        TESTFALSE(sb.st_ino == cached[i].st_ino);
+        TESTFALSE(sb.st_dev == cached[i].st_dev);
+        TESTFALSE(sb.st_mode == cached[i].st_mode);
+        TESTFALSE(sb.st_size == cached[i].st_size);
+        TESTFALSE(sb.st_mtime == cached[i].st_mtime);
+        TESTFALSE(sb.st_blksize == cached[i].st_blksize);
+        if (i < FILES)
+            TESTFALSE(S_ISREG(sb.st_mode) && sb.st_size == i % 20);
+        else
+            TESTFALSE(S_ISDIR(sb.st_mode));
+    }
+    TEST(i == FILES + 1);
+
+    cleanup();
+
+    return OK;
+}
+
+void cleanup()
+{
+    char path[64];
+    int i;
+
+    if (dir)
+        closedir(dir);
+    dir = NULL;
+
+    for (i = 0; i < FILES; i++)
+    {
+        makename(path, i);
+        unlink(path);
+    }
+    makename(path, FILES);
+    rmdir(path);
+    rmdir(TESTDIR);
+}
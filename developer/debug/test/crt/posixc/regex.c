@@ -0,0 +1,184 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Checks regexec() results for anchors, word boundaries, subexpressions
+    and back references, and that scanning a buffer of lines with
+    REG_NEWLINE finds the same lines as matching each line on its own.
+*/
+
+#include <regex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+
+#define LINES       5000
+#define LINELEN     80
+
+struct testcase
+{
+    const char *pattern;
+    int         cflags;
+    const char *string;
+    int         eflags;
+    regoff_t    so[3];      /* so[0] == -2: no match */
+    regoff_t    eo[3];
+};
+
+static const struct testcase cases[] =
+{
+    { "abc", REG_EXTENDED, "xxabcxx", 0, { 2, -1, -1 }, { 5, -1, -1 } },
+    { "a(b*)c", REG_EXTENDED, "xac abbbc", 0, { 1, 2, -1 }, { 3, 2, -1 } },
+    { "(a|ab)(c|bcd)", REG_EXTENDED, "abcd", 0, { 0, 0, 1 }, { 4, 1, 4 } },
+    { "^foo", REG_EXTENDED, "foo", REG_NOTBOL, { -2 }, { -2 } },
+    { "^foo", REG_EXTENDED | REG_NEWLINE, "bar\nfoo", REG_NOTBOL, { 4, -1, -1 }, { 7, -1, -1 } },
+    { "bar$", REG_EXTENDED, "bar", REG_NOTEOL, { -2 }, { -2 } },
+    { "bar$", REG_EXTENDED | REG_NEWLINE, "xbar\nbar", REG_NOTEOL, { 1, -1, -1 }, { 4, -1, -1 } },
+    { "[[:<:]]is[[:>:]]", REG_EXTENDED, "this is it", 0, { 5, -1, -1 }, { 7, -1, -1 } },
+    { "[[:<:]](x+)[[:>:]]", REG_EXTENDED, "axx xx_ xxx", 0, { 8, 8, -1 }, { 11, 11, -1 } },
+    { "[[:digit:]]+(\\.[[:digit:]]+)?", REG_EXTENDED, "v 12.5.1", 0, { 2, 4, -1 }, { 6, 6, -1 } },
+    { "ERROR", REG_EXTENDED | REG_ICASE, "an error here", 0, { 3, -1, -1 }, { 8, -1, -1 } },
+    { "x*", REG_EXTENDED, "abc", 0, { 0, -1, -1 }, { 0, -1, -1 } },
+    { "(a*)*b", REG_EXTENDED, "aaab", 0, { 0, 3, -1 }, { 4, 3, -1 } },
+    { "\\(a\\)\\1", 0, "xaax", 0, { 1, 1, -1 }, { 3, 2, -1 } },
+    { "\\([ab]*\\)c\\1", 0, "abcab", 0, { 0, 0, -1 }, { 5, 2, -1 } },
+    { "a.c", REG_EXTENDED | REG_NEWLINE, "a\nc abc", 0, { 4, -1, -1 }, { 7, -1, -1 } },
+};
+
+static const char *patterns[] =
+{
+    "timeout",
+    "(error|warning) [0-9]+",
+    "^[a-z]+:[0-9]+ ",
+    "[[:<:]]disk[0-9][[:>:]]",
+    "[0-9]{3}$",
+};
+
+static regex_t re;
+static int compiled;
+static char *buffer;
+
+static unsigned int next(unsigned int *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+int main()
+{
+    static const char *words[] =
+    {
+        "timeout", "error", "warning", "disk0", "disk12", "sda:1", "ok", "42", "100"
+    };
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789 :";
+    regmatch_t pm[3];
+    unsigned int seed = 1;
+    char *p, *line, *eol;
+    int i, j, pass, r, each, scan;
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        /* The second pass runs with the states the first one made */
+        for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        {
+            const struct testcase *tc = &cases[i];
+
+            TESTFALSE(regcomp(&re, tc->pattern, tc->cflags) == 0);
+            compiled = 1;
+            for (j = 0; j <= pass; j++)
+            {
+                r = regexec(&re, tc->string, 3, pm, tc->eflags);
+                if (tc->so[0] == -2)
+                {
+                    TESTFALSE(r == REG_NOMATCH);
+                    TESTFALSE(regexec(&re, tc->string, 0, NULL, tc->eflags) == REG_NOMATCH);
+                    continue;
+                }
+                TESTFALSE(r == 0);
+                TESTFALSE(regexec(&re, tc->string, 0, NULL, tc->eflags) == 0);
+                TESTFALSE(pm[0].rm_so == tc->so[0] && pm[0].rm_eo == tc->eo[0]);
+                TESTFALSE(pm[1].rm_so == tc->so[1] && pm[1].rm_eo == tc->eo[1]);
+                TESTFALSE(pm[2].rm_so == tc->so[2] && pm[2].rm_eo == tc->eo[2]);
+            }
+            regfree(&re);
+            compiled = 0;
+        }
+    }
+    TEST(pass == 2);
+
+    /* Lines of random text with some words that the patterns look for */
+    buffer = malloc(LINES * (LINELEN + 1) + 1);
+    TEST(buffer != NULL);
+    p = buffer;
+    for (i = 0; i < LINES; i++)
+    {
+        int len = next(&seed) % LINELEN;
+
+        for (j = 0; j < len; j++)
+        {
+            if (next(&seed) % 16 == 0)
+            {
+                const char *w = words[next(&seed) % (sizeof(words) / sizeof(words[0]))];
+
+                while (*w && j < len)
+                {
+                    *p++ = *w++;
+                    j++;
+                }
+                if (j == len)
+                    break;
+            }
+            *p++ = alphabet[next(&seed) % (sizeof(alphabet) - 1)];
+        }
+        *p++ = '\n';
+    }
+    *p = '\0';
+
+    for (i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+    {
+        TESTFALSE(regcomp(&re, patterns[i], REG_EXTENDED | REG_NEWLINE) == 0);
+        compiled = 1;
+
+        /* Each line on its own */
+        each = 0;
+        for (line = buffer; *line; line = eol + 1)
+        {
+            eol = strchr(line, '\n');
+            pm[0].rm_so = 0;
+            pm[0].rm_eo = eol - line;
+            if (regexec(&re, line, 1, pm, REG_STARTEND) == 0)
+                each++;
+        }
+
+        /* The whole buffer, continuing after the line of each match */
+        scan = 0;
+        line = buffer;
+        while (regexec(&re, line, 1, pm, 0) == 0)
+        {
+            scan++;
+            eol = strchr(line + pm[0].rm_eo, '\n');
+            if (eol == NULL)
+                break;
+            line = eol + 1;
+        }
+
+        TESTFALSE(each == scan);
+        TESTFALSE(each > 0);
+        regfree(&re);
+        compiled = 0;
+    }
+    TEST(i == sizeof(patterns) / sizeof(patterns[0]));
+
+    cleanup();
+
+    return OK;
+}
+
+void cleanup()
+{
+    if (compiled)
+        regfree(&re);
+    compiled = 0;
+    free(buffer);
+    buffer = NULL;
+}
@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Mixes getc()/putc() with the other stdio functions on one
+          file, so the stdio buffer of the stream is used and given
+          back in all combinations.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "test.h"
+
+#define FILENAME    "T:stdiobuf.txt"
+#define CHARS       100000
+
+static FILE *f;
+static char big[9000];
+
+int main(void)
+{
+    char line[100];
+    int i, c;
+
+    f = fopen(FILENAME, "w+");
+    TEST(f != NULL);
+
+    for (i = 0; i < CHARS; i++)
+        TESTFALSE(putc('a' + i % 26, f) == 'a' + i % 26);
+    TEST(fputs("\nhello\nworld\n", f) >= 0);
+    TEST(fwrite("xyz", 1, 3, f) == 3);
+    TEST(ftell(f) == CHARS + 16);
+
+    /* Reading back with getc() and the block functions */
+    TEST(fseek(f, 0, SEEK_SET) == 0);
+    for (i = 0; i < CHARS; i++)
+        TESTFALSE(getc(f) == 'a' + i % 26);
+    TEST(ftell(f) == CHARS);
+    TEST(getc(f) == '\n');
+    TEST(ungetc('Q', f) == 'Q');
+    TEST(ftell(f) == CHARS);
+    TEST(getc(f) == 'Q');
+    TEST(fgets(line, sizeof(line), f) != NULL && strcmp(line, "hello\n") == 0);
+    TEST(getc(f) == 'w');
+    TEST(fread(line, 1, 4, f) == 4 && memcmp(line, "orld", 4) == 0);
+    TEST(fgets(line, sizeof(line), f) != NULL && strcmp(line, "\n") == 0);
+    TEST(fgets(line, sizeof(line), f) != NULL && strcmp(line, "xyz") == 0);
+    TEST(getc(f) == EOF && feof(f));
+
+    /* Writing in the middle after reading */
+    TEST(fseek(f, 5, SEEK_SET) == 0);
+    TEST(getc(f) == 'f');
+    TEST(fseek(f, 0, SEEK_CUR) == 0);
+    TEST(putc('#', f) == '#');
+    TEST(fflush(f) == 0);
+    TEST(fseek(f, 4, SEEK_SET) == 0);
+    TEST(getc(f) == 'e' && getc(f) == 'f' && getc(f) == '#' && getc(f) == 'h');
+
+    /* fread() starting in the buffer and going past it */
+    TEST(fseek(f, 10, SEEK_SET) == 0);
+    TEST(getc(f) == 'k');
+    TEST(fread(big, 3, 3000, f) == 3000);
+    for (i = 0; i < 9000; i++)
+        TESTFALSE(big[i] == 'a' + (11 + i) % 26);
+    TEST(ftell(f) == 9011);
+
+    /* fgets() for a line that goes past the buffer */
+    TEST(fseek(f, CHARS - 10, SEEK_SET) == 0);
+    c = getc(f);
+    TEST(c == 'a' + (CHARS - 10) % 26);
+    TEST(fgets(line, sizeof(line), f) != NULL && strlen(line) == 10 && line[9] == '\n');
+
+    TEST(fclose(f) == 0);
+    f = NULL;
+
+    cleanup();
+
+    return OK;
+}
+
+void cleanup(void)
+{
+    if (f)
+        fclose(f);
+    f = NULL;
+    remove(FILENAME);
+}
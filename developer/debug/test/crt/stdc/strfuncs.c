@@ -0,0 +1,175 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Compares the optimised string and memory functions with simple
+    byte at a time versions for random data at all alignments, also
+    with strings that end right at the end of a page.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <exec/types.h>
+
+#include "test.h"
+
+#define PAGESIZE    4096
+#define MAXLEN      300
+#define ITERATIONS  100000
+
+static unsigned char *area;
+
+static size_t ref_strlen(const unsigned char *s)
+{
+    size_t n = 0;
+
+    while (s[n])
+        n++;
+    return n;
+}
+
+static const unsigned char *ref_memchr(const unsigned char *s, int c, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        if (s[i] == (unsigned char)c)
+            return s + i;
+    return NULL;
+}
+
+static int ref_memcmp(const unsigned char *a, const unsigned char *b, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        if (a[i] != b[i])
+            return a[i] - b[i];
+    return 0;
+}
+
+static const unsigned char *ref_strchr(const unsigned char *s, int c)
+{
+    for (;; s++)
+    {
+        if (*s == (unsigned char)c)
+            return s;
+        if (!*s)
+            return NULL;
+    }
+}
+
+static int ref_strcmp(const unsigned char *a, const unsigned char *b)
+{
+    while (*a && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return *a - *b;
+}
+
+static int sign(int x)
+{
+    return (x > 0) - (x < 0);
+}
+
+static unsigned int next(unsigned int *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+int main()
+{
+    unsigned char *page, *s, *t, *d;
+    unsigned char ref[1024], tmp[MAXLEN];
+    unsigned int seed = 1;
+    size_t len, i, from, to;
+    int iter, c;
+
+    area = malloc(PAGESIZE * 4);
+    TEST(area != NULL);
+
+    /* Odd iterations put the strings right before page + 2 * PAGESIZE */
+    page = (unsigned char *)(((IPTR)area + PAGESIZE - 1) & ~(IPTR)(PAGESIZE - 1));
+
+    for (iter = 0; iter < ITERATIONS; iter++)
+    {
+        len = next(&seed) % MAXLEN;
+
+        if (iter & 1)
+            s = page + 2 * PAGESIZE - len - 1;
+        else
+            s = page + PAGESIZE / 2 + next(&seed) % 64;
+
+        /* Small alphabets give long common prefixes */
+        for (i = 0; i < len; i++)
+            s[i] = 1 + next(&seed) % ((iter & 2) ? 4 : 255);
+        s[len] = 0;
+
+        TESTFALSE(strlen((char *)s) == ref_strlen(s));
+
+        c = len ? s[next(&seed) % len] : 'x';
+        if (iter % 7 == 0)
+            c = 0;
+        else if (iter % 11 == 0)
+            c |= 0x100;
+
+        TESTFALSE((unsigned char *)strchr((char *)s, c) == ref_strchr(s, c));
+        TESTFALSE(memchr(s, c, len + 1) == ref_memchr(s, c, len + 1));
+        TESTFALSE(memchr(s, 0xEE, len) == ref_memchr(s, 0xEE, len));
+
+        /* A copy of s, maybe changed or cut short */
+        if (iter & 4)
+            t = page + 2 * PAGESIZE - len - 1 - next(&seed) % 2;
+        else
+            t = page + PAGESIZE / 4 + next(&seed) % 64;
+        memmove(t, s, len + 1);
+        if (len && (iter & 8))
+        {
+            i = next(&seed) % len;
+            t[i] ^= (iter & 16) ? 0x80 : 0x01;
+            if (!t[i])
+                t[i] = 1;
+        }
+        if (len && (iter & 32))
+            t[next(&seed) % len] = 0;
+
+        TESTFALSE(sign(strcmp((char *)s, (char *)t)) == sign(ref_strcmp(s, t)));
+        TESTFALSE(sign(strcmp((char *)t, (char *)s)) == sign(ref_strcmp(t, s)));
+        TESTFALSE(sign(memcmp(s, t, len)) == sign(ref_memcmp(s, t, len)));
+
+        /* memset() must not touch the bytes around the area */
+        d = page + PAGESIZE + next(&seed) % 64;
+        memset(d - 16, 0x55, len + 32);
+        memset(d, c, len);
+        for (i = 0; i < 16; i++)
+            TESTFALSE(d[(int)i - 16] == 0x55 && d[len + i] == 0x55);
+        for (i = 0; i < len; i++)
+            TESTFALSE(d[i] == (unsigned char)c);
+
+        /* Overlapping moves in both directions */
+        d = page + PAGESIZE / 8;
+        for (i = 0; i < 700; i++)
+            d[i] = ref[i] = (unsigned char)(i * 7);
+        from = next(&seed) % 300;
+        to = next(&seed) % 300;
+        memcpy(tmp, ref + from, len);
+        memcpy(ref + to, tmp, len);
+        TESTFALSE(memmove(d + to, d + from, len) == d + to);
+        TESTFALSE(ref_memcmp(d, ref, 700) == 0);
+    }
+
+    TEST(iter == ITERATIONS);
+
+    cleanup();
+
+    return OK;
+}
+
+void cleanup()
+{
+    free(area);
+    area = NULL;
+}
@@ -0,0 +1,157 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Checks that FindPort(), FindSemaphore() and OpenLibrary() still
+          find the same nodes as a walk of the system lists when ports
+          and semaphores with the same names are added and removed.
+*/
+
+#include <exec/memory.h>
+#include <exec/ports.h>
+#include <exec/semaphores.h>
+#include <proto/exec.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+#define PORTS       300
+
+static struct MsgPort ports[PORTS];
+static char names[PORTS][20];
+static struct MsgPort dup1, dup2, dup3;
+static struct SignalSemaphore sem1, sem2;
+
+/* ln_Type tells cleanup() which ports are still in the list */
+static void rem(struct MsgPort *port)
+{
+    RemPort(port);
+    port->mp_Node.ln_Type = NT_UNKNOWN;
+}
+
+static void remsem(struct SignalSemaphore *sem)
+{
+    RemSemaphore(sem);
+    sem->ss_Link.ln_Type = NT_UNKNOWN;
+}
+
+int main(void)
+{
+    struct MsgPort *port;
+    struct Library *lib;
+    int i;
+
+    /* More ports than the index has room for */
+    for (i = 0; i < PORTS; i++)
+    {
+        sprintf(names[i], "findname.%d", i);
+        ports[i].mp_Node.ln_Name = names[i];
+        ports[i].mp_Flags = PA_IGNORE;
+        AddPort(&ports[i]);
+    }
+    for (i = 0; i < PORTS; i++)
+        TESTFALSE(FindPort(names[i]) == &ports[i]);
+    TEST(FindPort("findname.none") == NULL);
+
+    /* With the same name the port of the higher priority is found */
+    dup1.mp_Node.ln_Name = "findname.dup";
+    dup1.mp_Node.ln_Pri = 0;
+    dup2.mp_Node.ln_Name = "findname.dup";
+    dup2.mp_Node.ln_Pri = 5;
+    dup3.mp_Node.ln_Name = "findname.dup";
+    dup3.mp_Node.ln_Pri = -5;
+    AddPort(&dup1);
+    TEST(FindPort("findname.dup") == &dup1);
+    AddPort(&dup2);
+    TEST(FindPort("findname.dup") == &dup2);
+    AddPort(&dup3);
+    TEST(FindPort("findname.dup") == &dup2);
+    rem(&dup2);
+    TEST(FindPort("findname.dup") == &dup1);
+    rem(&dup1);
+    TEST(FindPort("findname.dup") == &dup3);
+
+    /* Unlinked without Remove() */
+    Forbid();
+    REMOVE(&dup3.mp_Node);
+    dup3.mp_Node.ln_Type = NT_UNKNOWN;
+    Permit();
+    TEST(FindPort("findname.dup") == NULL);
+
+    /* Unlinked without Remove() and freed, only its pointer may be used */
+    port = AllocMem(sizeof(struct MsgPort), MEMF_PUBLIC | MEMF_CLEAR);
+    TEST(port != NULL);
+    port->mp_Node.ln_Name = "findname.freed";
+    port->mp_Flags = PA_IGNORE;
+    AddPort(port);
+    TEST(FindPort("findname.freed") == port);
+    Forbid();
+    REMOVE(&port->mp_Node);
+    memset(port, 0xAA, sizeof(struct MsgPort));
+    FreeMem(port, sizeof(struct MsgPort));
+    Permit();
+    TEST(FindPort("findname.freed") == NULL);
+
+    /* Renamed while in the list */
+    Forbid();
+    ports[0].mp_Node.ln_Name = "findname.renamed";
+    Permit();
+    TEST(FindPort(names[0]) == NULL);
+    TEST(FindPort("findname.renamed") == &ports[0]);
+    Forbid();
+    ports[0].mp_Node.ln_Name = names[0];
+    Permit();
+    TEST(FindPort(names[0]) == &ports[0]);
+    TEST(FindPort("findname.renamed") == NULL);
+
+    for (i = 0; i < PORTS; i += 2)
+        rem(&ports[i]);
+    for (i = 0; i < PORTS; i++)
+        TESTFALSE(FindPort(names[i]) == (i % 2 ? &ports[i] : NULL));
+
+    /* Semaphores are in their own list */
+    sem1.ss_Link.ln_Name = "findname.1";
+    sem1.ss_Link.ln_Pri = 0;
+    AddSemaphore(&sem1);
+    TEST(FindSemaphore("findname.1") == &sem1);
+    TEST(FindPort("findname.1") == &ports[1]);
+    sem2.ss_Link.ln_Name = "findname.1";
+    sem2.ss_Link.ln_Pri = 1;
+    AddSemaphore(&sem2);
+    TEST(FindSemaphore("findname.1") == &sem2);
+    remsem(&sem2);
+    TEST(FindSemaphore("findname.1") == &sem1);
+    remsem(&sem1);
+    TEST(FindSemaphore("findname.1") == NULL);
+
+    /* Libraries that are already open are found again */
+    lib = OpenLibrary("exec.library", 0);
+    TEST(lib == (struct Library *)SysBase);
+    CloseLibrary(lib);
+
+    cleanup();
+
+    return OK;
+}
+
+void cleanup(void)
+{
+    struct MsgPort *dups[] = { &dup1, &dup2, &dup3 };
+    int i;
+
+    for (i = 0; i < PORTS; i++)
+    {
+        if (ports[i].mp_Node.ln_Type == NT_MSGPORT)
+            rem(&ports[i]);
+    }
+    for (i = 0; i < 3; i++)
+    {
+        if (dups[i]->mp_Node.ln_Type == NT_MSGPORT)
+            rem(dups[i]);
+    }
+    if (sem1.ss_Link.ln_Type == NT_SIGNALSEM)
+        remsem(&sem1);
+    if (sem2.ss_Link.ln_Type == NT_SIGNALSEM)
+        remsem(&sem2);
+}
@@ -0,0 +1,147 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Exercises the pthread pool: nested futures, parallel loops with
+    automatic and given grain sizes, detached jobs, and a plain exec task
+    submitting jobs and waiting for them.
+*/
+
+#include <proto/exec.h>
+#include <dos/dos.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RANGE       100003
+
+static volatile int hits[RANGE];
+static volatile int detached;
+static struct Task *parent;
+static volatile long taskresult;
+
+static long fib(long n);
+
+static void *fib_job(void *arg)
+{
+    return (void *)fib((long)arg);
+}
+
+/* Splits the work until it is small, the waiting worker runs other jobs */
+static long fib(long n)
+{
+    pthread_future_t *future;
+    void *value;
+    long a;
+
+    if (n < 15)
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+
+    if (pthread_pool_submit_np(&future, fib_job, (void *)(n - 1)) != 0)
+        return -1;
+    a = fib(n - 2);
+    if (pthread_future_wait_np(future, &value) != 0)
+        return -1;
+
+    return a + (long)value;
+}
+
+static void count_hits(long first, long last, void *arg)
+{
+    for (; first < last; first++)
+        __atomic_fetch_add(&hits[first], 1, __ATOMIC_RELAXED);
+}
+
+static void nested_loop(long first, long last, void *arg)
+{
+    for (; first < last; first++)
+        pthread_parallel_for_np(0, 100, 7, count_hits, NULL);
+}
+
+static void *detached_job(void *arg)
+{
+    __atomic_fetch_add(&detached, 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static void plain_task(void)
+{
+    pthread_future_t *future;
+    void *value;
+
+    taskresult = -1;
+    if (pthread_pool_submit_np(&future, fib_job, (void *)20) == 0
+        && pthread_future_wait_np(future, &value) == 0)
+    {
+        taskresult = (long)value;
+    }
+
+    Signal(parent, SIGBREAKF_CTRL_F);
+}
+
+static int check_hits(int expected, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (hits[i] != expected)
+        {
+            printf("hits[%d] is %d instead of %d\n", i, hits[i], expected);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int main(void)
+{
+    long grain, result;
+    int i;
+
+    printf("pool has %d workers\n", pthread_pool_size_np());
+
+    result = fib(27);
+    printf("fib(27) = %ld\n", result);
+    if (result != 196418)
+        return 1;
+
+    for (grain = 0; grain < 5000; grain = grain * 3 + 1)
+    {
+        memset((void *)hits, 0, sizeof(hits));
+        if (pthread_parallel_for_np(0, RANGE, grain, count_hits, NULL) != 0 || !check_hits(1, RANGE))
+        {
+            printf("parallel_for with grain %ld failed\n", grain);
+            return 1;
+        }
+    }
+    printf("parallel_for ok\n");
+
+    memset((void *)hits, 0, sizeof(hits));
+    pthread_parallel_for_np(0, 50, 1, nested_loop, NULL);
+    if (!check_hits(50, 100))
+        return 1;
+    printf("nested parallel_for ok\n");
+
+    for (i = 0; i < 10000; i++)
+    {
+        if (pthread_pool_submit_np(NULL, detached_job, NULL) != 0)
+            return 1;
+    }
+
+    parent = FindTask(NULL);
+    SetSignal(0, SIGBREAKF_CTRL_F);
+    if (NewCreateTask(TASKTAG_PC, plain_task, TASKTAG_NAME, "pthreadpool task",
+        TASKTAG_STACKSIZE, 16384, TAG_DONE) == NULL)
+    {
+        return 1;
+    }
+    Wait(SIGBREAKF_CTRL_F);
+    printf("fib(20) from a plain task = %ld\n", taskresult);
+    if (taskresult != 6765)
+        return 1;
+
+    printf("finished!\n");
+
+    return 0;
+}
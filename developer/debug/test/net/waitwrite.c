@@ -0,0 +1,181 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: A TCP sender with a full send buffer must be woken up by
+          WaitSelect() and WaitSocketEvents() when the peer's ACKs
+          free space in it.
+*/
+
+#include <dos/dos.h>
+#include <dos/dostags.h>
+#include <proto/dos.h>
+#include <proto/exec.h>
+#include <proto/socket.h>
+
+#include <sys/socket.h>
+#include <sys/filio.h>
+#include <netinet/in.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define CHUNK   4096
+
+static struct Task *parent;
+static UWORD port;
+static UBYTE buffer[CHUNK];
+static UBYTE readbuf[65536];
+
+/*
+ * The receiving end runs in its own process with its own library base.
+ * Each CTRL-E makes it read once, after giving the sender time to block.
+ * CTRL-C makes it drain the connection until the sender closes it.
+ */
+static void Reader(void)
+{
+    struct Library *SocketBase;
+    struct sockaddr_in sin;
+    ULONG sigs;
+    LONG s = -1;
+
+    SocketBase = OpenLibrary("bsdsocket.library", 4);
+    if (SocketBase)
+    {
+        s = socket(AF_INET, SOCK_STREAM, 0);
+        memset(&sin, 0, sizeof(sin));
+        sin.sin_len = sizeof(sin);
+        sin.sin_family = AF_INET;
+        sin.sin_port = htons(port);
+        sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (s != -1 && connect(s, (struct sockaddr *)&sin, sizeof(sin)) == 0)
+        {
+            do
+            {
+                sigs = Wait(SIGBREAKF_CTRL_C | SIGBREAKF_CTRL_E);
+                if (sigs & SIGBREAKF_CTRL_E)
+                {
+                    Delay(25);
+                    recv(s, readbuf, sizeof(readbuf), 0);
+                }
+            } while (!(sigs & SIGBREAKF_CTRL_C));
+
+            while (recv(s, readbuf, sizeof(readbuf), 0) > 0)
+                ;
+        }
+        if (s != -1)
+            CloseSocket(s);
+        CloseLibrary(SocketBase);
+    }
+
+    Forbid();
+    Signal(parent, SIGBREAKF_CTRL_F);
+}
+
+/* Queue data on a non-blocking socket until no more fits */
+static void Fill(LONG s)
+{
+    while (send(s, buffer, sizeof(buffer), 0) > 0)
+        ;
+}
+
+int main(void)
+{
+    struct sockaddr_in sin;
+    socklen_t len = sizeof(sin);
+    struct timeval tv;
+    struct SocketEvent ev;
+    struct Process *reader;
+    fd_set wfds;
+    LONG one = 1;
+    LONG s, c = -1;
+    int ret = RETURN_FAIL;
+    int n;
+
+    parent = FindTask(NULL);
+    SetSignal(0, SIGBREAKF_CTRL_F);
+
+    s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == -1)
+    {
+        printf("socket() failed\n");
+        return RETURN_FAIL;
+    }
+
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_len = sizeof(sin);
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(s, (struct sockaddr *)&sin, sizeof(sin)) != 0 ||
+        listen(s, 1) != 0 ||
+        getsockname(s, (struct sockaddr *)&sin, &len) != 0)
+    {
+        printf("Could not set up the listening socket\n");
+        CloseSocket(s);
+        return RETURN_FAIL;
+    }
+    port = ntohs(sin.sin_port);
+
+    reader = CreateNewProcTags(NP_Entry, (IPTR)Reader,
+                               NP_Name, (IPTR)"waitwrite reader",
+                               TAG_DONE);
+    if (!reader)
+    {
+        printf("Could not start the reader\n");
+        CloseSocket(s);
+        return RETURN_FAIL;
+    }
+
+    len = sizeof(sin);
+    c = accept(s, (struct sockaddr *)&sin, &len);
+    if (c == -1 || IoctlSocket(c, FIONBIO, (char *)&one) != 0)
+    {
+        printf("accept() failed\n");
+        goto done;
+    }
+
+    /* WaitSelect() must return once the reader has made room */
+    Fill(c);
+    Signal(&reader->pr_Task, SIGBREAKF_CTRL_E);
+
+    FD_ZERO(&wfds);
+    FD_SET(c, &wfds);
+    tv.tv_sec = 10;
+    tv.tv_usec = 0;
+    n = WaitSelect(c + 1, NULL, &wfds, NULL, &tv, NULL);
+    if (n != 1 || !FD_ISSET(c, &wfds))
+    {
+        printf("WaitSelect() returned %d, socket not writeable\n", n);
+        goto done;
+    }
+
+    /* So must WaitSocketEvents() for an FD_WRITE interest */
+    Fill(c);
+    if (SetSocketInterest(c, FD_WRITE, SIF_EDGE, &ev) != 0)
+    {
+        printf("SetSocketInterest() failed\n");
+        goto done;
+    }
+    Signal(&reader->pr_Task, SIGBREAKF_CTRL_E);
+
+    tv.tv_sec = 10;
+    tv.tv_usec = 0;
+    n = WaitSocketEvents(&ev, 1, &tv, NULL);
+    if (n != 1 || ev.se_Socket != c || !(ev.se_Events & FD_WRITE) ||
+        ev.se_UserData != &ev)
+    {
+        printf("WaitSocketEvents() returned %d, no FD_WRITE event\n", n);
+        goto done;
+    }
+
+    ret = RETURN_OK;
+
+done:
+    if (c != -1)
+        CloseSocket(c);
+    CloseSocket(s);
+
+    Signal(&reader->pr_Task, SIGBREAKF_CTRL_C);
+    Wait(SIGBREAKF_CTRL_F);
+
+    return ret;
+}
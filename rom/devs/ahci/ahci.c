@@ -2030,12 +2030,32 @@ ahci_load_prdt(struct ahci_ccb *ccb)
             return (0);
     }
 
-    error = bus_dmamap_load(sc->sc_tag_data, dmap,
-                            xa->data, xa->datalen,
-                            ahci_load_prdt_callback,
-                            &prdt,
-                            ((xa->flags & ATA_F_NOWAIT) ?
-                                BUS_DMA_NOWAIT : BUS_DMA_WAITOK));
+    if (ccb->ccb_nsg > 1) {
+        int i;
+
+        /*
+         * Merged request - one or more PRD entries per buffer, each
+         * segment continuing after the last entry of the previous one.
+         */
+        for (i = 0, error = 0; i < ccb->ccb_nsg && error == 0; i++) {
+            if (i > 0)
+                ++prdt;
+            error = bus_dmamap_load(sc->sc_tag_data, dmap,
+                                    ccb->ccb_sg[i].sg_data,
+                                    ccb->ccb_sg[i].sg_len,
+                                    ahci_load_prdt_callback,
+                                    &prdt,
+                                    ((xa->flags & ATA_F_NOWAIT) ?
+                                        BUS_DMA_NOWAIT : BUS_DMA_WAITOK));
+        }
+    } else {
+        error = bus_dmamap_load(sc->sc_tag_data, dmap,
+                                xa->data, xa->datalen,
+                                ahci_load_prdt_callback,
+                                &prdt,
+                                ((xa->flags & ATA_F_NOWAIT) ?
+                                    BUS_DMA_NOWAIT : BUS_DMA_WAITOK));
+    }
     if (error != 0) {
         ahciError("%s: error %d loading dmamap\n", PORTNAME(ap), error);
         return (1);
@@ -3433,6 +3453,7 @@ ahci_put_ccb(struct ahci_ccb *ccb)
 #endif
     lockmgr(&ap->ap_ccb_lock, LK_EXCLUSIVE);
     ccb->ccb_xa.state = ATA_S_PUT;
+    ccb->ccb_nsg = 0;
     ++ccb->ccb_xa.serial;
     TAILQ_INSERT_TAIL(&ap->ap_ccb_free, ccb, ccb_entry);
     lockmgr(&ap->ap_ccb_lock, LK_RELEASE);
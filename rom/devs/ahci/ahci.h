@@ -407,6 +407,17 @@ struct ahci_cmd_table {
 
 #define AHCI_MAX_PORTS		32
 
+/*
+ * Maximum number of separate buffers a single CCB may carry when the
+ * AROS request queue merges adjacent transfers into one command.
+ */
+#define AHCI_MAX_SGMERGE	16
+
+struct ahci_sgseg {
+	void			*sg_data;
+	size_t			sg_len;
+};
+
 struct ahci_dmamem {
 	bus_dma_tag_t		adm_tag;
 	bus_dmamap_t		adm_map;
@@ -436,6 +447,10 @@ struct ahci_ccb {
 
 	void			(*ccb_done)(struct ahci_ccb *);
 
+	/* Scatter list, used instead of xa->data when ccb_nsg > 1 */
+	struct ahci_sgseg	ccb_sg[AHCI_MAX_SGMERGE];
+	int			ccb_nsg;
+
 	TAILQ_ENTRY(ahci_ccb)	ccb_entry;
 };
 
@@ -162,6 +162,7 @@ static int ahci_RegisterPort(struct ahci_port *ap)
     unit->sim_Unit = ap->ap_sc->sc_dev->dev_HostID * 32 + ap->ap_num;
     InitSemaphore(&unit->sim_Lock);
     NEWLIST(&unit->sim_IOs);
+    ahci_queue_init(unit);
 
     AddTail((struct List *)&AHCIBase->ahci_Units, (struct Node *)unit);
 
@@ -139,6 +139,9 @@ struct ahci_Controller
 
 #include <exec/semaphores.h>
 
+/* Command slots per port, as defined by the AHCI specification */
+#define AHCI_QUEUE_TAGS         32
+
 struct cam_sim {
     struct MinNode          sim_Node;
     struct ahci_port        *sim_Port;
@@ -154,6 +157,9 @@ struct cam_sim {
 #define SIMF_OffLine            (1 << SIMB_OffLine)
     ULONG                   sim_ChangeNum;
     struct Task             *sim_Monitor;
+    struct List             sim_Queue;          /* R/W requests waiting for a CCB, by offset */
+    struct List             sim_Active[AHCI_QUEUE_TAGS]; /* Requests carried by each CCB */
+    UQUAD                   sim_QueuePos;       /* Elevator position                */
 };
 
 struct ahci_Unit;
@@ -180,6 +186,9 @@ struct ahci_Unit
 /* Function prototypes */
 
 BOOL Hidd_AHCIBus_Start(OOP_Object *, struct AHCIBase *);
+void ahci_queue_init(struct cam_sim *unit);
+void ahci_queue_rw(struct IORequest *io, UQUAD off64);
+void ahci_queue_dispatch(struct cam_sim *unit);
 AROS_UFP3(BOOL, Hidd_AHCIBus_Open,
           AROS_UFPA(struct Hook *, h, A0),
           AROS_UFPA(OOP_Object *, obj, A2),
@@ -117,6 +117,14 @@ static BOOL ahci_sector_rw(struct IORequest *io, UQUAD off64, BOOL is_write)
         return TRUE;
     }
 
+    /* Disk transfers go through the unit's request queue, which
+     * keeps all NCQ tags busy and merges adjacent requests.
+     */
+    if (ap->ap_type == ATA_PORT_T_DISK) {
+        ahci_queue_rw(io, off64);
+        return FALSE;
+    }
+
     scsi.scsi_Data = data;
     scsi.scsi_Length = len;
     scsi.scsi_Flags  = is_write ? SCSIF_WRITE : SCSIF_READ;
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2025, The AROS Development Team.  All rights reserved.
+ *
+ * Licensed under the AROS PUBLIC LICENSE (APL) Version 1.1
+ */
+
+/*
+ * Per-unit request queue for disk transfers.
+ *
+ * Read and write requests are kept sorted by their byte offset and
+ * handed to the port whenever a CCB is free, so that up to the
+ * negotiated NCQ depth of commands from different clients are on the
+ * chip at the same time. The queue is serviced in one direction only
+ * (C-LOOK), and requests that continue exactly where the chosen one
+ * ends are merged into the same command using a scatter list.
+ */
+
+#include <aros/debug.h>
+
+#include <proto/exec.h>
+
+#include <exec/errors.h>
+#include <devices/trackdisk.h>
+#include <devices/newstyle.h>
+
+#include "ahci.h"
+#include "ahci_scsi.h"
+
+/* Largest transfer in sectors one READ/WRITE (FP)DMA EXT command can describe */
+#define AHCI_QUEUE_MAXSECTORS   0xFFFF
+
+/* Position of a queued request, see ahci_queue_rw() */
+static inline UQUAD ahci_queue_offset(struct IORequest *io)
+{
+    return ((UQUAD)IOStdReq(io)->io_Actual << 32) | IOStdReq(io)->io_Offset;
+}
+
+static inline BOOL ahci_queue_is_write(struct IORequest *io)
+{
+    switch (io->io_Command) {
+    case CMD_WRITE:
+    case TD_WRITE64:
+    case NSCMD_TD_WRITE64:
+    case TD_FORMAT:
+    case TD_FORMAT64:
+    case NSCMD_TD_FORMAT64:
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void ahci_queue_init(struct cam_sim *unit)
+{
+    int i;
+
+    NEWLIST(&unit->sim_Queue);
+    for (i = 0; i < AHCI_QUEUE_TAGS; i++)
+        NEWLIST(&unit->sim_Active[i]);
+    unit->sim_QueuePos = 0;
+}
+
+static void ahci_queue_complete(struct ata_xfer *xa)
+{
+    struct cam_sim *unit = xa->atascsi_private;
+    struct IORequest *io;
+    struct List done;
+    BYTE error;
+
+    switch (xa->state) {
+    case ATA_S_COMPLETE:
+        error = 0;
+        break;
+    case ATA_S_ERROR:
+        error = TDERR_SeekError;
+        break;
+    case ATA_S_TIMEOUT:
+        error = IOERR_UNITBUSY;
+        break;
+    default:
+        error = IOERR_NOCMD;
+        break;
+    }
+
+    NEWLIST(&done);
+    ObtainSemaphore(&unit->sim_Lock);
+    while ((io = (struct IORequest *)RemHead(&unit->sim_Active[xa->tag])))
+        AddTail(&done, &io->io_Message.mn_Node);
+    ReleaseSemaphore(&unit->sim_Lock);
+
+    ahci_ata_put_xfer(xa);
+
+    while ((io = (struct IORequest *)RemHead(&done))) {
+        io->io_Error = error;
+        IOStdReq(io)->io_Actual = error ? 0 : IOStdReq(io)->io_Length;
+        ReplyMsg(&io->io_Message);
+    }
+
+    /* A CCB has been freed, start the next queued request */
+    ahci_queue_dispatch(unit);
+}
+
+/*
+ * Issue queued requests for as long as there are free CCBs.
+ *
+ * May be called from the caller of BeginIO() and from the port
+ * thread. The port lock is always taken after sim_Lock has been
+ * released, matching the order used by the completion path.
+ */
+void ahci_queue_dispatch(struct cam_sim *unit)
+{
+    struct ahci_port *ap = unit->sim_Port;
+    struct ata_port *at = ap->ap_ata[0];
+    ULONG sector_size = at->at_identify.sector_size;
+    struct ata_xfer *xa;
+    struct ahci_ccb *ccb;
+    struct IORequest *io, *next;
+    UQUAD off, end;
+    BOOL is_write;
+
+    for (;;) {
+        ObtainSemaphore(&unit->sim_Lock);
+        if (IsListEmpty(&unit->sim_Queue)) {
+            ReleaseSemaphore(&unit->sim_Lock);
+            break;
+        }
+
+        /* All CCBs busy - the next completion calls us again */
+        xa = ahci_ata_get_xfer(ap, at);
+        if (xa == NULL) {
+            ReleaseSemaphore(&unit->sim_Lock);
+            break;
+        }
+        ccb = (struct ahci_ccb *)xa;
+
+        /* Continue the sweep from the elevator position, or wrap around */
+        ForeachNode(&unit->sim_Queue, io) {
+            if (ahci_queue_offset(io) >= unit->sim_QueuePos)
+                break;
+        }
+        if (io->io_Message.mn_Node.ln_Succ == NULL)
+            io = (struct IORequest *)GetHead(&unit->sim_Queue);
+
+        is_write = ahci_queue_is_write(io);
+        off = end = ahci_queue_offset(io);
+
+        xa->flags = is_write ? ATA_F_WRITE : ATA_F_READ;
+        xa->data = IOStdReq(io)->io_Data;
+        xa->datalen = 0;
+
+        /* Take the request, and any that follow on directly */
+        do {
+            next = (struct IORequest *)io->io_Message.mn_Node.ln_Succ;
+
+            Remove(&io->io_Message.mn_Node);
+            AddTail(&unit->sim_Active[xa->tag], &io->io_Message.mn_Node);
+
+            ccb->ccb_sg[ccb->ccb_nsg].sg_data = IOStdReq(io)->io_Data;
+            ccb->ccb_sg[ccb->ccb_nsg].sg_len = IOStdReq(io)->io_Length;
+            ccb->ccb_nsg++;
+            xa->datalen += IOStdReq(io)->io_Length;
+            end += IOStdReq(io)->io_Length;
+
+            io = next;
+        } while (io->io_Message.mn_Node.ln_Succ != NULL &&
+                 ccb->ccb_nsg < AHCI_MAX_SGMERGE &&
+                 ahci_queue_offset(io) == end &&
+                 ahci_queue_is_write(io) == is_write &&
+                 (xa->datalen + IOStdReq(io)->io_Length) / sector_size <= AHCI_QUEUE_MAXSECTORS);
+
+        unit->sim_QueuePos = end;
+        ReleaseSemaphore(&unit->sim_Lock);
+
+        ahci_ata_rw_fis(xa, off / sector_size, xa->datalen / sector_size);
+        xa->complete = ahci_queue_complete;
+        xa->timeout = 1500;    /* milliseconds */
+        xa->atascsi_private = unit;
+
+        ahci_os_lock_port(ap);
+        xa->fis->flags |= at->at_target;
+        ahci_ata_cmd(xa);
+        ahci_os_unlock_port(ap);
+    }
+}
+
+/*
+ * Queue a disk read or write. The request has already been validated
+ * by the caller.
+ *
+ * While queued, io_Offset and io_Actual hold the low and high 32 bits
+ * of the byte offset for every command flavour, io_Actual is set to
+ * the real result on completion.
+ */
+void ahci_queue_rw(struct IORequest *io, UQUAD off64)
+{
+    struct cam_sim *unit = (struct cam_sim *)io->io_Unit;
+    struct IORequest *pos, *pred = NULL;
+
+    IOStdReq(io)->io_Offset = (ULONG)off64;
+    IOStdReq(io)->io_Actual = (ULONG)(off64 >> 32);
+
+    /* The request may be replied before we return */
+    io->io_Flags &= ~IOF_QUICK;
+
+    ObtainSemaphore(&unit->sim_Lock);
+
+    /* Move from the list of pending IOs into the sorted queue. Requests
+     * for the same offset stay in the order they were received.
+     */
+    Remove(&io->io_Message.mn_Node);
+    ForeachNode(&unit->sim_Queue, pos) {
+        if (ahci_queue_offset(pos) > off64)
+            break;
+        pred = pos;
+    }
+    Insert(&unit->sim_Queue, &io->io_Message.mn_Node,
+           pred ? &pred->io_Message.mn_Node : NULL);
+
+    ReleaseSemaphore(&unit->sim_Lock);
+
+    ahci_queue_dispatch(unit);
+}
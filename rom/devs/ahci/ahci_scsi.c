@@ -318,6 +318,70 @@ static BYTE ahci_scsi_page_inquiry(struct ahci_port *ap, struct ata_port *at, st
 }
 
 
+/*
+ * Fill in the FIS of a READ/WRITE DMA transfer of count sectors
+ * starting at lba. xa->flags must already hold ATA_F_READ or
+ * ATA_F_WRITE.
+ *
+ * FPDMA QUEUED commands are used whenever NCQ was negotiated for the
+ * port, so that all free CCBs can be on the chip at the same time.
+ */
+void ahci_ata_rw_fis(struct ata_xfer *xa, u_int64_t lba, u_int32_t count)
+{
+    struct ata_port *at = xa->at;
+    struct ahci_port *ap = at->at_ahci_port;
+    struct ata_fis_h2d *fis;
+
+    fis = xa->fis;
+    fis->flags = ATA_H2D_FLAGS_CMD;
+    fis->lba_low = (u_int8_t)lba;
+    fis->lba_mid = (u_int8_t)(lba >> 8);
+    fis->lba_high = (u_int8_t)(lba >> 16);
+    fis->device = ATA_H2D_DEVICE_LBA;
+
+    /*
+     * NCQ only for direct-attached disks, do not currently
+     * try to use NCQ with port multipliers.
+     */
+    if (at->at_ncqdepth > 1 &&
+        ap->ap_type == ATA_PORT_T_DISK &&
+        (ap->ap_sc->sc_cap & AHCI_REG_CAP_SNCQ)) {
+        /*
+         * Use NCQ - always uses 48 bit addressing
+         */
+        xa->flags |= ATA_F_NCQ;
+        fis->command = (xa->flags & ATA_F_WRITE) ?
+                ATA_C_WRITE_FPDMA : ATA_C_READ_FPDMA;
+        fis->lba_low_exp = (u_int8_t)(lba >> 24);
+        fis->lba_mid_exp = (u_int8_t)(lba >> 32);
+        fis->lba_high_exp = (u_int8_t)(lba >> 40);
+        fis->sector_count = xa->tag << 3;
+        fis->features = (u_int8_t)count;
+        fis->features_exp = (u_int8_t)(count >> 8);
+    } else if (count > 0x100 || lba > 0x0FFFFFFFU) {
+        /*
+         * Use LBA48
+         */
+        fis->command = (xa->flags & ATA_F_WRITE) ?
+                ATA_C_WRITEDMA_EXT : ATA_C_READDMA_EXT;
+        fis->lba_low_exp = (u_int8_t)(lba >> 24);
+        fis->lba_mid_exp = (u_int8_t)(lba >> 32);
+        fis->lba_high_exp = (u_int8_t)(lba >> 40);
+        fis->sector_count = (u_int8_t)count;
+        fis->sector_count_exp = (u_int8_t)(count >> 8);
+    } else {
+        /*
+         * Use LBA
+         *
+         * NOTE: 256 sectors is supported, stored as 0.
+         */
+        fis->command = (xa->flags & ATA_F_WRITE) ?
+                ATA_C_WRITEDMA : ATA_C_READDMA;
+        fis->device |= (u_int8_t)(lba >> 24) & 0x0F;
+        fis->sector_count = (u_int8_t)count;
+    }
+}
+
 /*
  * Convert the SCSI command to an ata_xfer command in xa
  * for ATA_PORT_T_DISK operations.  Set the completion function
@@ -348,6 +412,10 @@ BOOL ahci_scsi_disk_io(struct IORequest *io, struct SCSICmd *scsi)
     scsi_cdb_t cdb = (APTR)scsi->scsi_Command;
 
     xa = ahci_ata_get_xfer(ap, at);
+    if (xa == NULL) {
+        io->io_Error = IOERR_UNITBUSY;
+        return TRUE;
+    }
 
     switch(cdb->generic.opcode) {
     case SCSI_REQUEST_SENSE:
@@ -490,54 +558,7 @@ BOOL ahci_scsi_disk_io(struct IORequest *io, struct SCSICmd *scsi)
         if (done)
             break;
 
-        fis = xa->fis;
-        fis->flags = ATA_H2D_FLAGS_CMD;
-        fis->lba_low = (u_int8_t)lba;
-        fis->lba_mid = (u_int8_t)(lba >> 8);
-        fis->lba_high = (u_int8_t)(lba >> 16);
-        fis->device = ATA_H2D_DEVICE_LBA;
-
-        /*
-         * NCQ only for direct-attached disks, do not currently
-         * try to use NCQ with port multipliers.
-         */
-        if (at->at_ncqdepth > 1 &&
-            ap->ap_type == ATA_PORT_T_DISK &&
-            (ap->ap_sc->sc_cap & AHCI_REG_CAP_SNCQ)) {
-            /*
-             * Use NCQ - always uses 48 bit addressing
-             */
-            xa->flags |= ATA_F_NCQ;
-            fis->command = (xa->flags & ATA_F_WRITE) ?
-                    ATA_C_WRITE_FPDMA : ATA_C_READ_FPDMA;
-            fis->lba_low_exp = (u_int8_t)(lba >> 24);
-            fis->lba_mid_exp = (u_int8_t)(lba >> 32);
-            fis->lba_high_exp = (u_int8_t)(lba >> 40);
-            fis->sector_count = xa->tag << 3;
-            fis->features = (u_int8_t)count;
-            fis->features_exp = (u_int8_t)(count >> 8);
-        } else if (count > 0x100 || lba > 0x0FFFFFFFU) {
-            /*
-             * Use LBA48
-             */
-            fis->command = (xa->flags & ATA_F_WRITE) ?
-                    ATA_C_WRITEDMA_EXT : ATA_C_READDMA_EXT;
-            fis->lba_low_exp = (u_int8_t)(lba >> 24);
-            fis->lba_mid_exp = (u_int8_t)(lba >> 32);
-            fis->lba_high_exp = (u_int8_t)(lba >> 40);
-            fis->sector_count = (u_int8_t)count;
-            fis->sector_count_exp = (u_int8_t)(count >> 8);
-        } else {
-            /*
-             * Use LBA
-             *
-             * NOTE: 256 sectors is supported, stored as 0.
-             */
-            fis->command = (xa->flags & ATA_F_WRITE) ?
-                    ATA_C_WRITEDMA : ATA_C_READDMA;
-            fis->device |= (u_int8_t)(lba >> 24) & 0x0F;
-            fis->sector_count = (u_int8_t)count;
-        }
+        ahci_ata_rw_fis(xa, lba, count);
 
         xa->data = scsi->scsi_Data;
         xa->datalen = scsi->scsi_Length;
@@ -345,6 +345,7 @@ typedef union scsi_cdb {
 } *scsi_cdb_t;
 
 
+void ahci_ata_rw_fis(struct ata_xfer *xa, u_int64_t lba, u_int32_t count);
 BOOL ahci_scsi_disk_io(struct IORequest *io, struct SCSICmd *scsi);
 BOOL ahci_scsi_atapi_io(struct IORequest *io, struct SCSICmd *scsi);
 
@@ -9,6 +9,7 @@
 #include <devices/newstyle.h>
 #include <proto/exec.h>
 #include <proto/input.h>
+#include <proto/timer.h>
 #include <exec/memory.h>
 #include <exec/errors.h>
 #include <exec/initializers.h>
@@ -35,6 +36,7 @@ static const UWORD SupportedCommands[] =
     IND_ADDEVENT,
     IND_SETTHRESH,
     IND_SETPERIOD,
+    IND_GETSTATS,
     NSCMD_DEVICEQUERY,
     0
 };
@@ -45,6 +47,7 @@ static const UWORD SupportedCommands[] =
 static int GM_UNIQUENAME(Init) (LIBBASETYPEPTR InputDevice)
 {
     NEWLIST(&(InputDevice->HandlerList));
+    NEWLIST(&(InputDevice->ReplyList));
 
     /*
        These defaults are in terms of 50 Hz ticks. The real VBlank frequency
@@ -143,10 +146,42 @@ AROS_LH1(void, beginio,
         break;
 #endif
 
-    case IND_ADDHANDLER:
-    case IND_REMHANDLER:
+    case IND_GETSTATS:
+        {
+            ULONG len = ioStd(ioreq)->io_Length;
+
+            if (len > sizeof(struct InputStatistics))
+                len = sizeof(struct InputStatistics);
+
+            Forbid();
+            CopyMem(&InputDevice->Stats, ioStd(ioreq)->io_Data, len);
+            Permit();
+
+            ioStd(ioreq)->io_Actual = len;
+        }
+        break;
+
     case IND_WRITEEVENT:
     case IND_ADDEVENT:
+        /* Timestamp the events now, not when the input task gets to them */
+        if (InputDevice->TimerBase)
+        {
+            struct Library *TimerBase = InputDevice->TimerBase;
+            struct InputEvent *ie = (struct InputEvent *)ioStd(ioreq)->io_Data;
+            struct timeval now;
+            ULONG count = 1;
+
+            if (ioreq->io_Command == IND_ADDEVENT)
+                count = ioStd(ioreq)->io_Length / sizeof(struct InputEvent);
+
+            GetSysTime(&now);
+            for (; count; count--, ie++)
+                ie->ie_TimeStamp = now;
+        }
+        /* Fall through */
+
+    case IND_ADDHANDLER:
+    case IND_REMHANDLER:
     case IND_SETTHRESH:
     case IND_SETPERIOD:
         done_quick = FALSE;
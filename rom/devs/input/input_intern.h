@@ -41,6 +41,13 @@
 #define DEFAULT_KEY_REPEAT_THRESHOLD 25
 #define DEFAULT_KEY_REPEAT_INTERVAL  2
 
+/* Events collected at most before the handlers are called */
+#define INPUT_MAXBATCH              32
+
+/* Copies of events from our own sources; one gathering pass adds at
+   most one each from the timer, key repeat, keyboard and gameport */
+#define INPUT_POOLSIZE              (INPUT_MAXBATCH + 4)
+
 struct inputbase
 {
     struct InputDevice pub;
@@ -61,6 +68,13 @@ struct inputbase
     UBYTE Prev1DownQual;
     UBYTE Prev2DownCode;
     UBYTE Prev2DownQual;
+
+    struct Library *TimerBase;
+    struct MinList ReplyList;       /* Requests with events in the queue */
+    UWORD QueuedEvents;             /* Events added since the last run */
+    UWORD PoolUsed;
+    struct InputEvent EventPool[INPUT_POOLSIZE];
+    struct InputStatistics Stats;
 };
 
 /* Prototypes */
@@ -68,6 +82,8 @@ VOID ProcessEvents(struct inputbase *InputDevice);
 struct Task *CreateInputTask(APTR taskparams,
     struct inputbase *InputDevice);
 VOID AddEQTail(struct InputEvent *ie, struct inputbase *InputDevice);
+struct InputEvent *CopyEvent(struct InputEvent *ie,
+    struct inputbase *InputDevice);
 struct InputEvent *GetEventsFromQueue(struct inputbase *InputDevice);
 BOOL IsQualifierKey(UWORD key);
 BOOL IsRepeatableKey(UWORD key);
@@ -90,15 +90,44 @@ asm(".global is_Code_Wrapper\n"
     "jsr (%a2)\n" "movem.l %sp@+,%d2-%d4/%a2\n" "rts\n");
 #endif
 
+/* Microseconds from one timestamp to a later one */
+static ULONG ElapsedMicros(const struct timeval *from,
+    const struct timeval *to)
+{
+    LONG secs = to->tv_secs - from->tv_secs;
+    LONG micro = to->tv_micro - from->tv_micro;
+
+    if (secs < 0 || (secs == 0 && micro < 0))
+        return 0;
+    if (secs > 4000)
+        return 0xFFFFFFFF;
+
+    return (ULONG)secs * 1000000 + micro;
+}
+
 /* Forwards a chain of events to the inputhandlers */
 VOID ForwardQueuedEvents(struct inputbase *InputDevice)
 {
-    struct InputEvent *ie_chain;
+    struct Library *TimerBase = InputDevice->TimerBase;
+    struct InputStatistics *stats = &InputDevice->Stats;
+    struct InputEvent *ie_chain, *ie;
     struct Interrupt *ihiterator;
+    struct timeval start, end;
+    ULONG count = 0, elapsed;
 
     ie_chain = GetEventsFromQueue(InputDevice);
     if (ie_chain)
     {
+        for (ie = ie_chain; ie; ie = ie->ie_NextEvent)
+            count++;
+
+        /* How long the oldest event has been waiting */
+        GetSysTime(&start);
+        elapsed = ElapsedMicros(&ie_chain->ie_TimeStamp, &start);
+        stats->ist_LastDelay = elapsed;
+        if (elapsed > stats->ist_MaxDelay)
+            stats->ist_MaxDelay = elapsed;
+
         ForeachNode(&(InputDevice->HandlerList), ihiterator)
         {
             D(bug("ipe: calling inputhandler %s at %p\n",
@@ -122,18 +151,44 @@ VOID ForwardQueuedEvents(struct inputbase *InputDevice)
             D(bug("ipe: returned from inputhandler\n"));
 
         }
+
+        GetSysTime(&end);
+        elapsed = ElapsedMicros(&start, &end);
+        stats->ist_Events += count;
+        stats->ist_Batches++;
+        if (count > stats->ist_MaxBatch)
+            stats->ist_MaxBatch = count;
+        stats->ist_LastTime = elapsed;
+        if (elapsed > stats->ist_MaxTime)
+            stats->ist_MaxTime = elapsed;
+        stats->ist_TotalTime += elapsed;
     }
 
     return;
 }
 
+/* Forwards the queued events, then replies the requests they came with */
+static VOID FlushEvents(struct inputbase *InputDevice)
+{
+    struct Message *msg;
+
+    ForwardQueuedEvents(InputDevice);
+
+    while ((msg = (struct Message *)RemHead((struct List *)
+                &InputDevice->ReplyList)))
+        ReplyMsg(msg);
+
+    InputDevice->QueuedEvents = 0;
+    InputDevice->PoolUsed = 0;
+}
+
 
 /***********************************
 ** Input device task entry point  **
 ***********************************/
 void ProcessEvents(struct inputbase *InputDevice)
 {
-    ULONG commandsig, kbdsig, wakeupsigs;
+    ULONG commandsig, kbdsig, wakeupsigs, sigs;
     ULONG gpdsig, timersig, keytimersig;
     struct MsgPort *timermp, *keytimermp;
     struct timerequest *timerio, *keytimerio;
@@ -176,6 +231,7 @@ void ProcessEvents(struct inputbase *InputDevice)
         Alert(AT_DeadEnd | AG_OpenDev | AN_Unknown);
 
     TimerBase = (struct Library *)timerio->tr_node.io_Device;
+    InputDevice->TimerBase = TimerBase;
 
     *keytimerio = *timerio;
     keytimerio->tr_node.io_Message.mn_ReplyPort = keytimermp;
@@ -261,9 +317,32 @@ void ProcessEvents(struct inputbase *InputDevice)
 
     for (;;)
     {
-        wakeupsigs = Wait(commandsig |
-            kbdsig |
-            gpdsig | timersig | keytimersig | InputDevice->ResetSig);
+        sigs = commandsig | kbdsig | gpdsig | timersig | keytimersig |
+            InputDevice->ResetSig;
+
+        if (InputDevice->QueuedEvents == 0
+            && IsListEmpty((struct List *)&InputDevice->ReplyList))
+        {
+            wakeupsigs = Wait(sigs);
+        }
+        else
+        {
+            /*
+             * Events are queued. Whatever has arrived in the meantime is
+             * added to them, so that the handlers get one chain and
+             * pointer moves can be merged. Once nothing more is pending,
+             * or the batch is full, the handlers are called.
+             */
+            wakeupsigs = SetSignal(0, sigs) & sigs;
+            if (!wakeupsigs || InputDevice->QueuedEvents >= INPUT_MAXBATCH)
+            {
+                SetSignal(wakeupsigs, wakeupsigs);
+                D(bug("id: Forwarding events\n"));
+                FlushEvents(InputDevice);
+                D(bug("id: Events forwarded\n"));
+                continue;
+            }
+        }
 
         D(bug("Wakeup sig: %x, cmdsig: %x, kbdsig: %x\n, timersig: %x",
                 wakeupsigs, commandsig, kbdsig, timersig));
@@ -284,8 +363,7 @@ void ProcessEvents(struct inputbase *InputDevice)
             /* Add a timestamp to the event */
             GetSysTime(&(timer_ie.ie_TimeStamp));
 
-            AddEQTail(&timer_ie, InputDevice);
-            ForwardQueuedEvents(InputDevice);
+            AddEQTail(CopyEvent(&timer_ie, InputDevice), InputDevice);
 
             SEND_TIMER_REQUEST(timerio);
         }
@@ -298,6 +376,8 @@ void ProcessEvents(struct inputbase *InputDevice)
             while ((ioreq =
                     (struct IOStdReq *)GetMsg(InputDevice->CommandPort)))
             {
+                /* Events are replied after the handlers have seen them */
+                BOOL reply = TRUE;
 
                 switch (ioreq->io_Command)
                 {
@@ -327,7 +407,8 @@ void ProcessEvents(struct inputbase *InputDevice)
                         /*
                          * IND_ADDEVENT command allows client to send multiple
                          * RAWKEY or RAWMOUSE events to the input.device. All
-                         * other classes will be ignored.
+                         * other classes will be ignored. The events have
+                         * been timestamped by BeginIO().
                          */
                         struct InputEvent *ie =
                             (struct InputEvent *)ioreq->io_Data;
@@ -382,28 +463,11 @@ void ProcessEvents(struct inputbase *InputDevice)
                                     }
                                 }
 
-                                /* If the event's qualifier differs from the
-                                   current one, fire the events */
-                                if (InputDevice->ActQualifier ==
-                                    ie->ie_Qualifier)
-                                {
-                                    UWORD q = ie->ie_Qualifier;
-                                    ForwardQueuedEvents(InputDevice);
-
-                                    /* And set new qualifier */
-                                    InputDevice->ActQualifier = q;
-                                }
-
-                                /* Set the timestamp */
-                                GetSysTime(&(ie->ie_TimeStamp));
-
                                 /* and enqueue */
                                 AddEQTail(ie, InputDevice);
                             }
                         }
-                        /* In case some events are still in the queue, fire
-                           them all up */
-                        ForwardQueuedEvents(InputDevice);
+                        reply = FALSE;
                     }
                     break;
 
@@ -414,17 +478,13 @@ void ProcessEvents(struct inputbase *InputDevice)
                         ie = (struct InputEvent *)ioreq->io_Data;
 
                         ie->ie_NextEvent = NULL;
-                        /* Add a timestamp to the event */
-                        GetSysTime(&(ie->ie_TimeStamp));
 
                         D(bug("id: %d\n", ie->ie_Class));
 
                         /* Add event to queue */
                         AddEQTail((struct InputEvent *)ioreq->io_Data,
                             InputDevice);
-
-                        /* Forward event (and possible others in the queue) */
-                        ForwardQueuedEvents(InputDevice);
+                        reply = FALSE;
                     } break;
 
                 case IND_SETTHRESH:
@@ -443,7 +503,19 @@ void ProcessEvents(struct inputbase *InputDevice)
 
                 }
 
-                ReplyMsg((struct Message *)ioreq);
+                if (reply)
+                    ReplyMsg((struct Message *)ioreq);
+                else
+                    AddTail((struct List *)&InputDevice->ReplyList,
+                        (struct Node *)ioreq);
+
+                /* Leave the rest for the next batch */
+                if (InputDevice->QueuedEvents >= INPUT_MAXBATCH)
+                {
+                    if (!IsMsgPortEmpty(InputDevice->CommandPort))
+                        SetSignal(commandsig, commandsig);
+                    break;
+                }
             }
         }
 
@@ -461,10 +533,7 @@ void ProcessEvents(struct inputbase *InputDevice)
             ie.ie_Qualifier |= IEQUALIFIER_REPEAT;
             GetSysTime(&ie.ie_TimeStamp);
 
-            AddEQTail(&ie, InputDevice);
-
-            /* Forward event (and possible others in the queue) */
-            ForwardQueuedEvents(InputDevice);
+            AddEQTail(CopyEvent(&ie, InputDevice), InputDevice);
 
             SEND_KEYTIMER_REQUEST(keytimerio,
                 InputDevice->KeyRepeatInterval);
@@ -484,8 +553,8 @@ void ProcessEvents(struct inputbase *InputDevice)
             kbdie->ie_Qualifier |=
                 (InputDevice->ActQualifier & MOUSE_QUALIFIERS);
 
-            /* Add event to queue */
-            AddEQTail(kbdie, InputDevice);
+            /* Add event to queue, kbdie is reused for the next one */
+            AddEQTail(CopyEvent(kbdie, InputDevice), InputDevice);
 
             if (!IsQualifierKey(kbdie->ie_Code))
             {
@@ -511,11 +580,6 @@ void ProcessEvents(struct inputbase *InputDevice)
 
             /* New event from keyboard device */
             D(bug("id: Keyboard event\n"));
-            D(bug("id: Events forwarded\n"));
-
-            /* Forward event (and possible others in the queue) */
-            ForwardQueuedEvents(InputDevice);
-            D(bug("id: Events forwarded\n"));
 
             /* Wait for some more events */
             SEND_KBD_REQUEST(kbdio, kbdie);
@@ -551,16 +615,11 @@ void ProcessEvents(struct inputbase *InputDevice)
                     InputDevice->ActQualifier & KEY_QUALIFIERS;
             }
 
-            /* Add event to queue */
-            AddEQTail(gpdie, InputDevice);
+            /* Add event to queue, gpdie is reused for the next one */
+            AddEQTail(CopyEvent(gpdie, InputDevice), InputDevice);
 
             /* New event from gameport device */
             D(bug("id: Gameport event\n"));
-            D(bug("id: Forwarding events\n"));
-
-            /* Forward event (and possible others in the queue) */
-            ForwardQueuedEvents(InputDevice);
-            D(bug("id: Events forwarded\n"));
 
             /* Wait for some more events */
             SEND_GPD_REQUEST(gpdio, gpdie);
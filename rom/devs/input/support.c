@@ -31,6 +31,73 @@ struct InputEvent *GetEventsFromQueue(struct inputbase *InputDevice)
 
 
 
+/**********************
+**  CoalesceEvent()  **
+**********************/
+/* Merges a pointer move into the same kind of move at the end of the
+   queue. Only events that arrived while the handlers were busy are in
+   the queue, so this happens only when they cannot keep up. */
+static BOOL CoalesceEvent(struct InputEvent *ie, struct InputEvent *tail)
+{
+    LONG x, y;
+
+    if (tail == NULL || ie->ie_NextEvent != NULL
+        || ie->ie_Class != tail->ie_Class
+        || ie->ie_SubClass != tail->ie_SubClass
+        || ie->ie_Qualifier != tail->ie_Qualifier
+        || ie->ie_Code != IECODE_NOBUTTON
+        || tail->ie_Code != IECODE_NOBUTTON)
+        return FALSE;
+
+    switch (ie->ie_Class)
+    {
+    case IECLASS_RAWMOUSE:
+        if (ie->ie_Qualifier & IEQUALIFIER_RELATIVEMOUSE)
+        {
+            x = tail->ie_X + ie->ie_X;
+            y = tail->ie_Y + ie->ie_Y;
+            if (x < -32768 || x > 32767 || y < -32768 || y > 32767)
+                return FALSE;
+            tail->ie_X = x;
+            tail->ie_Y = y;
+        }
+        else
+        {
+            tail->ie_X = ie->ie_X;
+            tail->ie_Y = ie->ie_Y;
+        }
+        break;
+
+    case IECLASS_NEWPOINTERPOS:
+        /* Absolute, the sender's data stays valid until we reply */
+        tail->ie_EventAddress = ie->ie_EventAddress;
+        break;
+
+    default:
+        return FALSE;
+    }
+
+    tail->ie_TimeStamp = ie->ie_TimeStamp;
+
+    return TRUE;
+}
+
+/******************
+**  CopyEvent()  **
+******************/
+/* Queues a copy of an event whose buffer is reused right away */
+struct InputEvent *CopyEvent(struct InputEvent *ie,
+    struct inputbase *InputDevice)
+{
+    struct InputEvent *copy =
+        &InputDevice->EventPool[InputDevice->PoolUsed++];
+
+    *copy = *ie;
+    copy->ie_NextEvent = NULL;
+
+    return copy;
+}
+
 /******************
 **  AddEQTail()  **
 ******************/
@@ -82,6 +149,14 @@ VOID AddEQTail(struct InputEvent *ie, struct inputbase *InputDevice)
         }
     }
 
+    InputDevice->QueuedEvents++;
+
+    if (CoalesceEvent(ie, InputDevice->EventQueueTail))
+    {
+        InputDevice->Stats.ist_Coalesced++;
+        return;
+    }
+
     if (!InputDevice->EventQueueHead)   /* Empty queue? */
     {
         InputDevice->EventQueueHead = ie;
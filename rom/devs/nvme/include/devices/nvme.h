@@ -0,0 +1,45 @@
+#ifndef DEVICES_NVME_H
+#define DEVICES_NVME_H
+
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: nvme.device specific commands
+    Lang: english
+*/
+
+#ifndef EXEC_TYPES_H
+#   include <exec/types.h>
+#endif
+#ifndef EXEC_IO_H
+#   include <exec/io.h>
+#endif
+
+/*
+ * Vectored transfers.
+ *
+ * io_Data points to an array of io_Length NVMEIOVec entries, each one
+ * describing an independent, sector aligned extent. All extents are
+ * queued on one hardware queue with a single doorbell write, and the
+ * request is replied once every extent has completed.
+ *
+ * On return io_Actual holds the number of bytes transferred and io_Error
+ * the first error encountered. The result of each extent is stored in
+ * its nv_Error field.
+ */
+#define NVMECMD_READVEC         (CMD_NONSTD + 0x60)
+#define NVMECMD_WRITEVEC        (CMD_NONSTD + 0x61)
+
+/* Maximum number of extents in one vectored request */
+#define NVME_MAXIOVEC           64
+
+struct NVMEIOVec
+{
+    UQUAD       nv_Offset;      /* Byte offset on the unit          */
+    APTR        nv_Data;        /* Buffer                           */
+    ULONG       nv_Length;      /* Length in bytes                  */
+    BYTE        nv_Error;       /* Filled in by the device          */
+    UBYTE       nv_Pad[3];
+};
+
+#endif /* DEVICES_NVME_H */
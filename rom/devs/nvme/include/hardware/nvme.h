@@ -70,6 +70,13 @@ struct nvme_id_ctrl {
     UBYTE			vs[1024];
 };
 
+enum {
+	NVME_CTRL_ONCS_COMPARE		= 1 << 0,
+	NVME_CTRL_ONCS_WRITE_UNCORRECTABLE	= 1 << 1,
+	NVME_CTRL_ONCS_DSM		= 1 << 2,
+	NVME_CTRL_VWC_PRESENT		= 1 << 0,
+};
+
 /* i/o commands */
 enum nvme_opcode {
     nvme_cmd_flush		= 0x00,
@@ -194,6 +201,31 @@ enum {
     NVME_FEAT_SW_PROGRESS	= 0x0c,
 };
 
+struct nvme_dsm_cmd {
+    struct nvme_op              op;
+    ULONG			nsid;
+    UQUAD			rsvd2[2];
+    UQUAD			prp1;
+    UQUAD			prp2;
+    ULONG			nr;
+    ULONG			attributes;
+    ULONG			rsvd12[4];
+};
+
+enum {
+	NVME_DSMGMT_IDR		= 1 << 0,
+	NVME_DSMGMT_IDW		= 1 << 1,
+	NVME_DSMGMT_AD		= 1 << 2,
+};
+
+#define NVME_DSM_MAX_RANGES	256
+
+struct nvme_dsm_range {
+    ULONG			cattr;
+    ULONG			nlb;
+    UQUAD			slba;
+};
+
 struct nvme_features {
     struct nvme_op              op;
     ULONG			nsid;
@@ -251,6 +283,7 @@ struct nvme_command {
     union {
         struct nvme_common_command      common;
         struct nvme_rw_command          rw;
+        struct nvme_dsm_cmd             dsm;
         struct nvme_identify            identify;
         struct nvme_features            features;
         struct nvme_create_cq           create_cq;
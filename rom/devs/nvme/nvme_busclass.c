@@ -74,7 +74,6 @@ static AROS_INTH1(NVME_IOIntCode, struct nvme_queue *, nvmeq)
 static void nvme_iotask(struct nvme_queue *nvmeq)
 {
     struct Task *thisTask = FindTask(NULL);
-    int i;
 
     DIO(
         bug ("[NVME:Bus] %s(0x%p)\n", __func__, nvmeq);
@@ -83,26 +82,8 @@ static void nvme_iotask(struct nvme_queue *nvmeq)
     SetSignal(0, SIGF_SINGLE);
     for (;;) {
         Wait(SIGF_SINGLE);
-        for (i = 0; i < nvmeq->q_depth; i ++) {
-            struct completionevent_handler *slot = nvmeq->cehandlers[i];
-
-            if (slot && slot->ceh_Reply) {
-                struct IOExtTD *iotd = (struct IOExtTD *)slot->ceh_Msg;
-
-                D(bug ("[NVME:Bus] %s: replying to IO @ 0x%p\n", __func__, iotd);)
-
-                ReplyMsg((struct Message *)iotd);
-
-                slot->ceh_Reply = FALSE;
-                slot->ceh_Task = NULL;
-                slot->ceh_Msg = NULL;
-                slot->ceh_SigSet = 0;
-
-                nvmeq->cehandlers[i] = NULL;
-                nvmeq->cehooks[i] = NULL;
-                nvme_release_cmdid(nvmeq, i);
-            }
-        }
+        /* One signal may stand for any number of completions */
+        nvme_reply_iocompletions(nvmeq);
     }
 }
 
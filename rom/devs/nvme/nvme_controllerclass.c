@@ -291,6 +291,15 @@ OOP_Object *NVME__Root__New(OOP_Class *cl, OOP_Object *o, struct pRoot_New *msg)
                         } else
                             dev->dev_Features &= ~NVME_DEVF_SGL_SUPPORTED;
 
+                        if (AROS_LE2WORD(ctrl->oncs) & NVME_CTRL_ONCS_DSM) {
+                            dev->dev_Features |= NVME_DEVF_DSM_SUPPORTED;
+                            D(bug ("[NVME:Controller] %s: Dataset Management supported\n", __func__);)
+                        }
+                        if (ctrl->vwc & NVME_CTRL_VWC_PRESENT) {
+                            dev->dev_Features |= NVME_DEVF_VWC_PRESENT;
+                            D(bug ("[NVME:Controller] %s: volatile write cache present\n", __func__);)
+                        }
+
                         struct TagItem attrs[] = {
                             {aHidd_Name,                (IPTR)GM_UNIQUENAME(LibName)                    },
                             {aHidd_HardwareName,        0                                               },
@@ -15,6 +15,7 @@
 
 #include "nvme_debug.h"
 #include "nvme_intern.h"
+#include "nvme_hw.h"
 
 /*
     Hardware Access Support Functions
@@ -78,15 +79,24 @@ void nvme_release_cmdid(struct nvme_queue *nvmeq, UWORD cmdid)
 }
 
 int nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
+{
+    return nvme_submit_cmds(nvmeq, &cmd, 1);
+}
+
+/*
+    Queue count commands and ring the submission doorbell once for all of
+    them. Either all commands are queued or none is.
+*/
+int nvme_submit_cmds(struct nvme_queue *nvmeq, struct nvme_command **cmds, UWORD count)
 {
 #if defined(__AROSEXEC_SMP__)
     struct NVMEBase *NVMEBase = nvmeq->dev->dev_NVMEBase;
 #endif
     UWORD tail;
-    UWORD next;
+    UWORD space;
+    UWORD i;
 
-    D(bug ("[NVME:HW] %s(0x%p, 0x%p)\n", __func__, nvmeq, cmd);)
-    D(bug ("[NVME:HW] %s: sending command id #%u\n", __func__, cmd->common.op.command_id);)
+    D(bug ("[NVME:HW] %s(0x%p, 0x%p, %u)\n", __func__, nvmeq, cmds, count);)
 
     Disable();
 #if defined(__AROSEXEC_SMP__)
@@ -94,11 +104,10 @@ int nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
 #endif
 
     tail = nvmeq->sq_tail;
-    next = tail + 1;
-    if (next == nvmeq->q_depth)
-        next = 0;
+    /* one entry always stays empty to tell a full queue from an empty one */
+    space = (nvmeq->sq_head + nvmeq->q_depth - tail - 1) % nvmeq->q_depth;
 
-    if (next == nvmeq->sq_head) {
+    if (count == 0 || count > space) {
 #if defined(__AROSEXEC_SMP__)
         KrnSpinUnLock(&nvmeq->q_lock);
 #endif
@@ -106,9 +115,14 @@ int nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
         return -1;
     }
 
-    CopyMem(cmd, &nvmeq->sqba[tail], sizeof(struct nvme_command));
-    nvmeq->sq_tail = next;
-    *nvmeq->q_db = next;
+    for (i = 0; i < count; i++) {
+        D(bug ("[NVME:HW] %s: sending command id #%u\n", __func__, cmds[i]->common.op.command_id);)
+        CopyMem(cmds[i], &nvmeq->sqba[tail], sizeof(struct nvme_command));
+        if (++tail == nvmeq->q_depth)
+            tail = 0;
+    }
+    nvmeq->sq_tail = tail;
+    *nvmeq->q_db = tail;
 
 #if defined(__AROSEXEC_SMP__)
     KrnSpinUnLock(&nvmeq->q_lock);
@@ -172,5 +186,11 @@ void nvme_process_cq(struct nvme_queue *nvmeq)
         KrnSpinUnLock(&nvmeq->q_lock);
     }
 #endif
+
+    /* Wake the IO task once for all IO completions found in this pass */
+    if (nvmeq->q_DoneSignal) {
+        nvmeq->q_DoneSignal = 0;
+        Signal(nvmeq->q_IOTask, SIGF_SINGLE);
+    }
     D(bug ("[NVME:HW] %s: finished\n", __func__);)
 }
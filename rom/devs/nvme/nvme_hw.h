@@ -1,5 +1,6 @@
 
 extern int nvme_submit_cmd(struct nvme_queue *, struct nvme_command *);
+extern int nvme_submit_cmds(struct nvme_queue *, struct nvme_command **, UWORD);
 extern struct nvme_queue *nvme_alloc_queue(device_t, int, int, int);
 extern void nvme_free_queue(struct nvme_queue *);
 extern void nvme_process_cq(struct nvme_queue *);
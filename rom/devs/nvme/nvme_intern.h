@@ -165,6 +165,8 @@ typedef struct {
 #define NVME_INLINE_DMA_SEGMENTS   4
 
 #define NVME_DEVF_SGL_SUPPORTED   (1UL << 0)
+#define NVME_DEVF_DSM_SUPPORTED   (1UL << 1)
+#define NVME_DEVF_VWC_PRESENT     (1UL << 2)
 
 struct nvme_dma_segment
 {
@@ -173,10 +175,20 @@ struct nvme_dma_segment
     ULONG               nds_Flags;
 };
 
+/* Tracks the outstanding commands of a vectored or discard request */
+struct nvme_iobatch
+{
+    ULONG               nib_Pending;
+    ULONG               nib_Actual;
+    BYTE                nib_Error;
+};
+
 struct completionevent_handler
 {
     struct Task         *ceh_Task;
     APTR                ceh_Msg;
+    struct nvme_iobatch *ceh_Batch;             /* NULL for single commands */
+    APTR                ceh_Vec;                /* struct NVMEIOVec of this command */
     struct MemEntry     ceh_IOMem;
     ULONG               ceh_SigSet;
     ULONG               ceh_Result;
@@ -310,6 +322,13 @@ struct nvme_queue {
     UWORD cq_phase;
     UWORD cmdid_hint;
     UBYTE *cmdid_busy;
+    /* completed IO command ids waiting to be replied by q_IOTask */
+    UWORD *q_DoneRing;
+    UWORD q_DoneHead;
+    UWORD q_DoneTail;
+    UWORD q_DoneSignal;
+    /* IO commands submitted but not yet replied */
+    ULONG q_Outstanding;
 };
 
 struct nvme_Controller
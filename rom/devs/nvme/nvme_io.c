@@ -37,24 +37,131 @@
 #include "nvme_intern.h"
 #include "nvme_queue_io.h"
 
+#include <devices/nvme.h>
+#include <devices/ata.h>
+
 #include LC_LIBDEFS_FILE
 
 extern BOOL nvme_initprp(struct nvme_command *cmdio, struct completionevent_handler *ioehandle, struct nvme_Unit *unit, ULONG len, APTR *data, BOOL is_write);
 extern BOOL nvme_initsgl(struct nvme_command *cmdio, struct completionevent_handler *ioehandle, struct nvme_Unit *unit, ULONG len, APTR *data, BOOL is_write);
 
+/*
+    A queue with this many more commands in flight than another one loses
+    its CPU affinity for new requests.
+*/
+#define NVME_QUEUE_AFFINITY_SLACK       8
+
+/*
+    Pick the IO queue for a new request. The queue of the current CPU is
+    preferred, unless another queue has noticeably fewer commands in flight.
+*/
+static struct nvme_queue *nvme_select_ioqueue(device_t dev)
+{
+    struct NVMEBase *NVMEBase = dev->dev_NVMEBase;
+    struct nvme_queue *best;
+    ULONG bestdepth;
+    ULONG qno;
+
+    (void)NVMEBase;
+
+    best = dev->dev_Queues[1 + (KrnGetCPUNumber() % dev->queuecnt)];
+    bestdepth = best->q_Outstanding;
+
+    for (qno = 1; qno <= dev->queuecnt && bestdepth > NVME_QUEUE_AFFINITY_SLACK; qno++) {
+        struct nvme_queue *nvmeq = dev->dev_Queues[qno];
+
+        if (nvmeq && nvmeq->q_Outstanding + NVME_QUEUE_AFFINITY_SLACK < bestdepth) {
+            best = nvmeq;
+            bestdepth = nvmeq->q_Outstanding;
+        }
+    }
+
+    return best;
+}
+
+static inline ULONG nvme_unit_nsid(struct nvme_Unit *unit)
+{
+    return (unit->au_UnitNum & ((1 << 12) - 1)) + 1;
+}
+
+/*
+    Check an extent and build the read/write command and DMA mapping for it.
+    Returns 0 or an IOERR_ code.
+*/
+static BYTE nvme_setup_rw(struct nvme_Unit *unit, UQUAD off64, APTR data, ULONG len, BOOL is_write,
+                          struct nvme_command *cmdio, struct completionevent_handler *ioehandle)
+{
+    device_t dev = unit->au_Bus->ab_Dev;
+    BOOL setup_ok = FALSE;
+    ULONG nsid;
+
+    if ((off64 >> unit->au_SecShift) > unit->au_High) {
+        bug("[NVME%02ld] %s: BADADDRESS %x > %x\n", unit->au_UnitNum, __func__, (off64 >> unit->au_SecShift), unit->au_High);
+        return IOERR_BADADDRESS;
+    } else if ((len == 0) || (len > (1 << dev->dev_mdts) * dev->pagesize)) {
+        bug("[NVME%02ld] %s: BADLENGTH (writing %u bytes to %x)\n", unit->au_UnitNum, __func__, len, (off64 >> unit->au_SecShift));
+        return IOERR_BADLENGTH;
+    }
+
+    memset(cmdio, 0, sizeof(*cmdio));
+    memset(ioehandle, 0, sizeof(*ioehandle));
+    nvme_dma_init(ioehandle);
+
+    if (dev && (dev->dev_Features & NVME_DEVF_SGL_SUPPORTED)) {
+        if (nvme_initsgl(cmdio, ioehandle, unit, len, &data, is_write)) {
+            setup_ok = TRUE;
+        } else {
+            nvme_dma_release(ioehandle, TRUE);
+            nvme_dma_init(ioehandle);
+            ioehandle->ceh_IOMem.me_Un.meu_Addr = NULL;
+            ioehandle->ceh_IOMem.me_Length = 0;
+        }
+    }
+
+    if (!setup_ok) {
+        if (!nvme_initprp(cmdio, ioehandle, unit, len, &data, is_write)) {
+            nvme_dma_release(ioehandle, TRUE);
+            return IOERR_BADADDRESS;
+        }
+    }
+
+    nsid = nvme_unit_nsid(unit);
+
+    if (is_write) {
+        cmdio->rw.op.opcode = nvme_cmd_write;
+    } else {
+        cmdio->rw.op.opcode = nvme_cmd_read;
+    }
+
+    cmdio->rw.nsid = AROS_LONG2LE(nsid);
+    cmdio->rw.length = AROS_WORD2LE((len >> unit->au_SecShift) - 1);
+    cmdio->rw.slba = AROS_QUAD2LE(off64 >> unit->au_SecShift);
+    cmdio->rw.control = 0;
+    cmdio->rw.dsmgmt = 0;
+
+    return 0;
+}
+
+static void nvme_cleanup_rw(struct completionevent_handler *ioehandle)
+{
+    if (ioehandle->ceh_IOMem.me_Un.meu_Addr) {
+        FreeMem(ioehandle->ceh_IOMem.me_Un.meu_Addr, ioehandle->ceh_IOMem.me_Length);
+        ioehandle->ceh_IOMem.me_Un.meu_Addr = NULL;
+    }
+    nvme_dma_release(ioehandle, TRUE);
+}
+
 static BOOL nvme_sector_rw(struct IORequest *io, UQUAD off64, BOOL is_write)
 {
     struct IOExtTD *iotd = (struct IOExtTD *)io;
     struct nvme_Unit *unit = (struct nvme_Unit *)io->io_Unit;
     struct NVMEBase *NVMEBase = unit->au_Bus->ab_Base;
-    device_t dev = unit->au_Bus->ab_Dev;
     APTR data = iotd->iotd_Req.io_Data;
     ULONG len = iotd->iotd_Req.io_Length;
     struct nvme_queue *nvmeq;
     struct completionevent_handler ioehandle;
     struct nvme_command cmdio;
-    int queueno;
-    BOOL setup_ok = FALSE;
+    BYTE err;
 
     D(
         bug("[NVME%02ld] %s(%08x%08x, 0x%p, %u) %s\n", unit->au_UnitNum, __func__, (off64 >> 32), off64 & 0xFFFFFFFF, data, len, is_write ? "WRITE" : "READ");
@@ -65,44 +172,147 @@ static BOOL nvme_sector_rw(struct IORequest *io, UQUAD off64, BOOL is_write)
         bug("[NVME%02ld] %s: %u queues available\n", unit->au_UnitNum, __func__, unit->au_Bus->ab_Dev->queuecnt);
     )
 
-    if ((off64 >> unit->au_SecShift) > unit->au_High) {
-        bug("[NVME%02ld] %s: BADADDRESS %x > %x\n", unit->au_UnitNum, __func__, (off64 >> unit->au_SecShift), unit->au_High);
-        io->io_Error = IOERR_BADADDRESS;
+    (void)NVMEBase;
+
+    err = nvme_setup_rw(unit, off64, data, len, is_write, &cmdio, &ioehandle);
+    if (err) {
+        io->io_Error = err;
         return TRUE;
-    } else if ((len == 0) || (len > (1 << unit->au_Bus->ab_Dev->dev_mdts) * unit->au_Bus->ab_Dev->pagesize)) {
-        bug("[NVME%02ld] %s: BADLENGTH (writing %u bytes to %x)\n", unit->au_UnitNum, __func__, len, (off64 >> unit->au_SecShift));
+    }
+
+    nvmeq = nvme_select_ioqueue(unit->au_Bus->ab_Dev);
+
+    DIO(bug("[NVME%02ld] %s: queue @ 0x%p\n", unit->au_UnitNum, __func__, nvmeq);)
+
+    ioehandle.ceh_Task = nvmeq->q_IOTask;
+    ioehandle.ceh_SigSet = SIGF_SINGLE;
+    ioehandle.ceh_Msg = io;
+
+    ObtainSemaphore(&unit->au_Lock);
+    Remove(&io->io_Message.mn_Node);
+    ReleaseSemaphore(&unit->au_Lock);
+
+    DIO(
+        bug("[NVME%02ld] %s: %08x%08x (%u)\n", unit->au_UnitNum, __func__, (cmdio.rw.slba >> 32), (cmdio.rw.slba & 0xFFFFFFFF), AROS_LE2WORD(cmdio.rw.length));
+    )
+
+    if (nvme_submit_iocmd(nvmeq, &cmdio, &ioehandle) != 0) {
+        nvme_cleanup_rw(&ioehandle);
+        io->io_Error = IOERR_ABORTED;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*
+    NVMECMD_READVEC/NVMECMD_WRITEVEC: build one command per extent and
+    queue them all on the same IO queue with a single doorbell write.
+    The queue's IO task replies the request when the last one completes.
+*/
+static BOOL nvme_vector_rw(struct IORequest *io, BOOL is_write)
+{
+    struct IOStdReq *ios = IOStdReq(io);
+    struct nvme_Unit *unit = (struct nvme_Unit *)io->io_Unit;
+    struct NVMEIOVec *vec = ios->io_Data;
+    ULONG count = ios->io_Length;
+    struct nvme_command *cmds = NULL, *cmdptrs[NVME_MAXIOVEC];
+    struct completionevent_handler *handles = NULL, *handleptrs[NVME_MAXIOVEC];
+    struct nvme_iobatch *batch = NULL;
+    struct nvme_queue *nvmeq;
+    ULONG i, setup = 0;
+    BYTE err = 0;
+
+    D(bug("[NVME%02ld] %s(0x%p, %u) %s\n", unit->au_UnitNum, __func__, vec, count, is_write ? "WRITE" : "READ");)
+
+    ios->io_Actual = 0;
+
+    if (!vec || count == 0 || count > NVME_MAXIOVEC) {
         io->io_Error = IOERR_BADLENGTH;
         return TRUE;
     }
 
-    memset(&cmdio, 0, sizeof(cmdio));
-    memset(&ioehandle, 0, sizeof(ioehandle));
-    nvme_dma_init(&ioehandle);
+    cmds = AllocMem(count * sizeof(struct nvme_command), MEMF_ANY);
+    handles = AllocMem(count * sizeof(struct completionevent_handler), MEMF_ANY);
+    batch = AllocMem(sizeof(struct nvme_iobatch), MEMF_CLEAR);
+    if (!cmds || !handles || !batch) {
+        err = IOERR_NOMEMORY;
+        goto fail;
+    }
 
-    if (dev && (dev->dev_Features & NVME_DEVF_SGL_SUPPORTED)) {
-        if (nvme_initsgl(&cmdio, &ioehandle, unit, len, &data, is_write)) {
-            setup_ok = TRUE;
-        } else {
-            nvme_dma_release(&ioehandle, TRUE);
-            nvme_dma_init(&ioehandle);
-            ioehandle.ceh_IOMem.me_Un.meu_Addr = NULL;
-            ioehandle.ceh_IOMem.me_Length = 0;
+    nvmeq = nvme_select_ioqueue(unit->au_Bus->ab_Dev);
+
+    for (setup = 0; setup < count; setup++) {
+        vec[setup].nv_Error = 0;
+        err = nvme_setup_rw(unit, vec[setup].nv_Offset, vec[setup].nv_Data, vec[setup].nv_Length, is_write,
+                            &cmds[setup], &handles[setup]);
+        if (err) {
+            vec[setup].nv_Error = err;
+            goto fail;
         }
+        handles[setup].ceh_Task = nvmeq->q_IOTask;
+        handles[setup].ceh_SigSet = SIGF_SINGLE;
+        handles[setup].ceh_Msg = io;
+        handles[setup].ceh_Batch = batch;
+        handles[setup].ceh_Vec = &vec[setup];
+        cmdptrs[setup] = &cmds[setup];
+        handleptrs[setup] = &handles[setup];
     }
 
-    if (!setup_ok) {
-        if (!nvme_initprp(&cmdio, &ioehandle, unit, len, &data, is_write)) {
-            nvme_dma_release(&ioehandle, TRUE);
-            io->io_Error = IOERR_BADADDRESS;
-            return TRUE;
-        }
+    batch->nib_Pending = count;
+
+    ObtainSemaphore(&unit->au_Lock);
+    Remove(&io->io_Message.mn_Node);
+    ReleaseSemaphore(&unit->au_Lock);
+
+    if (nvme_submit_iocmds(nvmeq, cmdptrs, handleptrs, count) != 0) {
+        err = IOERR_ABORTED;
+        goto fail;
     }
 
-    ULONG nsid = (unit->au_UnitNum & ((1 << 12) - 1)) + 1;
-    queueno = 1 + (KrnGetCPUNumber() % unit->au_Bus->ab_Dev->queuecnt);
-    nvmeq = unit->au_Bus->ab_Dev->dev_Queues[queueno];
+    /* The command slots hold copies of everything the completion needs */
+    FreeMem(handles, count * sizeof(struct completionevent_handler));
+    FreeMem(cmds, count * sizeof(struct nvme_command));
 
-    DIO(bug("[NVME%02ld(%02u)] %s: queue @ 0x%p\n", unit->au_UnitNum, queueno, __func__, nvmeq);)
+    return FALSE;
+
+fail:
+    for (i = 0; i < setup; i++)
+        nvme_cleanup_rw(&handles[i]);
+    if (batch)
+        FreeMem(batch, sizeof(struct nvme_iobatch));
+    if (handles)
+        FreeMem(handles, count * sizeof(struct completionevent_handler));
+    if (cmds)
+        FreeMem(cmds, count * sizeof(struct nvme_command));
+    io->io_Error = err;
+    return TRUE;
+}
+
+/*
+    CMD_UPDATE: flush the volatile write cache, if the controller has one.
+*/
+static BOOL nvme_flush(struct IORequest *io)
+{
+    struct nvme_Unit *unit = (struct nvme_Unit *)io->io_Unit;
+    device_t dev = unit->au_Bus->ab_Dev;
+    struct completionevent_handler ioehandle;
+    struct nvme_command cmdio;
+    struct nvme_queue *nvmeq;
+
+    if (!(dev->dev_Features & NVME_DEVF_VWC_PRESENT)) {
+        D(bug("[NVME%02ld] %s: no volatile write cache\n", unit->au_UnitNum, __func__);)
+        return TRUE;
+    }
+
+    memset(&cmdio, 0, sizeof(cmdio));
+    memset(&ioehandle, 0, sizeof(ioehandle));
+    nvme_dma_init(&ioehandle);
+
+    cmdio.common.op.opcode = nvme_cmd_flush;
+    cmdio.common.nsid = AROS_LONG2LE(nvme_unit_nsid(unit));
+
+    nvmeq = nvme_select_ioqueue(dev);
 
     ioehandle.ceh_Task = nvmeq->q_IOTask;
     ioehandle.ceh_SigSet = SIGF_SINGLE;
@@ -112,33 +322,191 @@ static BOOL nvme_sector_rw(struct IORequest *io, UQUAD off64, BOOL is_write)
     Remove(&io->io_Message.mn_Node);
     ReleaseSemaphore(&unit->au_Lock);
 
-    if (is_write) {
-        cmdio.rw.op.opcode = nvme_cmd_write;
-    } else {
-        cmdio.rw.op.opcode = nvme_cmd_read;
+    if (nvme_submit_iocmd(nvmeq, &cmdio, &ioehandle) != 0) {
+        io->io_Error = IOERR_ABORTED;
+        return TRUE;
     }
 
-    cmdio.rw.nsid = AROS_LONG2LE(nsid);
-    cmdio.rw.length = AROS_WORD2LE((len >> unit->au_SecShift) - 1);
-    cmdio.rw.slba = AROS_QUAD2LE(off64 >> unit->au_SecShift);
-    cmdio.rw.control = 0;
-    cmdio.rw.dsmgmt = 0;
+    return FALSE;
+}
+
+/*
+    Convert the next part of a byte range into an LBA range. Only whole
+    sectors are discarded, and one DSM range covers at most 2^32-1 sectors.
+*/
+static BOOL nvme_trim_next(struct nvme_Unit *unit, UQUAD *start, UQUAD end, UQUAD *slba, ULONG *nlb)
+{
+    UQUAD secmask = (1ULL << unit->au_SecShift) - 1;
+    UQUAD first = (*start + secmask) >> unit->au_SecShift;
+    UQUAD last = end >> unit->au_SecShift;
 
-    DIO(
-        bug("[NVME%02ld(%02u)] %s: %08x%08x (%u)\n", unit->au_UnitNum, queueno, __func__, (cmdio.rw.slba >> 32), (cmdio.rw.slba & 0xFFFFFFFF), AROS_LE2WORD(cmdio.rw.length));
-    )
+    if (last > unit->au_SecCnt)
+        last = unit->au_SecCnt;
+    if (first >= last)
+        return FALSE;
 
-    if (nvme_submit_iocmd(nvmeq, &cmdio, &ioehandle) != 0) {
-        if (ioehandle.ceh_IOMem.me_Un.meu_Addr) {
-            FreeMem(ioehandle.ceh_IOMem.me_Un.meu_Addr, ioehandle.ceh_IOMem.me_Length);
-            ioehandle.ceh_IOMem.me_Un.meu_Addr = NULL;
+    *slba = first;
+    *nlb = (last - first > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (ULONG)(last - first);
+    *start = (first + *nlb) << unit->au_SecShift;
+
+    return TRUE;
+}
+
+/*
+    HD_TRIMCMD: deallocate the ranges passed in io_Data. Ranges are packed
+    NVME_DSM_MAX_RANGES to a Dataset Management command, and all commands
+    are submitted together with a single doorbell write.
+*/
+static BOOL nvme_trim(struct IORequest *io)
+{
+    struct IOStdReq *ios = IOStdReq(io);
+    struct nvme_Unit *unit = (struct nvme_Unit *)io->io_Unit;
+    struct NVMEBase *NVMEBase = unit->au_Bus->ab_Base;
+    device_t dev = unit->au_Bus->ab_Dev;
+    struct TRIMRange *ranges = ios->io_Data;
+    ULONG nranges = ios->io_Length / sizeof(struct TRIMRange);
+    struct nvme_command *cmds = NULL, *cmdptrs[NVME_MAXIOVEC];
+    struct completionevent_handler *handles = NULL, *handleptrs[NVME_MAXIOVEC];
+    struct nvme_iobatch *batch = NULL;
+    struct nvme_queue *nvmeq;
+    ULONG total = 0, ncmds, i, r, setup = 0;
+    UQUAD start, slba;
+    ULONG nlb;
+    BYTE err = 0;
+
+    if (!(dev->dev_Features & NVME_DEVF_DSM_SUPPORTED)) {
+        io->io_Error = IOERR_NOCMD;
+        return TRUE;
+    }
+
+    /*
+     * Availability probe. The disabled ata/scsi code expects the feature
+     * code in io_Reserved1/io_Reserved2, which struct IOStdReq doesn't
+     * have here, so it is passed in io_Offset as devices/ata.h documents.
+     */
+    if (ios->io_Offset == ATAFEATURE_TEST_AVAIL) {
+        if (ios->io_Length >= sizeof(ULONG)) {
+            *((ULONG *)ios->io_Data) = TRIM_MAGIC_ID;
+            ios->io_Actual = sizeof(ULONG);
         }
-        nvme_dma_release(&ioehandle, TRUE);
-        io->io_Error = IOERR_ABORTED;
         return TRUE;
     }
 
+    ios->io_Actual = 0;
+
+    /* Count the DSM ranges needed */
+    for (r = 0; r < nranges; r++) {
+        start = ranges[r].tr_Offset;
+        while (nvme_trim_next(unit, &start, ranges[r].tr_Offset + ranges[r].tr_Length, &slba, &nlb))
+            total++;
+    }
+
+    D(bug("[NVME%02ld] %s: %u ranges -> %u DSM ranges\n", unit->au_UnitNum, __func__, nranges, total);)
+
+    if (total == 0) {
+        ios->io_Actual = ios->io_Length;
+        return TRUE;
+    }
+
+    ncmds = (total + NVME_DSM_MAX_RANGES - 1) / NVME_DSM_MAX_RANGES;
+    if (ncmds > NVME_MAXIOVEC) {
+        io->io_Error = IOERR_BADLENGTH;
+        return TRUE;
+    }
+
+    cmds = AllocMem(ncmds * sizeof(struct nvme_command), MEMF_CLEAR);
+    handles = AllocMem(ncmds * sizeof(struct completionevent_handler), MEMF_CLEAR);
+    batch = AllocMem(sizeof(struct nvme_iobatch), MEMF_CLEAR);
+    if (!cmds || !handles || !batch) {
+        err = IOERR_NOMEMORY;
+        goto fail;
+    }
+
+    nvmeq = nvme_select_ioqueue(dev);
+
+    r = 0;
+    start = nranges ? ranges[0].tr_Offset : 0;
+    for (setup = 0; setup < ncmds; setup++) {
+        struct completionevent_handler *ioehandle = &handles[setup];
+        ULONG count = MIN(total - setup * NVME_DSM_MAX_RANGES, NVME_DSM_MAX_RANGES);
+        ULONG buflen = count * sizeof(struct nvme_dsm_range);
+        ULONG dmalen = buflen;
+        struct nvme_dsm_range *dsm;
+        APTR phys;
+
+        nvme_dma_init(ioehandle);
+
+        /* The range list must not cross a page, so only PRP1 is needed */
+        ioehandle->ceh_IOMem.me_Length = buflen + dev->pagesize - 1;
+        ioehandle->ceh_IOMem.me_Un.meu_Addr = AllocMem(ioehandle->ceh_IOMem.me_Length, MEMF_ANY);
+        if (!ioehandle->ceh_IOMem.me_Un.meu_Addr) {
+            setup++;
+            err = IOERR_NOMEMORY;
+            goto fail;
+        }
+        dsm = (struct nvme_dsm_range *)(((IPTR)ioehandle->ceh_IOMem.me_Un.meu_Addr + dev->pagesize - 1) & ~(IPTR)(dev->pagesize - 1));
+
+        for (i = 0; i < count; ) {
+            if (nvme_trim_next(unit, &start, ranges[r].tr_Offset + ranges[r].tr_Length, &slba, &nlb)) {
+                dsm[i].cattr = 0;
+                dsm[i].nlb = AROS_LONG2LE(nlb);
+                dsm[i].slba = AROS_QUAD2LE(slba);
+                i++;
+            } else if (++r < nranges) {
+                start = ranges[r].tr_Offset;
+            } else
+                break;
+        }
+
+        phys = CachePreDMA(dsm, &dmalen, DMAFLAGS_PREWRITE);
+        if (!phys || dmalen < buflen || !nvme_dma_append(ioehandle, dsm, dmalen, DMAFLAGS_PREWRITE)) {
+            setup++;
+            err = IOERR_BADADDRESS;
+            goto fail;
+        }
+
+        cmds[setup].dsm.op.opcode = nvme_cmd_dsm;
+        cmds[setup].dsm.nsid = AROS_LONG2LE(nvme_unit_nsid(unit));
+        cmds[setup].dsm.prp1 = AROS_QUAD2LE((UQUAD)(IPTR)HIDD_PCIDriver_CPUtoPCI(dev->dev_PCIDriverObject, phys));
+        cmds[setup].dsm.nr = AROS_LONG2LE(count - 1);
+        cmds[setup].dsm.attributes = AROS_LONG2LE(NVME_DSMGMT_AD);
+
+        ioehandle->ceh_Task = nvmeq->q_IOTask;
+        ioehandle->ceh_SigSet = SIGF_SINGLE;
+        ioehandle->ceh_Msg = io;
+        ioehandle->ceh_Batch = batch;
+        cmdptrs[setup] = &cmds[setup];
+        handleptrs[setup] = ioehandle;
+    }
+
+    batch->nib_Pending = ncmds;
+    batch->nib_Actual = ios->io_Length;
+
+    ObtainSemaphore(&unit->au_Lock);
+    Remove(&io->io_Message.mn_Node);
+    ReleaseSemaphore(&unit->au_Lock);
+
+    if (nvme_submit_iocmds(nvmeq, cmdptrs, handleptrs, ncmds) != 0) {
+        err = IOERR_ABORTED;
+        goto fail;
+    }
+
+    FreeMem(handles, ncmds * sizeof(struct completionevent_handler));
+    FreeMem(cmds, ncmds * sizeof(struct nvme_command));
+
     return FALSE;
+
+fail:
+    for (i = 0; i < setup; i++)
+        nvme_cleanup_rw(&handles[i]);
+    if (batch)
+        FreeMem(batch, sizeof(struct nvme_iobatch));
+    if (handles)
+        FreeMem(handles, ncmds * sizeof(struct completionevent_handler));
+    if (cmds)
+        FreeMem(cmds, ncmds * sizeof(struct nvme_command));
+    io->io_Error = err;
+    return TRUE;
 }
 
 
@@ -173,6 +541,9 @@ AROS_LH1(void, BeginIO,
         NSCMD_TD_WRITE64,
         NSCMD_TD_SEEK64,
         NSCMD_TD_FORMAT64,
+        NVMECMD_READVEC,
+        NVMECMD_WRITEVEC,
+        HD_TRIMCMD,
         0
     };
     struct IOExtTD *iotd = (struct IOExtTD *)io;
@@ -225,6 +596,16 @@ AROS_LH1(void, BeginIO,
         done = nvme_sector_rw(io, off64, TRUE);
         break;
 
+    case NVMECMD_READVEC:
+        D(bug("[NVME%02ld] NVMECMD_READVEC (%u)\n", unit->au_UnitNum, len);)
+        done = nvme_vector_rw(io, FALSE);
+        break;
+
+    case NVMECMD_WRITEVEC:
+        D(bug("[NVME%02ld] NVMECMD_WRITEVEC (%u)\n", unit->au_UnitNum, len);)
+        done = nvme_vector_rw(io, TRUE);
+        break;
+
     case TD_FORMAT:
         D(bug("[NVME%02ld] TD_FORMAT\n", unit->au_UnitNum);)
         off64  = iotd->iotd_Req.io_Offset;
@@ -337,8 +718,12 @@ AROS_LH1(void, BeginIO,
 
     case CMD_UPDATE:
         D(bug("[NVME%02ld] TD_UPDATE\n", unit->au_UnitNum);)
-        // FIXME: Implement cache flush
-        done = TRUE;
+        done = nvme_flush(io);
+        break;
+
+    case HD_TRIMCMD:
+        D(bug("[NVME%02ld] HD_TRIMCMD\n", unit->au_UnitNum);)
+        done = nvme_trim(io);
         break;
 
     default:
@@ -74,6 +74,13 @@ struct nvme_queue *nvme_alloc_queue(device_t dev, int qid, int depth, int vector
         return NULL;
     }
 
+    /* one spare slot, so that a ring with every command id queued isn't empty */
+    nvmeq->q_DoneRing = AllocMem(sizeof(UWORD) * (depth + 1), MEMF_CLEAR);
+    if (!nvmeq->q_DoneRing) {
+        nvme_free_queue(nvmeq);
+        return NULL;
+    }
+
     nvmeq->cqba = HIDD_PCIDriver_AllocPCIMem(dev->dev_PCIDriverObject, cq_bytes);
     if (!nvmeq->cqba) {
         nvme_free_queue(nvmeq);
@@ -137,6 +144,11 @@ void nvme_free_queue(struct nvme_queue *nvmeq)
         nvmeq->ce_entries = NULL;
     }
 
+    if (nvmeq->q_DoneRing) {
+        FreeMem(nvmeq->q_DoneRing, sizeof(UWORD) * (nvmeq->q_depth + 1));
+        nvmeq->q_DoneRing = NULL;
+    }
+
     if (nvmeq->cehandlers) {
         FreeMem(nvmeq->cehandlers, sizeof(struct completionevent_handler *) * nvmeq->q_depth);
         nvmeq->cehandlers = NULL;
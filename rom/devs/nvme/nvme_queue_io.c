@@ -9,6 +9,8 @@
 #include <hidd/pci.h>
 #include <exec/errors.h>
 #include <exec/memory.h>
+#include <aros/atomic.h>
+#include <devices/nvme.h>
 
 #include <string.h>
 
@@ -42,7 +44,7 @@ void nvme_complete_ioevent(struct nvme_queue *nvmeq, struct nvme_completion *cqe
 
             nvme_dma_release(slot, TRUE);
 
-            if (!((iotd->iotd_Req.io_Command == CMD_WRITE) ||
+            if (!slot->ceh_Batch && !((iotd->iotd_Req.io_Command == CMD_WRITE) ||
                     (iotd->iotd_Req.io_Command == TD_WRITE64) ||
                     (iotd->iotd_Req.io_Command == NSCMD_TD_WRITE64) ||
                     (iotd->iotd_Req.io_Command == TD_FORMAT) ||
@@ -76,29 +78,121 @@ void nvme_complete_ioevent(struct nvme_queue *nvmeq, struct nvme_completion *cqe
 
             if (slot->ceh_Status) {
                 UBYTE sct = (slot->ceh_Status >> 7) & 0x7, sc = (slot->ceh_Status) & 0x7F;
-                iotd->iotd_Req.io_Error = IOERR_ABORTED;
+                if (slot->ceh_Vec)
+                    ((struct NVMEIOVec *)slot->ceh_Vec)->nv_Error = IOERR_ABORTED;
+                else if (!slot->ceh_Batch)
+                    iotd->iotd_Req.io_Error = IOERR_ABORTED;
                 D(bug("[NVME:IOQ] %s: NVME IO Error %u:%u\n", __func__, sct, sc);)
-            } else {
+            } else if (slot->ceh_Vec) {
+                ((struct NVMEIOVec *)slot->ceh_Vec)->nv_Error = 0;
+            } else if (!slot->ceh_Batch) {
                 iotd->iotd_Req.io_Error = 0;
                 iotd->iotd_Req.io_Actual = iotd->iotd_Req.io_Length;
             }
         }
 
-        D(bug ("[NVME:IOQ] %s: Signaling 0x%p (%08x)\n", __func__, slot->ceh_Task, slot->ceh_SigSet);)
-        Signal(slot->ceh_Task, slot->ceh_SigSet);
+        /*
+         * Queue the command for the IO task. nvme_process_cq() signals
+         * the task once after it has drained the completion queue.
+         * The ring has q_depth + 1 slots, so it can hold every command id
+         * at once without the tail catching up with the head.
+         */
+        nvmeq->q_DoneRing[nvmeq->q_DoneTail] = cqe->command_id;
+        if (++nvmeq->q_DoneTail > nvmeq->q_depth)
+            nvmeq->q_DoneTail = 0;
+        nvmeq->q_DoneSignal = 1;
     }
 }
 
-int nvme_submit_iocmd(struct nvme_queue *nvmeq,
-                      struct nvme_command *cmd,
-                      struct completionevent_handler *handler)
+/*
+    Reply all IO requests whose commands have completed. Called by the
+    queue's IO task only.
+*/
+void nvme_reply_iocompletions(struct nvme_queue *nvmeq)
+{
+#if defined(__AROSEXEC_SMP__)
+    struct NVMEBase *NVMEBase = nvmeq->dev->dev_NVMEBase;
+#endif
+
+    for (;;) {
+        struct completionevent_handler *slot;
+        struct IOExtTD *iotd;
+        struct nvme_iobatch *batch;
+        UWORD cmdid;
+
+        Disable();
+#if defined(__AROSEXEC_SMP__)
+        KrnSpinLock(&nvmeq->q_lock, NULL, SPINLOCK_MODE_WRITE);
+#endif
+        if (nvmeq->q_DoneHead == nvmeq->q_DoneTail) {
+#if defined(__AROSEXEC_SMP__)
+            KrnSpinUnLock(&nvmeq->q_lock);
+#endif
+            Enable();
+            break;
+        }
+        cmdid = nvmeq->q_DoneRing[nvmeq->q_DoneHead];
+        if (++nvmeq->q_DoneHead > nvmeq->q_depth)
+            nvmeq->q_DoneHead = 0;
+#if defined(__AROSEXEC_SMP__)
+        KrnSpinUnLock(&nvmeq->q_lock);
+#endif
+        Enable();
+
+        slot = nvmeq->cehandlers[cmdid];
+        if (!slot || !slot->ceh_Reply)
+            continue;
+
+        iotd = (struct IOExtTD *)slot->ceh_Msg;
+        batch = slot->ceh_Batch;
+
+        if (batch) {
+            struct NVMEIOVec *vec = slot->ceh_Vec;
+
+            if (slot->ceh_Status) {
+                if (!batch->nib_Error)
+                    batch->nib_Error = IOERR_ABORTED;
+            } else if (vec)
+                batch->nib_Actual += vec->nv_Length;
+
+            if (--batch->nib_Pending == 0) {
+                iotd->iotd_Req.io_Error = batch->nib_Error;
+                iotd->iotd_Req.io_Actual = batch->nib_Actual;
+                FreeMem(batch, sizeof(struct nvme_iobatch));
+
+                D(bug ("[NVME:IOQ] %s: replying to batched IO @ 0x%p\n", __func__, iotd);)
+                ReplyMsg((struct Message *)iotd);
+            }
+        } else {
+            D(bug ("[NVME:IOQ] %s: replying to IO @ 0x%p\n", __func__, iotd);)
+            ReplyMsg((struct Message *)iotd);
+        }
+
+        slot->ceh_Reply = FALSE;
+        slot->ceh_Task = NULL;
+        slot->ceh_Msg = NULL;
+        slot->ceh_Batch = NULL;
+        slot->ceh_Vec = NULL;
+        slot->ceh_SigSet = 0;
+
+        nvmeq->cehandlers[cmdid] = NULL;
+        nvmeq->cehooks[cmdid] = NULL;
+        nvme_release_cmdid(nvmeq, cmdid);
+        AROS_ATOMIC_DEC(nvmeq->q_Outstanding);
+    }
+}
+
+/*
+    Claim a command id for an IO command and take over its completion
+    handler. Returns the command id or -1.
+*/
+static int nvme_prepare_ioslot(struct nvme_queue *nvmeq,
+                               struct nvme_command *cmd,
+                               struct completionevent_handler *handler)
 {
-    int retval;
     int cmdid;
     struct completionevent_handler *slot;
 
-    D(bug ("[NVME:IOQ] %s(0x%p, 0x%p)\n", __func__, nvmeq, cmd);)
-
     cmdid = nvme_alloc_cmdid(nvmeq);
     if (cmdid < 0) {
         return -1;
@@ -134,12 +228,61 @@ int nvme_submit_iocmd(struct nvme_queue *nvmeq,
     nvmeq->cehooks[cmdid] = nvme_complete_ioevent;
     nvmeq->cehandlers[cmdid] = slot;
 
-    retval = nvme_submit_cmd(nvmeq, cmd);
+    AROS_ATOMIC_INC(nvmeq->q_Outstanding);
+
+    return cmdid;
+}
+
+static void nvme_cancel_ioslot(struct nvme_queue *nvmeq, UWORD cmdid)
+{
+    nvmeq->cehooks[cmdid] = NULL;
+    nvmeq->cehandlers[cmdid] = NULL;
+    nvme_dma_release(&nvmeq->ce_entries[cmdid], TRUE);
+    nvme_release_cmdid(nvmeq, cmdid);
+    AROS_ATOMIC_DEC(nvmeq->q_Outstanding);
+}
+
+int nvme_submit_iocmd(struct nvme_queue *nvmeq,
+                      struct nvme_command *cmd,
+                      struct completionevent_handler *handler)
+{
+    D(bug ("[NVME:IOQ] %s(0x%p, 0x%p)\n", __func__, nvmeq, cmd);)
+
+    return nvme_submit_iocmds(nvmeq, &cmd, &handler, 1);
+}
+
+/*
+    Submit several IO commands with a single doorbell write. On failure
+    none of the commands has been queued, and the caller still owns the
+    IO memory of all handlers.
+*/
+int nvme_submit_iocmds(struct nvme_queue *nvmeq,
+                       struct nvme_command **cmds,
+                       struct completionevent_handler **handlers,
+                       UWORD count)
+{
+    int cmdids[NVME_MAXIOVEC];
+    int retval;
+    UWORD i, j;
+
+    D(bug ("[NVME:IOQ] %s(0x%p, 0x%p, %u)\n", __func__, nvmeq, cmds, count);)
+
+    if (count > NVME_MAXIOVEC)
+        return -1;
+
+    for (i = 0; i < count; i++) {
+        cmdids[i] = nvme_prepare_ioslot(nvmeq, cmds[i], handlers[i]);
+        if (cmdids[i] < 0) {
+            for (j = 0; j < i; j++)
+                nvme_cancel_ioslot(nvmeq, cmdids[j]);
+            return -1;
+        }
+    }
+
+    retval = nvme_submit_cmds(nvmeq, cmds, count);
     if (retval != 0) {
-        nvmeq->cehooks[cmdid] = NULL;
-        nvmeq->cehandlers[cmdid] = NULL;
-        nvme_dma_release(slot, TRUE);
-        nvme_release_cmdid(nvmeq, cmdid);
+        for (i = 0; i < count; i++)
+            nvme_cancel_ioslot(nvmeq, cmdids[i]);
     }
 
     return retval;
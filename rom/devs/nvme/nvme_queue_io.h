@@ -1,4 +1,10 @@
 
+void nvme_complete_ioevent(struct nvme_queue *nvmeq, struct nvme_completion *cqe);
+void nvme_reply_iocompletions(struct nvme_queue *nvmeq);
 int nvme_submit_iocmd(struct nvme_queue *nvmeq,
                                     struct nvme_command *cmd,
                                     struct completionevent_handler *handler);
+int nvme_submit_iocmds(struct nvme_queue *nvmeq,
+                                    struct nvme_command **cmds,
+                                    struct completionevent_handler **handlers,
+                                    UWORD count);
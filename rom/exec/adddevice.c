@@ -12,6 +12,7 @@
 #include "exec_intern.h"
 #include "exec_debug.h"
 #include "exec_locks.h"
+#include "nameindex.h"
 
 /*****************************************************************************
 
@@ -64,6 +65,7 @@
 
     /* And add the device */
     Enqueue(&SysBase->DeviceList,&device->dd_Library.lib_Node);
+    NameIndex_Add(&SysBase->DeviceList, &device->dd_Library.lib_Node, SysBase);
 
     /* All done. */
     EXEC_UNLOCK_LIST_AND_PERMIT(&SysBase->DeviceList);
@@ -13,6 +13,7 @@
 #include "exec_intern.h"
 #include "exec_debug.h"
 #include "exec_locks.h"
+#include "nameindex.h"
 
 /*****************************************************************************
 
@@ -68,6 +69,7 @@
     EXEC_LOCK_LIST_WRITE_AND_FORBID(&SysBase->LibList);
     /* And add the library */
     Enqueue(&SysBase->LibList,&library->lib_Node);
+    NameIndex_Add(&SysBase->LibList, &library->lib_Node, SysBase);
     /* We're done with midifying the LibList */
     EXEC_UNLOCK_LIST_AND_PERMIT(&SysBase->LibList);
     /*
@@ -9,6 +9,7 @@
 
 #include "exec_intern.h"
 #include "exec_debug.h"
+#include "nameindex.h"
 
 /*****************************************************************************
 
@@ -64,6 +65,7 @@
 #endif
     /* And add the actual port */
     Enqueue(&SysBase->PortList,&port->mp_Node);
+    NameIndex_Add(&SysBase->PortList, &port->mp_Node, SysBase);
 #if defined(__AROSEXEC_SMP__)
     EXEC_SPINLOCK_UNLOCK(&PrivExecBase(SysBase)->PortListSpinLock);
 #endif
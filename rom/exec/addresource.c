@@ -14,6 +14,7 @@
 #include "exec_intern.h"
 #include "exec_debug.h"
 #include "exec_locks.h"
+#include "nameindex.h"
 
 /* Kludge for old kernels */
 #ifndef KrnStatMemory
@@ -64,6 +65,7 @@
 
     /* And add the resource */
     Enqueue(&SysBase->ResourceList,(struct Node *)resource);
+    NameIndex_Add(&SysBase->ResourceList, (struct Node *)resource, SysBase);
 
     /* All done. */
     EXEC_UNLOCK_LIST_AND_PERMIT(&SysBase->ResourceList);
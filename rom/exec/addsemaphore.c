@@ -9,6 +9,7 @@
 
 #include "exec_intern.h"
 #include "exec_debug.h"
+#include "nameindex.h"
 
 /*****************************************************************************
 
@@ -58,6 +59,7 @@
 #endif
     /* Add the semaphore */
     Enqueue(&SysBase->SemaphoreList,&sigSem->ss_Link);
+    NameIndex_Add(&SysBase->SemaphoreList, &sigSem->ss_Link, SysBase);
 #if defined(__AROSEXEC_SMP__)
     EXEC_SPINLOCK_UNLOCK(&PrivExecBase(SysBase)->SemListSpinLock);
 #endif
@@ -11,6 +11,9 @@
 #include <aros/libcall.h>
 #include <proto/exec.h>
 
+#include "exec_intern.h"
+#include "nameindex.h"
+
 #include "exec_debug.h"
 #ifndef DEBUG_CloseDevice
 #   define DEBUG_CloseDevice 0
@@ -70,10 +73,16 @@
     /* Something to do? */
     if(iORequest->io_Device!=NULL)
     {
+        struct Device *device = iORequest->io_Device;
+        /* The last close may expunge the device */
+        BOOL last = (device->dd_Library.lib_OpenCnt <= 1);
+
         dc_ret = AROS_LVO_CALL1(BPTR,
             AROS_LCA(struct IORequest *,iORequest, A1),
             struct Device *,iORequest->io_Device,2,
         );
+        if (last)
+            NameIndex_Forget(&device->dd_Library.lib_Node, SysBase);
         /*
             Normally you'd expect the device to be expunged if this returns
             non-zero, but this is only exec which doesn't know anything about
@@ -9,6 +9,9 @@
 #include <aros/libcall.h>
 #include <proto/exec.h>
 
+#include "exec_intern.h"
+#include "nameindex.h"
+
 #include "exec_debug.h"
 #ifndef DEBUG_CloseLibrary
 #   define DEBUG_CloseLibrary 0
@@ -56,6 +59,7 @@
 {
     AROS_LIBFUNC_INIT
     BPTR seglist;
+    BOOL last;
 
     D(bug("CloseLibrary $%lx (\"%s\") by \"%s\"\n", library,
         library ? library->lib_Node.ln_Name : "(null)",
@@ -69,8 +73,13 @@
         /* Single-thread the close routine. */
         Forbid();
 
+        /* The last close may expunge the library */
+        last = (library->lib_OpenCnt <= 1);
+
         /* Do the close */
         seglist = AROS_LVO_CALL0(BPTR,struct Library *,library,2,);
+        if (last)
+            NameIndex_Forget(&library->lib_Node, SysBase);
         /*
             Normally you'd expect the library to be expunged if this returns
             non-zero, but this is only exec which doesn't know anything about
@@ -33,6 +33,7 @@
 #include "etask.h"
 #include "intservers.h"
 #include "memory.h"
+#include "nameindex.h"
 
 #include LC_LIBDEFS_FILE
 
@@ -140,6 +141,9 @@ AROS_UFH3S(struct ExecBase *, GM_UNIQUENAME(init),
      */
     set_call_libfuncs(SETNAME(PREINITLIB), 1, 0, origSysBase);
 
+    /* The memory list is complete now, FindName() can use the index from here */
+    NameIndex_Init(SysBase);
+
     DINIT("Preparing Bootstrap Task...");
 
     /* Now we are ready to become a Boot Task and turn on the multitasking */
@@ -44,6 +44,7 @@
    Internals of this structure are host-specific, we don't know them here
  */
 struct HostInterface;
+struct NameIndex;
 
 struct SupervisorAlertTask
 {
@@ -70,6 +71,7 @@ struct IntExecBase
     ULONG                       IntFlags;                       /* Internal flags, see below                                    */
     struct MsgPort              *ServicePort;                   /* Message port for service task                                */
     struct List                 AllocatorCtxList;               /* List of allocator contexts for system mem headers            */
+    struct NameIndex            *NameIndex;                     /* Hashed names of the system list nodes, see nameindex.h       */
     struct Exec_PlatformData    PlatformData;                   /* Platform-specific stuff                                      */
     struct SupervisorAlertTask  SAT;
     ULONG                       SupervisorDeadEndCnt;           /* Counter of reaching AT_DeadEnd under Supervisor mode         */
@@ -88,6 +90,7 @@ struct IntExecBase
     spinlock_t                  LibListSpinLock;
     spinlock_t                  PortListSpinLock;
     spinlock_t                  SemListSpinLock;
+    spinlock_t                  NameIndexSpinLock;
 
     /* .. and then scheduling related locks ... */
     spinlock_t                  TaskRunningSpinLock;
@@ -8,6 +8,7 @@
 
 #include "exec_intern.h"
 #include "exec_debug.h"
+#include "nameindex.h"
 
 /*****************************************************************************
 
@@ -41,6 +42,10 @@
 
         When supplied with a NULL list argument, defaults to the exec port list.
 
+        Libraries and devices must only leave the system lists through
+        RemLibrary() and RemDevice(), or their expunge function when the
+        system calls it, not by a plain Remove() before they are freed.
+
     EXAMPLE
         struct List * list;
         struct Node * node;
@@ -53,11 +58,19 @@
     SEE ALSO
 
     INTERNALS
+        The system lists of libraries, devices, resources, ports and
+        semaphores have a hashed index of their nodes, see nameindex.h.
+        It is looked at first, and nodes found by walking one of these
+        lists are added to it. An indexed port, semaphore or resource is
+        only returned once it has been found in its list by pointer, so
+        these may still be unlinked with Remove() and freed.
 
 ******************************************************************************/
 {
     AROS_LIBFUNC_INIT
     struct Node * node;
+    UBYTE which = 0;
+    ULONG hash = 0;
 /* FIX !
         FindName supplied with a NULL list defaults to the exec port list
         Changed in lists.c as well....
@@ -73,6 +86,13 @@
 /*    ASSERT(list != NULL); */
     ASSERT(name);
 
+    if (PrivExecBase(SysBase)->NameIndex && (which = NameIndex_List(list, SysBase)))
+    {
+        node = NameIndex_Find(which, name, &hash, SysBase);
+        if (node)
+            return node;
+    }
+
     /* Look through the list */
     for (node=GetHead(list); node; node=GetSucc(node))
     {
@@ -85,6 +105,9 @@
         }
     }
 
+    if (node && which)
+        NameIndex_Insert(which, node, hash, SysBase);
+
     /*
         If we found a node, this will contain the pointer to it. If we
         didn't, this will be NULL (either because the list was
@@ -0,0 +1,208 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Hashed index of the named nodes in the system lists
+*/
+
+#include <aros/debug.h>
+#include <exec/memory.h>
+#include <proto/exec.h>
+
+#include <string.h>
+
+#include "exec_intern.h"
+#include "exec_debug.h"
+#include "nameindex.h"
+
+/* FNV-1a, started differently for every list */
+static ULONG NameIndex_Hash(UBYTE which, CONST_STRPTR name)
+{
+    ULONG hash = 2166136261UL ^ which;
+
+    while (*name)
+    {
+        hash ^= (UBYTE)*name++;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+/*
+ * Whether an indexed node is still in its list. Libraries and devices only
+ * leave the lists through exec or LDDemon, which forget them before they
+ * can be freed, so their link can be checked. Ports, semaphores and
+ * resources can be unlinked with Remove() and freed by their owners, so
+ * their node is only looked at once it has been found in the list.
+ */
+static BOOL NameIndex_Linked(UBYTE which, struct Node *node, struct ExecBase *SysBase)
+{
+    struct List *list;
+    struct Node *n;
+
+    switch (which)
+    {
+    case 1:
+    case 2:
+        return node->ln_Pred->ln_Succ == node;
+    case 3:
+        list = &SysBase->ResourceList;
+        break;
+    case 4:
+        list = &SysBase->PortList;
+        break;
+    default:
+        list = &SysBase->SemaphoreList;
+        break;
+    }
+
+    ForeachNode(list, n)
+    {
+        if (n == node)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static struct NameIndexEntry *NameIndex_Lookup(struct NameIndex *index, UBYTE which,
+                                               CONST_STRPTR name, ULONG hash,
+                                               struct ExecBase *SysBase)
+{
+    struct NameIndexEntry *entry, *next;
+
+    for (entry = *NameIndex_Bucket(index, hash); entry; entry = next)
+    {
+        next = entry->next;
+
+        if (entry->hash != hash || entry->list != which)
+            continue;
+
+        /*
+         * Nodes unlinked without the exec functions are still here, their
+         * name must not be looked at. The name can also have been changed
+         * after the node was indexed.
+         */
+        if (!NameIndex_Linked(which, entry->node, SysBase))
+        {
+            NameIndex_Unlink(index, entry);
+            continue;
+        }
+        if (!entry->node->ln_Name || strcmp(entry->node->ln_Name, name))
+            continue;
+
+        return entry;
+    }
+
+    return NULL;
+}
+
+void NameIndex_Insert(UBYTE which, struct Node *node, ULONG hash, struct ExecBase *SysBase)
+{
+    struct NameIndex *index = PrivExecBase(SysBase)->NameIndex;
+    struct NameIndexEntry *entry, **bucket;
+
+    NAMEINDEX_LOCK;
+
+    /* When the index is full the list is walked for the other nodes */
+    if ((entry = index->free))
+    {
+        index->free = entry->next;
+
+        bucket = NameIndex_Bucket(index, hash);
+        entry->node = node;
+        entry->hash = hash;
+        entry->list = which;
+        entry->next = *bucket;
+        *bucket = entry;
+    }
+
+    NAMEINDEX_UNLOCK;
+}
+
+/*
+ * Called for a node that was just added to one of the lists. Which node of
+ * a name FindName() has to return depends on the order of the list, and
+ * nodes of the same name that are not indexed can be in it already. So the
+ * new node is not indexed here, but an indexed node of the same name that
+ * may now come after it is dropped. The next FindName() then walks the list
+ * and indexes the right node.
+ */
+void NameIndex_Add(struct List *list, struct Node *node, struct ExecBase *SysBase)
+{
+    struct NameIndex *index = PrivExecBase(SysBase)->NameIndex;
+    struct NameIndexEntry *entry;
+    UBYTE which;
+
+    if (!index || !node->ln_Name || !(which = NameIndex_List(list, SysBase)))
+        return;
+
+    NAMEINDEX_LOCK;
+    if ((entry = NameIndex_Lookup(index, which, node->ln_Name, NameIndex_Hash(which, node->ln_Name), SysBase)))
+        NameIndex_Unlink(index, entry);
+    NAMEINDEX_UNLOCK;
+}
+
+struct Node *NameIndex_Find(UBYTE which, CONST_STRPTR name, ULONG *hash, struct ExecBase *SysBase)
+{
+    struct NameIndex *index = PrivExecBase(SysBase)->NameIndex;
+    struct NameIndexEntry *entry;
+    struct Node *node = NULL;
+
+    *hash = NameIndex_Hash(which, name);
+
+    NAMEINDEX_LOCK;
+    if ((entry = NameIndex_Lookup(index, which, name, *hash, SysBase)))
+        node = entry->node;
+    NAMEINDEX_UNLOCK;
+
+    return node;
+}
+
+/*
+ * Called once the memory list is complete, still without multitasking. The
+ * nodes added before are indexed here, the first node of a name in each
+ * list wins as in FindName().
+ */
+void NameIndex_Init(struct ExecBase *SysBase)
+{
+    struct List *lists[] =
+    {
+        &SysBase->LibList, &SysBase->DeviceList, &SysBase->ResourceList,
+        &SysBase->PortList, &SysBase->SemaphoreList
+    };
+    struct NameIndex *index;
+    struct Node *node;
+    UBYTE which;
+    ULONG hash;
+    int i;
+
+    index = AllocMem(sizeof(struct NameIndex), MEMF_PUBLIC | MEMF_CLEAR);
+    if (!index)
+        return;
+
+    for (i = NAMEINDEX_ENTRIES - 1; i >= 0; i--)
+    {
+        index->entries[i].next = index->free;
+        index->free = &index->entries[i];
+    }
+
+    PrivExecBase(SysBase)->NameIndex = index;
+
+    for (i = 0; i < (int)(sizeof(lists) / sizeof(lists[0])); i++)
+    {
+        which = NameIndex_List(lists[i], SysBase);
+
+        ForeachNode(lists[i], node)
+        {
+            if (!node->ln_Name)
+                continue;
+
+            hash = NameIndex_Hash(which, node->ln_Name);
+            if (!NameIndex_Lookup(index, which, node->ln_Name, hash, SysBase))
+                NameIndex_Insert(which, node, hash, SysBase);
+        }
+    }
+
+    DINIT("Name index at 0x%p", index);
+}
@@ -0,0 +1,134 @@
+#ifndef _EXEC_NAMEINDEX_H
+#define _EXEC_NAMEINDEX_H
+
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Hashed index of the named nodes in the system lists
+*/
+
+#include <exec/nodes.h>
+#include <exec/lists.h>
+
+#include "exec_intern.h"
+
+/*
+ * FindName() on LibList, DeviceList, ResourceList, PortList and
+ * SemaphoreList looks the name up here before walking the list. The index
+ * only caches what is in the lists, it does not replace them: nodes that
+ * are not in it are still found by walking the list, and are added to it
+ * then.
+ *
+ * Nodes are indexed by FindName() when it found them by walking the list.
+ * Adding a node to a list with the exec functions drops the indexed node of
+ * the same name, as the new one may go before it. RemPort(), RemSemaphore()
+ * and RemResource() forget the node they remove. Libraries and devices
+ * remove themselves in their expunge code, so they are forgotten by the
+ * functions that call it: RemLibrary(), RemDevice(), and CloseLibrary() and
+ * CloseDevice() when the last opener closes. LDDemon replaces these and
+ * does the same. Remove(), RemHead() and RemTail() don't know the list, and
+ * are too hot to look here.
+ *
+ * Nodes that are put into the lists directly, without the exec functions,
+ * or renamed while in a list, are found as well. Only if such a node goes
+ * before an indexed node of the same name, FindName() keeps returning the
+ * indexed one. Entries of nodes that were unlinked otherwise are dropped
+ * when they are looked up.
+ *
+ * Ports, semaphores and resources may be unlinked with Remove() and freed
+ * without exec knowing, so before an entry of one of them is used the list
+ * is walked up to its node, comparing pointers only. Libraries and devices
+ * must leave their lists through exec, see FindName().
+ */
+
+#define NAMEINDEX_BUCKETS       64
+#define NAMEINDEX_ENTRIES       256
+
+struct NameIndexEntry
+{
+    struct NameIndexEntry       *next;                          /* Next in bucket or in free list                               */
+    struct Node                 *node;                          /* NULL if the entry is free                                    */
+    ULONG                       hash;                           /* Hash of the name and the list                                */
+    UBYTE                       list;                           /* Which list, see NameIndex_List()                             */
+};
+
+struct NameIndex
+{
+    struct NameIndexEntry       *buckets[NAMEINDEX_BUCKETS];
+    struct NameIndexEntry       *free;
+    struct NameIndexEntry       entries[NAMEINDEX_ENTRIES];
+};
+
+void NameIndex_Init(struct ExecBase *SysBase);
+void NameIndex_Add(struct List *list, struct Node *node, struct ExecBase *SysBase);
+struct Node *NameIndex_Find(UBYTE which, CONST_STRPTR name, ULONG *hash, struct ExecBase *SysBase);
+void NameIndex_Insert(UBYTE which, struct Node *node, ULONG hash, struct ExecBase *SysBase);
+
+/* The number of an indexed system list, 0 for all other lists */
+static inline UBYTE NameIndex_List(struct List *list, struct ExecBase *SysBase)
+{
+    if (list == &SysBase->LibList)
+        return 1;
+    if (list == &SysBase->DeviceList)
+        return 2;
+    if (list == &SysBase->ResourceList)
+        return 3;
+    if (list == &SysBase->PortList)
+        return 4;
+    if (list == &SysBase->SemaphoreList)
+        return 5;
+
+    return 0;
+}
+
+#if defined(__AROSEXEC_SMP__)
+#define NAMEINDEX_LOCK      EXEC_SPINLOCK_LOCK(&PrivExecBase(SysBase)->NameIndexSpinLock, NULL, SPINLOCK_MODE_WRITE)
+#define NAMEINDEX_UNLOCK    EXEC_SPINLOCK_UNLOCK(&PrivExecBase(SysBase)->NameIndexSpinLock)
+#else
+/* The lists, and so the index, are only changed and searched under Forbid() */
+#define NAMEINDEX_LOCK
+#define NAMEINDEX_UNLOCK
+#endif
+
+static inline struct NameIndexEntry **NameIndex_Bucket(struct NameIndex *index, ULONG hash)
+{
+    return &index->buckets[(hash ^ (hash >> 16)) & (NAMEINDEX_BUCKETS - 1)];
+}
+
+static inline void NameIndex_Unlink(struct NameIndex *index, struct NameIndexEntry *entry)
+{
+    struct NameIndexEntry **prev = NameIndex_Bucket(index, entry->hash);
+
+    while (*prev != entry)
+        prev = &(*prev)->next;
+    *prev = entry->next;
+
+    entry->node = NULL;
+    entry->next = index->free;
+    index->free = entry;
+}
+
+/*
+ * Called for a node that was taken out of one of the lists, or may have
+ * been, by an expunge. The node may be freed already, so it is not looked
+ * at: the few hundred entries are searched for it instead. Inline, as
+ * LDDemon needs it as well.
+ */
+static inline void NameIndex_Forget(struct Node *node, struct ExecBase *SysBase)
+{
+    struct NameIndex *index = PrivExecBase(SysBase)->NameIndex;
+    struct NameIndexEntry *entry;
+
+    if (!index)
+        return;
+
+    NAMEINDEX_LOCK;
+    for (entry = index->entries; entry < &index->entries[NAMEINDEX_ENTRIES]; entry++)
+    {
+        if (entry->node == node)
+            NameIndex_Unlink(index, entry);
+    }
+    NAMEINDEX_UNLOCK;
+}
+
+#endif /* _EXEC_NAMEINDEX_H */
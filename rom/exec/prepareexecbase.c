@@ -284,6 +284,10 @@ struct ExecBase *PrepareExecBase(struct MemHeader *mh, struct TagItem *msg)
     NEWLIST(&SysBase->SemaphoreList);
     SysBase->SemaphoreList.lh_Type = NT_SEMAPHORE;
 
+#if defined(__AROSEXEC_SMP__)
+    EXEC_SPINLOCK_INIT(&PrivExecBase(SysBase)->NameIndexSpinLock);
+#endif
+
     NEWLIST(&SysBase->ex_MemHandlers);
 
     for (i = 0; i < 5; i++)
@@ -10,6 +10,9 @@
 #include <dos/dos.h>
 #include <proto/exec.h>
 
+#include "exec_intern.h"
+#include "nameindex.h"
+
 #include "exec_debug.h"
 #ifndef DEBUG_RemDevice
 #   define DEBUG_RemDevice 0
@@ -70,6 +73,8 @@
         AROS_LCA(struct Device *,device, D0),
         struct Device *,device,3,
     );
+    /* The expunge code removes the device from the list */
+    NameIndex_Forget(&device->dd_Library.lib_Node, SysBase);
     /*
         Normally you'd expect the device to be expunged if this returns
         non-zero, but this is only exec which doesn't know anything about
@@ -9,6 +9,9 @@
 #include <dos/dos.h>
 #include <proto/exec.h>
 
+#include "exec_intern.h"
+#include "nameindex.h"
+
 #include "exec_debug.h"
 #ifndef DEBUG_RemLibrary
 #   define DEBUG_RemLibrary 0
@@ -68,6 +71,8 @@
     seglist = AROS_LVO_CALL1(BPTR,
                         AROS_LCA(struct Library *, library, D0),
                         struct Library *,library,3,);
+    /* The expunge code removes the library from the list */
+    NameIndex_Forget(&library->lib_Node, SysBase);
     /*
         Normally you'd expect the library to be expunged if this returns
         non-zero, but this is only exec which doesn't know anything about
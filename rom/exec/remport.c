@@ -8,6 +8,9 @@
 #include <aros/libcall.h>
 #include <proto/exec.h>
 
+#include "exec_intern.h"
+#include "nameindex.h"
+
 /*****************************************************************************
 
     NAME */
@@ -49,6 +52,7 @@
 
     /* Remove the current port. */
     Remove(&port->mp_Node);
+    NameIndex_Forget(&port->mp_Node, SysBase);
 
     /* All done. */
     Permit();
@@ -7,6 +7,9 @@
 #include <aros/libcall.h>
 #include <proto/exec.h>
 
+#include "exec_intern.h"
+#include "nameindex.h"
+
 /*****************************************************************************
 
     NAME */
@@ -46,6 +49,7 @@
     Forbid();
 
     Remove((struct Node *)resource);
+    NameIndex_Forget((struct Node *)resource, SysBase);
 
     /* All done. */
     Permit();
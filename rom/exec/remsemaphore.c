@@ -5,6 +5,7 @@
 */
 
 #include "exec_intern.h"
+#include "nameindex.h"
 #include <exec/semaphores.h>
 #include <proto/exec.h>
 
@@ -49,6 +50,7 @@
 
     /* Remove the semaphore */
     Remove(&sigSem->ss_Link);
+    NameIndex_Forget(&sigSem->ss_Link, SysBase);
 
     /* All done. */
     Permit();
@@ -77,12 +77,92 @@ static BOOL enoughspace(ULONG blocks) {
 LONG availablespace(BLCK block,ULONG maxneeded);
 
 
+/* Space freed by freespace() is remembered in the discardlist, so the
+   device can be told it is unused once the transaction which freed it has
+   been written (see discardfreedspace()).  Space which is allocated again
+   before that must be removed from the list.  When the list is full freed
+   space is simply not discarded. */
+
+static void adddiscard(BLCK block, ULONG blocks) {
+  struct Space *s=globals->discardlist;
+  ULONG n;
+
+  if(globals->candiscard==FALSE) {
+    return;
+  }
+
+  for(n=0; n<globals->discardcount; n++) {
+    if(s[n].block+s[n].blocks==block) {
+      s[n].blocks+=blocks;
+      return;
+    }
+    else if(block+blocks==s[n].block) {
+      s[n].block=block;
+      s[n].blocks+=blocks;
+      return;
+    }
+  }
+
+  if(globals->discardcount<DISCARDLIST_MAX) {
+    s[globals->discardcount].block=block;
+    s[globals->discardcount].blocks=blocks;
+    globals->discardcount++;
+  }
+}
+
+
+
+static void removediscard(BLCK block, ULONG blocks) {
+  struct Space *s=globals->discardlist;
+  BLCK end=block+blocks;
+  LONG n;
+
+  for(n=globals->discardcount-1; n>=0; n--) {
+    BLCK sstart=s[n].block;
+    BLCK send=s[n].block+s[n].blocks;
+
+    if(end<=sstart || block>=send) {
+      continue;
+    }
+
+    if(block<=sstart && end>=send) {
+      s[n]=s[--globals->discardcount];
+    }
+    else if(block<=sstart) {
+      s[n].block=end;
+      s[n].blocks=send-end;
+    }
+    else if(end>=send) {
+      s[n].blocks=block-sstart;
+    }
+    else {
+      s[n].blocks=block-sstart;
+
+      if(globals->discardcount<DISCARDLIST_MAX) {
+        s[globals->discardcount].block=end;
+        s[globals->discardcount].blocks=send-end;
+        globals->discardcount++;
+      }
+    }
+  }
+}
+
+
+
+void cleardiscards(void) {
+  globals->discardcount=0;
+}
+
+
+
 LONG markspace(BLCK block,ULONG blocks) {
   ULONG freeblocks;
   LONG errorcode;
 
   _XDEBUG(DEBUG_BITMAP,"markspace: Marking %ld blocks from block %ld\n",blocks,block);
 
+  removediscard(block, blocks);
+
   if(((ULONG)availablespace(block, blocks))<blocks) {
     req_unusual("Attempted to mark %ld blocks from block %ld,\n but some of them were already full.", blocks, block);
     return(-1);
@@ -150,6 +230,8 @@ LONG freespace(BLCK block,ULONG blocks) {
 
       // blocks_useddiff-=blocks;
 
+      adddiscard(block, blocks);
+
       block-=skipblocks*globals->blocks_inbitmap;
       bitmapblock=globals->block_bitmapbase+skipblocks;
 
@@ -6,6 +6,7 @@
 #include "blockstructure.h"
 
 #define SPACELIST_MAX (1000)
+#define DISCARDLIST_MAX (128)
 
 /* Used by smartfindandmarkspace() */
 
@@ -17,6 +17,8 @@ LONG findspace2_backwards(ULONG maxneeded, BLCK startblock, BLCK endblock, BLCK
 LONG findandmarkspace(ULONG,BLCK *);
 LONG smartfindandmarkspace(BLCK startblock,ULONG blocksneeded);
 
+void cleardiscards(void);
+
 LONG getusedblocks(ULONG *returned_usedblocks);
 LONG getfreeblocks(ULONG *returned_freeblocks);
 LONG setfreeblocks(ULONG freeblocks);
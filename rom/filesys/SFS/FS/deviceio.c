@@ -13,6 +13,7 @@
 #include <exec/types.h>
 #include <proto/exec.h>
 #include <devices/newstyle.h>      /* Doesn't include exec/types.h which is why it is placed here */
+#include <devices/ata.h>
 
 #ifdef __AROS__
 #include <aros/asmcall.h>
@@ -22,6 +23,7 @@
 
 #include "deviceio.h"
 #include "deviceio_protos.h"
+#include "bitmap_protos.h"
 #include "debug.h"
 #include "globals.h"
 #include "req_protos.h"
@@ -59,6 +61,41 @@ void update(void)
     DoIO((struct IORequest *)globals->ioreq);
 }
 
+void discardfreedspace(void)
+{
+    struct TRIMRange *ranges;
+    ULONG n;
+
+    /* Tells the device that the space in the discardlist is no longer in
+       use.  Must only be called once the bitmap which frees the space has
+       been written.  Errors are ignored; the space simply stays allocated
+       on the device. */
+
+    if(globals->discardcount==0) {
+        return;
+    }
+
+    if((ranges=AllocMem(globals->discardcount * sizeof(struct TRIMRange), MEMF_ANY))!=0) {
+        for(n=0; n<globals->discardcount; n++) {
+            ranges[n].tr_Offset=globals->byte_low + ((UQUAD)globals->discardlist[n].block << globals->shifts_block);
+            ranges[n].tr_Length=(UQUAD)globals->discardlist[n].blocks << globals->shifts_block;
+        }
+
+        _TDEBUG("DISCARD %ld ranges\n", globals->discardcount);
+
+        globals->ioreq->io_Command=HD_TRIMCMD;
+        globals->ioreq->io_Offset=0;
+        globals->ioreq->io_Length=globals->discardcount * sizeof(struct TRIMRange);
+        globals->ioreq->io_Actual=0;
+        globals->ioreq->io_Data=(APTR)ranges;
+        DoIO((struct IORequest *)globals->ioreq);
+
+        FreeMem(ranges, globals->discardcount * sizeof(struct TRIMRange));
+    }
+
+    cleardiscards();
+}
+
 void motoroff(void)
 {
     _TDEBUG("MOTOR OFF\n");
@@ -374,6 +411,22 @@ LONG initdeviceio(UBYTE *devicename, IPTR unit, ULONG flags, struct DosEnvec *de
 
                         changegeometry(de);
 
+                        /* Check whether the device can be told about unused blocks */
+                        {
+                            ULONG trimid=0;
+
+                            globals->ioreq->io_Command=HD_TRIMCMD;
+                            globals->ioreq->io_Offset=ATAFEATURE_TEST_AVAIL;
+                            globals->ioreq->io_Length=sizeof(trimid);
+                            globals->ioreq->io_Actual=0;
+                            globals->ioreq->io_Data=(APTR)&trimid;
+
+                            if(DoIO((struct IORequest *)globals->ioreq)==0 && globals->ioreq->io_Actual>=sizeof(trimid) && trimid==TRIM_MAGIC_ID) {
+                                _DEBUG("Device supports HD_TRIMCMD\n");
+                                globals->candiscard=TRUE;
+                            }
+                        }
+
                         if(de->de_TableSize>=12) {
                             globals->bufmemtype=de->de_BufMemType;
 
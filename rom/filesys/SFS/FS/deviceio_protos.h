@@ -13,6 +13,7 @@ LONG writeprotection(void);
 ULONG deviceapiused(void);
 
 LONG transfer(UWORD action, UBYTE *buffer, ULONG blockoffset, ULONG blocklength);
+void discardfreedspace(void);
 
 LONG initdeviceio(UBYTE *devicename, IPTR unit, ULONG flags, struct DosEnvec *de);
 void cleanupdeviceio(void);
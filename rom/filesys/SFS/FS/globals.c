@@ -27,6 +27,8 @@ void initGlobals()
     globals->inactivity_timeout = TIMEOUT;
     globals->retries = MAX_RETRIES;
     globals->scsidirect = FALSE;
+    globals->candiscard = FALSE;
+    globals->discardcount = 0;
     globals->does64bit = FALSE;
     globals->newstyledevice = FALSE;
     globals->deviceopened = FALSE;
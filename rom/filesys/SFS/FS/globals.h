@@ -99,6 +99,8 @@ struct SFSBase
     BOOL is_LittleEndian; /* Little endian filesystem? */
 
     struct Space spacelist[SPACELIST_MAX+1];
+    struct Space discardlist[DISCARDLIST_MAX];  /* freed space, to be discarded after the next flush */
+    ULONG discardcount;
     UBYTE string[260];  /* For storing BCPL string (usually path) */
     UBYTE string2[260]; /* For storing BCPL string (usually comment) */
     UBYTE pathstring[520];    /* Used by fullpath to build a full path */
@@ -118,6 +120,7 @@ struct SFSBase
     BYTE newstyledevice;
     BYTE does64bit;
     BYTE scsidirect;
+    BYTE candiscard;                  /* device supports HD_TRIMCMD */
 
     LONG retries;
 
@@ -12,6 +12,7 @@
 #include "cachebuffers_protos.h"
 #include "debug.h"
 #include "cachedio_protos.h"
+#include "deviceio_protos.h"
 #include "req_protos.h"
 #include "support_protos.h"
 
@@ -703,6 +704,11 @@ void deletetransaction(void) {
   }
 
   globals->transactionnestcount--;
+
+  /* Space freed in the deleted transaction is in use again.  We don't know
+     which entries it added, so forget all of them. */
+
+  cleardiscards();
 }
 
 
@@ -924,6 +930,10 @@ LONG flushtransaction(void) {
 
                 if((errorcode=removetransactionfailure())==0) {
                   stoptimeout();
+
+                  /* The space freed by the transaction is now really free. */
+
+                  discardfreedspace();
                 }
               }
             }
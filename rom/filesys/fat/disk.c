@@ -15,6 +15,7 @@
 #include <exec/types.h>
 #include <exec/errors.h>
 
+#include <devices/ata.h>
 #include <devices/newstyle.h>
 #include <devices/trackdisk.h>
 
@@ -73,7 +74,12 @@ void ProcessDiskChange(struct Globals *glob)
 void UpdateDisk(struct Globals *glob)
 {
     if (glob->sb)
-        Cache_Flush(glob->sb->cache);
+    {
+        /* Only discard freed clusters once the FAT no longer refers to
+         * them on disk */
+        if (Cache_Flush(glob->sb->cache))
+            DiscardFreedClusters(glob);
+    }
 
     glob->diskioreq->iotd_Req.io_Command = CMD_UPDATE;
     DoIO((struct IORequest *)glob->diskioreq);
@@ -134,6 +140,61 @@ void Probe64BitSupport(struct Globals *glob)
         }
 }
 
+/* Probe the device to determine whether it can discard unused blocks */
+void ProbeDiscardSupport(struct Globals *glob)
+{
+    ULONG trimid = 0;
+
+    glob->candiscard = FALSE;
+
+    glob->diskioreq->iotd_Req.io_Command = HD_TRIMCMD;
+    glob->diskioreq->iotd_Req.io_Offset = ATAFEATURE_TEST_AVAIL;
+    glob->diskioreq->iotd_Req.io_Length = sizeof(trimid);
+    glob->diskioreq->iotd_Req.io_Actual = 0;
+    glob->diskioreq->iotd_Req.io_Data = &trimid;
+
+    if (DoIO((struct IORequest *)glob->diskioreq) == 0
+        && glob->diskioreq->iotd_Req.io_Actual >= sizeof(trimid)
+        && trimid == TRIM_MAGIC_ID)
+    {
+        D(bug("ProbeDiscardSupport: device supports discarding\n"));
+        glob->candiscard = TRUE;
+    }
+}
+
+/* Tell the device that the clusters freed since the last flush no longer
+ * hold any data. All pending runs are passed in a single request */
+void DiscardFreedClusters(struct Globals *glob)
+{
+    struct FSSuper *sb = glob->sb;
+    struct TRIMRange ranges[FAT_MAX_DISCARDS];
+    ULONG i;
+
+    if (sb->discard_count == 0)
+        return;
+
+    for (i = 0; i < sb->discard_count; i++)
+    {
+        ranges[i].tr_Offset = ((UQUAD)(sb->first_device_sector
+            + SECTOR_FROM_CLUSTER(sb, sb->discards[i].first_cluster)))
+            << sb->sectorsize_bits;
+        ranges[i].tr_Length =
+            ((UQUAD)sb->discards[i].count) << sb->clustersize_bits;
+    }
+
+    D(bug("DiscardFreedClusters: %ld ranges\n", sb->discard_count));
+
+    glob->diskioreq->iotd_Req.io_Command = HD_TRIMCMD;
+    glob->diskioreq->iotd_Req.io_Offset = 0;
+    glob->diskioreq->iotd_Req.io_Actual = 0;
+    glob->diskioreq->iotd_Req.io_Length =
+        sb->discard_count * sizeof(struct TRIMRange);
+    glob->diskioreq->iotd_Req.io_Data = ranges;
+    DoIO((struct IORequest *)glob->diskioreq);
+
+    ClearDiscards(sb);
+}
+
 /* N.B. returns an Exec error code, not a DOS error code! */
 LONG AccessDisk(BOOL do_write, ULONG num, ULONG nblocks, ULONG block_size,
     UBYTE *data, APTR priv)
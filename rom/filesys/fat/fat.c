@@ -347,8 +347,88 @@ void CountFreeClusters(struct FSSuper *sb)
     D(bug("\tfree clusters: %ld\n", free));
 }
 
+/* Remember a freed cluster so that it can be discarded once the FAT change
+ * that freed it has reached the disk. Runs of adjacent clusters are merged;
+ * when the list is full the cluster is simply not discarded */
+static void AddDiscard(struct FSSuper *sb, ULONG cluster)
+{
+    struct DiscardRange *dr;
+    ULONG i;
+
+    if (!sb->glob->candiscard)
+        return;
+
+    for (i = 0; i < sb->discard_count; i++)
+    {
+        dr = &sb->discards[i];
+        if (dr->first_cluster + dr->count == cluster)
+        {
+            dr->count++;
+            return;
+        }
+        if (cluster + 1 == dr->first_cluster)
+        {
+            dr->first_cluster--;
+            dr->count++;
+            return;
+        }
+    }
+
+    if (sb->discard_count < FAT_MAX_DISCARDS)
+    {
+        dr = &sb->discards[sb->discard_count++];
+        dr->first_cluster = cluster;
+        dr->count = 1;
+    }
+}
+
+/* Forget a pending discard for a cluster that is being reused */
+static void RemoveDiscard(struct FSSuper *sb, ULONG cluster)
+{
+    struct DiscardRange *dr;
+    ULONG i, end;
+
+    for (i = 0; i < sb->discard_count; i++)
+    {
+        dr = &sb->discards[i];
+        end = dr->first_cluster + dr->count;
+        if (cluster < dr->first_cluster || cluster >= end)
+            continue;
+
+        if (cluster == dr->first_cluster)
+        {
+            dr->first_cluster++;
+            dr->count--;
+        }
+        else if (cluster == end - 1)
+            dr->count--;
+        else if (sb->discard_count < FAT_MAX_DISCARDS)
+        {
+            /* Split the run around the reused cluster */
+            dr->count = cluster - dr->first_cluster;
+            sb->discards[sb->discard_count].first_cluster = cluster + 1;
+            sb->discards[sb->discard_count].count = end - cluster - 1;
+            sb->discard_count++;
+        }
+        else
+            /* No room to split, keep only the lower part */
+            dr->count = cluster - dr->first_cluster;
+
+        if (dr->count == 0)
+            *dr = sb->discards[--sb->discard_count];
+        return;
+    }
+}
+
+void ClearDiscards(struct FSSuper *sb)
+{
+    sb->discard_count = 0;
+}
+
 void AllocCluster(struct FSSuper *sb, ULONG cluster)
 {
+    if (sb->discard_count != 0)
+        RemoveDiscard(sb, cluster);
     SET_NEXT_CLUSTER(sb, cluster, sb->eoc_mark);
     sb->free_clusters--;
     if (sb->fsinfo_buffer != NULL)
@@ -362,6 +442,7 @@ void AllocCluster(struct FSSuper *sb, ULONG cluster)
 void FreeCluster(struct FSSuper *sb, ULONG cluster)
 {
     SET_NEXT_CLUSTER(sb, cluster, 0);
+    AddDiscard(sb, cluster);
     sb->free_clusters++;
     if (sb->fsinfo_buffer != NULL)
     {
@@ -172,6 +172,15 @@ struct VolumeIdentity
     struct DateStamp    create_time;
 };
 
+/* Maximum number of freed cluster runs remembered for discarding */
+#define FAT_MAX_DISCARDS 64
+
+struct DiscardRange
+{
+    ULONG first_cluster;
+    ULONG count;
+};
+
 struct FSSuper
 {
     struct Node node;
@@ -227,6 +236,10 @@ struct FSSuper
 
     struct VolumeIdentity volume;
 
+    /* freed clusters waiting to be discarded after the next flush */
+    struct DiscardRange discards[FAT_MAX_DISCARDS];
+    ULONG discard_count;
+
     /* function table */
     ULONG (*func_get_fat_entry)(struct FSSuper *sb, ULONG n);
     BOOL (*func_set_fat_entry)(struct FSSuper *sb, ULONG n, ULONG val);
@@ -265,6 +278,7 @@ struct Globals
     ULONG last_num;    /* last block number that was outside boundaries */
     UWORD readcmd;
     UWORD writecmd;
+    BOOL candiscard;   /* device accepts HD_TRIMCMD */
     BOOL timer_active;
     BOOL restart_timer;
 
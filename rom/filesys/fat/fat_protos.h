@@ -17,6 +17,8 @@
 void ProcessDiskChange (struct Globals *glob);
 void UpdateDisk(struct Globals *glob);
 void Probe64BitSupport(struct Globals *glob);
+void ProbeDiscardSupport(struct Globals *glob);
+void DiscardFreedClusters(struct Globals *glob);
 
 /* packet.c */
 void ProcessPackets(struct Globals *glob);
@@ -68,6 +70,7 @@ LONG FindFreeCluster(struct FSSuper *sb, ULONG *rcluster);
 void CountFreeClusters(struct FSSuper *sb);
 void AllocCluster(struct FSSuper *sb, ULONG cluster);
 void FreeCluster(struct FSSuper *sb, ULONG cluster);
+void ClearDiscards(struct FSSuper *sb);
 
 /* volume.c */
 LONG ReadFATSuper(struct FSSuper *s);
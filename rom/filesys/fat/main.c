@@ -244,6 +244,7 @@ static LONG InitDiskHandler(struct Globals *glob)
                 {
                     D(bug("\tDevice successfully opened\n"));
                     Probe64BitSupport(glob);
+                    ProbeDiscardSupport(glob);
 
                     if ((glob->diskchgreq =
                         AllocVec(sizeof(struct IOExtTD), MEMF_PUBLIC)))
@@ -71,6 +71,10 @@ struct gfx_data
     struct SignalSemaphore  fbsema;
     BOOL                    backup_done;
 
+    /* Methods of the real driver, used with fbsema held */
+    struct OOP_MethodCache  copybox_mc;
+    struct OOP_MethodCache  copyboxmasked_mc;
+
     /* baseclasses for CreateObject */
     OOP_Class *basegc;
     OOP_Class *basebm;
@@ -578,6 +582,7 @@ UFB_QUICK(data);
 
 static void gfx_copybox(OOP_Class *cl, OOP_Object *o, struct pHidd_Gfx_CopyBox *msg)
 {
+    struct pHidd_Gfx_CopyBox realmsg;
     struct gfx_data *data;
     OOP_Object *src = NULL;
     OOP_Object *dest = NULL;
@@ -606,8 +611,10 @@ static void gfx_copybox(OOP_Class *cl, OOP_Object *o, struct pHidd_Gfx_CopyBox *
     if (inside)
         draw_cursor(data, FALSE, FALSE, GfxBase);
 
-    HIDD_Gfx_CopyBox(data->gfxhidd, src, msg->srcX, msg->srcY,
-                     dest, msg->destX, msg->destY, msg->width, msg->height, msg->gc);
+    realmsg = *msg;
+    realmsg.src  = src;
+    realmsg.dest = dest;
+    OOP_DoCachedMethod(&data->copybox_mc, data->gfxhidd, &realmsg.mID);
 
     if (inside)
         draw_cursor(data, TRUE, FALSE, GfxBase);
@@ -617,6 +624,7 @@ static void gfx_copybox(OOP_Class *cl, OOP_Object *o, struct pHidd_Gfx_CopyBox *
 
 static IPTR gfx_copyboxmasked(OOP_Class *cl, OOP_Object *o, struct pHidd_Gfx_CopyBoxMasked *msg)
 {
+    struct pHidd_Gfx_CopyBoxMasked realmsg;
     struct gfx_data *data;
     OOP_Object *src = NULL;
     OOP_Object *dest = NULL;
@@ -648,8 +656,10 @@ static IPTR gfx_copyboxmasked(OOP_Class *cl, OOP_Object *o, struct pHidd_Gfx_Cop
     if (inside)
         draw_cursor(data, FALSE, FALSE, GfxBase);
 
-    ret = HIDD_Gfx_CopyBoxMasked(data->gfxhidd, src, msg->srcX, msg->srcY,
-                                 dest, msg->destX, msg->destY, msg->width, msg->height, msg->mask, msg->gc);
+    realmsg = *msg;
+    realmsg.src  = src;
+    realmsg.dest = dest;
+    ret = OOP_DoCachedMethod(&data->copyboxmasked_mc, data->gfxhidd, &realmsg.mID);
 
     if (inside)
         draw_cursor(data, TRUE, FALSE, GfxBase);
@@ -747,6 +757,9 @@ struct fakefb_data
 {
     OOP_Object *framebuffer;
     OOP_Object *fakegfxhidd;
+
+    /* Methods of the real framebuffer, used with fbsema of the fake driver held */
+    struct OOP_MethodCache fwd_mc[num_Hidd_BitMap_Methods];
 };
 
 #define FGH(data) ((struct gfx_data *)data->fakegfxhidd)
@@ -767,7 +780,7 @@ struct fakefb_data
 LFB(fgh);
     
 #define FORWARD_METHOD                  \
-    retval = OOP_DoMethod(data->framebuffer, (OOP_Msg)msg);
+    retval = OOP_DoCachedMethod(&data->fwd_mc[*(OOP_Msg)msg - HiddBitMapBase], data->framebuffer, msg);
 
 #define BITMAP_METHOD_EXIT      \
     if (inside) {               \
@@ -534,6 +534,7 @@ BOOL int_bltbitmap(struct BitMap *srcBitMap, OOP_Object *srcbm_obj, WORD xSrc, W
         else
         {
             HIDDT_DrawMode old_drmd;
+            struct pHidd_Gfx_CopyBox cbmsg;
             
             struct TagItem cbtags[] =
             {
@@ -546,14 +547,19 @@ BOOL int_bltbitmap(struct BitMap *srcBitMap, OOP_Object *srcbm_obj, WORD xSrc, W
             cbtags[0].ti_Data = drmd;
             
             OOP_SetAttrs(gc, cbtags);
-            HIDD_Gfx_CopyBox(gfxhidd
-                , srcbm_obj
-                , xSrc, ySrc
-                , dstbm_obj
-                , xDest, yDest
-                , xSize, ySize
-                , gc
-            );
+
+            /* Blits come in long runs on the same driver, skip its dispatcher */
+            cbmsg.mID    = HiddGfxBase + moHidd_Gfx_CopyBox;
+            cbmsg.src    = srcbm_obj;
+            cbmsg.srcX   = xSrc;
+            cbmsg.srcY   = ySrc;
+            cbmsg.dest   = dstbm_obj;
+            cbmsg.destX  = xDest;
+            cbmsg.destY  = yDest;
+            cbmsg.width  = xSize;
+            cbmsg.height = ySize;
+            cbmsg.gc     = gc;
+            OOP_DoCachedMethod(&PrivGBase(GfxBase)->copybox_mc, gfxhidd, &cbmsg.mID);
             
             cbtags[0].ti_Data = drmd;
             OOP_SetAttrs(gc, cbtags);
@@ -200,6 +200,7 @@ struct GfxBase_intern
 
     /* Semaphores */
     struct SignalSemaphore      blit_sema;
+    struct OOP_MethodCache      copybox_mc;          /* HIDD_Gfx_CopyBox() of int_bltbitmap(), under blit_sema */
 
     /* Private library bases */
     struct Library	       *CyberGfxBase;
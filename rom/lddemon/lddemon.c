@@ -34,6 +34,10 @@
 
 #include "lddemon.h"
 
+/* exec's name index has to forget the modules that are expunged here */
+#include "exec_intern.h"
+#include "nameindex.h"
+
 #ifdef __mc68000
 #define INIT_IN_LDDEMON_CONTEXT 1
 #else
@@ -575,8 +579,13 @@ AROS_LH1(void, CloseLibrary,
 
     if( library != NULL )
     {
+        /* The last close may expunge the library */
+        BOOL last = (library->lib_OpenCnt <= 1);
+
         Forbid();
         seglist = AROS_LVO_CALL0(BPTR, struct Library *, library, 2, );
+        if( last )
+            NameIndex_Forget(&library->lib_Node, SysBase);
         if( seglist )
         {
             ldBase->dl_LDReturn = MEM_TRY_AGAIN;
@@ -604,9 +613,14 @@ AROS_LH1(void, CloseDevice,
     Forbid();
     if( iORequest->io_Device != NULL )
     {
+        struct Device *device = iORequest->io_Device;
+        BOOL last = (device->dd_Library.lib_OpenCnt <= 1);
+
         seglist = AROS_LVO_CALL1(BPTR,
                     AROS_LCA(struct IORequest *, iORequest, A1),
                     struct Device *, iORequest->io_Device, 2, );
+        if( last )
+            NameIndex_Forget(&device->dd_Library.lib_Node, SysBase);
         iORequest->io_Device=(struct Device *)-1;
         if( seglist )
         {
@@ -636,6 +650,7 @@ AROS_LH1(void, RemLibrary,
                 AROS_LCA(struct Library *, library, D0),
                 struct Library *, library
     );
+    NameIndex_Forget(&library->lib_Node, SysBase);
     if( seglist )
     {
         ldBase->dl_LDReturn = MEM_TRY_AGAIN;
@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2025, The AROS Development Team. All rights reserved.
+
+    Desc: Look up a method for an inline method cache
+*/
+#include <proto/exec.h>
+#include <oop/oop.h>
+#include <aros/debug.h>
+#include "intern.h"
+
+/*****************************************************************************
+
+    NAME */
+#include <proto/oop.h>
+
+        AROS_LH3(OOP_MethodFunc, OOP_CacheMethod,
+
+/*  SYNOPSIS */
+        AROS_LHA(OOP_Object *,             obj,   A0),
+        AROS_LHA(OOP_MethodID,             mid,   D0),
+        AROS_LHA(struct OOP_MethodCache *, cache, A1),
+
+/*  LOCATION */
+        struct Library *, OOPBase, 26, OOP)
+
+/*  FUNCTION
+        Looks up a method for an object like OOP_GetMethod() does, and
+        stores it in a method cache together with the class of the object.
+        The OOP_DoCachedMethod() macro calls this when the cache does not
+        match the object it is called on.
+
+    INPUTS
+        obj   - object to look the method up for.
+        mid   - method ID, as obtained with OOP_GetMethodID().
+        cache - method cache to fill in.
+
+    RESULT
+        The method function, or NULL if the class of the object does not
+        implement the method. The cache is cleared in that case.
+
+    NOTES
+        The cache must be cleared to zeroes before its first use, and must
+        not be used by more than one task at the same time, unless all the
+        objects it is used with are of the same class.
+
+        Like OOP_GetMethod(), the method is called directly, so this must
+        not be used for objects whose class has its own DoMethod function.
+
+        A cache must not be used any more once the class of the object it
+        was filled in for is disposed.
+
+    EXAMPLE
+        struct OOP_MethodCache cache = { 0 };
+
+        for (i = 0; i < count; i++)
+            OOP_DoCachedMethod(&cache, obj, &msg.mID);
+
+    BUGS
+
+    SEE ALSO
+        OOP_GetMethod(), OOP_GetMethodID()
+
+    INTERNALS
+        The class is stored last, so that a cache that is only used with
+        objects of one class is complete when the class matches.
+
+*****************************************************************************/
+{
+    AROS_LIBFUNC_INIT
+
+    struct IFMethod *ifm;
+
+    cache->mc_ObjClass = NULL;
+
+    ifm = meta_findmethod((OOP_Object *)OOP_OCLASS(obj), mid, (struct Library *)OOPBase);
+    if ((NULL == ifm) || (NULL == ifm->MethodFunc))
+        return NULL;
+
+    cache->mc_MethodID = mid;
+    cache->mc_Method   = (OOP_MethodFunc)ifm->MethodFunc;
+    cache->mc_Class    = ifm->mClass;
+    asm volatile("" ::: "memory");
+    cache->mc_ObjClass = OOP_OCLASS(obj);
+
+    return cache->mc_Method;
+
+    AROS_LIBFUNC_EXIT
+} /* OOP_CacheMethod */
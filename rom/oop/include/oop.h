@@ -123,6 +123,31 @@ struct OOP_MethodDescr
     ULONG MethodIdx;
 };
 
+/* Inline method cache, see OOP_CacheMethod() */
+struct OOP_MethodCache
+{
+    OOP_Class       *mc_ObjClass;   /* Class of the objects the method is cached for */
+    OOP_MethodID    mc_MethodID;
+    OOP_MethodFunc  mc_Method;
+    OOP_Class       *mc_Class;      /* Class to call mc_Method with */
+};
+
+/*
+ * Like OOP_DoMethod(), but calls the method directly when the object has the
+ * class the cache was filled in for. Otherwise the method is looked up with
+ * OOP_CacheMethod(), which needs OOPBase.
+ */
+#define OOP_DoCachedMethod(cache, o, msg)                                       \
+({                                                                              \
+    struct OOP_MethodCache *__mc = (cache);                                     \
+    OOP_Object *__mo = (OOP_Object *)(o);                                       \
+    OOP_Msg __mm = (OOP_Msg)(msg);                                              \
+    ((OOP_OCLASS(__mo) == __mc->mc_ObjClass) && (*__mm == __mc->mc_MethodID))   \
+        || OOP_CacheMethod(__mo, *__mm, __mc)                                   \
+        ? __mc->mc_Method(__mc->mc_Class, __mo, __mm)                           \
+        : OOP_DoMethod(__mo, __mm);                                             \
+})
+
 
 /* Some basic interfaces and classes */
 
@@ -23,6 +23,11 @@
 #include <proto/graphics.h>
 #include <proto/utility.h>
 #include <proto/cybergraphics.h>
+#include <proto/dos.h>
+#include <dos/dostags.h>
+#ifdef __AROS__
+#include <proto/kernel.h>
+#endif
 
 #include "debug.h"
 #include "pictureclass.h"
@@ -36,6 +41,9 @@ static BOOL RemapCM2CM( struct Picture_Data *pd );
 static BOOL RemapTC2CM( struct Picture_Data *pd );
 static int HistSort( const void *HistEntry1, const void *HistEntry2 );
 static void RemapPens( struct Picture_Data *pd, int NumColors, int DestNumColors );
+static BOOL RemapTC2CMLines( struct Picture_Data *pd, ULONG firstline, ULONG numlines, UBYTE *dest );
+static BOOL RemapCM2CMLines( struct Picture_Data *pd, ULONG firstline, ULONG numlines, UBYTE *dest );
+static BOOL RemapImage( struct Picture_Data *pd, BOOL (*linefunc)( struct Picture_Data *, ULONG, ULONG, UBYTE * ) );
 
 /**************************************************************************************************/
 /*
@@ -681,167 +689,123 @@ static BOOL RemapTC2CM( struct Picture_Data *pd )
     RemapPens( pd, 256, DestNumColors );
 
     /*
-     *  Remap line-by-line truecolor source buffer to destination using sparse table
+     *  Remap truecolor source buffer to destination using sparse table
      */
-    {
-        struct RastPort DestRP;
-        ULONG x, srcy, srcyinc, srcypos;
-        ULONG desty;
-        UBYTE *srcline, *destline, *thissrc, *thisdest;
+    D(bug("picture.datatype/RemapTC2CM: remapping buffer, dither quality %d\n", (int)pd->DitherQuality));
+    return RemapImage( pd, RemapTC2CMLines );
+}
 
-        UBYTE *srcbuf = pd->SrcBuffer;
-        ULONG srcwidth = pd->SrcWidth;
-        ULONG destwidth = pd->DestWidth;
-        UBYTE *sparsetable = pd->SparseTable;
-        int skipbyte = 0;
-        BOOL scale = pd->Scale;
-
-        if (pd->SrcPixelFormat == PBPAFMT_ARGB)
-            skipbyte = SKIPFIRSTBYTE;
-        else if (pd->SrcPixelFormat == PBPAFMT_RGBA)
-            skipbyte = SKIPLASTBYTE;
-
-        srcline = AllocLineBuffer( MAX(srcwidth, destwidth) * 4, 1, 1 );
-        if( !srcline )
-            return FALSE;
-        if( scale )
-            destline = AllocLineBuffer( destwidth, 1, 1 );
-        else
-            destline = srcline;
-        if( !destline )
-            return FALSE;
+/*
+ *  Remap the destination lines [firstline, firstline+numlines) of a truecolor
+ *  source into the chunky buffer dest. Every line is done from scratch, so
+ *  separate bands can be handled by different tasks at the same time.
+ */
+static BOOL RemapTC2CMLines( struct Picture_Data *pd, ULONG firstline, ULONG numlines, UBYTE *dest )
+{
+    ULONG x, srcy, lastsrcy, desty;
+    UBYTE *srcbuf, *workline, *thissrc, *thisdest;
+    int index;
+
+    ULONG srcwidth = pd->SrcWidth;
+    ULONG destwidth = pd->DestWidth;
+    UBYTE *sparsetable = pd->SparseTable;
+    int skipbyte = 0;
+    BOOL scale = pd->Scale;
+
+    if (pd->SrcPixelFormat == PBPAFMT_ARGB)
+        skipbyte = SKIPFIRSTBYTE;
+    else if (pd->SrcPixelFormat == PBPAFMT_RGBA)
+        skipbyte = SKIPLASTBYTE;
+
+    workline = AllocLineBuffer( MAX(srcwidth, destwidth) * 4, 1, 1 );
+    if( !workline )
+        return FALSE;
+
+    lastsrcy = (ULONG)-1;
+    for( desty=firstline; desty<firstline+numlines; desty++, dest+=destwidth )
+    {
+        srcy = scale ? (ULONG)(((UQUAD)desty * pd->YScale) >> 16) : desty;
+        if( srcy == lastsrcy )  // same source line as the last one when scaling up
+        {
+            CopyMem( dest-destwidth, dest, destwidth );
+            continue;
+        }
+        lastsrcy = srcy;
+        srcbuf = pd->SrcBuffer + srcy * pd->SrcWidthBytes;
 
-        InitRastPort( &DestRP );
-        DestRP.BitMap = pd->DestBM;
-        srcy = 0;
-        srcyinc = 1;
-        srcypos = 0;
         if( pd->DitherQuality )
         {
             int rval, gval, bval;
             long rerr, gerr, berr;
             UBYTE destindex;
             ULONG *colregs;
-            int feedback;
-            
-            D(bug("picture.datatype/RemapTC2CM: remapping buffer with dither of %d\n", (int)pd->DitherQuality));
-            feedback = 4 - pd->DitherQuality;
-            destcolregs = pd->DestColRegs;
-            for( desty=0; desty<pd->DestHeight; desty++ )
+            ULONG *destcolregs = pd->DestColRegs;
+            int feedback = 4 - pd->DitherQuality;
+
+            if( scale )
             {
-                if( srcyinc )   // incremented source line after last line scaling ?
-                {
-                    if( scale )
-                    {
-                        ScaleLineSimple( srcbuf, srcline, destwidth, pd->SrcPixelBytes, pd->XScale );
-                        skipbyte = SKIPFIRSTBYTE;
-                        thissrc = srcline;
-                    }
-                    else
-                    {
-                        thissrc = srcbuf;
-                    }
-                    thisdest = destline;
-                    rerr = gerr = berr = 0;
-                    x = destwidth;
-                    while( x-- )
-                    {
-                        if( skipbyte == SKIPFIRSTBYTE )
-                            thissrc++;
-                        if( feedback )
-                        {
-                            rerr >>= feedback;
-                            gerr >>= feedback;
-                            berr >>= feedback;
-                        }
-                        rerr += (*thissrc++);
-                        gerr += (*thissrc++);
-                        berr += (*thissrc++);
-                        if( skipbyte == SKIPLASTBYTE )
-                            thissrc++;
-
-                        rval = CLIP( rerr );
-                        gval = CLIP( gerr );
-                        bval = CLIP( berr );
-                        index = (rval>>2 & 0x38) | (gval>>5 & 0x07) | (bval & 0xc0);
-                        destindex = sparsetable[index];
-                        *thisdest++ = destindex;
-                        colregs = destcolregs + destindex*3;
-                        rerr -= (*colregs++)>>24;
-                        gerr -= (*colregs++)>>24;
-                        berr -= (*colregs)>>24;
-                    }
-                }
-                if( scale )
-                {
-                    srcypos += pd->YScale;
-                    srcyinc = (srcypos >> 16) - srcy;
-                }
-                WriteChunkyPixels( &DestRP,
-                                    0,
-                                    desty,
-                                    destwidth-1,
-                                    desty,
-                                    destline,
-                                    destwidth );
-                if( srcyinc )
+                ScaleLineSimple( srcbuf, workline, destwidth, pd->SrcPixelBytes, pd->XScale );
+                skipbyte = SKIPFIRSTBYTE;
+                thissrc = workline;
+            }
+            else
+            {
+                thissrc = srcbuf;
+            }
+            thisdest = dest;
+            rerr = gerr = berr = 0;
+            x = destwidth;
+            while( x-- )
+            {
+                if( skipbyte == SKIPFIRSTBYTE )
+                    thissrc++;
+                if( feedback )
                 {
-                    if( srcyinc == 1 )  srcbuf += pd->SrcWidthBytes;
-                    else                srcbuf += pd->SrcWidthBytes * srcyinc;
-                    srcy += srcyinc;
+                    rerr >>= feedback;
+                    gerr >>= feedback;
+                    berr >>= feedback;
                 }
+                rerr += (*thissrc++);
+                gerr += (*thissrc++);
+                berr += (*thissrc++);
+                if( skipbyte == SKIPLASTBYTE )
+                    thissrc++;
+
+                rval = CLIP( rerr );
+                gval = CLIP( gerr );
+                bval = CLIP( berr );
+                index = (rval>>2 & 0x38) | (gval>>5 & 0x07) | (bval & 0xc0);
+                destindex = sparsetable[index];
+                *thisdest++ = destindex;
+                colregs = destcolregs + destindex*3;
+                rerr -= (*colregs++)>>24;
+                gerr -= (*colregs++)>>24;
+                berr -= (*colregs)>>24;
             }
         }
         else
         {
-            D(bug("picture.datatype/RemapTC2CM: remapping buffer without dithering\n"));
-            for( desty=0; desty<pd->DestHeight; desty++ )
+            thissrc = srcbuf;
+            thisdest = scale ? workline : dest;
+            x = srcwidth;
+            while( x-- )
             {
-                if( srcyinc )   // incremented source line after last line scaling ?
-                {
-                    thissrc = srcbuf;
-                    thisdest = srcline;
-                    x = srcwidth;
-                    while( x-- )
-                    {
-                        if( skipbyte == SKIPFIRSTBYTE )
-                            thissrc++;
-                        index  = (*thissrc++)>>2 & 0x38; // red
-                        index |= (*thissrc++)>>5 & 0x07; // green
-                        index |= (*thissrc++)    & 0xc0; // blue
-                        if( skipbyte == SKIPLASTBYTE )
-                            thissrc++;
-
-                        *thisdest++ = sparsetable[index];
-                    }
-                    if( scale )
-                        ScaleLineSimple( srcline, destline, destwidth, 1, pd->XScale );
-                }
-                if( scale )
-                {
-                    srcypos += pd->YScale;
-                    srcyinc = (srcypos >> 16) - srcy;
-                }
-                WriteChunkyPixels( &DestRP,
-                                    0,
-                                    desty,
-                                    destwidth-1,
-                                    desty,
-                                    destline,
-                                    destwidth );
-                if( srcyinc )
-                {
-                    if( srcyinc == 1 )  srcbuf += pd->SrcWidthBytes;
-                    else                srcbuf += pd->SrcWidthBytes * srcyinc;
-                    srcy += srcyinc;
-                }
+                if( skipbyte == SKIPFIRSTBYTE )
+                    thissrc++;
+                index  = (*thissrc++)>>2 & 0x38; // red
+                index |= (*thissrc++)>>5 & 0x07; // green
+                index |= (*thissrc++)    & 0xc0; // blue
+                if( skipbyte == SKIPLASTBYTE )
+                    thissrc++;
+
+                *thisdest++ = sparsetable[index];
             }
+            if( scale )
+                ScaleLineSimple( workline, dest, destwidth, 1, pd->XScale );
         }
-
-        FreeVec( (void *) srcline );
-        if( scale )
-            FreeVec( (void *) destline );
     }
+
+    FreeVec( (void *) workline );
     return TRUE;
 }
 
@@ -936,73 +900,230 @@ static BOOL RemapCM2CM( struct Picture_Data *pd )
      *  Remap source buffer to dest Bitmap
      */
     D(bug("picture.datatype/RemapCM2CM: remapping buffer to new pens\n"));
-    {
-        struct RastPort DestRP;
-        ULONG x, srcy, srcyinc, srcypos;
-        ULONG desty;
-        UBYTE *srcline, *destline, *thissrc, *thisdest;
+    return RemapImage( pd, RemapCM2CMLines );
+}
 
-        UBYTE *srcbuf = pd->SrcBuffer;
-        ULONG srcwidth = pd->SrcWidth;
-        ULONG destwidth = pd->DestWidth;
-        BOOL scale = pd->Scale;
-        UBYTE *sparsetable = pd->SparseTable;
- 
-        srcline = AllocLineBuffer( srcwidth, 1, 1 );
-        if( !srcline )
+/*
+ *  Remap the destination lines [firstline, firstline+numlines) of a colormapped
+ *  source into the chunky buffer dest, see RemapTC2CMLines().
+ */
+static BOOL RemapCM2CMLines( struct Picture_Data *pd, ULONG firstline, ULONG numlines, UBYTE *dest )
+{
+    ULONG x, srcy, lastsrcy, desty;
+    UBYTE *workline, *thissrc, *thisdest;
+
+    ULONG srcwidth = pd->SrcWidth;
+    ULONG destwidth = pd->DestWidth;
+    BOOL scale = pd->Scale;
+    UBYTE *sparsetable = pd->SparseTable;
+
+    workline = NULL;
+    if( scale )
+    {
+        workline = AllocLineBuffer( srcwidth, 1, 1 );
+        if( !workline )
             return FALSE;
+    }
+
+    lastsrcy = (ULONG)-1;
+    for( desty=firstline; desty<firstline+numlines; desty++, dest+=destwidth )
+    {
+        srcy = scale ? (ULONG)(((UQUAD)desty * pd->YScale) >> 16) : desty;
+        if( srcy == lastsrcy )  // same source line as the last one when scaling up
+        {
+            CopyMem( dest-destwidth, dest, destwidth );
+            continue;
+        }
+        lastsrcy = srcy;
+
+        thissrc = pd->SrcBuffer + srcy * pd->SrcWidthBytes;
+        thisdest = scale ? workline : dest;
+        x = srcwidth;
+        while( x-- )
+        {
+            *thisdest++ = sparsetable[*thissrc++];
+        }
         if( scale )
-            destline = AllocLineBuffer( destwidth, 1, 1 );
-        else
-            destline = srcline;
-        if( !destline )
-            return FALSE;
+            ScaleLineSimple( workline, dest, destwidth, 1, pd->XScale );
+    }
 
-        InitRastPort( &DestRP );
-        DestRP.BitMap = pd->DestBM;
-        srcy = 0;
-        srcyinc = 1;
-        srcypos = 0;
-        for( desty=0; desty<pd->DestHeight; desty++ )
+    if( workline )
+        FreeVec( (void *) workline );
+    return TRUE;
+}
+
+/**************************************************************************************************/
+
+/*
+ *  Tiled remapping pipeline: the destination is converted in bands of lines.
+ *  On SMP systems the lines of each band are shared out between the layout
+ *  task and some helper processes, then the finished band is written to the
+ *  destination bitmap with a single WriteChunkyPixels() call. Only the layout
+ *  task ever touches the bitmap.
+ */
+#define REMAP_BANDLINES     32      /* lines per band and task */
+#define REMAP_MAXWORKERS    7       /* helper processes besides the layout task */
+#define REMAP_MINPIXELS     65536   /* don't bother with helpers for small pictures */
+
+struct RemapJob
+{
+    struct Message          rj_Message;
+    struct Process          *rj_Worker;
+    struct Picture_Data     *rj_PD;
+    BOOL                    (*rj_LineFunc)( struct Picture_Data *, ULONG, ULONG, UBYTE * );
+    ULONG                   rj_FirstLine;
+    ULONG                   rj_NumLines;    /* 0 tells the worker to quit */
+    UBYTE                   *rj_Dest;
+    BOOL                    rj_Success;
+};
+
+static void RemapWorkerEntry( void )
+{
+    struct Process *proc = (struct Process *) FindTask(NULL);
+    struct RemapJob *job;
+
+    for( ;; )
+    {
+        WaitPort( &proc->pr_MsgPort );
+        job = (struct RemapJob *) GetMsg( &proc->pr_MsgPort );
+        if( !job )
+            continue;
+        if( job->rj_NumLines == 0 )
+            break;
+
+        job->rj_Success = job->rj_LineFunc( job->rj_PD, job->rj_FirstLine, job->rj_NumLines, job->rj_Dest );
+        ReplyMsg( &job->rj_Message );
+    }
+
+    Forbid();
+    ReplyMsg( &job->rj_Message );
+}
+
+static ULONG StartRemapWorkers( struct Picture_Data *pd, struct RemapJob *jobs, struct MsgPort *replyport )
+{
+    ULONG numcpus = 1, numworkers, i;
+#ifdef __AROS__
+    APTR KernelBase = OpenResource( "kernel.resource" );
+
+    if( KernelBase )
+        numcpus = KrnGetCPUCount();
+#endif
+
+    if( numcpus < 2 || (pd->DestWidth * pd->DestHeight) < REMAP_MINPIXELS )
+        return 0;
+
+    numworkers = MIN( numcpus - 1, REMAP_MAXWORKERS );
+    for( i=0; i<numworkers; i++ )
+    {
+        jobs[i].rj_Message.mn_Node.ln_Type = NT_MESSAGE;
+        jobs[i].rj_Message.mn_ReplyPort = replyport;
+        jobs[i].rj_Message.mn_Length = sizeof(struct RemapJob);
+        jobs[i].rj_Worker = CreateNewProcTags( NP_Entry, (IPTR)RemapWorkerEntry,
+                                               NP_Name, (IPTR)"picture.datatype remap process",
+                                               NP_Priority, FindTask(NULL)->tc_Node.ln_Pri,
+                                               NP_StackSize, 16384,
+                                               TAG_DONE );
+        if( !jobs[i].rj_Worker )
+            break;
+    }
+    D(bug("picture.datatype/StartRemapWorkers: %d cpus, %d workers\n", (int)numcpus, (int)i));
+
+    return i;
+}
+
+static void StopRemapWorkers( struct RemapJob *jobs, ULONG numworkers, struct MsgPort *replyport )
+{
+    ULONG i;
+
+    for( i=0; i<numworkers; i++ )
+    {
+        jobs[i].rj_NumLines = 0;
+        PutMsg( &jobs[i].rj_Worker->pr_MsgPort, &jobs[i].rj_Message );
+    }
+    while( numworkers )
+    {
+        WaitPort( replyport );
+        while( GetMsg( replyport ) )
+            numworkers--;
+    }
+}
+
+static BOOL RemapImage( struct Picture_Data *pd, BOOL (*linefunc)( struct Picture_Data *, ULONG, ULONG, UBYTE * ) )
+{
+    struct RemapJob jobs[REMAP_MAXWORKERS];
+    struct MsgPort *replyport;
+    struct RastPort DestRP;
+    ULONG destwidth = pd->DestWidth;
+    ULONG numworkers = 0, bandlines, numlines, perjob, desty, line, pending, i;
+    UBYTE *band;
+    BOOL success = TRUE;
+
+    replyport = CreateMsgPort();
+    if( replyport )
+        numworkers = StartRemapWorkers( pd, jobs, replyport );
+
+    bandlines = REMAP_BANDLINES * (numworkers + 1);
+    band = AllocVec( destwidth * bandlines, MEMF_ANY );
+    if( !band )
+    {
+        StopRemapWorkers( jobs, numworkers, replyport );
+        if( replyport )
+            DeleteMsgPort( replyport );
+        return FALSE;
+    }
+
+    InitRastPort( &DestRP );
+    DestRP.BitMap = pd->DestBM;
+    for( desty=0; desty<pd->DestHeight && success; desty+=numlines )
+    {
+        numlines = MIN( bandlines, pd->DestHeight - desty );
+        perjob = (numlines + numworkers) / (numworkers + 1);
+
+        /* hand out the first parts of the band, do the last one ourselves */
+        line = desty;
+        pending = 0;
+        for( i=0; i<numworkers && (line + perjob) < (desty + numlines); i++ )
         {
-            if( srcyinc )       // incremented source line after last line scaling ?
-            {
-                thissrc = srcbuf;
-                thisdest = srcline;
-                x = srcwidth;
-                while( x-- )
-                {
-                    *thisdest++ = sparsetable[*thissrc++];
-                }
-                if( scale )
-                    ScaleLineSimple( srcline, destline, destwidth, 1, pd->XScale );
-            }
-            if( scale )
+            jobs[i].rj_PD = pd;
+            jobs[i].rj_LineFunc = linefunc;
+            jobs[i].rj_FirstLine = line;
+            jobs[i].rj_NumLines = perjob;
+            jobs[i].rj_Dest = band + (line - desty) * destwidth;
+            PutMsg( &jobs[i].rj_Worker->pr_MsgPort, &jobs[i].rj_Message );
+            line += perjob;
+            pending++;
+        }
+        success = linefunc( pd, line, desty + numlines - line, band + (line - desty) * destwidth );
+
+        while( pending )
+        {
+            struct RemapJob *job;
+
+            WaitPort( replyport );
+            while( (job = (struct RemapJob *) GetMsg( replyport )) )
             {
-                srcypos += pd->YScale;
-                srcyinc = (srcypos >> 16) - srcy;
+                if( !job->rj_Success )
+                    success = FALSE;
+                pending--;
             }
+        }
+
+        if( success )
             WriteChunkyPixels( &DestRP,
                                 0,
                                 desty,
                                 destwidth-1,
-                                desty,
-                                destline,
+                                desty+numlines-1,
+                                band,
                                 destwidth );
-            if( srcyinc )
-            {
-                if( srcyinc == 1 )      srcbuf += pd->SrcWidthBytes;
-                else            srcbuf += pd->SrcWidthBytes * srcyinc;
-                srcy += srcyinc;
-            }
-        }
-
-        FreeVec( (void *) srcline );
-        if( scale )
-            FreeVec( (void *) destline );
     }
 
-    return TRUE;
+    StopRemapWorkers( jobs, numworkers, replyport );
+    if( replyport )
+        DeleteMsgPort( replyport );
+    FreeVec( (void *) band );
+
+    return success;
 }
 
 static int HistSort( const void *HistEntry1, const void *HistEntry2 )
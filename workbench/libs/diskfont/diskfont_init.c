@@ -39,6 +39,10 @@ static int Init(LIBBASETYPEPTR LIBBASE)
     NEWLIST(&LIBBASE->fontsdirentrylist);
     InitSemaphore(&LIBBASE->fontssemaphore);
 
+    LIBBASE->notifyport.mp_Node.ln_Type = NT_MSGPORT;
+    LIBBASE->notifyport.mp_Flags = PA_IGNORE;
+    NEWLIST(&LIBBASE->notifyport.mp_MsgList);
+
     /* Insert the fonthooks into the DiskfontBase */
 
     LIBBASE->dsh.h_Entry = (void *)AROS_ASMSYMNAME(dosstreamhook);
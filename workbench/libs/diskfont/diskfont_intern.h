@@ -21,6 +21,9 @@
 #   include  <exec/lists.h>
 #endif
 #include <exec/semaphores.h>
+#ifndef EXEC_PORTS_H
+#   include <exec/ports.h>
+#endif
 #ifndef AROS_ASMCALL_H
 #   include <aros/asmcall.h>
 #endif
@@ -75,6 +78,9 @@
 #define PROGDIRFONTSDIR "PROGDIR:Fonts/"
 #define FONTSDIR        "FONTS:"
 
+/* Size of the path buffer used for notification on font directories */
+#define NOTIFYPATHLEN   256
+
 struct OTagList
 {
     STRPTR		filename;
@@ -208,6 +214,10 @@ struct DiskfontBase
     
     struct MinList         fontsdirentrylist;
     struct SignalSemaphore fontssemaphore;
+
+    /* Receives DOS notifications for the cached FONTS: directories. The
+       port has no signal task; it is drained with fontssemaphore held. */
+    struct MsgPort         notifyport;
     
     /* MemHandler interrupt for flushing library */
     struct Interrupt       memint;
@@ -8,6 +8,7 @@
 
 #include <exec/initializers.h>
 #include <dos/dosextens.h>
+#include <dos/notify.h>
 #include <proto/dos.h>
 #include <proto/graphics.h>
 #include <proto/arossupport.h>
@@ -43,6 +44,9 @@ struct DirEntry
     BPTR                   DirLock;
     struct DateStamp       DirChanged;
     struct MinList         FileList;
+    struct NotifyRequest   Notify;
+    BOOL                   Notifying; /* Notify is active, dates need not be checked */
+    BOOL                   Changed;   /* A notification arrived since the last scan */
 };
 
 struct DF_FontsData /*DiskFontData */
@@ -507,6 +511,77 @@ STATIC BOOL StreamInFileList(struct DirEntry *direntry, BPTR fh, struct Diskfont
     
 /****************************************************************************************/
 
+/************************/
+/* HandleNotifications  */
+/************************/
+
+/****************************************************************************************/
+
+/* Mark the directories for which a notification arrived as changed.
+ * Must be called with fontssemaphore held.
+ */
+STATIC VOID HandleNotifications(struct DiskfontBase *DiskfontBase)
+{
+    struct NotifyMessage *nm;
+
+    while ((nm = (struct NotifyMessage *)GetMsg(&DiskfontBase->notifyport)) != NULL)
+    {
+        struct DirEntry *direntry = (struct DirEntry *)nm->nm_NReq->nr_UserData;
+
+        D(bug("HandleNotifications: direntry 0x%lx changed\n", direntry));
+        direntry->Changed = TRUE;
+        ReplyMsg(&nm->nm_ExecMessage);
+    }
+}
+
+/****************************************************************************************/
+
+/******************/
+/* StartDirNotify */
+/******************/
+
+/****************************************************************************************/
+
+/* Ask the filesystem to tell us when the directory changes so that the
+ * FileList can be trusted without examining the directory on every call.
+ * If the filesystem does not support notification the directory date is
+ * checked instead as before.
+ */
+STATIC VOID StartDirNotify(struct DirEntry *direntry, struct DiskfontBase *DiskfontBase)
+{
+    STRPTR name;
+
+    name = AllocVec(NOTIFYPATHLEN, MEMF_ANY);
+    if (name == NULL)
+        return;
+
+    if (!NameFromLock(direntry->DirLock, name, NOTIFYPATHLEN))
+    {
+        FreeVec(name);
+        return;
+    }
+
+    direntry->Notify.nr_Name = name;
+    direntry->Notify.nr_UserData = (IPTR)direntry;
+    direntry->Notify.nr_Flags = NRF_SEND_MESSAGE;
+    direntry->Notify.nr_stuff.nr_Msg.nr_Port = &DiskfontBase->notifyport;
+
+    if (StartNotify(&direntry->Notify))
+    {
+        D(bug("StartDirNotify: notifying on \"%s\"\n", name));
+        direntry->Notifying = TRUE;
+        direntry->Changed = FALSE;
+    }
+    else
+    {
+        D(bug("StartDirNotify: no notification for \"%s\"\n", name));
+        direntry->Notify.nr_Name = NULL;
+        FreeVec(name);
+    }
+}
+
+/****************************************************************************************/
+
 /****************/
 /* FreeDirEntry */
 /****************/
@@ -517,6 +592,13 @@ STATIC VOID FreeDirEntry(struct DirEntry *direntry, struct DiskfontBase *Diskfon
 {
     if (direntry!=NULL)
     {
+        if (direntry->Notifying)
+        {
+            EndNotify(&direntry->Notify);
+            /* Reply messages that may still point to this direntry */
+            HandleNotifications(DiskfontBase);
+            FreeVec(direntry->Notify.nr_Name);
+        }
         FreeFileList(&direntry->FileList, DiskfontBase);
         UnLock(direntry->DirLock);
         FreeVec(direntry);
@@ -540,6 +622,14 @@ STATIC struct DirEntry *ReadDirEntry(BPTR dirlock, struct DirEntry *direntry, st
     BPTR fh;
 
     D(bug("ReadDirEntry(dirlock=0x%lx, direntry=0x%lx)\n", dirlock, direntry));
+
+    /* Nothing can have changed if the filesystem did not tell us so */
+    if (direntry != NULL && direntry->Notifying && !direntry->Changed)
+    {
+        D(bug("ReadDirEntry: direntry 0x%lx not notified\n", direntry));
+        UnLock(dirlock);
+        ReturnPtr("ReadDirEntry", struct DirEntry *, direntry);
+    }
     
     Self               = (struct Process *) FindTask(NULL);
     oldwinptr          = Self->pr_WindowPtr;
@@ -611,7 +701,7 @@ STATIC struct DirEntry *ReadDirEntry(BPTR dirlock, struct DirEntry *direntry, st
     {
         CurrentDir(direntry->DirLock);
         UnLock(dirlock);
-        if (CompareDates(&direntry->DirChanged, &fib->fib_Date) == 0)
+        if (!direntry->Notifying && CompareDates(&direntry->DirChanged, &fib->fib_Date) == 0)
         {
             D(bug("ReadDirEntry: direntry 0x%lx not changed\n", direntry));
             FreeDosObject(DOS_FIB, fib);
@@ -622,14 +712,14 @@ STATIC struct DirEntry *ReadDirEntry(BPTR dirlock, struct DirEntry *direntry, st
     }
 
     direntry->DirChanged = fib->fib_Date;
+    direntry->Changed = FALSE;
 
     if (!GetFileList(direntry, DiskfontBase))
     {
         D(bug("ReadDirEntry: Error reading FileList\n"));
         FreeDosObject(DOS_FIB, fib);
         CurrentDir(olddir);
-        UnLock(direntry->DirLock);
-        FreeVec(direntry);
+        FreeDirEntry(direntry, DiskfontBase);
         Self->pr_WindowPtr = oldwinptr;
         ReturnPtr("ReadDirEntry", struct DirEntry *, NULL);
     }
@@ -666,6 +756,13 @@ STATIC struct DirEntry *ReadDirEntry(BPTR dirlock, struct DirEntry *direntry, st
 
         if (!ok)
             DeleteFile(CACHE_FILE);
+
+        /* Don't rescan because of our own write to the cache file */
+        if (direntry->Notifying)
+        {
+            HandleNotifications(DiskfontBase);
+            direntry->Changed = FALSE;
+        }
     }
 
     FreeDosObject(DOS_FIB, fib);
@@ -754,6 +851,8 @@ STATIC struct DF_Data *AllocResources(struct TTextAttr *reqattr, struct Diskfont
             struct DirEntry *direntry, *direntry2;
 
             df_data->Type = DF_FONTSDATA;
+
+            HandleNotifications(DiskfontBase);
             
 #ifdef PROGDIRFONTSDIR
             do
@@ -813,6 +912,9 @@ STATIC struct DF_Data *AllocResources(struct TTextAttr *reqattr, struct Diskfont
                 direntry = ReadDirEntry(lock, direntry, DiskfontBase);
                 if (direntry!=NULL)
                 {
+                    if (!direntry->Notifying)
+                        StartDirNotify(direntry, DiskfontBase);
+
                     D(bug("AllocResources: addtail direntry 0x%lx\n", direntry));
                     D(bug("AllocResources: first FileEntry: %p\n", GetHead(&direntry->FileList)));
                     ADDTAIL(&newdirlist, direntry);
@@ -3,6 +3,7 @@
  * Richard Griffith
  */
 #include "ftglyphengine.h"
+#include "glyphcache.h"
 
 //#define DEBUG 1
 #include <aros/debug.h>
@@ -57,6 +58,8 @@ void FreeGE(FT_GlyphEngine *ge)
     if (ge->face_established)
         FT_Done_Face( ge->face );
 
+    GlyphCache_ReleaseFace(ge->cache_face);
+
     FT_Done_Library( ge->engine );
 
     FreeVec(ge);
@@ -21,6 +21,7 @@
 									// 0 == scalable
 #define OT_GlyphMap8Bit_Old	(OT_Level1 | 0x108)
 #define OT_Spec9_Hinter		(OT_Level1 | 0x109)
+#define OT_GlyphRun		(OT_Level1 | 0x10A)			// ObtainInfoA(): struct FTGlyphRun *
 
 // Values for OT_Spec4_Metric
 #define METRIC_GLOBALBBOX	0	// default
@@ -39,6 +40,24 @@
 #define HINTER_NONE		2	// Use NO hinter (may speed up things, but bad results).
 					// Default for bitmap fonts.
 
+// Flags for fgr_Flags
+#define FGRF_8BITS		(1 << 0)	// anti-aliased glyph maps, like OT_GlyphMap8Bits
+
+/* OT_GlyphRun: obtain the glyph maps of a whole run of characters, plus
+ * the kerning between each pair of them, with a single ObtainInfoA() call.
+ * Release the run with ReleaseInfoA() and the same tag.
+ */
+struct FTGlyphRun {
+    ULONG			fgr_NumChars;
+    const ULONG			*fgr_Chars;	/* character codes, as OT_GlyphCode */
+    struct GlyphMap		**fgr_GlyphMaps;/* filled in, NULL if no glyph */
+    LONG			*fgr_Kerning;	/* optional, fgr_NumChars - 1 entries,
+						   as OT_TextKernPair */
+    ULONG			fgr_Flags;
+};
+
+struct GlyphCacheFace;
+
 struct FT_GlyphEngine_ {
     /* diskfont standard */
     struct Library		*gle_Library;	/* should be our lib base */
@@ -97,6 +116,9 @@ struct FT_GlyphEngine_ {
     unsigned short int		codepage[256];
 
     struct GlyphMap		*GMap;
+
+    /* shared rendered glyph cache, see glyphcache.c */
+    struct GlyphCacheFace	*cache_face;
 };
 
 typedef struct FT_GlyphEngine_ FT_GlyphEngine ;
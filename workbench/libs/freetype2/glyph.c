@@ -4,6 +4,7 @@
  */
 #include "ftglyphengine.h"
 #include "glyph.h"
+#include "glyphcache.h"
 
 //#define DEBUG 1
 #include <aros/debug.h>
@@ -390,6 +391,9 @@ static int OpenFace(FT_GlyphEngine *ge, char *new_ft_filename)
         /* it is different, free the old one first */
         FT_Done_Face( ge->face );
         //ge->KernPairs = -1;
+
+        GlyphCache_ReleaseFace(ge->cache_face);
+        ge->cache_face = NULL;
     }
 
     ge->face_established = FALSE;
@@ -415,6 +419,9 @@ static int OpenFace(FT_GlyphEngine *ge, char *new_ft_filename)
 
     ge->face_established = TRUE;
 
+    /* may fail, the glyphs just won't be cached then */
+    ge->cache_face = GlyphCache_ObtainFace(ge->ft_filename, ge->face_num);
+
     return set_last_error(ge, OTERR_Success);
 }
 
@@ -0,0 +1,280 @@
+/*
+ * Size keyed LRU cache of rendered glyph maps, shared by all glyph
+ * engines of the library.
+ */
+#include "glyphcache.h"
+
+//#define DEBUG 1
+#include <aros/debug.h>
+#include <aros/symbolsets.h>
+#include <exec/memory.h>
+#include <exec/semaphores.h>
+#include <proto/exec.h>
+#include <clib/alib_protos.h>
+
+#include <string.h>
+#include <strings.h>
+
+#include LC_LIBDEFS_FILE
+
+/* Everything which influences the rendered bitmap. The key is always
+ * cleared before it is filled in, so it can be compared with memcmp().
+ */
+struct GlyphCacheKey {
+    struct GlyphCacheFace	*gck_Face;
+    LONG			gck_PointSize;
+    LONG			gck_XRes, gck_YRes;
+    LONG			gck_MetricSource;
+    LONG			gck_MetricCustom;
+    LONG			gck_Rotate, gck_Shear;
+    FT_Matrix			gck_RotateMatrix;
+    FT_Matrix			gck_ShearMatrix;
+    ULONG			gck_GlyphCode;
+    ULONG			gck_8Bits;
+};
+
+struct GlyphCacheEntry {
+    struct MinNode		gce_LRUNode;
+    struct GlyphCacheEntry	*gce_HashNext;
+    ULONG			gce_Hash;
+    ULONG			gce_BitMapSize;
+    struct GlyphCacheKey	gce_Key;
+    struct GlyphMap		gce_GlyphMap;
+    /* bitmap data follows */
+};
+
+static struct SignalSemaphore gc_Lock;
+static struct MinList gc_Faces;
+static struct MinList gc_LRU;		/* most recently used at head */
+static struct GlyphCacheEntry *gc_Hash[GLYPHCACHE_HASHSIZE];
+static ULONG gc_Bytes;
+
+static void make_key(FT_GlyphEngine *ge, int glyph_8bits, struct GlyphCacheKey *key)
+{
+    memset(key, 0, sizeof(*key));
+
+    key->gck_Face = ge->cache_face;
+    key->gck_PointSize = ge->point_size;
+    key->gck_XRes = ge->xres;
+    key->gck_YRes = ge->yres;
+    key->gck_MetricSource = ge->metric_source;
+    key->gck_MetricCustom = ge->metric_custom;
+    if ((key->gck_Rotate = ge->do_rotate))
+        key->gck_RotateMatrix = ge->rotate_matrix;
+    if ((key->gck_Shear = ge->do_shear))
+        key->gck_ShearMatrix = ge->shear_matrix;
+    key->gck_GlyphCode = ge->glyph_code;
+    key->gck_8Bits = glyph_8bits ? 1 : 0;
+}
+
+static ULONG hash_key(const struct GlyphCacheKey *key)
+{
+    const UBYTE *p = (const UBYTE *)key;
+    ULONG hash = 2166136261UL, i;
+
+    /* FNV-1a */
+    for (i = 0; i < sizeof(*key); i++)
+        hash = (hash ^ p[i]) * 16777619UL;
+
+    return hash;
+}
+
+static void remove_entry(struct GlyphCacheEntry *gce)
+{
+    struct GlyphCacheEntry **prev = &gc_Hash[gce->gce_Hash % GLYPHCACHE_HASHSIZE];
+
+    while (*prev != gce)
+        prev = &(*prev)->gce_HashNext;
+    *prev = gce->gce_HashNext;
+
+    Remove((struct Node *)&gce->gce_LRUNode);
+    gc_Bytes -= gce->gce_BitMapSize;
+    gce->gce_Key.gck_Face->gcf_Entries--;
+
+    if (gce->gce_Key.gck_Face->gcf_RefCount == 0 &&
+            gce->gce_Key.gck_Face->gcf_Entries == 0) {
+        Remove((struct Node *)&gce->gce_Key.gck_Face->gcf_Node);
+        FreeVec(gce->gce_Key.gck_Face);
+    }
+
+    FreeVec(gce);
+}
+
+/* hand out a private copy, so that ReleaseInfoA() can free it as usual */
+static struct GlyphMap *copy_glyphmap(const struct GlyphMap *src, ULONG size)
+{
+    struct GlyphMap *gm;
+
+    gm = AllocVec(sizeof(struct GlyphMap), MEMF_PUBLIC);
+    if (gm == NULL)
+        return NULL;
+
+    *gm = *src;
+
+    /* always allocate at least one byte, see RenderGlyph() */
+    gm->glm_BitMap = AllocVec(size + 1, MEMF_PUBLIC);
+    if (gm->glm_BitMap == NULL) {
+        FreeVec(gm);
+        return NULL;
+    }
+    CopyMem(src->glm_BitMap, gm->glm_BitMap, size);
+
+    return gm;
+}
+
+struct GlyphCacheFace *GlyphCache_ObtainFace(const char *filename, LONG facenum)
+{
+    struct GlyphCacheFace *gcf;
+
+    ObtainSemaphore(&gc_Lock);
+
+    ForeachNode(&gc_Faces, gcf) {
+        if (gcf->gcf_FaceNum == facenum &&
+                stricmp(gcf->gcf_FileName, filename) == 0) {
+            gcf->gcf_RefCount++;
+            ReleaseSemaphore(&gc_Lock);
+            return gcf;
+        }
+    }
+
+    gcf = AllocVec(sizeof(struct GlyphCacheFace) + strlen(filename) + 1,
+                   MEMF_PUBLIC | MEMF_CLEAR);
+    if (gcf) {
+        gcf->gcf_RefCount = 1;
+        gcf->gcf_FaceNum = facenum;
+        strcpy(gcf->gcf_FileName, filename);
+        AddHead((struct List *)&gc_Faces, (struct Node *)&gcf->gcf_Node);
+    }
+
+    ReleaseSemaphore(&gc_Lock);
+
+    return gcf;
+}
+
+void GlyphCache_ReleaseFace(struct GlyphCacheFace *gcf)
+{
+    if (gcf == NULL)
+        return;
+
+    ObtainSemaphore(&gc_Lock);
+
+    if (--gcf->gcf_RefCount == 0 && gcf->gcf_Entries == 0) {
+        Remove((struct Node *)&gcf->gcf_Node);
+        FreeVec(gcf);
+    }
+
+    ReleaseSemaphore(&gc_Lock);
+}
+
+struct GlyphMap *GlyphCache_Lookup(FT_GlyphEngine *ge, int glyph_8bits)
+{
+    struct GlyphCacheKey key;
+    struct GlyphCacheEntry *gce;
+    struct GlyphMap *gm = NULL;
+    ULONG hash;
+
+    if (ge->cache_face == NULL)
+        return NULL;
+
+    make_key(ge, glyph_8bits, &key);
+    hash = hash_key(&key);
+
+    ObtainSemaphore(&gc_Lock);
+
+    for (gce = gc_Hash[hash % GLYPHCACHE_HASHSIZE]; gce; gce = gce->gce_HashNext) {
+        if (gce->gce_Hash == hash &&
+                memcmp(&gce->gce_Key, &key, sizeof(key)) == 0) {
+            /* move to front of LRU list */
+            Remove((struct Node *)&gce->gce_LRUNode);
+            AddHead((struct List *)&gc_LRU, (struct Node *)&gce->gce_LRUNode);
+
+            gm = copy_glyphmap(&gce->gce_GlyphMap, gce->gce_BitMapSize);
+            break;
+        }
+    }
+
+    ReleaseSemaphore(&gc_Lock);
+
+    D(bug("GlyphCache_Lookup(%ld) = 0x%p\n", (LONG)ge->glyph_code, gm));
+
+    return gm;
+}
+
+void GlyphCache_Insert(FT_GlyphEngine *ge, int glyph_8bits, struct GlyphMap *gm)
+{
+    struct GlyphCacheEntry *gce;
+    ULONG size, slot;
+
+    if (ge->cache_face == NULL || gm->glm_BitMap == NULL)
+        return;
+
+    size = gm->glm_BMModulo * gm->glm_BMRows;
+
+    /* don't let a single huge glyph flush the whole cache */
+    if (size > GLYPHCACHE_MAXBYTES / 8)
+        return;
+
+    gce = AllocVec(sizeof(struct GlyphCacheEntry) + size, MEMF_PUBLIC);
+    if (gce == NULL)
+        return;
+
+    make_key(ge, glyph_8bits, &gce->gce_Key);
+    gce->gce_Hash = hash_key(&gce->gce_Key);
+    gce->gce_BitMapSize = size;
+    gce->gce_GlyphMap = *gm;
+    gce->gce_GlyphMap.glm_BitMap = (UBYTE *)(gce + 1);
+    CopyMem(gm->glm_BitMap, gce->gce_GlyphMap.glm_BitMap, size);
+
+    ObtainSemaphore(&gc_Lock);
+
+    /* evict least recently used glyphs until the new one fits */
+    while (gc_Bytes + size > GLYPHCACHE_MAXBYTES && !IsListEmpty((struct List *)&gc_LRU))
+        remove_entry((struct GlyphCacheEntry *)gc_LRU.mlh_TailPred);
+
+    slot = gce->gce_Hash % GLYPHCACHE_HASHSIZE;
+    gce->gce_HashNext = gc_Hash[slot];
+    gc_Hash[slot] = gce;
+    AddHead((struct List *)&gc_LRU, (struct Node *)&gce->gce_LRUNode);
+    gc_Bytes += size;
+    gce->gce_Key.gck_Face->gcf_Entries++;
+
+    ReleaseSemaphore(&gc_Lock);
+}
+
+int GlyphCache_Init(void)
+{
+    InitSemaphore(&gc_Lock);
+    NEWLIST((struct List *)&gc_Faces);
+    NEWLIST((struct List *)&gc_LRU);
+    gc_Bytes = 0;
+
+    return TRUE;
+}
+
+void GlyphCache_Cleanup(void)
+{
+    struct GlyphCacheFace *gcf, *tmp;
+
+    while (!IsListEmpty((struct List *)&gc_LRU))
+        remove_entry((struct GlyphCacheEntry *)gc_LRU.mlh_TailPred);
+
+    ForeachNodeSafe(&gc_Faces, gcf, tmp) {
+        Remove((struct Node *)&gcf->gcf_Node);
+        FreeVec(gcf);
+    }
+}
+
+static int GlyphCacheInit(LIBBASETYPEPTR LIBBASE)
+{
+    return GlyphCache_Init();
+}
+
+static int GlyphCacheExpunge(LIBBASETYPEPTR LIBBASE)
+{
+    GlyphCache_Cleanup();
+
+    return TRUE;
+}
+
+ADD2INITLIB(GlyphCacheInit, 0);
+ADD2EXPUNGELIB(GlyphCacheExpunge, 0);
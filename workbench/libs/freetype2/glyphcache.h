@@ -0,0 +1,34 @@
+#ifndef _FT_AROS_GLYPHCACHE_H
+#define _FT_AROS_GLYPHCACHE_H
+
+#include "ftglyphengine.h"
+
+#include <exec/nodes.h>
+#include <diskfont/glyph.h>
+
+/* Rendered glyphs are shared by all engines which have the same face
+ * file open, so a face is looked up once in OpenFace() and the engine
+ * keeps a reference to it.
+ */
+struct GlyphCacheFace {
+    struct MinNode		gcf_Node;
+    ULONG			gcf_RefCount;
+    ULONG			gcf_Entries;	/* cached glyphs of this face */
+    LONG			gcf_FaceNum;
+    char			gcf_FileName[0];
+};
+
+/* upper limit for the memory used by all cached glyph bitmaps */
+#define GLYPHCACHE_MAXBYTES	(512 * 1024)
+#define GLYPHCACHE_HASHSIZE	256
+
+int GlyphCache_Init(void);
+void GlyphCache_Cleanup(void);
+
+struct GlyphCacheFace *GlyphCache_ObtainFace(const char *, LONG);
+void GlyphCache_ReleaseFace(struct GlyphCacheFace *);
+
+struct GlyphMap *GlyphCache_Lookup(FT_GlyphEngine *, int);
+void GlyphCache_Insert(FT_GlyphEngine *, int, struct GlyphMap *);
+
+#endif /*_FT_AROS_GLYPHCACHE_H*/
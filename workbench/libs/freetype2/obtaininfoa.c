@@ -5,6 +5,7 @@
 #include "ftglyphengine.h"
 #include "glyph.h"
 #include "kerning.h"
+#include "glyphcache.h"
 
 #include <proto/utility.h>
 #include <aros/debug.h>
@@ -33,12 +34,20 @@ static struct GlyphMap *GetGlyph(FT_GlyphEngine *ge, int glyph_8bits)
 
     UnicodeToGlyphIndex(ge);
     if (ge->glyph_code) {
+        /* rendered before at this size? */
+        if ((ge->GMap = GlyphCache_Lookup(ge, glyph_8bits)))
+            return ge->GMap;
+
         /* has code, try to render */
         /* first, get a GlyphMap structure to fill in */
         ge->GMap = AllocVec((ULONG)sizeof(struct GlyphMap),
                           MEMF_PUBLIC | MEMF_CLEAR);
         if (ge->GMap)
             RenderGlyph(ge, glyph_8bits);
+        else {
+            set_last_error(ge, OTERR_NoMemory);
+            return NULL;
+        }
     } else {
         set_last_error(ge, OTERR_UnknownGlyph);
         return NULL;
@@ -52,9 +61,35 @@ static struct GlyphMap *GetGlyph(FT_GlyphEngine *ge, int glyph_8bits)
         return NULL;
     }
 
+    GlyphCache_Insert(ge, glyph_8bits, ge->GMap);
+
     return ge->GMap;
 }
 
+/* render a whole run of characters, plus the kerning between them */
+static ULONG GetGlyphRun(FT_GlyphEngine *ge, struct FTGlyphRun *run)
+{
+    int hold_char = ge->request_char, hold_char2 = ge->request_char2;
+    ULONG i;
+
+    for (i = 0; i < run->fgr_NumChars; i++) {
+        ge->request_char = run->fgr_Chars[i];
+        run->fgr_GlyphMaps[i] = GetGlyph(ge, run->fgr_Flags & FGRF_8BITS);
+
+        if (run->fgr_Kerning && i > 0) {
+            ge->request_char = run->fgr_Chars[i - 1];
+            ge->request_char2 = run->fgr_Chars[i];
+            run->fgr_Kerning[i - 1] = get_kerning_dir(ge);
+        }
+    }
+
+    ge->request_char = hold_char;
+    ge->request_char2 = hold_char2;
+
+    /* missing glyphs are not an error, they are just left NULL */
+    return set_last_error(ge, OTERR_Success);
+}
+
 /**
  * ObtainInfoA
  **/
@@ -114,6 +149,12 @@ AROS_LH2(ULONG, ObtainInfoA,
             }
             break;
 
+        case OT_GlyphRun:
+            D(bug("Obtain: OT_GlyphRun  Data=%lx\n", otagdata));
+
+            rc = GetGlyphRun(engine, (struct FTGlyphRun *)otagdata);
+            break;
+
         case OT_WidthList:
             D(bug("Obtain: OT_WidthList  Data=%lx\n", otagdata));
 
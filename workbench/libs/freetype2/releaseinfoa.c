@@ -30,6 +30,8 @@ AROS_LH2(ULONG, ReleaseInfoA,
     struct TagItem *tstate;
     struct TagItem *tag;
     struct GlyphMap *GMap;
+    struct FTGlyphRun *run;
+    ULONG i;
 
     D(bug("ReleaseInfoA engine = 0x%lx tags = 0x%lx\n",engine,tags));
 
@@ -48,6 +50,18 @@ AROS_LH2(ULONG, ReleaseInfoA,
             FreeVec(GMap);
             break;
 
+        case OT_GlyphRun:
+            //D(bug("Release: OT_GlyphRun  Data=%lx\n", otagdata));
+            run = (struct FTGlyphRun *)otagdata;
+            for (i = 0; i < run->fgr_NumChars; i++) {
+                if ((GMap = run->fgr_GlyphMaps[i])) {
+                    if (GMap->glm_BitMap) FreeVec(GMap->glm_BitMap);
+                    FreeVec(GMap);
+                    run->fgr_GlyphMaps[i] = NULL;
+                }
+            }
+            break;
+
         case OT_WidthList:
             //D(bug("Release: OT_WidthList  Data=%lx\n", otagdata));
             FreeWidthList(engine, (struct MinList  *)otagdata);
@@ -25,3 +25,67 @@ void dispose_catalog(struct IntCatalog * cat,
     }
     
 }
+
+/*
+** Sort the catalog's string index by ID, so that GetCatalogStr()
+** can use a binary search. The sort is stable: if a catalog contains
+** the same ID more than once, the first one in the file still wins,
+** just like with the old linear search.
+** Returns FALSE if there was not enough memory, in which case the
+** index is left untouched.
+*/
+BOOL sort_catalog(struct IntCatalog * cat,
+                  struct LocaleBase * LocaleBase)
+{
+    struct CatStr *src = cat->ic_CatStrings, *dst, *tmp;
+    ULONG num = cat->ic_NumStrings;
+    ULONG width, lo, mid, hi, i, j, k;
+
+    if (num < 2)
+        return TRUE;
+
+    if (!(tmp = AllocVec(num * sizeof(struct CatStr), MEMF_PUBLIC)))
+        return FALSE;
+
+    /* Bottom-up merge sort, ping-ponging between the two arrays */
+    dst = tmp;
+    for (width = 1; width < num; width <<= 1)
+    {
+        for (lo = 0; lo < num; lo += width << 1)
+        {
+            mid = lo + width;
+            if (mid > num)
+                mid = num;
+            hi = mid + width;
+            if (hi > num)
+                hi = num;
+
+            i = lo; j = mid; k = lo;
+            while ((i < mid) && (j < hi))
+            {
+                if (src[j].cs_Id < src[i].cs_Id)
+                    dst[k++] = src[j++];
+                else
+                    dst[k++] = src[i++];
+            }
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
+        }
+
+        dst = src;
+        src = (src == tmp) ? cat->ic_CatStrings : tmp;
+    }
+
+    /* The sorted result is in src. Keep it, free the other one. */
+    if (src == tmp)
+    {
+        FreeVec(cat->ic_CatStrings);
+        cat->ic_CatStrings = tmp;
+    }
+    else
+        FreeVec(tmp);
+
+    return TRUE;
+}
@@ -51,6 +51,8 @@
         OpenCatalogA(), CloseCatalog()
 
     INTERNALS
+        The string index is sorted by ID when the catalog is loaded,
+        so the lookup is a binary search.
 
 *****************************************************************************/
 {
@@ -64,19 +66,31 @@
         ULONG numstrings = IntCat(catalog)->ic_NumStrings;
         ULONG i = 0;
 
-        for (i = 0; i < numstrings; i++, cs++)
+        if (IntCat(catalog)->ic_Flags & ICF_INORDER)
         {
-            if (cs->cs_Id == stringNum)
-            {
-                str = cs->cs_String;
+            ULONG lo = 0, hi = numstrings;
 
-                break;
+            /* Find the first entry with an ID >= stringNum */
+            while (lo < hi)
+            {
+                i = lo + ((hi - lo) >> 1);
+                if (cs[i].cs_Id < stringNum)
+                    lo = i + 1;
+                else
+                    hi = i;
             }
-            else
+
+            if ((lo < numstrings) && (cs[lo].cs_Id == stringNum))
+                str = cs[lo].cs_String;
+        }
+        else
+        {
+            for (i = 0; i < numstrings; i++, cs++)
             {
-                if ((IntCat(catalog)->ic_Flags & ICF_INORDER) &&
-                    (cs->cs_Id > stringNum))
+                if (cs->cs_Id == stringNum)
                 {
+                    str = cs->cs_String;
+
                     break;
                 }
             }
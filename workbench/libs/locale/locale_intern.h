@@ -134,7 +134,7 @@ struct IntCatalog
     /* structure size depends on length of ic_Name string */
 };
 
-/* Catalog strings are in order, so we don't have to search them all */
+/* Catalog strings are sorted by ID, so they can be binary searched */
 #define ICF_INORDER        (1L<<0)
 
 /* Shortcuts to the internal structures */
@@ -168,6 +168,8 @@ static void localeDataStreamFromFormat(CONST_STRPTR format, APTR dataStream,  UL
 
 void dispose_catalog(struct IntCatalog * cat,
                      struct LocaleBase * LocaleBase);
+BOOL sort_catalog(struct IntCatalog * cat,
+                  struct LocaleBase * LocaleBase);
 
 void SetLocaleLanguage(struct IntLocale *, struct LocaleBase *);
 
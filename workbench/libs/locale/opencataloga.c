@@ -472,7 +472,9 @@ static IPTR _OpenCatalog(const struct Locale * locale, CONST_STRPTR name, STRPTR
                                 previd = id;
                             }
 
-                            if (inorder)
+                            /* Index the strings once, so that lookups
+                               don't have to scan the whole array */
+                            if (inorder || sort_catalog(catalog, LocaleBase))
                                 catalog->ic_Flags |= ICF_INORDER;
                         }
                         break;
@@ -434,5 +434,26 @@ AROS_LP2(LONG, inet_aton,
          AROS_LPA(struct in_addr *, addr, A1),
          LIBBASETYPEPTR, SocketBase, 99, BSDSocket
 );
+
+/* AROS Extensions .. */
+AROS_LP4(LONG, SetSocketInterest,
+         AROS_LPA(LONG, fd, D0),
+         AROS_LPA(ULONG, events, D1),
+         AROS_LPA(ULONG, flags, D2),
+         AROS_LPA(APTR, userdata, A0),
+         LIBBASETYPEPTR, SocketBase, 100, BSDSocket
+);
+AROS_LP4(LONG, WaitSocketEvents,
+         AROS_LPA(struct SocketEvent *, events, A0),
+         AROS_LPA(LONG, maxevents, D0),
+         AROS_LPA(struct timeval *, timeout, A1),
+         AROS_LPA(ULONG *, sigmp, D1),
+         LIBBASETYPEPTR, SocketBase, 101, BSDSocket
+);
+AROS_LP2(LONG, SetSocketEventNotify,
+         AROS_LPA(struct MsgPort *, port, A0),
+         AROS_LPA(ULONG, sigmask, D0),
+         LIBBASETYPEPTR, SocketBase, 102, BSDSocket
+);
 #endif /* __CONFIG_ROADSHOW__ */
 #endif /* CLIB_BSDSOCKET_PROTOS_H */
@@ -816,6 +816,39 @@
 #define inet_aton(arg1, arg2) \
     __inet_aton_WB(SocketBase, (arg1), (arg2))
 
+/* AROS Extensions .. */
+
+#define __SetSocketInterest_WB(__SocketBase, __arg1, __arg2, __arg3, __arg4) \
+        AROS_LC4(LONG, SetSocketInterest, \
+                  AROS_LCA(LONG,(__arg1),D0), \
+                  AROS_LCA(ULONG,(__arg2),D1), \
+                  AROS_LCA(ULONG,(__arg3),D2), \
+                  AROS_LCA(APTR,(__arg4),A0), \
+        struct Library *, (__SocketBase), 100, BSDSocket)
+
+#define SetSocketInterest(arg1, arg2, arg3, arg4) \
+    __SetSocketInterest_WB(SocketBase, (arg1), (arg2), (arg3), (arg4))
+
+#define __WaitSocketEvents_WB(__SocketBase, __arg1, __arg2, __arg3, __arg4) \
+        AROS_LC4(LONG, WaitSocketEvents, \
+                  AROS_LCA(struct SocketEvent *,(__arg1),A0), \
+                  AROS_LCA(LONG,(__arg2),D0), \
+                  AROS_LCA(struct timeval *,(__arg3),A1), \
+                  AROS_LCA(ULONG *,(__arg4),D1), \
+        struct Library *, (__SocketBase), 101, BSDSocket)
+
+#define WaitSocketEvents(arg1, arg2, arg3, arg4) \
+    __WaitSocketEvents_WB(SocketBase, (arg1), (arg2), (arg3), (arg4))
+
+#define __SetSocketEventNotify_WB(__SocketBase, __arg1, __arg2) \
+        AROS_LC2(LONG, SetSocketEventNotify, \
+                  AROS_LCA(struct MsgPort *,(__arg1),A0), \
+                  AROS_LCA(ULONG,(__arg2),D0), \
+        struct Library *, (__SocketBase), 102, BSDSocket)
+
+#define SetSocketEventNotify(arg1, arg2) \
+    __SetSocketEventNotify_WB(SocketBase, (arg1), (arg2))
+
 #endif /* __CONFIG_ROADSHOW__ */
 
 #ifdef PTHREAD_H
@@ -693,6 +693,8 @@ struct PacketMonitorMessage
 					   statistics */
 #define NETSTATUS_tcp_sockets	9	/* TCP socket statistics */
 #define NETSTATUS_udp_sockets	10	/* UDP socket statistics */
+#define NETSTATUS_tcp_connections 11	/* Per-connection TCP state and
+					   statistics (AROSTCP) */
 
 /* Protocol connection data returned for each TCP/UDP socket. */
 struct protocol_connection_data
@@ -708,6 +710,34 @@ struct protocol_connection_data
 	LONG	pcd_tcp_state;		/* Socket TCP state */
 };
 
+/* Data returned for each TCP socket with NETSTATUS_tcp_connections. */
+struct tcp_connection_data
+{
+	struct protocol_connection_data
+		tcd_connection;		/* Addresses, queues and state */
+	ULONG	tcd_flags;		/* See below */
+	ULONG	tcd_srtt;		/* Smoothed round trip time (ms) */
+	ULONG	tcd_rttvar;		/* Round trip time variance (ms) */
+	ULONG	tcd_rto;		/* Retransmission timeout (ms) */
+	ULONG	tcd_rtt_last;		/* Last round trip time sample (ms) */
+	ULONG	tcd_rtt_min;		/* Lowest round trip time seen (ms) */
+	ULONG	tcd_cwnd;		/* Congestion window (bytes) */
+	ULONG	tcd_ssthresh;		/* Slow start threshold (bytes) */
+	ULONG	tcd_send_window;	/* Window offered by the peer */
+	ULONG	tcd_maxseg;		/* Maximum segment size */
+	ULONG	tcd_retransmits;	/* Data segments retransmitted */
+	ULONG	tcd_out_of_order;	/* Out of order segments received */
+	ULONG	tcd_recoveries;		/* Fast recovery episodes */
+	ULONG	tcd_timeouts;		/* Retransmission timeouts */
+	ULONG	tcd_sack_holes;		/* Holes in the SACK scoreboard */
+	char	tcd_congestion[16];	/* Congestion control algorithm */
+};
+
+#define TCDF_TIMESTAMPS		(1UL<<0) /* RFC 7323 timestamps in use */
+#define TCDF_WINDOW_SCALE	(1UL<<1) /* RFC 7323 window scaling in use */
+#define TCDF_SACK		(1UL<<2) /* Selective acknowledgments in use */
+#define TCDF_RECOVERY		(1UL<<3) /* In fast recovery right now */
+
 /****************************************************************************/
 
 /*
@@ -156,6 +156,7 @@ struct ifnet {
 		int	ifq_maxlen;
 		int	ifq_drops;
 	} if_snd;			/* output queue */
+	int	if_hwassist;		/* CSUM_* the interface computes */
 };
 #define	if_mtu		if_data.ifi_mtu
 #define	if_type		if_data.ifi_type
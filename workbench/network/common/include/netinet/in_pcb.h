@@ -67,10 +67,50 @@ struct inpcb {
 struct inpcbinfo {
 	struct inpcbhead *listhead;
 	struct inpcbhead *hashbase;
-	unsigned long hashsize;
+	unsigned long hashmask;		/* number of hash chains - 1 */
+	unsigned long hashcount;	/* PCBs on the hash chains */
+	struct inpcb *lasthit;		/* last exact match of a lookup */
 	unsigned short lastport;
 };
 
+/*
+ * Hash chain of a connection.  Listening and unconnected PCBs have
+ * inp_faddr and inp_fport zero, and all PCBs for the same local port
+ * hash to the same chain irrespective of the local address, so a
+ * wildcard match is found on the chain of (INADDR_ANY, lport, 0).
+ */
+#define	INP_PCBHASH(faddr, lport, fport, mask) \
+	((ntohl(faddr) ^ (ntohl(faddr) >> 16) ^ ntohs((lport) ^ (fport))) & (mask))
+
+/* The hash table is grown up to this many chains, see in_pcbinshash() */
+#define	INP_PCBHASHMAX		4096
+
+/*
+ * The PCB the previous segment was delivered to is checked first,
+ * before the hash chains are searched.
+ */
+#define	INP_LASTHIT(pcbinfo, faddr, fport, laddr, lport) \
+	((pcbinfo)->lasthit != NULL && \
+	 (pcbinfo)->lasthit->inp_faddr.s_addr == (faddr).s_addr && \
+	 (pcbinfo)->lasthit->inp_fport == (fport) && \
+	 (pcbinfo)->lasthit->inp_lport == (lport) && \
+	 (pcbinfo)->lasthit->inp_laddr.s_addr == (laddr).s_addr ? \
+	 (pcbinfo)->lasthit : NULL)
+
+/*
+ * Start loading the socket buffer and protocol control block of a
+ * matched PCB while the rest of the header is being processed.
+ */
+#ifdef __GNUC__
+#define	INP_PREFETCH(inp) do { \
+	__builtin_prefetch((inp)->inp_socket); \
+	__builtin_prefetch(&(inp)->inp_socket->so_rcv); \
+	__builtin_prefetch((inp)->inp_ppcb); \
+} while (0)
+#else
+#define	INP_PREFETCH(inp)
+#endif
+
 /* flags in inp_flags: */
 #define	INP_RECVOPTS		0x01	/* receive incoming IP options */
 #define	INP_RECVRETOPTS		0x02	/* receive IP options for reply */
@@ -115,7 +155,7 @@ struct inpcb *
 	    struct in_addr, u_int, struct in_addr, u_int, int));
 struct inpcb *
 	 in_pcblookuphash __P((struct inpcbinfo *,
-	    struct in_addr, u_int, struct in_addr, u_int));
+	    struct in_addr, u_int, struct in_addr, u_int, int));
 void	 in_pcbnotify __P((struct inpcbhead *, struct sockaddr *,
 	    u_int, struct in_addr, u_int, int, void (*)(struct inpcb *, int)));
 void	 in_pcbrehash __P((struct inpcb *));
@@ -40,6 +40,45 @@
  * Kernel variables for tcp.
  */
 
+/*
+ * SACK blocks held by the receiver, and holes in the sender's
+ * scoreboard (RFC 2018, RFC 6675).  A hole is a range of sequence
+ * space between snd_una and snd_fack that the peer has not reported
+ * as received; rxmit is the next byte of it to retransmit.
+ */
+struct sackblk {
+	tcp_seq	start;			/* start seq no. of sack block */
+	tcp_seq	end;			/* end seq no. */
+};
+
+struct sackhole {
+	tcp_seq	start;			/* start seq no. of hole */
+	tcp_seq	end;			/* end seq no. */
+	tcp_seq	rxmit;			/* next seq. no in hole to be retransmitted */
+};
+
+#define	TCP_SACK_MAXHOLES	16	/* scoreboard size per connection */
+
+struct tcpcb;
+
+/*
+ * Congestion control algorithm.  Each connection points to one of
+ * these, the hooks are called from tcp_input(), tcp_output() and the
+ * retransmit timer.
+ */
+struct tcp_cc_algo {
+	const char *name;
+	void	(*cc_init) __P((struct tcpcb *));
+	void	(*ack_received) __P((struct tcpcb *, u_long));
+	void	(*cong_signal) __P((struct tcpcb *, int));
+	void	(*post_recovery) __P((struct tcpcb *));
+	void	(*after_idle) __P((struct tcpcb *));
+};
+
+/* cong_signal types */
+#define	CC_NDUPACK	1		/* loss detected by duplicate acks */
+#define	CC_RTO		2		/* retransmit timeout */
+
 /*
  * Tcp control block, one per tcp; fields:
  */
@@ -69,6 +108,7 @@ struct tcpcb {
 #define TF_NOPUSH	0x1000		/* don't push */
 #define TF_REQ_CC	0x2000		/* have/will request CC */
 #define	TF_RCVD_CC	0x4000		/* a CC was received in SYN */
+#define	TF_FASTRECOVERY	0x8000		/* in NewReno/SACK fast recovery */
 
 	struct	tcpiphdr *t_template;	/* skeletal packet for transmit */
 	struct	inpcb *t_inpcb;		/* back pointer to internet pcb */
@@ -137,10 +177,45 @@ struct tcpcb {
 	tcp_cc	cc_recv;		/* receive connection count */
 	u_long	t_duration;		/* connection duration */
 
+/* SACK, RFC 2018 and RFC 6675 */
+	int	rcv_numsacks;		/* # distinct sack blks present */
+	struct sackblk sackblks[MAX_SACK_BLKS]; /* seq nos. of sack blocks */
+	int	snd_numholes;		/* # holes in the scoreboard */
+	struct sackhole snd_holes[TCP_SACK_MAXHOLES]; /* in sequence order */
+	tcp_seq	snd_fack;		/* highest sacked sequence */
+
+/* congestion control */
+	struct tcp_cc_algo *t_cc;	/* congestion control algorithm */
+	u_long	t_cc_wmax;		/* CUBIC: window before last reduction */
+	u_long	t_cc_wlastmax;		/* CUBIC: previous t_cc_wmax */
+	u_long	t_cc_k;			/* CUBIC: ms from epoch to t_cc_wmax */
+	u_long	t_cc_epoch;		/* CUBIC: start of growth epoch, ms */
+	u_long	t_cc_wtcp;		/* CUBIC: Reno-friendly window */
+
+/* per-connection statistics */
+	u_long	t_sndrexmitpack;	/* data packets retransmitted */
+	u_long	t_rcvoopack;		/* out-of-order packets received */
+	u_long	t_recoveries;		/* fast recovery episodes */
+	u_long	t_rtos;			/* retransmit timeouts */
+	u_long	t_rttlast;		/* last rtt sample, ms */
+	u_long	t_rttbest;		/* lowest rtt sample, ms */
+
 /* TUBA stuff */
 	caddr_t	t_tuba_pcb;		/* next level down pcb for TCP over z */
 };
 
+#define	IN_FASTRECOVERY(tp)	((tp)->t_flags & TF_FASTRECOVERY)
+#define	TCP_SACK_ENABLED(tp)	((tp)->t_flags & TF_SACK_PERMIT)
+
+#define	CC_ACK_RECEIVED(tp, acked) \
+	(*(tp)->t_cc->ack_received)((tp), (acked))
+#define	CC_CONG_SIGNAL(tp, type) \
+	(*(tp)->t_cc->cong_signal)((tp), (type))
+#define	CC_POST_RECOVERY(tp) \
+	(*(tp)->t_cc->post_recovery)((tp))
+#define	CC_AFTER_IDLE(tp) \
+	(*(tp)->t_cc->after_idle)((tp))
+
 /*
  * Structure to hold TCP options that are only used during segment
  * processing (in tcp_input), but not held in the tcpcb.
@@ -153,10 +228,14 @@ struct tcpopt {
 #define TOF_CC		0x0002		/* CC and CCnew are exclusive */
 #define TOF_CCNEW	0x0004
 #define	TOF_CCECHO	0x0008
+#define	TOF_SACKPERM	0x0010		/* SACK permitted */
+#define	TOF_SACK	0x0020		/* SACK blocks */
 	u_int32_t	to_tsval;
 	u_int32_t	to_tsecr;
 	tcp_cc	to_cc;		/* holds CC or CCnew */
 	tcp_cc	to_ccecho;
+	int	to_nsacks;		/* number of SACK blocks */
+	u_char	*to_sacks;		/* pointer to the first SACK block */
 };
 
 /*
@@ -277,6 +356,13 @@ struct	tcpstat {
 	u_long	tcps_predack;		/* times hdr predict ok for acks */
 	u_long	tcps_preddat;		/* times hdr predict ok for data pkts */
 	u_long	tcps_pcbcachemiss;
+	u_long	tcps_fastrecovery;	/* fast recovery episodes */
+	u_long	tcps_partialack;	/* partial acks during recovery */
+	u_long	tcps_sack_recovery;	/* recovery episodes driven by SACK */
+	u_long	tcps_sack_rexmitpack;	/* segments retransmitted from holes */
+	u_long	tcps_sack_rexmitbyte;	/* bytes retransmitted from holes */
+	u_long	tcps_sack_rcvblocks;	/* SACK blocks received */
+	u_long	tcps_sack_sndblocks;	/* SACK blocks sent */
 };
 
 /*
@@ -316,6 +402,9 @@ extern	int tcp_mssdflt;	/* XXX */
 extern	u_long tcp_now;		/* for RFC 1323 timestamps */
 extern	int tcp_rttdflt;	/* XXX */
 extern  u_short tcp_lastport;	/* last assigned port */
+extern	int tcp_do_sack;	/* use RFC 2018 selective acks */
+extern	int tcp_cc_default;	/* index into tcp_cc_algos[] */
+extern	struct tcp_cc_algo *tcp_cc_algos[];
 
 int	 tcp_attach __P((struct socket *));
 void	 tcp_canceltimers __P((struct tcpcb *));
@@ -363,6 +452,20 @@ struct tcpcb *
 int	 tcp_usrreq __P((struct socket *,
 	    int, struct mbuf *, struct mbuf *, struct mbuf *));
 void	 tcp_xmit_timer __P((struct tcpcb *, int));
+u_long	 tcp_ts_getticks __P((void));
+
+void	 tcp_cc_init __P((struct tcpcb *));
+struct tcp_cc_algo *
+	 tcp_cc_lookup __P((const char *));
+
+void	 tcp_update_sack_list __P((struct tcpcb *, tcp_seq, tcp_seq));
+int	 tcp_sack_option __P((struct tcpcb *, u_char *, int));
+void	 tcp_sack_doack __P((struct tcpcb *, struct tcpopt *, tcp_seq));
+void	 tcp_free_sackholes __P((struct tcpcb *));
+struct sackhole *
+	 tcp_sack_output __P((struct tcpcb *));
+u_long	 tcp_sack_pipe __P((struct tcpcb *));
+void	 tcp_sack_startrecovery __P((struct tcpcb *));
 #endif /* KERNEL */
 
 #endif /* _NETINET_TCP_VAR_H_ */
@@ -125,8 +125,31 @@ struct	pkthdr {
 	struct	ifnet *rcvif;	/* rcv interface */
 	/* variables for ip and tcp reassembly */
 	caddr_t header;                 /* pointer to packet header */	
+	/* checksum offload, see CSUM_* below */
+	int	csum_flags;		/* checksum state of the packet */
+	u_short	csum_data;		/* partial sum for CSUM_FRAME */
 };
 
+/*
+ * Checksum state in m_pkthdr.csum_flags.
+ *
+ * On output the protocols set CSUM_IP, CSUM_TCP or CSUM_UDP instead of
+ * filling in the checksum field; the field is zero and the sum is
+ * computed by ip_output(), the interface or the SANA-II driver.
+ *
+ * On input the interface tells what it has already checked, or with
+ * CSUM_FRAME gives the ones complement sum of the whole IP datagram
+ * computed while it was copied.
+ */
+#define	CSUM_IP		0x0001	/* IP header checksum needed */
+#define	CSUM_TCP	0x0002	/* TCP checksum needed */
+#define	CSUM_UDP	0x0004	/* UDP checksum needed */
+#define	CSUM_DELAY_DATA	(CSUM_TCP|CSUM_UDP)
+
+#define	CSUM_IP_CHECKED	0x0100	/* IP header checksum verified */
+#define	CSUM_DATA_VALID	0x0200	/* TCP/UDP checksum verified */
+#define	CSUM_FRAME	0x0400	/* csum_data is the datagram sum */
+
 /* description of external storage mapped into mbuf, valid if M_EXT set */
 struct m_ext {
 	struct mcluster *ext_buf;	/* external buffer */
@@ -236,6 +259,7 @@ struct mbuf {
 	if (m) { \
 	        (m)->m_data = (m)->m_pktdat; \
 	        (m)->m_flags = M_PKTHDR; \
+	        (m)->m_pkthdr.csum_flags = 0; \
 	} \
 }
 
@@ -251,7 +275,7 @@ struct mbuf {
 #define	MCLALLOC(p, canwait) \
 	{ spl_t ms = splimp(); \
 	  if (mclfree == 0) \
-		(void)m_clalloc(mbconf.clusterchunk, (canwait)); \
+		(void)m_clgrow(canwait); \
 	  if ((p) = mclfree) { \
 		mbstat.m_clfree--; \
 		mclfree = (p)->mcl.mcl_next; \
@@ -417,6 +441,8 @@ BOOL mbinit(void);
 void mbdeinit(void);
 BOOL m_alloc(int howmany, int canwait);
 BOOL m_clalloc(int ncl, int canwait);
+BOOL m_clgrow(int canwait);
+void mb_trim(void);
 struct mbuf * m_retry(int canwait, int type);
 void m_reclaim(void);
 struct mbuf * m_get(int canwait, int type);
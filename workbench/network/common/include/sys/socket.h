@@ -46,6 +46,18 @@
 #define FD_ERROR	 0x020	/* asynchronous error on socket */
 #define FD_CLOSE	 0x040	/* connection closed (graceful or not) */
 
+/*
+ * Persistent event interest, see SetSocketInterest()
+ */
+#define SIF_EDGE	 0x001	/* report only when woken up, not while true */
+#define SIF_ONESHOT	 0x002	/* disable the interest after one report */
+
+struct SocketEvent {
+	long		se_Socket;	/* socket descriptor */
+	unsigned long	se_Events;	/* FD_xxx conditions that are true */
+	void *		se_UserData;	/* as given to SetSocketInterest() */
+};
+
 /*
  * Definitions related to sockets: types, address families, options.
  */
@@ -67,7 +67,7 @@
 #include <exec/nodes.h>
 #endif
 
-struct newselitem;
+struct sointerest;
 
 /*
  * Kernel structure per socket.
@@ -114,7 +114,6 @@ struct socket {
 		u_long	sb_mbmax;	     /* max chars of mbufs to use */
 		long	sb_lowat;	     /* low water mark */
 		struct	mbuf *sb_mb;	     /* the mbuf chain */
-		struct	newselitem *sb_sel;  /* chain for selecting tasks */
 		short	sb_flags;	     /* flags, see below */
 		struct timeval sb_timeo;     /* timeout for read/write */
 	} so_rcv, so_snd;
@@ -122,13 +121,13 @@ struct socket {
 #define	SB_LOCK		0x01		/* lock on data queue */
 #define	SB_WANT		0x02		/* someone is waiting to lock */
 #define	SB_WAIT		0x04		/* someone is waiting for data/space */
-#define	SB_SEL		0x08		/* someone is selecting */
 #define	SB_ASYNC	0x10		/* ASYNC I/O, need signals */
-#define	SB_NOTIFY	(SB_WAIT|SB_SEL|SB_ASYNC)
+#define	SB_NOTIFY	(SB_WAIT|SB_ASYNC)
 #define	SB_COLL		0x20		/* collision selecting */
 #define	SB_NOINTR	0x40		/* operations not interruptible */
 
 	u_long so_eventmask;		/* Events mask */
+	struct	sointerest *so_interest; /* event queues watching us */
 	caddr_t	so_tpcb;		/* Wisc. protocol control block XXX */
 };
 
@@ -174,6 +173,10 @@ struct soevent {
     ((long) imin((int)((sb)->sb_hiwat - (sb)->sb_cc), \
 	 (int)((sb)->sb_mbmax - (sb)->sb_mbcnt)))
 
+/* does a change to sb have to wake up sleepers or event queues? */
+#define	sb_notify(so, sb) \
+    (((sb)->sb_flags & SB_NOTIFY) || (so)->so_interest)
+
 /* do we have to send all at once on a socket? */
 #define	sosendallatonce(so) \
     ((so)->so_proto->pr_flags & PR_ATOMIC)
@@ -55,6 +55,8 @@ int smb_proc_read(struct smb_server *server, struct smb_dirent *finfo, off_t off
 int smb_proc_read_raw(struct smb_server *server, struct smb_dirent *finfo, off_t offset, long count, char *data);
 int smb_proc_write (struct smb_server *server, struct smb_dirent *finfo, off_t offset, long count, const char *data);
 int smb_proc_write_raw(struct smb_server *server, struct smb_dirent *finfo, off_t offset, long count, const char *data);
+int smb_proc_read_pipelined(struct smb_server *server, struct smb_dirent *finfo, off_t offset, long count, char *data);
+int smb_proc_write_pipelined(struct smb_server *server, struct smb_dirent *finfo, off_t offset, long count, const char *data);
 int smb_proc_lseek (struct smb_server *server, struct smb_dirent *finfo, off_t offset, int mode, off_t  * new_position_ptr);
 int smb_proc_lockingX (struct smb_server *server, struct smb_dirent *finfo, struct smb_lkrng *locks, int num_entries, int mode, long timeout);
 int smb_proc_create(struct smb_server *server, const char *path, int len, struct smb_dirent *entry);
@@ -81,5 +83,7 @@ int smb_request(struct smb_server *server);
 int smb_trans2_request(struct smb_server *server, int *data_len, int *param_len, char **data, char **param);
 int smb_request_read_raw(struct smb_server *server, unsigned char *target, int max_len);
 int smb_request_write_raw(struct smb_server *server, unsigned const char *source, int length);
+int smb_request_send(struct smb_server *server, const void *data, int data_len);
+int smb_request_receive(struct smb_server *server);
 
 #endif /* _LINUX_SMB_FS_H */
@@ -47,6 +47,10 @@ struct smb_server
 	/* The following are LANMAN 1.0 options transferred to us in SMBnegprot */
 	dword capabilities;
 
+	/* Number of requests which may be outstanding at the same time,
+	   limited to SMB_MAX_PIPELINE. */
+	int max_mpx;
+
 	/* olsen (2012-12-10): raw SMB over TCP instead of NBT transport? */
 	int raw_smb;
 };
@@ -67,4 +71,19 @@ struct smb_server
 #define CAP_RAW_MODE 0x00000001	/* The server supports SMB_COM_WRITE_RAW
 								   and SMB_COM_READ_RAW requests. */
 
+#define CAP_LARGE_READX 0x00004000	/* The server supports SMB_COM_READ_ANDX
+									   requests larger than its maximum
+									   buffer size. */
+
+#define CAP_LARGE_WRITEX 0x00008000	/* The server supports SMB_COM_WRITE_ANDX
+									   requests larger than its maximum
+									   buffer size. */
+
+#define CAP_UNIX 0x00800000			/* The server supports the CIFS UNIX
+									   extensions. */
+
+/* Upper limit for the number of SMB_COM_READ_ANDX and SMB_COM_WRITE_ANDX
+   requests kept in flight for a single transfer. */
+#define SMB_MAX_PIPELINE 8
+
 #endif
@@ -4875,14 +4875,28 @@ Action_End(
 	struct FileNode *	fn,
 	SIPTR *				error_ptr)
 {
+	LONG result = DOSTRUE;
+	LONG error = OK;
+	int errnum;
+
 	Remove((struct Node *)fn);
 
+	/* Data held back for write-behind is sent now; the file is
+	 * closed even if that fails.
+	 */
+	errnum = smba_flush(fn->fn_File);
+	if(errnum < 0)
+	{
+		error = MapErrnoToIoErr(errnum);
+		result = DOSFALSE;
+	}
+
 	smba_close(fn->fn_File);
 	FreeMemory(fn->fn_FullName);
 	FreeMemory(fn);
 
-	(*error_ptr) = OK;
-	return(DOSTRUE);
+	(*error_ptr) = error;
+	return(result);
 }
 
 /****************************************************************************/
@@ -917,6 +917,290 @@ smb_proc_write_raw (struct smb_server *server, struct smb_dirent *finfo, off_t o
 	return result;
 }
 
+/*****************************************************************************
+ *
+ *  Pipelined transfers.
+ *
+ *  A large transfer is split into SMB_COM_READ_ANDX/SMB_COM_WRITE_ANDX
+ *  requests of smb_readx_size()/smb_writex_size() bytes. Up to
+ *  server->max_mpx of them are sent before the first reply is picked up,
+ *  and another request is sent for each reply received, so that the
+ *  connection is kept busy instead of waiting one round trip per
+ *  request. Replies are matched to their requests by the multiplex id,
+ *  which is the number of the request within the transfer.
+ *
+ ****************************************************************************/
+
+/* Fixed part of a SMB_COM_READ_ANDX response and of a SMB_COM_WRITE_ANDX
+   request, including the pad byte in front of the data. */
+#define SMB_ANDX_OVERHEAD (SMB_HEADER_LEN + 12 * 2 + 2 + 8)
+
+#define SMB_PIPELINE_MID(n) ((word)(((n) % 0x7fff) + 1))
+
+/* Largest amount of data to ask for with a single SMB_COM_READ_ANDX.
+   The response has to fit into the receive buffer, and unless the
+   server supports large reads also into its maximum buffer size. */
+static long
+smb_readx_size (const struct smb_server *server)
+{
+	long limit = server->max_recv - 4;
+
+	if ((server->capabilities & CAP_LARGE_READX) == 0 && limit > (long)server->max_buffer_size)
+		limit = server->max_buffer_size;
+
+	limit -= SMB_ANDX_OVERHEAD;
+	if (limit > 0xffff)
+		limit = 0xffff;
+
+	return limit & ~511;
+}
+
+/* Largest amount of data to send with a single SMB_COM_WRITE_ANDX. The
+   data is not copied into the packet buffer, so only the server limits
+   the request size. */
+static long
+smb_writex_size (const struct smb_server *server)
+{
+	long limit;
+
+	if (server->capabilities & CAP_LARGE_WRITEX)
+		limit = 0xffff;
+	else
+		limit = (long)server->max_buffer_size - SMB_ANDX_OVERHEAD;
+
+	return limit & ~511;
+}
+
+/* Find out which of the outstanding requests a reply is for. The
+   requests in flight all lie below 'next' and within the range of the
+   multiplex ids. */
+static long
+smb_pipeline_request (long next, word mid)
+{
+	return next - 1 - (long)(((SMB_PIPELINE_MID (next - 1) - mid) + 0x7fff) % 0x7fff);
+}
+
+/* Read count bytes starting at offset with pipelined SMB_COM_READ_ANDX
+   requests. The result is the number of bytes read, which is less than
+   count only if the end of the file was reached or an error occurred in
+   the middle of the range, or an error code if nothing could be read. */
+int
+smb_proc_read_pipelined (struct smb_server *server, struct smb_dirent *finfo, off_t offset, long count, char *data)
+{
+	char *buf = server->packet;
+	long chunk = smb_readx_size (server);
+	long num_requests, next, n, want, got;
+	long valid = count;
+	int in_flight = 0;
+	int error = 0;
+	int result;
+	word data_offset;
+
+	if (chunk <= 0)
+	{
+		result = -EIO;
+		goto out;
+	}
+
+	num_requests = (count + chunk - 1) / chunk;
+
+	for (next = 0 ; next < num_requests || in_flight > 0 ; )
+	{
+		/* Fill the pipeline, but do not ask for data beyond the end of
+		   the file or an error once we know about it. */
+		while (in_flight < server->max_mpx && next < num_requests && next * chunk < valid)
+		{
+			want = min (chunk, count - next * chunk);
+
+			smb_setup_header (server, SMBreadX, 10, 0);
+			WSET (buf, smb_mid, SMB_PIPELINE_MID (next));
+			WSET (buf, smb_vwv0, 0xff); /* no secondary command */
+			WSET (buf, smb_vwv1, 0);
+			WSET (buf, smb_vwv2, finfo->fileid);
+			DSET (buf, smb_vwv3, offset + next * chunk);
+			WSET (buf, smb_vwv5, want); /* maxcnt */
+			WSET (buf, smb_vwv6, want); /* mincnt */
+			DSET (buf, smb_vwv7, 0); /* timeout */
+			WSET (buf, smb_vwv9, 0); /* remaining */
+
+			if ((result = smb_request_send (server, NULL, 0)) < 0)
+				goto out;
+
+			next++;
+			in_flight++;
+		}
+
+		if (in_flight == 0)
+			break;
+
+		/* If the connection fails there is no telling which parts
+		   of the buffer are valid. */
+		if ((result = smb_request_receive (server)) < 0)
+			goto out;
+
+		in_flight--;
+
+		n = smb_pipeline_request (next, WVAL (buf, smb_mid));
+		want = min (chunk, count - n * chunk);
+
+		if ((result = smb_valid_packet (buf)) != 0 || (result = smb_verify (buf, SMBreadX, 12, -1)) != 0)
+		{
+			if (n * chunk < valid)
+			{
+				valid = n * chunk;
+				error = result;
+			}
+
+			continue;
+		}
+
+		if (server->rcls != 0)
+		{
+			if (n * chunk < valid)
+			{
+				valid = n * chunk;
+				error = -smb_errno (server->rcls, server->err);
+			}
+
+			continue;
+		}
+
+		got = WVAL (buf, smb_vwv5);
+		data_offset = WVAL (buf, smb_vwv6);
+
+		if (got > want || data_offset + got > smb_len (buf))
+		{
+			LOG (("bad SMBreadX response, %ld bytes at %ld\n", got, data_offset));
+
+			if (n * chunk < valid)
+			{
+				valid = n * chunk;
+				error = -EIO;
+			}
+
+			continue;
+		}
+
+		memcpy (data + n * chunk, smb_base (buf) + data_offset, got);
+
+		/* A short read means we hit the end of the file. */
+		if (got < want && n * chunk + got < valid)
+			valid = n * chunk + got;
+	}
+
+	if (valid == 0 && error != 0)
+		result = error;
+	else
+		result = valid;
+
+ out:
+
+	return result;
+}
+
+/* Write count bytes starting at offset with pipelined SMB_COM_WRITE_ANDX
+   requests. The result is the number of bytes written from the start of
+   the range, which is less than count if the disk is full, or an error
+   code if nothing could be written. */
+int
+smb_proc_write_pipelined (struct smb_server *server, struct smb_dirent *finfo, off_t offset, long count, const char *data)
+{
+	char *buf = server->packet;
+	long chunk = smb_writex_size (server);
+	long num_requests, next, n, want, got;
+	long valid = count;
+	int in_flight = 0;
+	int error = 0;
+	int result;
+	byte *p;
+
+	if (chunk <= 0)
+	{
+		result = -EIO;
+		goto out;
+	}
+
+	num_requests = (count + chunk - 1) / chunk;
+
+	for (next = 0 ; next < num_requests || in_flight > 0 ; )
+	{
+		while (in_flight < server->max_mpx && next < num_requests && next * chunk < valid)
+		{
+			want = min (chunk, count - next * chunk);
+
+			/* The data follows a single pad byte, which keeps it
+			   word aligned. */
+			p = smb_setup_header (server, SMBwriteX, 12, 1 + want);
+			WSET (buf, smb_mid, SMB_PIPELINE_MID (next));
+			WSET (buf, smb_vwv0, 0xff); /* no secondary command */
+			WSET (buf, smb_vwv1, 0);
+			WSET (buf, smb_vwv2, finfo->fileid);
+			DSET (buf, smb_vwv3, offset + next * chunk);
+			DSET (buf, smb_vwv5, 0); /* timeout */
+			WSET (buf, smb_vwv7, 0); /* write mode */
+			WSET (buf, smb_vwv8, count - next * chunk - want); /* remaining */
+			WSET (buf, smb_vwv9, want >> 16);
+			WSET (buf, smb_vwv10, want);
+			WSET (buf, smb_vwv11, (p + 1) - smb_base (buf));
+			(*p) = 0;
+
+			if ((result = smb_request_send (server, data + next * chunk, want)) < 0)
+				goto out;
+
+			next++;
+			in_flight++;
+		}
+
+		if (in_flight == 0)
+			break;
+
+		if ((result = smb_request_receive (server)) < 0)
+			goto out;
+
+		in_flight--;
+
+		n = smb_pipeline_request (next, WVAL (buf, smb_mid));
+		want = min (chunk, count - n * chunk);
+
+		if ((result = smb_valid_packet (buf)) != 0 || (result = smb_verify (buf, SMBwriteX, 6, -1)) != 0)
+		{
+			if (n * chunk < valid)
+			{
+				valid = n * chunk;
+				error = result;
+			}
+
+			continue;
+		}
+
+		if (server->rcls != 0)
+		{
+			if (n * chunk < valid)
+			{
+				valid = n * chunk;
+				error = -smb_errno (server->rcls, server->err);
+			}
+
+			continue;
+		}
+
+		got = WVAL (buf, smb_vwv2) | ((long)WVAL (buf, smb_vwv4) << 16);
+
+		/* Fewer data written than intended? Could be out of disk space. */
+		if (got < want && n * chunk + got < valid)
+			valid = n * chunk + got;
+	}
+
+	if (valid == 0 && error != 0)
+		result = error;
+	else
+		result = valid;
+
+ out:
+
+	return result;
+}
+
 int
 smb_proc_lseek (struct smb_server *server, struct smb_dirent *finfo, off_t offset, int mode, off_t * new_position_ptr)
 {
@@ -2230,6 +2514,7 @@ smb_proc_reconnect (struct smb_server *server)
 	packet = server->packet;
 
 	server->max_buffer_size = default_max_buffer_size;
+	server->max_mpx = 1;
 
 	/* Prepend a NetBIOS header? */
 	if(!server->raw_smb)
@@ -2320,6 +2605,7 @@ smb_proc_reconnect (struct smb_server *server)
 		if (server->protocol >= PROTOCOL_NT1)
 		{
 			server->security_mode = BVAL(packet, smb_vwv1);
+			server->max_mpx = WVAL (packet, smb_vwv1 + 1);
 			max_buffer_size = DVAL (packet, smb_vwv3 + 1);
 			server->max_raw_size = DVAL (packet, smb_vwv5 + 1);
 			server_sesskey = DVAL (packet, smb_vwv7 + 1);
@@ -2335,6 +2621,7 @@ smb_proc_reconnect (struct smb_server *server)
 
 			server->security_mode = BVAL(packet, smb_vwv1);
 			max_buffer_size = WVAL (packet, smb_vwv2);
+			server->max_mpx = WVAL (packet, smb_vwv3);
 			/* Maximum raw read/write size is fixed to 65535 bytes. */
 			server->max_raw_size = 65535;
 			blkmode = WVAL (packet, smb_vwv5);
@@ -2434,7 +2721,7 @@ smb_proc_reconnect (struct smb_server *server)
 			WSET (packet, smb_vwv7, password_len);
 			WSET (packet, smb_vwv8, nt_password_len);
 			DSET (packet, smb_vwv9, 0);	/* reserved */
-			DSET (packet, smb_vwv11, server->capabilities & 0x00800000);	/* capabilities: Unix support. */
+			DSET (packet, smb_vwv11, server->capabilities & (CAP_UNIX | CAP_LARGE_READX | CAP_LARGE_WRITEX));	/* capabilities: Unix support, large reads and writes. */
 
 			p = SMB_BUF (packet);
 
@@ -2607,7 +2894,14 @@ smb_proc_reconnect (struct smb_server *server)
 	if (server->max_buffer_size > given_max_xmit)
 		server->max_buffer_size = given_max_xmit;
 
-	LOG (("max_buffer_size = %ld, tid = %ld\n", server->max_buffer_size, server->tid));
+	/* Keep the number of outstanding requests within what the server
+	   allows, and what it makes sense for us to wait for. */
+	if (server->max_mpx < 1)
+		server->max_mpx = 1;
+	else if (server->max_mpx > SMB_MAX_PIPELINE)
+		server->max_mpx = SMB_MAX_PIPELINE;
+
+	LOG (("max_buffer_size = %ld, tid = %ld, max_mpx = %ld\n", server->max_buffer_size, server->tid, server->max_mpx));
 
 	LOG (("smb_proc_connect: Normal exit\n"));
 
@@ -30,6 +30,8 @@
 #define DIR_CACHE_TIME		5	/* cache directories for this time */
 #define DIRCACHE_SIZE		170
 #define DOS_PATHSEP			'\\'
+#define READ_AHEAD_SIZE		(128 * 1024)	/* read-ahead window for sequential reads */
+#define WRITE_BEHIND_SIZE	(64 * 1024)		/* sequential writes are collected up to this size */
 
 /*****************************************************************************/
 
@@ -63,6 +65,13 @@ struct smba_file
 	dircache_t *dircache;			/* content cache for directories */
 	unsigned attr_dirty:1;			/* attribute cache is dirty */
 	unsigned is_valid:1;			/* server was down, entry removed, ... */
+	char *read_ahead;				/* data read ahead of a sequential reader */
+	long read_ahead_offset;			/* file position of read_ahead[0] */
+	long read_ahead_len;			/* number of valid bytes in read_ahead */
+	long next_read_offset;			/* where a sequential read continues */
+	char *write_behind;				/* data written but not yet sent */
+	long write_behind_offset;		/* file position of write_behind[0] */
+	long write_behind_len;			/* number of bytes in write_behind */
 };
 
 /*****************************************************************************/
@@ -75,6 +84,10 @@ static int smba_connect(smba_connect_parameters_t *p, unsigned int ip_addr, int
 	int cache_size, int max_transmit, int opt_raw_smb, smba_server_t **result);
 static INLINE int make_open(smba_file_t *f, int need_fid);
 static int write_attr(smba_file_t *f);
+static int read_data(smba_file_t *f, char *data, long len, long offset);
+static int write_data(smba_file_t *f, char *data, long len, long offset);
+static int flush_write_behind(smba_file_t *f);
+static int sync_other_files(smba_file_t *f);
 static void invalidate_dircache(struct smba_server *server, char *path);
 static void close_path(smba_server_t *s, char *path);
 static void smba_cleanup_dircache(struct smba_server *server);
@@ -397,6 +410,8 @@ smba_close (smba_file_t * f)
 		if(f->node.mln_Succ != NULL || f->node.mln_Pred != NULL)
 			Remove((struct Node *)f);
 
+		flush_write_behind(f);
+
 		if(f->attr_dirty)
 			write_attr(f);
 
@@ -413,14 +428,20 @@ smba_close (smba_file_t * f)
 			f->dircache = NULL;
 		}
 
+		if (f->read_ahead != NULL)
+			free (f->read_ahead);
+
+		if (f->write_behind != NULL)
+			free (f->write_behind);
+
 		free (f);
 	}
 }
 
 /*****************************************************************************/
 
-int
-smba_read (smba_file_t * f, char *data, long len, long offset)
+static int
+read_data (smba_file_t * f, char *data, long len, long offset)
 {
 	int num_bytes_read = 0;
 	int maxsize, count, result;
@@ -435,6 +456,15 @@ smba_read (smba_file_t * f, char *data, long len, long offset)
 
 	D(("read %ld bytes from offset %ld",len,offset));
 
+	/* SMB_COM_READ_ANDX is available since LAN Manager 1.0 and allows
+	 * for several requests to be in flight at the same time.
+	 */
+	if (f->server->server.protocol >= PROTOCOL_LANMAN1)
+	{
+		result = smb_proc_read_pipelined (&f->server->server, &f->dirent, offset, len, data);
+		goto out;
+	}
+
 	/* SMB_COM_READ_RAW and SMB_COM_WRITE_RAW supported? */
 	if (f->server->server.capabilities & CAP_RAW_MODE)
 	{
@@ -528,8 +558,8 @@ smba_read (smba_file_t * f, char *data, long len, long offset)
 
 /*****************************************************************************/
 
-int
-smba_write (smba_file_t * f, char *data, long len, long offset)
+static int
+write_data (smba_file_t * f, char *data, long len, long offset)
 {
 	int maxsize, count, result;
 	long num_bytes_written = 0;
@@ -542,6 +572,18 @@ smba_write (smba_file_t * f, char *data, long len, long offset)
 		goto out;
 	}
 
+	/* SMB_COM_WRITE_ANDX is available since LAN Manager 1.0 and allows
+	 * for several requests to be in flight at the same time.
+	 */
+	if (f->server->server.protocol >= PROTOCOL_LANMAN1)
+	{
+		result = smb_proc_write_pipelined (&f->server->server, &f->dirent, offset, len, data);
+		if (result > 0)
+			num_bytes_written = result;
+
+		goto out;
+	}
+
 	/* Calculate maximum number of bytes that could be transferred with
 	   a single SMBwrite packet... */
 	maxsize = f->server->server.max_buffer_size - (SMB_HEADER_LEN + 5 * sizeof (word) + 5) - 4;
@@ -662,6 +704,208 @@ smba_write (smba_file_t * f, char *data, long len, long offset)
 
 /*****************************************************************************/
 
+/* Send the data collected by smba_write() to the server. The data is
+ * discarded even if this fails, the error is reported to the caller
+ * of whichever operation triggered the flush.
+ */
+static int
+flush_write_behind (smba_file_t * f)
+{
+	long len = f->write_behind_len;
+	int result;
+
+	if (len == 0)
+		return 0;
+
+	f->write_behind_len = 0;
+
+	result = write_data (f, f->write_behind, len, f->write_behind_offset);
+	if (result >= 0 && result < len)
+		result = -ENOSPC;
+
+	return result < 0 ? result : 0;
+}
+
+/* Other handles on the same file may hold data which has not been sent
+ * yet, or which has been read ahead and is now stale.
+ */
+static int
+sync_other_files (smba_file_t * f)
+{
+	smba_file_t *p;
+	int errnum;
+	int result = 0;
+
+	for (p = (smba_file_t *)f->server->open_files.mlh_Head;
+	     p->node.mln_Succ != NULL;
+	     p = (smba_file_t *)p->node.mln_Succ)
+	{
+		if (p == f || (p->read_ahead_len == 0 && p->write_behind_len == 0))
+			continue;
+
+		if (CompareNames(p->dirent.complete_path, f->dirent.complete_path) != SAME)
+			continue;
+
+		errnum = flush_write_behind (p);
+		if (errnum < 0 && result == 0)
+			result = errnum;
+
+		p->read_ahead_len = 0;
+	}
+
+	return result;
+}
+
+/*****************************************************************************/
+
+/* Send any data still held back by smba_write(). */
+int
+smba_flush (smba_file_t * f)
+{
+	return flush_write_behind (f);
+}
+
+/*****************************************************************************/
+
+/* Small sequential reads are served from a read-ahead window, which is
+ * refilled with a single pipelined transfer. Larger reads go straight
+ * into the caller's buffer.
+ */
+int
+smba_read (smba_file_t * f, char *data, long len, long offset)
+{
+	long num_bytes_read = 0;
+	int sequential = (offset == f->next_read_offset);
+	long n;
+	int result;
+
+	result = flush_write_behind (f);
+	if (result == 0)
+		result = sync_other_files (f);
+
+	if (result < 0)
+		goto out;
+
+	/* Whatever the read-ahead window already holds. */
+	if (f->read_ahead_len > 0 && offset >= f->read_ahead_offset && offset < f->read_ahead_offset + f->read_ahead_len)
+	{
+		n = min(len, f->read_ahead_offset + f->read_ahead_len - offset);
+
+		memcpy (data, f->read_ahead + (offset - f->read_ahead_offset), n);
+
+		num_bytes_read += n;
+		len -= n;
+		offset += n;
+		data += n;
+	}
+
+	if (len > 0)
+	{
+		if (len < READ_AHEAD_SIZE && sequential && f->read_ahead == NULL)
+			f->read_ahead = malloc (READ_AHEAD_SIZE);
+
+		if (len < READ_AHEAD_SIZE && sequential && f->read_ahead != NULL)
+		{
+			f->read_ahead_len = 0;
+
+			result = read_data (f, f->read_ahead, READ_AHEAD_SIZE, offset);
+			if (result > 0)
+			{
+				f->read_ahead_offset = offset;
+				f->read_ahead_len = result;
+
+				n = min(len, result);
+
+				memcpy (data, f->read_ahead, n);
+				result = n;
+			}
+		}
+		else
+		{
+			result = read_data (f, data, len, offset);
+		}
+
+		if (result < 0)
+		{
+			/* Return what we have, the error will show up again
+			 * with the next read.
+			 */
+			if (num_bytes_read > 0)
+				result = num_bytes_read;
+
+			goto out;
+		}
+
+		num_bytes_read += result;
+		offset += result;
+	}
+
+	f->next_read_offset = offset;
+
+	result = num_bytes_read;
+
+ out:
+
+	return result;
+}
+
+/*****************************************************************************/
+
+/* Small sequential writes are collected and sent in one pipelined
+ * transfer when the buffer fills up, a non-sequential write follows, or
+ * the file is read, examined, locked or closed.
+ */
+int
+smba_write (smba_file_t * f, char *data, long len, long offset)
+{
+	int result;
+
+	result = sync_other_files (f);
+	if (result < 0)
+		goto out;
+
+	/* The read-ahead window must not keep stale data. */
+	if (f->read_ahead_len > 0 && offset < f->read_ahead_offset + f->read_ahead_len && offset + len > f->read_ahead_offset)
+		f->read_ahead_len = 0;
+
+	if (f->write_behind_len > 0 &&
+	    (offset != f->write_behind_offset + f->write_behind_len || f->write_behind_len + len > WRITE_BEHIND_SIZE))
+	{
+		result = flush_write_behind (f);
+		if (result < 0)
+			goto out;
+	}
+
+	if (len < WRITE_BEHIND_SIZE && f->write_behind == NULL)
+		f->write_behind = malloc (WRITE_BEHIND_SIZE);
+
+	if (len < WRITE_BEHIND_SIZE && f->write_behind != NULL)
+	{
+		if (f->write_behind_len == 0)
+			f->write_behind_offset = offset;
+
+		memcpy (f->write_behind + f->write_behind_len, data, len);
+		f->write_behind_len += len;
+
+		f->dirent.mtime = GetCurrentTime();
+
+		if (offset + len > f->dirent.size)
+			f->dirent.size = offset + len;
+
+		result = len;
+	}
+	else
+	{
+		result = write_data (f, data, len, offset);
+	}
+
+ out:
+
+	return result;
+}
+
+/*****************************************************************************/
+
 long
 smba_seek (smba_file_t *f, long offset, long mode, off_t * new_position_ptr)
 {
@@ -670,6 +914,14 @@ smba_seek (smba_file_t *f, long offset, long mode, off_t * new_position_ptr)
 
 	D(("seek %ld bytes from position %s",offset,mode > 0 ? (mode == 2 ? "SEEK_END" : "SEEK_CUR") : "SEEK_SET"));
 
+	/* The server needs to know the file size for SEEK_END. */
+	errnum = flush_write_behind (f);
+	if(errnum < 0)
+	{
+		result = errnum;
+		goto out;
+	}
+
 	errnum = make_open (f, 1);
 	if(errnum < 0)
 	{
@@ -701,6 +953,13 @@ smba_lockrec (smba_file_t *f, long offset, long len, long mode, int unlocked, lo
 	int errnum;
 	int result;
 
+	errnum = flush_write_behind (f);
+	if(errnum < 0)
+	{
+		result = errnum;
+		goto out;
+	}
+
 	errnum = make_open (f, 1);
 	if(errnum < 0)
 	{
@@ -747,6 +1006,14 @@ smba_getattr (smba_file_t * f, smba_stat_t * data)
 	int errnum;
 	int result;
 
+	/* Size and modification time have to include delayed writes. */
+	errnum = flush_write_behind (f);
+	if (errnum < 0)
+	{
+		result = errnum;
+		goto out;
+	}
+
 	errnum = make_open (f, 0);
 	if (errnum < 0)
 	{
@@ -798,6 +1065,14 @@ smba_setattr (smba_file_t * f, smba_stat_t * data)
 	int errnum;
 	int result;
 
+	/* Delayed writes must not undo a new size or modification time. */
+	errnum = flush_write_behind (f);
+	if (errnum < 0)
+	{
+		result = errnum;
+		goto out;
+	}
+
 	if (data->atime != -1)
 		f->dirent.atime = data->atime;
 
@@ -1142,6 +1417,9 @@ close_path (smba_server_t * s, char *path)
 	{
 		if (p->is_valid && CompareNames(p->dirent.complete_path, path) == SAME)
 		{
+			flush_write_behind (p);
+			p->read_ahead_len = 0;
+
 			if (p->dirent.opened)
 				smb_proc_close (&s->server, p->dirent.fileid, p->dirent.mtime);
 
@@ -1271,6 +1549,7 @@ smb_invalidate_all_inodes (struct smb_server *server)
 	{
 		f->dirent.opened = 0;
 		f->is_valid = 0;
+		f->read_ahead_len = 0;
 	}
 }
 
@@ -63,6 +63,7 @@ int smba_open(smba_server_t *s, char *name, size_t name_size, smba_file_t **file
 void smba_close(smba_file_t *f);
 int smba_read(smba_file_t *f, char *data, long len, long offset);
 int smba_write(smba_file_t *f, char *data, long len, long offset);
+int smba_flush(smba_file_t *f);
 long smba_seek (smba_file_t *f, long offset, long mode, off_t * new_position_ptr);
 int smba_lockrec (smba_file_t *f, long offset, long len, long mode, int unlocked, long timeout);
 int smba_getattr(smba_file_t *f, smba_stat_t *data);
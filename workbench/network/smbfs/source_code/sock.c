@@ -615,3 +615,99 @@ smb_request_write_raw (struct smb_server *server, unsigned const char *source, i
 
 	return result;
 }
+
+/* Send the request in server->packet without waiting for the reply,
+ * which has to be picked up later with smb_request_receive(). This
+ * allows several requests to be in flight at the same time. If data
+ * is not NULL, the last data_len bytes of the message are sent from
+ * there rather than from the packet buffer.
+ */
+int
+smb_request_send (struct smb_server *server, const void *data, int data_len)
+{
+	int len, result;
+	int sock_fd = server->mount_data.fd;
+	unsigned char *buffer = server->packet;
+
+	if ((sock_fd < 0) || (buffer == NULL))
+	{
+		LOG (("smb_request_send: Bad server!\n"));
+		result = -EBADF;
+		goto out;
+	}
+
+	if (server->state != CONN_VALID)
+	{
+		result = -EIO;
+		goto out;
+	}
+
+	/* Length includes the NetBIOS session header (4 bytes), which
+	 * is prepended to the packet to be sent.
+	 */
+	len = smb_len (buffer) + 4;
+	if (data != NULL)
+		len -= data_len;
+
+	LOG (("smb_request_send: len = %ld cmd = 0x%lx mid = %ld\n", len, buffer[8], WVAL (buffer, smb_mid)));
+
+	#if defined(DUMP_SMB)
+	dump_netbios_header(__FILE__,__LINE__,buffer,&buffer[4],len);
+	dump_smb(__FILE__,__LINE__,0,buffer+4,len-4,smb_packet_from_consumer,server->max_recv);
+	#endif /* defined(DUMP_SMB) */
+
+	result = send (sock_fd, (void *) buffer, len, 0);
+	if (result >= 0 && data != NULL && data_len > 0)
+		result = send (sock_fd, (void *) data, data_len, 0);
+
+	if (result < 0)
+	{
+		LOG (("smb_request_send: send error = %ld\n", errno));
+
+		result = (-errno);
+	}
+	else
+	{
+		result = 0;
+	}
+
+ out:
+
+	if (result < 0)
+	{
+		server->state = CONN_INVALID;
+		smb_invalidate_all_inodes (server);
+	}
+
+	return result;
+}
+
+/* Receive the reply to a request sent with smb_request_send(). The
+ * replies to several outstanding requests may arrive in any order,
+ * the caller matches them through the multiplex id in the header.
+ */
+int
+smb_request_receive (struct smb_server *server)
+{
+	int result;
+
+	if (server->state != CONN_VALID)
+	{
+		result = -EIO;
+		goto out;
+	}
+
+	result = smb_receive (server, server->mount_data.fd);
+
+ out:
+
+	if (result < 0)
+	{
+		server->state = CONN_INVALID;
+		smb_invalidate_all_inodes (server);
+	}
+
+	LOG (("smb_request_receive: result = %ld\n", result));
+
+	return result;
+}
@@ -44,6 +44,7 @@
 
 #include <kern/amiga_subr.h>
 #include <kern/amiga_log.h>
+#include <kern/amiga_select_protos.h>
 
 #if 0
 /*#if sizeof (fd_mask) != 4 || sizeof (long) != 4*/
@@ -375,6 +376,7 @@ D(bug("[AROSTCP](amiga_api.c) __UL_Close: Closing proc 0x%lx base 0x%lx\n", libP
   for (i = 0; i < libPtr->dTableSize; i++)
     if (libPtr->dTable[i] != NULL)
       __CloseSocket(i, libPtr);
+  soevq_free(libPtr);
   
   Remove((struct Node *)libPtr); /* remove this librarybase from our list
 				    of opened library bases */
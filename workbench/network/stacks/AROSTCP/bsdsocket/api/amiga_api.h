@@ -88,7 +88,7 @@ struct LibInitTable {
 extern struct LibInitTable Miami_initTable;
 extern struct Library *MasterMiamiBase;
 
-struct newselbuf;
+struct soeventq;
 
 /*
  * structure for holding size and address of some dynamically allocated buffers
@@ -130,8 +130,8 @@ struct SocketBase {
   caddr_t		p_wchan;               /* event process is awaiting */
   struct timerequest *	tsleep_timer;
   struct MsgPort *	timerPort;
-/* -- pointer to select buffer during Select() -- */
-  struct newselbuf *	p_sb;
+/* -- persistent event queue, see SetSocketInterest() -- */
+  struct soeventq *	evQueue;
 /* -- per process fields used by various 'library' functions -- */
 /* buffer for inet_ntoa */
   char			inet_ntoa[20]; /* xxx.xxx.xxx.xxx\0 */
@@ -55,50 +55,11 @@
 #include <kern/uipc_domain_protos.h>
 #include <kern/uipc_socket_protos.h>
 #include <kern/uipc_socket2_protos.h>
+#include <kern/amiga_select_protos.h>
 
 /* Local protos */
-static int selscan(struct SocketBase *p, 
-		   fd_set *in, fd_set *ou, fd_set *ex, fd_mask *obits,
-		   int nfd, int *retval, int *selitemcount_p);
-void selenter(struct SocketBase * p, struct newselitem ** hdr);
-static void unselect(register struct newselbuf * sb);
-void selwakeup(struct newselitem **hdr);
-static int soo_select(struct socket *so, int which, struct SocketBase *p);
 static int countSockets(struct SocketBase * libPtr, struct socket * so);
 
-/*
- * itimerfix copied from bsdss/server/kern/kern_time.c. since fields
- * in struct timeval in amiga are ULONGs, values less than zero need
- * not be checked. the second check, timeval less than resolution of
- * the clock is not needed in amiga...hmm, is removed also.
- */
-static inline int itimerfix(struct timeval *tv)
-{
-	if (tv->tv_sec > 100000000 || tv->tv_usec >= 1000000)
-		return (EINVAL);
-/*	if (tv->tv_sec == 0 && tv->tv_usec != 0 && tv->tv_usec < tick)
-		tv->tv_usec = tick;
-*/	return (0);
-}
-
-/*
- * ffs() copied directly from bsdss/server/kern/subr_xxx.c
- */
-static inline int ffs(int mask)
-{
-  register int bit;
-
-  if (!mask)
-    return(0);
-  for (bit = 1;; ++bit) {
-    if (mask&0x01)
-      return(bit);
-    mask >>= 1;
-  }
-  /* NOT REACHED */
-}
-
-
 /*
  * Ioctl system call
  */
@@ -218,253 +179,6 @@ AROS_LH3(LONG, IoctlSocket,
   AROS_LIBFUNC_EXIT
 }
 
-
-
-/*
- *  Semaphore to prevent select buffers from simultaneous modifications
- */
-struct SignalSemaphore select_semaphore = { };
-
-struct newselbuf {
-  int s_state;
-#define	SB_CLEAR	0		/* wait condition cleared */
-#define	SB_WILLWAIT	1		/* will wait if not cleared */
-#define	SB_WAITING	2		/* waiting - wake up */
-  int s_count;
-  struct newselitem {
-    struct	newselitem  *	si_next;	/* next selbuf in item chain */
-    struct	newselitem **	si_prev;	/* back pointer */
-    struct	newselbuf   *	si_selbuf;	/* 'thread' waiting */
-  } s_item[0]; /* selitems are allocated at select when right
-		  number of descriptors are known */
-};
-
-void select_init(void)
-{
-  InitSemaphore(&select_semaphore);
-}
-
-/*
- *  symbolic names FREAD and FWRITE aren'n needed anywhere else if only
- *  socket descriptors are in use.
- */
-#define FREAD	0x1
-#define FWRITE	0x2
-
-/*
- * Select(), selscan(), selenter(), selwakeup() and unselect() are taken from
- * ../server/kern/sys_generic.h in bsdss distribution. soo_select() is
- * taken from ../server/kern/sys_socket.h, same distribution.
- */
-
-/* 
- * Althrough the fd_set is used as the type of the masks, the size
- * of the fd_set is not fixed, and is indeed calculated from nfds.
- */
-LONG __WaitSelect(ULONG nfds, fd_set *readfds, fd_set *writefds, fd_set *exeptfds,
-   struct timeval *timeout, ULONG *sigmp, struct SocketBase *libPtr)
-{
-  fd_mask * obits;
-  u_int obitsize;  /* in bytes */
-  int error, retval;
-  int selitemcount;
-  ULONG sigmask = sigmp ? *sigmp : 0;
-
-  struct newselbuf * newselbuf;
-  
-  CHECK_TASK();
-
-  if (nfds > libPtr->dTableSize)
-    nfds = libPtr->dTableSize;	/* forgiving; slightly wrong */
-  
-  if (timeout && itimerfix(timeout)) {
-    error = EINVAL;
-    goto Return;
-  }
-  
-  /*
-   *	We use selscan twice each time around the loop.
-   *	The first time, we actually put ourself on device chains.
-   *	The second time, we make a "fast" check for a true condition.
-   *	selenter does nothing and we don't need to use unselect.
-   *	We only need to zero obits once because if selscan
-   *	turns on a bit it returns non-zero and we stop.
-   *
-   *	The "fast" scan is also done before the loop is ever entered.
-   *
-   *	We need to allocate some temporary buffers for output bit masks
-   *	and, later for selitems. The amount of selitems needed is
-   *	calculated during the first selscan -- when selenter does nothing
-   */
-
-  obitsize = howmany(nfds, NFDBITS) * sizeof (fd_mask);
-  if (allocDataBuffer(&libPtr->selitems, 3 * obitsize) == FALSE) {
-    error = ENOMEM;
-    goto Return;
-  }
-  obits = (fd_mask *)libPtr->selitems.db_Addr;
-
-  aligned_bzero((caddr_t)obits, 3 * obitsize);
-
-  /*
-   *	We make a first pass to check for conditions
-   *	which are already true.  Clearing uu_sb
-   *	will keep selenter from doing anything.
-   */
-  libPtr->p_sb = 0;
-  error = selscan(libPtr, readfds, writefds, exeptfds,
-		  obits, nfds, &retval, &selitemcount);
-
-  /*
-   *	Check if the 'real' loop should be entered.
-   */
-  if (!error && !retval) {
-    if (timeout == NULL || timeout->tv_secs != 0L || timeout->tv_micro != 0L) {
-	
-      /*
-       * Send timeout if there is any.
-       */
-      if (timeout)
-	tsleep_send_timeout(libPtr, timeout);
-
-      /*
-       * Now, make sure there is room for all the selitems...
-       */
-      if (allocDataBuffer(&libPtr->selitems,
-			  3 * obitsize + sizeof (struct newselbuf) +
-			  selitemcount * sizeof(struct newselitem)) == FALSE) {
-	error = ENOMEM;
-	goto Return;
-      }
-      /*
-       * We need to clear obits again _if_ the memory area for it has 
-       * changed.
-       */
-      if ((fd_mask *)libPtr->selitems.db_Addr != obits) {
-	obits = (fd_mask *)libPtr->selitems.db_Addr;
-	aligned_bzero((caddr_t)obits, 3 * obitsize);
-      }
-      newselbuf = (struct newselbuf *)((caddr_t)obits + (3 * obitsize));
-      
-      while (TRUE) {
-
-	/*
-	 *	Now we get serious about blocking.
-	 *	selenter will put us on device chains.
-	 *	We don't need select_lock here because
-	 *	no other thread can get at selbuf yet.
-	 */
-	
-	newselbuf->s_state = SB_WILLWAIT;
-	newselbuf->s_count = 0;
-	libPtr->p_sb = newselbuf;
-	
-	error = selscan(libPtr, readfds, writefds, exeptfds,
-			obits, nfds, &retval, &selitemcount);
-	if (error || retval) {
-	  ObtainSemaphore(&select_semaphore);
-	  unselect(newselbuf);
-	  ReleaseSemaphore(&select_semaphore);
-	  break;
-	}
-	
-	/*
-	 *	If the state is already SB_CLEAR, then a selwakeup
-	 *	slipped in after the selscan.
-	 */
-	
-	ObtainSemaphore(&select_semaphore);
-	if (newselbuf->s_state == SB_CLEAR) {
-	  unselect(newselbuf);
-	  ReleaseSemaphore(&select_semaphore);
-	}
-	else {
-	  newselbuf->s_state = SB_WAITING;
-	  tsleep_enter(libPtr, (caddr_t)newselbuf, "select");
-	  ReleaseSemaphore(&select_semaphore);
-	  /* ReleaseSemaphore(&syscall_semaphore); don't have this */
-	  
-	  error = tsleep_main(libPtr, sigmask);
-	  
-	  /* ObtainSemaphore(&syscall_semaphore); see above */
-	  ObtainSemaphore(&select_semaphore);
-	  unselect(newselbuf);
-	  ReleaseSemaphore(&select_semaphore);
-	  
-	  if (error != 0) {
-	    /*
-	     * The break at the end of this block means that selscan will NOT 
-	     * be done after this. This provides faster response to the 
-	     * used defined signals.
-	     *
-	     * Note also that the semantics of the tsleep_abort_timeout() has 
-	     * changed; it is now accepted to call it even after the timeout
-	     * has expired.
-	     */
-	    if (error == ERESTART || error == EWOULDBLOCK)
-	      error = 0;
-	    
-	    break;		/* do not scan now */
-	  }
-	  
-	}
-	/*
-	 *	Scan for true conditions. Clearing uu_sb
-	 *	will keep selenter from doing anything.
-	 */
-	libPtr->p_sb = 0;
-	error = selscan(libPtr, readfds, writefds, exeptfds,
-			obits, nfds, &retval, &selitemcount);
-	if (error || retval)
-	  break;
-      } /* while (TRUE) */	
-
-      if (timeout)		/* abort the timeout if any */
-	tsleep_abort_timeout(libPtr, timeout);
-    }
-  }
-
- Return:
-  libPtr->p_sb = 0;
-
-#define	putbits(name, x) \
-  if (name) { \
-    aligned_bcopy(((caddr_t)obits) + (x * obitsize), \
-		  (caddr_t)name, obitsize); \
-   }
-
-  if (error == 0) {
-    if (sigmp)
-      *sigmp &= SetSignal(0L, sigmask);
-/*  ULONG sigs = SetSignal(0L, sigmask);
-    if (sigmp)
-      *sigmp &= sigs;
-    SetSignal(0L,libPtr->sigIntrMask);*/
-    
-    putbits(readfds, 0);
-    putbits(writefds, 1);
-    putbits(exeptfds, 2);
-  }
-#undef putbits
-
-  API_STD_RETURN(error, retval);
-}
-
-AROS_LH6(LONG, WaitSelect,
-   AROS_LHA(ULONG, nfds, D0),
-   AROS_LHA(fd_set *, readfds, A0),
-   AROS_LHA(fd_set *, writefds, A1),
-   AROS_LHA(fd_set *, exeptfds, A2),
-   AROS_LHA(struct timeval *, timeout, A3),
-   AROS_LHA(ULONG *, sigmp, D1),
-   struct SocketBase *, libPtr, 21, UL)
-{
-  AROS_LIBFUNC_INIT
-  DSYSCALLS(log(LOG_DEBUG,"WaitSelect(%lu, 0x%08lx, 0x%08lx, 0x%08lx, 0x%08lx, 0x%08lx) called", nfds, readfds, writefds, exeptfds, timeout, sigmp);)
-  return __WaitSelect(nfds, readfds, writefds, exeptfds, timeout, sigmp, libPtr);
-  AROS_LIBFUNC_EXIT
-}
-
 AROS_LH1(LONG, GetSocketEvents,
    AROS_LHA(ULONG *,eventsp, A0),
    struct SocketBase *, libPtr, 50, UL)
@@ -492,191 +206,6 @@ AROS_LH1(LONG, GetSocketEvents,
    AROS_LIBFUNC_EXIT
 }
 
-/* 
- * Althrough the fd_set is used as the type of the masks, the size
- * of the fd_set is not fixed, and is indeed calculated from nfd.
- */
-static int 
-selscan(struct SocketBase *p,
-	fd_set * in,
-	fd_set * ou,
-	fd_set * ex,
-	fd_mask * obits,
-	int nfd,
-	int * retval,
-	int * selitemcount_p)
-{
-	register int which, i, j, selitemcount = 0;
-	register fd_mask bits;
-	register fd_set * cbits;
-	struct socket *so;
-	int flag;
-	int n = 0;
-	int error = 0;
-	u_int obitsize = howmany(nfd, NFDBITS); /* in longwords */
-
-	for (which = 0; which < 3; which++) {
-		switch (which) {
-
-		case 0:
-			flag = FREAD;
-			cbits = in;
-			break;
-		case 1:
-			flag = FWRITE;
-			cbits = ou;
-			break;
-		case 2:
-			flag = 0;
-			cbits = ex;
-			break;
-		}
-		if (cbits != NULL) {
-		  for (i = 0; i < nfd; i += NFDBITS) {
-			bits = cbits->fds_bits[i/NFDBITS];
-			while ((j = ffs(bits)) && i + --j < nfd) {
-				bits &= ~(1 << j);
-				so = p->dTable[i + j];
-				if (so == NULL) {
-				  error = EBADF;
-				  break;
-				}
-				selitemcount++;
-				if (soo_select(so, flag, p)) {
-				  FD_SET(i + j, (fd_set *)
-					 (obits + (which * obitsize)));
-				  n++;
-				}
-			}
-		  }
-		}
-	}
-	*retval = n;
-	*selitemcount_p = selitemcount;
-	return (error);
-}
-
-/*
- * Add a select event to the current select buffer.
- * Chain all select buffers that are waiting for
- * the same event.
- */
-void selenter(struct SocketBase *	p,
-	      struct newselitem **	hdr)
-{
-	register struct newselbuf *sb = p->p_sb;
-
-	if (sb) {
-	    register struct newselitem **sip = hdr;
-	    register struct newselitem *si;
-
-	    ObtainSemaphore(&select_semaphore);
-
-	    /* initialize this select item */
-	    si = &sb->s_item[sb->s_count++];
-	    si->si_selbuf = sb;
-
-	    /* and add it to the device chain */
-	    if (si->si_next = *sip)
-		si->si_next->si_prev = &si->si_next;
-	    *(si->si_prev = sip) = si;
-
-	    ReleaseSemaphore(&select_semaphore);
-	}
-}
-
-static void
-unselect(register struct newselbuf * sb)
-{
-	int i;
-
-	/*
-	 *	We unchain the select items.
-	 *	This assumes select_lock is held.
-	 */
-
-	for (i = 0; i < sb->s_count; i++) {
-	    register struct newselitem *si = &sb->s_item[i];
-
-	    /*
-	     *	We remove this item from its device chain.
-	     *	If selwakeup already got to it, then this is a nop.
-	     */
-
-	    *si->si_prev = si->si_next;
-	}
-}
-
-/*
- * Wakeup all threads waiting on the same select event.
- * Do not clear the other select events that each thread
- * is waiting on; thread will do that itself.
- */
-void selwakeup(struct newselitem **hdr)
-{
-	register struct newselitem **sip;
-	register struct newselitem *si;
-
-	ObtainSemaphore(&select_semaphore);
-
-	for (sip = hdr; (si = *sip) != 0; sip = &si->si_next) {
-	    register struct newselbuf *sb;
-	    int old_state;
-
-	    /* for when unselect tries to dequeue this item */
-	    si->si_prev = &si->si_next;
-
-	    /* check for wakeup */
-	    sb = si->si_selbuf;
-	    old_state = sb->s_state;
-	    sb->s_state = SB_CLEAR;
-	    if (old_state == SB_WAITING)
-		wakeup((caddr_t)sb);
-	}
-
-	/* clear the device chain */
-	*(struct newselitem **)hdr = 0;
-	ReleaseSemaphore(&select_semaphore);
-}
-
-static int
-soo_select(struct socket *so,
-	       int which,
-	       struct SocketBase *p)
-{
-	register spl_t s = splnet();
-
-	switch (which) {
-
-	case FREAD:
-		if (soreadable(so)) {
-			splx(s);
-			return (1);
-		}
-		sbselqueue(&so->so_rcv, p);
-		break;
-
-	case FWRITE:
-		if (sowriteable(so)) {
-			splx(s);
-			return (1);
-		}
-		sbselqueue(&so->so_snd, p);
-		break;
-
-	case 0:
-		if (so->so_oobmark ||
-		    (so->so_state & SS_RCVATMARK)) {
-			splx(s);
-			return (1);
-		}
-		sbselqueue(&so->so_rcv, p);
-		break;
-	}
-	splx(s);
-	return (0);
-}
-
 /*
  * countSockets() counts how many references ONE task (SocketBase) have to a
  * socket
@@ -735,6 +264,8 @@ LONG __CloseSocket(LONG fd, struct SocketBase *libPtr)
   if (so->so_pgid == libPtr && countSockets(libPtr, so) == 1) 
     so->so_pgid = NULL;		/* not ours any more */
 
+  soevq_forget(libPtr, fd, so);
+
   /*
    * Decrease the reference count of a socket (AmiTCP addition) and return if
    * not zero.
@@ -871,6 +402,7 @@ AROS_LH2(LONG, ReleaseSocket,
     so->so_pgid = NULL;*/	  /* not ours any more */
   sn->sn_Id = id;
   sn->sn_Socket = so;
+  soevq_forget(libPtr, fd, so);
   libPtr->dTable[fd] = NULL;
   FD_CLR(fd, (fd_set *)(libPtr->dTable + libPtr->dTableSize));
   
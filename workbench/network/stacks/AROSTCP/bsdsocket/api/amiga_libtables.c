@@ -154,6 +154,11 @@ void AROS_SLIB_ENTRY(setservent, UL, 96)(void);
 void AROS_SLIB_ENTRY(endservent, UL, 97)(void);
 void AROS_SLIB_ENTRY(getservent, UL, 98)(void);
 void AROS_SLIB_ENTRY(inet_aton, UL, 99)(void);
+
+  /* AROS extensions */
+void AROS_SLIB_ENTRY(SetSocketInterest, UL, 100)(void);
+void AROS_SLIB_ENTRY(WaitSocketEvents, UL, 101)(void);
+void AROS_SLIB_ENTRY(SetSocketEventNotify, UL, 102)(void);
 #endif
 
 /* TODO: following functions are not implemented yet */
@@ -274,6 +279,11 @@ f_void UserLibrary_funcTable[] = {
   AROS_SLIB_ENTRY(endservent, UL, 97),
   AROS_SLIB_ENTRY(getservent, UL, 98),
   AROS_SLIB_ENTRY(inet_aton, UL, 99),
+
+  /* AROS extensions */
+  AROS_SLIB_ENTRY(SetSocketInterest, UL, 100),
+  AROS_SLIB_ENTRY(WaitSocketEvents, UL, 101),
+  AROS_SLIB_ENTRY(SetSocketEventNotify, UL, 102),
 #endif
   /* TODO: Following functions are not implemented yet */
 
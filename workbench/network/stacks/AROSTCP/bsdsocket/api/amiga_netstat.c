@@ -7,6 +7,23 @@
 #include <api/amiga_api.h>
 #include <net/if_protos.h>
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/socketvar.h>
+#include <sys/synch.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <netinet/in_pcb.h>
+#include <netinet/ip_var.h>
+#include <netinet/icmp_var.h>
+#include <netinet/tcp.h>
+#include <netinet/tcp_fsm.h>
+#include <netinet/tcp_seq.h>
+#include <netinet/tcp_timer.h>
+#include <netinet/tcp_var.h>
+#include <netinet/udp.h>
+#include <netinet/udp_var.h>
+
+extern struct icmpstat icmpstat;
 
 long __QueryInterfaceTagList(STRPTR name, const struct TagItem *tags, struct SocketBase * libPtr)
 {
@@ -167,3 +184,154 @@ D(bug("[AROSTCP.RS] amiga_netstat.c: QueryInterfaceTagList()\n"));
 	AROS_LIBFUNC_EXIT
 }
 #endif
+
+static void
+netstat_connection(struct inpcb *inp, struct protocol_connection_data *pcd)
+{
+	struct socket *so = inp->inp_socket;
+	struct tcpcb *tp = intotcpcb(inp);
+
+	pcd->pcd_foreign_address = inp->inp_faddr;
+	pcd->pcd_foreign_port = ntohs(inp->inp_fport);
+	pcd->pcd_local_address = inp->inp_laddr;
+	pcd->pcd_local_port = ntohs(inp->inp_lport);
+	pcd->pcd_receive_queue_size = so->so_rcv.sb_cc;
+	pcd->pcd_send_queue_size = so->so_snd.sb_cc;
+	pcd->pcd_tcp_state = (so->so_type == SOCK_STREAM && tp) ? tp->t_state : 0;
+}
+
+/*
+ * Per-connection TCP state, RTT estimates are converted from slow
+ * timeout ticks to milliseconds.
+ */
+static void
+netstat_tcp_connection(struct inpcb *inp, struct tcp_connection_data *tcd)
+{
+	struct tcpcb *tp = intotcpcb(inp);
+
+	bzero(tcd, sizeof(*tcd));
+	netstat_connection(inp, &tcd->tcd_connection);
+	if (tp == NULL)
+		return;
+
+	if ((tp->t_flags & (TF_REQ_TSTMP|TF_RCVD_TSTMP)) == (TF_REQ_TSTMP|TF_RCVD_TSTMP))
+		tcd->tcd_flags |= TCDF_TIMESTAMPS;
+	if ((tp->t_flags & (TF_REQ_SCALE|TF_RCVD_SCALE)) == (TF_REQ_SCALE|TF_RCVD_SCALE))
+		tcd->tcd_flags |= TCDF_WINDOW_SCALE;
+	if (TCP_SACK_ENABLED(tp))
+		tcd->tcd_flags |= TCDF_SACK;
+	if (IN_FASTRECOVERY(tp))
+		tcd->tcd_flags |= TCDF_RECOVERY;
+
+	tcd->tcd_srtt = tp->t_srtt * 1000 / (PR_SLOWHZ << TCP_RTT_SHIFT);
+	tcd->tcd_rttvar = tp->t_rttvar * 1000 / (PR_SLOWHZ << TCP_RTTVAR_SHIFT);
+	tcd->tcd_rto = tp->t_rxtcur * 1000 / PR_SLOWHZ;
+	tcd->tcd_rtt_last = tp->t_rttlast;
+	tcd->tcd_rtt_min = tp->t_rttbest;
+	tcd->tcd_cwnd = tp->snd_cwnd;
+	tcd->tcd_ssthresh = tp->snd_ssthresh;
+	tcd->tcd_send_window = tp->snd_wnd;
+	tcd->tcd_maxseg = tp->t_maxseg;
+	tcd->tcd_retransmits = tp->t_sndrexmitpack;
+	tcd->tcd_out_of_order = tp->t_rcvoopack;
+	tcd->tcd_recoveries = tp->t_recoveries;
+	tcd->tcd_timeouts = tp->t_rtos;
+	tcd->tcd_sack_holes = tp->snd_numholes;
+	strncpy(tcd->tcd_congestion, tp->t_cc->name, sizeof(tcd->tcd_congestion) - 1);
+}
+
+/*
+ * Copy as much of the requested statistics as fits into size bytes of
+ * destination.  Returns the number of bytes copied, or -1 with errno
+ * set.
+ */
+LONG __GetNetworkStatistics(LONG type, LONG version, APTR destination, LONG size, struct SocketBase *libPtr)
+{
+	struct inpcbhead *head;
+	struct inpcb *inp;
+	APTR src = NULL;
+	UBYTE *dst = destination;
+	LONG len = 0, n = 0;
+	spl_t s;
+
+#if defined(__AROS__)
+D(bug("[AROSTCP] amiga_netstat.c: __GetNetworkStatistics(%ld)\n", type));
+#endif
+
+	if (version != NETWORKSTATUS_VERSION || destination == NULL || size < 0) {
+		writeErrnoValue(libPtr, EINVAL);
+		return -1;
+	}
+
+	switch (type)
+	{
+	case NETSTATUS_icmp:
+		src = &icmpstat;
+		len = sizeof(icmpstat);
+		break;
+	case NETSTATUS_ip:
+		src = &ipstat;
+		len = sizeof(ipstat);
+		break;
+	case NETSTATUS_tcp:
+		src = &tcpstat;
+		len = sizeof(tcpstat);
+		break;
+	case NETSTATUS_udp:
+		src = &udpstat;
+		len = sizeof(udpstat);
+		break;
+	case NETSTATUS_tcp_sockets:
+		head = &tcb;
+		len = sizeof(struct protocol_connection_data);
+		break;
+	case NETSTATUS_udp_sockets:
+		head = &udb;
+		len = sizeof(struct protocol_connection_data);
+		break;
+	case NETSTATUS_tcp_connections:
+		head = &tcb;
+		len = sizeof(struct tcp_connection_data);
+		break;
+	default:
+		writeErrnoValue(libPtr, ENOSYS);
+		return -1;
+	}
+
+	s = splnet();
+	if (src) {
+		n = MIN(len, size);
+		bcopy(src, dst, n);
+	} else {
+		for (inp = head->lh_first; inp != NULL && n + len <= size;
+		     inp = inp->inp_list.le_next, n += len) {
+			if (type == NETSTATUS_tcp_connections)
+				netstat_tcp_connection(inp, (struct tcp_connection_data *)(dst + n));
+			else
+				netstat_connection(inp, (struct protocol_connection_data *)(dst + n));
+		}
+	}
+	splx(s);
+
+	return n;
+}
+
+#if defined(__CONFIG_ROADSHOW__)
+AROS_LH4(LONG, GetNetworkStatistics,
+   AROS_LHA(LONG, type, D0),
+   AROS_LHA(LONG, version, D1),
+   AROS_LHA(APTR, destination, A0),
+   AROS_LHA(LONG, size, D2),
+   struct SocketBase *, libPtr, 85, UL)
+{
+	AROS_LIBFUNC_INIT
+
+#if defined(__AROS__)
+D(bug("[AROSTCP.RS] amiga_netstat.c: GetNetworkStatistics()\n"));
+#endif
+
+	return __GetNetworkStatistics(type, version, destination, size, libPtr);
+
+	AROS_LIBFUNC_EXIT
+}
+#endif
@@ -0,0 +1,688 @@
+/*
+ * Copyright (C) 1993 AmiTCP/IP Group, <amitcp-group@hut.fi>
+ *                    Helsinki University of Technology, Finland.
+ *                    All rights reserved.
+ * Copyright (C) 2005 - 2025 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+#include <conf.h>
+
+#include <aros/asmcall.h>
+#include <aros/libcall.h>
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/socket.h>
+#include <sys/socketvar.h>
+#include <sys/malloc.h>
+#include <sys/synch.h>
+
+#include <sys/time.h>
+#include <sys/errno.h>
+
+#include <kern/amiga_includes.h>
+
+#include <api/amiga_api.h>
+#include <api/amiga_libcallentry.h>
+#include <api/allocdatabuffer.h>
+
+#include <api/apicalls.h>
+
+#include <kern/amiga_select_protos.h>
+
+/*
+ * Socket readiness notification.
+ *
+ * Every socket keeps a chain of interest records, one for each event
+ * queue watching it. When the socket is woken up only this chain is
+ * walked, and the records whose condition is now true are moved to the
+ * ready list of their queue. Collecting events therefore costs time in
+ * proportion to the number of ready sockets, not the number watched.
+ *
+ * Each library base has one persistent queue, set up with
+ * SetSocketInterest() and read with WaitSocketEvents(). WaitSelect()
+ * builds a short lived queue of its own on the same mechanism.
+ */
+
+struct sointerest {
+  struct MinNode	si_node;	/* on the ready list of si_queue */
+  struct sointerest *	si_next;	/* next interest on the same socket */
+  struct soeventq *	si_queue;	/* queue this interest belongs to */
+  struct socket *	si_so;
+  LONG			si_fd;
+  ULONG			si_events;	/* FD_xxx conditions wanted */
+  ULONG			si_flags;	/* SIF_xxx */
+  APTR			si_userdata;
+  BOOL			si_queued;	/* on the ready list */
+};
+
+struct soeventq {
+  struct MinList	eq_ready;	/* interests with a condition pending */
+  struct SocketBase *	eq_owner;
+  BOOL			eq_waiting;	/* owner sleeps on this queue */
+  BOOL			eq_notified;	/* notification sent since last collect */
+  ULONG			eq_sigmask;	/* signals to send on new events */
+  struct MsgPort *	eq_port;	/* port to send eq_msg to */
+  struct Message	eq_msg;
+};
+
+/*
+ *  Semaphore protecting the interest chains and the ready lists
+ */
+struct SignalSemaphore select_semaphore = { };
+
+void select_init(void)
+{
+  InitSemaphore(&select_semaphore);
+}
+
+/*
+ * itimerfix copied from bsdss/server/kern/kern_time.c. since fields
+ * in struct timeval in amiga are ULONGs, values less than zero need
+ * not be checked. the second check, timeval less than resolution of
+ * the clock is not needed in amiga...hmm, is removed also.
+ */
+static inline int itimerfix(struct timeval *tv)
+{
+	if (tv->tv_sec > 100000000 || tv->tv_usec >= 1000000)
+		return (EINVAL);
+	return (0);
+}
+
+/*
+ * Conditions currently true on a socket. Must be called at splnet().
+ */
+static ULONG
+so_readiness(struct socket *so)
+{
+  ULONG ready = 0;
+
+  if (soreadable(so))
+    ready |= FD_READ;
+  if ((so->so_options & SO_ACCEPTCONN) && so->so_qlen)
+    ready |= FD_ACCEPT;
+  if (sowriteable(so))
+    ready |= FD_WRITE;
+  if (so->so_oobmark || (so->so_state & SS_RCVATMARK))
+    ready |= FD_OOB;
+  if (so->so_error)
+    ready |= FD_ERROR;
+  if (so->so_state & SS_CANTRCVMORE)
+    ready |= FD_CLOSE;
+
+  return ready;
+}
+
+/*
+ * Tell the owner of the queue that there is something to collect.
+ * Called with select_semaphore held.
+ */
+static void
+soevq_notify(struct soeventq *eq)
+{
+  if (eq->eq_waiting)
+    wakeup((caddr_t)eq);
+
+  if (eq->eq_notified)
+    return;
+  eq->eq_notified = TRUE;
+
+  if (eq->eq_sigmask)
+    Signal(eq->eq_owner->thisTask, eq->eq_sigmask);
+  /*
+   * The message is only sent again after the owner has replied it
+   */
+  if (eq->eq_port && eq->eq_msg.mn_Node.ln_Type != NT_MESSAGE)
+    PutMsg(eq->eq_port, &eq->eq_msg);
+}
+
+/*
+ * Put an interest on the ready list of its queue.
+ * Called with select_semaphore held.
+ */
+static void
+soevq_queue(struct sointerest *si)
+{
+  if (!si->si_queued) {
+    AddTail((struct List *)&si->si_queue->eq_ready, (struct Node *)si);
+    si->si_queued = TRUE;
+  }
+  soevq_notify(si->si_queue);
+}
+
+static void
+soevq_init(struct soeventq *eq, struct SocketBase *p)
+{
+  NewList((struct List *)&eq->eq_ready);
+  eq->eq_owner = p;
+  eq->eq_waiting = FALSE;
+  eq->eq_notified = FALSE;
+  eq->eq_sigmask = 0;
+  eq->eq_port = NULL;
+  eq->eq_msg.mn_Node.ln_Type = NT_UNKNOWN;
+  eq->eq_msg.mn_ReplyPort = NULL;
+  eq->eq_msg.mn_Length = sizeof(struct Message);
+}
+
+/*
+ * Attach an interest to a socket. If the condition is already true the
+ * interest goes directly to the ready list.
+ */
+static void
+soevq_add(struct soeventq *eq, struct sointerest *si, LONG fd,
+	  struct socket *so, ULONG events, ULONG flags, APTR userdata)
+{
+  spl_t s;
+
+  si->si_queue = eq;
+  si->si_so = so;
+  si->si_fd = fd;
+  si->si_events = events;
+  si->si_flags = flags;
+  si->si_userdata = userdata;
+  si->si_queued = FALSE;
+
+  s = splnet();
+  ObtainSemaphore(&select_semaphore);
+  si->si_next = so->so_interest;
+  so->so_interest = si;
+  if (so_readiness(so) & events)
+    soevq_queue(si);
+  ReleaseSemaphore(&select_semaphore);
+  splx(s);
+}
+
+/*
+ * Detach an interest from its socket and queue.
+ * Called with select_semaphore held.
+ */
+static void
+soevq_unlink(struct sointerest *si)
+{
+  struct sointerest **sip;
+
+  for (sip = &si->si_so->so_interest; *sip; sip = &(*sip)->si_next)
+    if (*sip == si) {
+      *sip = si->si_next;
+      break;
+    }
+  if (si->si_queued) {
+    Remove((struct Node *)si);
+    si->si_queued = FALSE;
+  }
+}
+
+/*
+ * Find the interest a queue has in a descriptor.
+ * Called with select_semaphore held.
+ */
+static struct sointerest *
+soevq_find(struct soeventq *eq, struct socket *so, LONG fd)
+{
+  struct sointerest *si;
+
+  for (si = so->so_interest; si; si = si->si_next)
+    if (si->si_queue == eq && si->si_fd == fd)
+      return si;
+  return NULL;
+}
+
+/*
+ * Move up to max pending events from the ready list to ev. Interests
+ * whose condition has gone away in the meantime are dropped. Level
+ * triggered interests stay on the list, behind those not yet reported,
+ * so that they are checked again on the next call.
+ */
+static int
+soevq_collect(struct soeventq *eq, struct SocketEvent *ev, int max)
+{
+  struct MinList again;
+  struct sointerest *si;
+  ULONG ready;
+  int n = 0;
+  spl_t s;
+
+  NewList((struct List *)&again);
+
+  s = splnet();
+  ObtainSemaphore(&select_semaphore);
+  eq->eq_notified = FALSE;
+
+  while (n < max &&
+	 (si = (struct sointerest *)RemHead((struct List *)&eq->eq_ready))) {
+    ready = so_readiness(si->si_so) & si->si_events;
+    if (ready == 0) {
+      si->si_queued = FALSE;
+      continue;
+    }
+
+    ev[n].se_Socket = si->si_fd;
+    ev[n].se_Events = ready;
+    ev[n].se_UserData = si->si_userdata;
+    n++;
+
+    if (si->si_flags & SIF_ONESHOT) {
+      si->si_events = 0;
+      si->si_queued = FALSE;
+    }
+    else if (si->si_flags & SIF_EDGE)
+      si->si_queued = FALSE;
+    else
+      AddTail((struct List *)&again, (struct Node *)si);
+  }
+
+  while ((si = (struct sointerest *)RemHead((struct List *)&again)))
+    AddTail((struct List *)&eq->eq_ready, (struct Node *)si);
+
+  ReleaseSemaphore(&select_semaphore);
+  splx(s);
+
+  return n;
+}
+
+/*
+ * Collect events from a queue, sleeping until there are some, the
+ * timeout expires or one of the signals in sigmask arrives.
+ */
+static int
+soevq_wait(struct SocketBase *p, struct soeventq *eq,
+	   struct SocketEvent *ev, int max,
+	   struct timeval *timeout, ULONG sigmask, int *retval)
+{
+  int error = 0, n;
+
+  n = soevq_collect(eq, ev, max);
+
+  if (n == 0 &&
+      (timeout == NULL || timeout->tv_secs != 0L || timeout->tv_micro != 0L)) {
+    if (timeout)
+      tsleep_send_timeout(p, timeout);
+
+    for (;;) {
+      /*
+       * Enter the sleep queue before releasing the semaphore so that an
+       * interest queued right after the check wakes us up.
+       */
+      ObtainSemaphore(&select_semaphore);
+      if (IsListEmpty((struct List *)&eq->eq_ready)) {
+	eq->eq_waiting = TRUE;
+	tsleep_enter(p, (caddr_t)eq, "select");
+	ReleaseSemaphore(&select_semaphore);
+
+	error = tsleep_main(p, sigmask);
+
+	ObtainSemaphore(&select_semaphore);
+	eq->eq_waiting = FALSE;
+	ReleaseSemaphore(&select_semaphore);
+
+	if (error != 0) {
+	  /*
+	   * Do not collect after a user signal or the timeout. This
+	   * provides faster response to the user defined signals.
+	   */
+	  if (error == ERESTART || error == EWOULDBLOCK)
+	    error = 0;
+	  break;
+	}
+      }
+      else
+	ReleaseSemaphore(&select_semaphore);
+
+      if ((n = soevq_collect(eq, ev, max)) != 0)
+	break;
+    }
+
+    if (timeout)		/* abort the timeout if any */
+      tsleep_abort_timeout(p, timeout);
+  }
+
+  *retval = n;
+  return error;
+}
+
+/*
+ * Called from sowakeup() and friends when the state of a socket may have
+ * changed.
+ */
+void
+soevq_wakeup(struct socket *so)
+{
+  struct sointerest *si;
+  ULONG ready;
+
+  ObtainSemaphore(&select_semaphore);
+  if (so->so_interest) {
+    ready = so_readiness(so);
+    for (si = so->so_interest; si; si = si->si_next)
+      if (ready & si->si_events)
+	soevq_queue(si);
+  }
+  ReleaseSemaphore(&select_semaphore);
+}
+
+/*
+ * Drop the persistent interest in a descriptor which is being closed or
+ * released. Caller holds the syscall semaphore.
+ */
+void
+soevq_forget(struct SocketBase *p, LONG fd, struct socket *so)
+{
+  struct sointerest *si;
+  spl_t s;
+
+  if (p->evQueue == NULL)
+    return;
+
+  s = splnet();
+  ObtainSemaphore(&select_semaphore);
+  if ((si = soevq_find(p->evQueue, so, fd)) != NULL)
+    soevq_unlink(si);
+  ReleaseSemaphore(&select_semaphore);
+  splx(s);
+
+  if (si)
+    bsd_free(si, M_TEMP);
+}
+
+/*
+ * Free the persistent queue of a library base. All sockets must have
+ * been closed already.
+ */
+void
+soevq_free(struct SocketBase *p)
+{
+  if (p->evQueue) {
+    bsd_free(p->evQueue, M_TEMP);
+    p->evQueue = NULL;
+  }
+}
+
+static struct soeventq *
+soevq_get(struct SocketBase *p)
+{
+  if (p->evQueue == NULL &&
+      (p->evQueue = bsd_malloc(sizeof(struct soeventq), M_TEMP, M_WAITOK)))
+    soevq_init(p->evQueue, p);
+  return p->evQueue;
+}
+
+/*
+ * Althrough the fd_set is used as the type of the masks, the size
+ * of the fd_set is not fixed, and is indeed calculated from nfds.
+ *
+ * One interest is attached to each socket in the sets for the duration
+ * of the call, so the sets are scanned only when entering and leaving,
+ * not again on every wakeup.
+ */
+LONG __WaitSelect(ULONG nfds, fd_set *readfds, fd_set *writefds, fd_set *exeptfds,
+   struct timeval *timeout, ULONG *sigmp, struct SocketBase *libPtr)
+{
+  fd_mask *obits;
+  u_int obitsize;  /* in bytes */
+  int error = 0, retval = 0;
+  ULONG sigmask = sigmp ? *sigmp : 0;
+  struct soeventq eq;
+  struct sointerest *si;
+  struct SocketEvent *ev;
+  int i, j, nsi = 0;
+  u_long bits;
+  u_int sioffset;
+  ULONG events;
+  spl_t s;
+
+  CHECK_TASK();
+
+  if (nfds > libPtr->dTableSize)
+    nfds = libPtr->dTableSize;	/* forgiving; slightly wrong */
+
+  if (timeout && itimerfix(timeout)) {
+    error = EINVAL;
+    goto Return;
+  }
+
+  /*
+   * Output masks, followed by room for one interest and one event per
+   * descriptor.
+   */
+  obitsize = howmany(nfds, NFDBITS) * sizeof (fd_mask);
+  sioffset = (3 * obitsize + sizeof (IPTR) - 1) & ~(sizeof (IPTR) - 1);
+  if (allocDataBuffer(&libPtr->selitems,
+		      sioffset + nfds * (sizeof (struct sointerest) +
+					 sizeof (struct SocketEvent)))
+      == FALSE) {
+    error = ENOMEM;
+    goto Return;
+  }
+  obits = (fd_mask *)libPtr->selitems.db_Addr;
+  aligned_bzero((caddr_t)obits, 3 * obitsize);
+  si = (struct sointerest *)((caddr_t)obits + sioffset);
+  ev = (struct SocketEvent *)(si + nfds);
+
+  soevq_init(&eq, libPtr);
+
+#define getbits(name, i) ((name) ? (u_long)(name)->fds_bits[(i)/NFDBITS] : 0)
+
+  for (i = 0; i < nfds && error == 0; i += NFDBITS) {
+    bits = getbits(readfds, i) | getbits(writefds, i) | getbits(exeptfds, i);
+    for (j = 0; bits != 0 && j < NFDBITS && i + j < nfds; j++, bits >>= 1) {
+      if ((bits & 1) == 0)
+	continue;
+
+      events = 0;
+      if (readfds && FD_ISSET(i + j, readfds))
+	events |= FD_READ;
+      if (writefds && FD_ISSET(i + j, writefds))
+	events |= FD_WRITE;
+      if (exeptfds && FD_ISSET(i + j, exeptfds))
+	events |= FD_OOB;
+
+      if (libPtr->dTable[i + j] == NULL) {
+	error = EBADF;
+	break;
+      }
+      soevq_add(&eq, &si[nsi++], i + j, libPtr->dTable[i + j], events, 0, NULL);
+    }
+  }
+
+#undef getbits
+
+  if (error == 0)
+    error = soevq_wait(libPtr, &eq, ev, nsi, timeout, sigmask, &retval);
+
+  s = splnet();
+  ObtainSemaphore(&select_semaphore);
+  for (i = 0; i < nsi; i++)
+    soevq_unlink(&si[i]);
+  ReleaseSemaphore(&select_semaphore);
+  splx(s);
+
+  /*
+   * select() counts each set a descriptor is found in
+   */
+  for (i = 0, j = retval, retval = 0; i < j; i++) {
+    if (ev[i].se_Events & FD_READ) {
+      FD_SET(ev[i].se_Socket, (fd_set *)obits);
+      retval++;
+    }
+    if (ev[i].se_Events & FD_WRITE) {
+      FD_SET(ev[i].se_Socket, (fd_set *)((caddr_t)obits + obitsize));
+      retval++;
+    }
+    if (ev[i].se_Events & FD_OOB) {
+      FD_SET(ev[i].se_Socket, (fd_set *)((caddr_t)obits + 2 * obitsize));
+      retval++;
+    }
+  }
+
+ Return:
+
+#define	putbits(name, x) \
+  if (name) { \
+    aligned_bcopy(((caddr_t)obits) + (x * obitsize), \
+		  (caddr_t)name, obitsize); \
+   }
+
+  if (error == 0) {
+    if (sigmp)
+      *sigmp &= SetSignal(0L, sigmask);
+
+    putbits(readfds, 0);
+    putbits(writefds, 1);
+    putbits(exeptfds, 2);
+  }
+#undef putbits
+
+  API_STD_RETURN(error, retval);
+}
+
+AROS_LH6(LONG, WaitSelect,
+   AROS_LHA(ULONG, nfds, D0),
+   AROS_LHA(fd_set *, readfds, A0),
+   AROS_LHA(fd_set *, writefds, A1),
+   AROS_LHA(fd_set *, exeptfds, A2),
+   AROS_LHA(struct timeval *, timeout, A3),
+   AROS_LHA(ULONG *, sigmp, D1),
+   struct SocketBase *, libPtr, 21, UL)
+{
+  AROS_LIBFUNC_INIT
+  DSYSCALLS(log(LOG_DEBUG,"WaitSelect(%lu, 0x%08lx, 0x%08lx, 0x%08lx, 0x%08lx, 0x%08lx) called", nfds, readfds, writefds, exeptfds, timeout, sigmp);)
+  return __WaitSelect(nfds, readfds, writefds, exeptfds, timeout, sigmp, libPtr);
+  AROS_LIBFUNC_EXIT
+}
+
+AROS_LH4(LONG, SetSocketInterest,
+   AROS_LHA(LONG, fd, D0),
+   AROS_LHA(ULONG, events, D1),
+   AROS_LHA(ULONG, flags, D2),
+   AROS_LHA(APTR, userdata, A0),
+   struct SocketBase *, libPtr, 100, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct soeventq *eq;
+  struct sointerest *si, *newsi = NULL;
+  struct socket *so;
+  int error;
+  spl_t s;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"SetSocketInterest(%ld, 0x%08lx, 0x%08lx, 0x%08lx) called", fd, events, flags, userdata);)
+  ObtainSyscallSemaphore(libPtr);
+
+  if (error = getSock(libPtr, fd, &so))
+    goto Return;
+
+  if (events == 0) {
+    soevq_forget(libPtr, fd, so);
+    goto Return;
+  }
+
+  if ((eq = soevq_get(libPtr)) == NULL) {
+    error = ENOMEM;
+    goto Return;
+  }
+
+  s = splnet();
+  ObtainSemaphore(&select_semaphore);
+  if ((si = soevq_find(eq, so, fd)) != NULL) {
+    si->si_events = events;
+    si->si_flags = flags;
+    si->si_userdata = userdata;
+    if (so_readiness(so) & events)
+      soevq_queue(si);
+  }
+  ReleaseSemaphore(&select_semaphore);
+  splx(s);
+
+  if (si == NULL) {
+    if ((newsi = bsd_malloc(sizeof(struct sointerest), M_TEMP, M_WAITOK)) == NULL) {
+      error = ENOMEM;
+      goto Return;
+    }
+    soevq_add(eq, newsi, fd, so, events, flags, userdata);
+  }
+
+ Return:
+  ReleaseSyscallSemaphore(libPtr);
+  API_STD_RETURN(error, 0);
+  AROS_LIBFUNC_EXIT
+}
+
+AROS_LH4(LONG, WaitSocketEvents,
+   AROS_LHA(struct SocketEvent *, events, A0),
+   AROS_LHA(LONG, maxevents, D0),
+   AROS_LHA(struct timeval *, timeout, A1),
+   AROS_LHA(ULONG *, sigmp, D1),
+   struct SocketBase *, libPtr, 101, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct soeventq *eq;
+  ULONG sigmask = sigmp ? *sigmp : 0;
+  int error, retval = 0;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"WaitSocketEvents(0x%08lx, %ld, 0x%08lx, 0x%08lx) called", events, maxevents, timeout, sigmp);)
+
+  if (events == NULL || maxevents <= 0 || (timeout && itimerfix(timeout))) {
+    error = EINVAL;
+    goto Return;
+  }
+
+  if ((eq = soevq_get(libPtr)) == NULL) {
+    error = ENOMEM;
+    goto Return;
+  }
+
+  error = soevq_wait(libPtr, eq, events, maxevents, timeout, sigmask, &retval);
+
+  if (error == 0 && sigmp)
+    *sigmp &= SetSignal(0L, sigmask);
+
+ Return:
+  API_STD_RETURN(error, retval);
+  AROS_LIBFUNC_EXIT
+}
+
+AROS_LH2(LONG, SetSocketEventNotify,
+   AROS_LHA(struct MsgPort *, port, A0),
+   AROS_LHA(ULONG, sigmask, D0),
+   struct SocketBase *, libPtr, 102, UL)
+{
+  AROS_LIBFUNC_INIT
+  struct soeventq *eq;
+  int error = 0;
+
+  CHECK_TASK();
+  DSYSCALLS(log(LOG_DEBUG,"SetSocketEventNotify(0x%08lx, 0x%08lx) called", port, sigmask);)
+
+  if ((eq = soevq_get(libPtr)) == NULL) {
+    error = ENOMEM;
+    goto Return;
+  }
+
+  ObtainSemaphore(&select_semaphore);
+  eq->eq_port = port;
+  eq->eq_sigmask = sigmask;
+  eq->eq_notified = FALSE;
+  if (!IsListEmpty((struct List *)&eq->eq_ready))
+    soevq_notify(eq);
+  ReleaseSemaphore(&select_semaphore);
+
+ Return:
+  API_STD_RETURN(error, 0);
+  AROS_LIBFUNC_EXIT
+}
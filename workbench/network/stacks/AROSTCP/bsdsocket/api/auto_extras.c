@@ -266,3 +266,100 @@
 *****************************************************************************
 * 
 */
+
+/****** bsdsocket.library/SetSocketInterest *********************************
+*
+*   NAME
+*        SetSocketInterest - register interest in events on a socket
+*
+*   SYNOPSIS
+*        error = SetSocketInterest(fd, events, flags, userdata)
+*        D0                        D0  D1      D2     A0
+*
+*        LONG SetSocketInterest(LONG, ULONG, ULONG, APTR);
+*
+*   FUNCTION
+*        Adds the socket fd to the event queue of the library base,
+*        or changes the interest already registered for it. events
+*        is a mask of the FD_xxx conditions  wanted  and  userdata is
+*        returned  with  each  event.  An  events  mask  of  0 removes
+*        the socket from the queue.  Closing or releasing  the socket
+*        removes it as well.
+*
+*        By default events are level triggered:  a condition is  re-
+*        ported by every WaitSocketEvents() call for as long  as  it
+*        is true. With SIF_EDGE it is reported once each time the
+*        socket is woken up by new data, space or state.  SIF_ONESHOT
+*        clears the events mask after the first report; call
+*        SetSocketInterest() again to re-arm it.
+*
+*        Unlike  WaitSelect(),  the  cost of  waiting  depends on the
+*        number of ready sockets only, not on the number registered.
+*
+*   RESULT
+*        0 on success, -1 on error (errno set to EBADF or ENOMEM).
+*
+*   SEE ALSO
+*        WaitSocketEvents(), SetSocketEventNotify(), WaitSelect()
+*
+*****************************************************************************
+*
+*/
+
+/****** bsdsocket.library/WaitSocketEvents **********************************
+*
+*   NAME
+*        WaitSocketEvents - wait for events registered with
+*                           SetSocketInterest()
+*
+*   SYNOPSIS
+*        n = WaitSocketEvents(events, maxevents, timeout, sigmp)
+*        D0                   A0      D0         A1       D1
+*
+*        LONG WaitSocketEvents(struct SocketEvent *, LONG,
+*                              struct timeval *, ULONG *);
+*
+*   FUNCTION
+*        Stores up to maxevents pending events into the events array
+*        and returns their number. If none are pending, waits like
+*        WaitSelect() until one occurs, the timeout expires or one of
+*        the signals in *sigmp arrives; *sigmp is then set to the
+*        signals received. A zero timeout polls.
+*
+*   RESULT
+*        Number of events stored, 0 on timeout or signal, -1 on error.
+*
+*   SEE ALSO
+*        SetSocketInterest(), SetSocketEventNotify()
+*
+*****************************************************************************
+*
+*/
+
+/****** bsdsocket.library/SetSocketEventNotify ******************************
+*
+*   NAME
+*        SetSocketEventNotify - get told asynchronously about new events
+*
+*   SYNOPSIS
+*        error = SetSocketEventNotify(port, sigmask)
+*        D0                           A0    D0
+*
+*        LONG SetSocketEventNotify(struct MsgPort *, ULONG);
+*
+*   FUNCTION
+*        When events become pending on the queue of the library base,
+*        the signals in sigmask are sent to the owning task and/or a
+*        message is put to port. Either may be 0/NULL.
+*
+*        Only one notification is sent until WaitSocketEvents() has
+*        been called again. The message belongs to the library and
+*        must be replied with ReplyMsg() once received; it is not sent
+*        again before that. Reply it before closing the library.
+*
+*   SEE ALSO
+*        SetSocketInterest(), WaitSocketEvents()
+*
+*****************************************************************************
+*
+*/
@@ -41,6 +41,12 @@
  */
 #include <net/if_protos.h>              /* if_slowtimo() */
 #include <kern/uipc_domain_protos.h>    /* pfslowtimo(), pffasttimo() */
+#include <sys/mbuf.h>                   /* mb_trim() */
+
+/*
+ * seconds between attempts to return unused mbuf memory to the system
+ */
+#define MB_TRIM_INTERVAL 5
 
 /*
  * Global timer base pointer used throughout the code.
@@ -62,7 +68,8 @@ static struct timerequest *timerIORequest = NULL; /* template IORequest */
 static struct timeoutRequest *ifTimer = NULL,
   *arpTimer = NULL, 
   *protoSlowTimer = NULL, 
-  *protoFastTimer = NULL;
+  *protoFastTimer = NULL,
+  *mbufTimer = NULL;
 
 static BOOL can_send_timeouts = FALSE; 
 
@@ -135,7 +142,8 @@ D(bug("[AROSTCP](amiga_timer.c) timer_init()\n"));
 	  arpTimer = createTimeoutRequest(arptimer, ARPT_AGE, 0); 
 	  protoSlowTimer = createTimeoutRequest(pfslowtimo, 0, 1000000 / PR_SLOWHZ); 
 	  protoFastTimer = createTimeoutRequest(pffasttimo, 0, 1000000 / PR_FASTHZ); 
-	  if (protoFastTimer && protoSlowTimer && arpTimer && ifTimer) {
+	  mbufTimer = createTimeoutRequest(mb_trim, MB_TRIM_INTERVAL, 0);
+	  if (protoFastTimer && protoSlowTimer && arpTimer && ifTimer && mbufTimer) {
 	    can_send_timeouts = TRUE;
 	    return (ULONG)(1 << timerport->mp_SigBit);
 	  }
@@ -163,6 +171,8 @@ D(bug("[AROSTCP](amiga_timer.c) timer_deinit()\n"));
 #endif
   can_send_timeouts = FALSE;
 
+  if (mbufTimer)
+    deleteTimeoutRequest(mbufTimer);
   if (protoFastTimer)
     deleteTimeoutRequest(protoFastTimer);
   if (protoSlowTimer)
@@ -203,6 +213,7 @@ D(bug("[AROSTCP](amiga_timer.c) timer_send()\n"));
     sendTimeoutRequest(arpTimer);
     sendTimeoutRequest(protoSlowTimer);
     sendTimeoutRequest(protoFastTimer);
+    sendTimeoutRequest(mbufTimer);
 
     can_send_timeouts = FALSE;
   }
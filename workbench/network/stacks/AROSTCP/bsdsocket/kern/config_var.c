@@ -32,7 +32,10 @@
  "RC=RCHKSUM,ROF=ROFFSET,RPS=RPSHORT,RDUPP=RDUPPACK,RDUPB=RDUPBYTE," \
  "RPDUPD=RPDUPDATA,RPDUPB=RPDUPBYTE,ROOP=ROOPACK,ROOB=ROOBYTE," \
  "RPL=RPLATE,RBL=RBLATE,RAF=RAFTER,RWP=RWPROBE,RDUPA=RDUPACK," \
- "RACKT=RACKTOOM,RACKP=RACKPACK,RACKB=RACKBYTE,RWU=RWUPDATE"
+ "RACKT=RACKTOOM,RACKP=RACKPACK,RACKB=RACKBYTE,RWU=RWUPDATE," \
+ "PAWS=PAWSDROP,PRA=PREDACK,PRD=PREDDAT,PCM=PCBCACHEMISS," \
+ "FR=FASTRECOVERY,PACK=PARTIALACK,SRC=SACKRECOVERY,SRXP=SACKREXPACK," \
+ "SRXB=SACKREXBYTE,SBR=SACKBLKRCVD,SBS=SACKBLKSENT"
 
 /* Variables related to User Datagram Protocol. */
 #define KW_UDP \
@@ -72,7 +75,8 @@ STRPTR KW_VARS =
   "TASKNAME,NTH=NTHBASE,DBSANA=DEBUGSANA,DBICMP=DEBUGICMP,"
   "DBIP=DEBUGIP,GTW=GATEWAY,REDIR=IPSENDREDIRECTS,"
   "USENS=USENAMESERVER,ULO=USELOOPBACK,TCPSND=TCP_SENDSPACE,"
-  "TCPRCV=TCP_RECVSPACE,CON=CONSOLENAME,LOGF=LOGFILENAME,OPENGUI,REFRESH";
+  "TCPRCV=TCP_RECVSPACE,SACK=TCP_SACK,TCPCC=TCP_CONGESTION,"
+  "CON=CONSOLENAME,LOGF=LOGFILENAME,OPENGUI,REFRESH";
 
 /* extern declarations */
 
@@ -102,6 +106,8 @@ extern LONG usens;
 extern LONG useloopback;
 extern ULONG tcp_sendspace;
 extern ULONG tcp_recvspace;
+extern LONG tcp_do_sack;
+extern LONG tcp_cc_default;
 extern STRPTR consolename ;	 int logname_changed(void *pt, IPTR new);
 extern STRPTR logfilename;
 extern LONG OpenGUIOnStartup;
@@ -137,6 +143,8 @@ struct cfg_variable variables[] = {
 { VAR_ENUM, VF_RW, NULL, &useloopback, boolean_enum },
 { VAR_LONG, VF_RW, NULL, (LONG*)&tcp_sendspace, NULL },
 { VAR_LONG, VF_RW, NULL, (LONG*)&tcp_recvspace, NULL },
+{ VAR_ENUM, VF_RW, NULL, &tcp_do_sack, boolean_enum },
+{ VAR_ENUM, VF_RW, NULL, &tcp_cc_default, (notify_f)"NEWRENO,CUBIC" },
 { VAR_STRP, VF_RW, NULL, &consolename, logname_changed },
 { VAR_STRP, VF_RW, NULL, &logfilename, logname_changed },
 { VAR_ENUM, VF_RCONF, NULL, &OpenGUIOnStartup, boolean_enum },
@@ -129,15 +129,36 @@ int	max_datalen = 0;		/* MHLEN - max_hdr */
  * Header structure that is placed at the start of every allocated memory 
  * region to be freed on deinit. All memory alloctions are thus 
  * sizeof(memHeader) larger and the data pointer is set past this header
- * before used. These headers are linked together and the mbufmem pointer 
- * holds the pointer to the start of the list.
+ * before used. The headers are kept on one list per item class (mbufs and
+ * clusters), so that mb_trim() can tell which chunk a free item lives in
+ * and give chunks that have become entirely free back to the system.
  */
 struct memHeader {
   struct memHeader *next;
   ULONG             size;
+  caddr_t           start;	/* first item in this chunk */
+  caddr_t           end;	/* end of the last item */
+  ULONG             count;	/* # of items in this chunk */
+  ULONG             nfree;	/* scratch count used by mb_trim() */
 };
 
-static struct memHeader *mbufmem = NULL;
+static struct memHeader *mbufmem = NULL;	/* chunks of mbufs */
+static struct memHeader *clustmem = NULL;	/* chunks of clusters */
+
+/*
+ * The pools grow by the configured chunk size times these multipliers.
+ * A multiplier is doubled every time its free list runs dry, so that a
+ * burst of traffic needs few AllocMem() calls, and halved again by
+ * mb_trim() when the pool had spare items over a whole trim interval.
+ */
+#define MB_GROW_MAX 16
+
+#define _offsetof(t, m) ((IPTR)((caddr_t)&((t *)0)->m))
+
+static u_long mbufgrow = 1;
+static u_long clustgrow = 1;
+static BOOL   mbufgrown = FALSE;
+static BOOL   clustgrown = FALSE;
 
 static BOOL initialized = FALSE;
 
@@ -245,6 +266,22 @@ D(bug("[AROSTCP](uipc_mbuf.c) mbinit: Failed to allocate memory!\n"));
   return (initialized);
 }
 
+static void
+mb_freechunks(struct memHeader **list)
+{
+  struct memHeader *mh, *next;
+
+  for (mh = *list; mh; mh = next) {
+#if defined(__AROS__)
+D(bug("[AROSTCP](uipc_mbuf.c) mb_freechunks: Freeing %d bytes @ 0x%08x\n", mh->size, mh));
+#endif
+    next = mh->next;
+    mbstat.m_memused -= mh->size;
+    FreeMem(mh, mh->size);
+  }
+  *list = NULL;
+}
+
 /*
  * Free all memory allocated by mbuf subsystem. This must be the last mbuf
  * related function called. (Implying that NO mbuf allocations should be done
@@ -255,7 +292,6 @@ D(bug("[AROSTCP](uipc_mbuf.c) mbinit: Failed to allocate memory!\n"));
 void
 mbdeinit(void)
 {
-  struct memHeader *next;
 #if defined(__AROS__)
 D(bug("[AROSTCP](uipc_mbuf.c) mbdeinit()\n"));
 #endif
@@ -263,15 +299,11 @@ D(bug("[AROSTCP](uipc_mbuf.c) mbdeinit()\n"));
   /*
    * free all memory chunks
    */
-  while (mbufmem) {
-#if defined(__AROS__)
-D(bug("[AROSTCP](uipc_mbuf.c) mbdeinit: Freeing %d bytes @ 0x%08x\n", mbufmem, mbufmem->size));
-#endif
-    next = mbufmem->next;
-    mbstat.m_memused -= mbufmem->size;
-    FreeMem(mbufmem, mbufmem->size);
-    mbufmem = next;
-  }
+  mb_freechunks(&mbufmem);
+  mb_freechunks(&clustmem);
+  mfree = NULL;
+  mclfree = NULL;
+  mbufgrow = clustgrow = 1;
   initialized = FALSE;
 }
 
@@ -328,8 +360,8 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_alloc: Cannot allocate memory for mbufs\n"));
   mbstat.m_memused += size;		/* add to the total */
   mh->size = size;
   mh->next = mbufmem;
+  mh->count = howmany;
   mbufmem = mh;
-  mh++;				/* pass by the memHeader */
 
   /*
    * update the statistics
@@ -339,7 +371,9 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_alloc: Cannot allocate memory for mbufs\n"));
   /*
    * link mbufs into the free list
    */
-  m = dtom(((caddr_t)mh) + MSIZE - 1); /* correctly aligned mbuf pointer */
+  m = dtom(((caddr_t)(mh + 1)) + MSIZE - 1); /* correctly aligned mbuf pointer */
+  mh->start = (caddr_t)m;
+  mh->end = (caddr_t)(m + howmany);
   while(howmany--) {
     m->m_next = mfree;
     mfree = m++;
@@ -359,7 +393,7 @@ m_clalloc(int ncl, int canwait)
   struct memHeader *mh;
   struct mcluster *p;
   ULONG  size;
-  short  i;
+  int    i;
 #if defined(__AROS__)
 D(bug("[AROSTCP](uipc_mbuf.c) m_clalloc()\n"));
 #endif
@@ -400,24 +434,154 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_clalloc: Cannot allocate memory for mbuf cluster
    */
   mbstat.m_memused += size;
   mh->size = size;
-  mh->next = mbufmem;
-  mbufmem = mh;
-  mh++;				/* pass by the memHeader */
+  mh->next = clustmem;
+  mh->count = ncl;
+  clustmem = mh;
   /*
    * link clusters to the free list
    */
-  for (i = 0, p = (struct mcluster *)mh; 
+  for (i = 0, p = (struct mcluster *)(mh + 1); 
        i < ncl; 
        i++, p = (struct mcluster*)((char *)(p + 1) + mbconf.mclbytes)) {
     p->mcl.mcl_next = mclfree;
     mclfree = p;
     mbstat.m_clfree++;
   }
+  mh->start = (caddr_t)(mh + 1);
+  mh->end = (caddr_t)p;
   mbstat.m_clusters += ncl;
   
   return TRUE;
 }
 
+/*
+ * Called by MCLALLOC when the cluster free list is empty. Adds a chunk
+ * of clusters, sized by the current growth multiplier.
+ * MUST be called at splimp.
+ */
+BOOL
+m_clgrow(int canwait)
+{
+  if (m_clalloc(mbconf.clusterchunk * clustgrow, canwait)) {
+    clustgrown = TRUE;
+    if (clustgrow < MB_GROW_MAX)
+      clustgrow <<= 1;
+    return TRUE;
+  }
+  if (clustgrow > 1) {
+    /* close to the limit, try the plain chunk size */
+    clustgrow = 1;
+    return m_clalloc(mbconf.clusterchunk, canwait);
+  }
+  return FALSE;
+}
+
+/*
+ * Find the chunk an item belongs to.
+ */
+static struct memHeader *
+mb_findchunk(struct memHeader *mh, caddr_t item)
+{
+  for (; mh; mh = mh->next)
+    if (item >= mh->start && item < mh->end)
+      return mh;
+  return NULL;
+}
+
+/*
+ * Release chunks whose items are all on the free list, as long as at
+ * least 'keep' free items remain in the pool. Returns the number of
+ * items released. The free list is given as the address of its head and
+ * the offset of the link field in the item.
+ */
+static ULONG
+mb_trimchunks(struct memHeader **list, void **freelist, size_t linkoff,
+	      ULONG nfree, ULONG keep)
+{
+  struct memHeader *mh, **mhp, *dead = NULL;
+  void *item, **link;
+  ULONG released = 0;
+
+  for (mh = *list; mh; mh = mh->next)
+    mh->nfree = 0;
+
+  for (item = *freelist; item; item = *(void **)((caddr_t)item + linkoff))
+    if ((mh = mb_findchunk(*list, item)) != NULL)
+      mh->nfree++;
+
+  /*
+   * Unlink the chunks to be released. The oldest chunks are at the end
+   * of the list, so the most recently added ones go first.
+   */
+  for (mhp = list; (mh = *mhp) != NULL; ) {
+    if (mh->nfree == mh->count && nfree - mh->count >= keep) {
+      nfree -= mh->count;
+      released += mh->count;
+      *mhp = mh->next;
+      mh->next = dead;
+      dead = mh;
+    }
+    else
+      mhp = &mh->next;
+  }
+
+  if (dead == NULL)
+    return 0;
+
+  /*
+   * Drop the items of the released chunks from the free list
+   */
+  for (link = freelist; (item = *link) != NULL; ) {
+    if (mb_findchunk(dead, item))
+      *link = *(void **)((caddr_t)item + linkoff);
+    else
+      link = (void **)((caddr_t)item + linkoff);
+  }
+
+  mb_freechunks(&dead);
+  return released;
+}
+
+/*
+ * Give memory that is no longer needed back to the system. Called
+ * periodically from the timer. A reserve of two growth steps is always
+ * kept on each free list so that a pool does not oscillate.
+ */
+void
+mb_trim(void)
+{
+  struct mbuf *m;
+  ULONG nfree, n;
+  spl_t s;
+
+  if (!initialized)
+    return;
+
+  s = splimp();
+
+  if (!mbufgrown && mbufgrow > 1)
+    mbufgrow >>= 1;
+  if (!clustgrown && clustgrow > 1)
+    clustgrow >>= 1;
+
+  for (nfree = 0, m = mfree; m; m = m->m_next)
+    nfree++;
+  n = mb_trimchunks(&mbufmem, (void **)&mfree,
+		    _offsetof(struct mbuf, m_next),
+		    nfree, 2 * mbconf.mbufchunk * mbufgrow);
+  mbstat.m_mbufs -= n;
+
+  n = mb_trimchunks(&clustmem, (void **)&mclfree,
+		    _offsetof(struct mcluster, mcl.mcl_next),
+		    mbstat.m_clfree, 2 * mbconf.clusterchunk * clustgrow);
+  mbstat.m_clusters -= n;
+  mbstat.m_clfree -= n;
+
+  mbufgrown = clustgrown = FALSE;
+
+  splx(s);
+}
+
 /*
  * When MGET failes, ask protocols to free space when short of memory,
  * then re-attempt to allocate an mbuf.
@@ -439,8 +603,18 @@ D(bug("[AROSTCP](uipc_mbuf.c) m_retry()\n"));
   /*
    * Try to allocate more memory if still no free mbufs
    */
-  if (!mfree)
-    m_alloc(mbconf.mbufchunk, canwait);
+  if (!mfree) {
+    if (m_alloc(mbconf.mbufchunk * mbufgrow, canwait)) {
+      mbufgrown = TRUE;
+      if (mbufgrow < MB_GROW_MAX)
+	mbufgrow <<= 1;
+    }
+    else if (mbufgrow > 1) {
+      /* close to the limit, try the plain chunk size */
+      mbufgrow = 1;
+      m_alloc(mbconf.mbufchunk, canwait);
+    }
+  }
   
 #define m_retry(i, t)	/*mbstat.m_drops++,*/NULL
   MGET(m, canwait, type);
@@ -1250,9 +1250,7 @@ sohasoutofband(so)
 	else if (so->so_pgid > 0 && (p = pfind(so->so_pgid)) != 0)
 		psignal(p, SIGURG);
 #endif
-	if (so->so_rcv.sb_flags & SB_SEL) {
-		so->so_rcv.sb_flags &= ~SB_SEL; /* do not notify us any more */
-		selwakeup(&so->so_rcv.sb_sel);
-	}
+	if (so->so_interest)
+		soevq_wakeup(so);
 }
 
@@ -332,18 +332,6 @@ socantrcvmore(so)
  * Socket select/wakeup routines.
  */
 
-/*
- * Queue a process for a select on a socket buffer.
- */
-void
-sbselqueue(sb, cp)
-     struct sockbuf *sb;
-     struct SocketBase *cp;
-{
-  selenter(cp, &sb->sb_sel);
-  sb->sb_flags |= SB_SEL; /* notify us if something happens */
-}
-
 /*
  * Wait for data to arrive at/drain from a socket buffer.
  */
@@ -392,10 +380,8 @@ sowakeup(so, sb)
 #ifndef AMITCP
         struct proc *p;
 #endif
-	if (sb->sb_flags & SB_SEL) {
-		sb->sb_flags &= ~SB_SEL; /* do not notify us any more */
-		selwakeup(&sb->sb_sel);
-	}
+	if (so->so_interest)
+		soevq_wakeup(so);
 	if (sb->sb_flags & SB_WAIT) {
 		sb->sb_flags &= ~SB_WAIT;
 		wakeup((caddr_t)&sb->sb_cc);
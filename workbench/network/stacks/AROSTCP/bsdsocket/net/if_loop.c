@@ -112,6 +112,7 @@ loattach()
 	ifp->if_type = IFT_LOOP;
 	ifp->if_hdrlen = 0;
 	ifp->if_addrlen = 0;
+	ifp->if_hwassist = CSUM_IP | CSUM_DELAY_DATA;
 	if_attach(ifp);
 }
 
@@ -140,6 +141,13 @@ looutput(ifp, m, dst, rt)
 		panic("looutput no HDR");
 	m->m_pkthdr.rcvif = ifp;
 
+	/*
+	 * Nothing can corrupt the packet on the way, so checksums left
+	 * to the interface are not computed at all.
+	 */
+	if (m->m_pkthdr.csum_flags & (CSUM_IP | CSUM_DELAY_DATA))
+		m->m_pkthdr.csum_flags = CSUM_IP_CHECKED | CSUM_DATA_VALID;
+
 	if (rt && rt->rt_flags & RTF_REJECT) {
 		m_freem(m);
 		DROUTE(log(LOG_DEBUG,"lo0: packet rejected");)
@@ -363,6 +363,7 @@ D(bug("[AROSTCP:SANA] %s: IP set to 0.0.0.0\n", __func__));
 			*/
 			req->ios2_Req.io_Command   = S2_DEVICEQUERY;
 			req->ios2_StatData         = &devicequery;
+			aligned_bzero_const(&devicequery, sizeof(devicequery));
 			devicequery.SizeAvailable  = sizeof(devicequery);
 			devicequery.DevQueryFormat = 0L;
 
@@ -411,6 +412,15 @@ D(bug("[AROSTCP:SANA] %s: IP set to 0.0.0.0\n", __func__));
 						ssc->ss_maxmtu         = devicequery.MTU;
 						ssc->ss_if.if_baudrate = devicequery.BPS;
 						ssc->ss_hwtype         = devicequery.HardwareType;	
+
+						/*
+						 * Older drivers know nothing of the capabilities.
+						 * TCP and UDP checksums are computed while the
+						 * driver copies the packet if it cannot do it.
+						 */
+						if (devicequery.SizeSupplied >= sizeof(devicequery))
+							ssc->ss_caps = devicequery.Capabilities;
+						ssc->ss_if.if_hwassist = CSUM_DELAY_DATA;
 						
 						/* These might be different on different hwtypes */
 						ssc->ss_if.if_output = sana_output;
@@ -864,9 +874,17 @@ static struct mbuf *
 sana_read(struct sana_softc *ssc, struct IOIPReq *req, 
 	  UWORD  flags, UWORD *sent, const char *banner, size_t mtu)
 {
-  register struct mbuf *m = req->ioip_packet;
+  register struct mbuf *m;
   register spl_t s = splimp();
 
+  /* The driver may have used the DMA hook instead of copying */
+  if (req->ioip_flags & IOIPF_DMA) {
+    if (req->ioip_Error == 0 && req->ioip_packet == NULL)
+      ioip_dma_packet(req);
+    req->ioip_flags &= ~IOIPF_DMA;
+  }
+
+  m = req->ioip_packet;
   req->ioip_packet = NULL;
 
   switch (req->ioip_Error) {
@@ -875,6 +893,9 @@ sana_read(struct sana_softc *ssc, struct IOIPReq *req,
       m->m_flags |= M_BCAST;
     if (req->ioip_s2.ios2_Req.io_Flags & SANA2IOF_MCAST)
       m->m_flags |= M_MCAST;
+    if ((req->ioip_s2.ios2_Req.io_Flags & SANA2IOF_CSUM)
+	&& (ssc->ss_caps & S2CAPF_RXCSUM))
+      m->m_pkthdr.csum_flags = CSUM_IP_CHECKED | CSUM_DATA_VALID;
     ssc->ss_if.if_ibytes += req->ioip_s2.ios2_DataLength;
     break;
   case S2ERR_OUTOFSERVICE:
@@ -1118,6 +1139,10 @@ sana_output(struct ifnet *ifp, struct mbuf *m0,
     req->ioip_s2.ios2_Req.io_Message.mn_Node.ln_Pri =
       (IPTOS_LOWDELAY & mtod(m, struct ip *)->ip_tos) ?
 	1 : 0;
+    /* Let the driver fill in checksums, see m_copy_from_mbuf() */
+    if ((ssc->ss_caps & S2CAPF_TXCSUM)
+	&& (m->m_pkthdr.csum_flags & CSUM_DELAY_DATA))
+      req->ioip_s2.ios2_Req.io_Flags |= SANA2IOF_CSUM;
     break;
 #endif
 #if NS
@@ -48,8 +48,13 @@ struct IOIPReq {
   struct mbuf       *ioip_reserved;   /* reserved for packet */
   struct mbuf       *ioip_packet;     /* packet */
   struct IOIPReq    *ioip_next;	      /* allocation queue */
+  ULONG              ioip_flags;
 };
 
+/* ioip_flags */
+#define IOIPF_DMA 0x0001		/* driver placed the packet directly
+					   into the first reserved cluster */
+
 /*
  * A socket address for a generic SANA-II host
  */
@@ -114,6 +119,7 @@ struct sana_softc {
   UWORD           ss_rawsent;
   UWORD           ss_eventsent;	      /* sent event requests */
   UWORD           ss_maxmtu;	      /* limit given by device */
+  ULONG           ss_caps;	      /* S2CAPF_* from S2_DEVICEQUERY */
   UBYTE          *ss_execname;
   ULONG           ss_execunit;
   UBYTE           ss_name[IFNAMSIZ];
@@ -41,6 +41,7 @@
 #include <netinet/in_systm.h>
 #include <netinet/in_var.h>
 #include <netinet/ip.h>
+#include <netinet/in_cksum_protos.h>
 #endif
 
 #include <net/if_sana.h>
@@ -184,6 +185,10 @@ ioip_alloc_mbuf(struct IOIPReq *s2rp, ULONG MTU)
  * Copy data from an mbuf chain starting from the beginning,
  * continuing for "n" bytes, into the indicated continuous buffer.
  *
+ * A TCP or UDP checksum left to the interface (CSUM_DELAY_DATA) is
+ * computed while the data is copied and stored into the buffer, unless
+ * the driver does it itself (SANA2IOF_CSUM).
+ *
  * NOTE: this WILL be called from INTERRUPTS, so compile with stack checking
  *       disabled and use __saveds if near data is needed.
  */
@@ -199,6 +204,23 @@ AROS_UFH3(BOOL, m_copy_from_mbuf,
   AROS_USERFUNC_INIT
   register struct mbuf *m = from->ioip_packet;
   register unsigned count;
+  struct ip *ip = mtod(m, struct ip *);
+  BYTE *start = to;
+  int csum = m->m_pkthdr.csum_flags & CSUM_DELAY_DATA;
+  unsigned hlen = 0, skip, done = 0;
+  u_long sum = 0, s;
+  u_short th_sum;
+
+  if (from->ioip_s2.ios2_Req.io_Flags & SANA2IOF_CSUM)
+    csum = 0;
+  else if (csum && n != m->m_pkthdr.len) {
+    /* Not copying the whole datagram, no chance to sum it on the way */
+    in_delayed_cksum(m);
+    m->m_pkthdr.csum_flags &= ~CSUM_DELAY_DATA;
+    csum = 0;
+  }
+  if (csum)
+    hlen = ip->ip_hl << 2;
 
   while (n > 0) {
 #if DIAGNOSTIC
@@ -208,11 +230,40 @@ AROS_UFH3(BOOL, m_copy_from_mbuf,
     }
 #endif
     count = MIN(m->m_len, n);
-    bcopy(mtod(m, caddr_t), to, count);
+    if (csum) {
+      /* The IP header is not part of the sum */
+      skip = MIN(hlen - MIN(hlen, done), count);
+      bcopy(mtod(m, caddr_t), to, skip);
+      if (count > skip) {
+	s = in_cksum_copy(mtod(m, caddr_t) + skip, to + skip, count - skip);
+	if ((done - hlen + skip) & 1)
+	  s = ((s << 8) | (s >> 8)) & 0xffff;
+	sum += s;
+      }
+      done += count;
+    } else
+      bcopy(mtod(m, caddr_t), to, count);
     n -= count;
     to += count;
     m = m->m_next;
   }
+
+  if (csum) {
+    sum += in_pseudo(ip->ip_src.s_addr, ip->ip_dst.s_addr,
+		     htonl(ip->ip_p + done - hlen));
+    sum = (sum >> 16) + (sum & 0xffff);
+    sum += sum >> 16;
+    th_sum = ~sum;
+    if (csum & CSUM_UDP) {
+      if (th_sum == 0)
+	th_sum = 0xffff;
+      start += hlen + 6;		/* uh_sum */
+    } else
+      start += hlen + 16;		/* th_sum */
+    /* The buffer need not be aligned */
+    start[0] = ((BYTE *)&th_sum)[0];
+    start[1] = ((BYTE *)&th_sum)[1];
+  }
   return TRUE;
   AROS_USERFUNC_EXIT
 }
@@ -222,6 +273,9 @@ AROS_UFH3(BOOL, m_copy_from_mbuf,
  * starting from the beginning, continuing for "n" bytes.
  * Mbufs in the preallocated chain must have their m_len field set to maximum
  * amount of data that they can have.
+ *
+ * The data of an IP datagram is summed up while it is copied, so that
+ * tcp_input() and udp_input() need not read it again (CSUM_FRAME).
  * 
  * NOTE: this WILL be called from INTERRUPTS, so compile with stack checking
  *       disabled and use __saveds if near data is needed.
@@ -238,6 +292,8 @@ AROS_UFH3(BOOL, m_copy_to_mbuf,
   AROS_USERFUNC_INIT
   register struct mbuf *f, *m = to->ioip_reserved;
   unsigned totlen = n;
+  int csum = !(to->ioip_s2.ios2_Req.io_Flags & SANA2IOF_RAW);
+  u_long sum = 0, s;
 
 #if DIAGNOSTIC
   if (!(m->m_flags & M_PKTHDR)) {
@@ -260,7 +316,13 @@ AROS_UFH3(BOOL, m_copy_to_mbuf,
 #endif
     if (n < m->m_len)
       m->m_len = n;
-    bcopy(from, mtod(m, caddr_t), m->m_len);
+    if (csum) {
+      s = in_cksum_copy(from, mtod(m, caddr_t), m->m_len);
+      if ((totlen - n) & 1)
+	s = ((s << 8) | (s >> 8)) & 0xffff;
+      sum += s;
+    } else
+      bcopy(from, mtod(m, caddr_t), m->m_len);
     from += m->m_len;
     n -= m->m_len;
     if (n > 0)
@@ -278,6 +340,14 @@ AROS_UFH3(BOOL, m_copy_to_mbuf,
   to->ioip_packet->m_pkthdr.len = totlen; /* set packet length */
   to->ioip_reserved = f;		/* leftover mbufs */
 
+  if (csum) {
+    sum = (sum >> 16) + (sum & 0xffff);
+    sum += sum >> 16;
+    to->ioip_packet->m_pkthdr.csum_flags = CSUM_FRAME;
+    to->ioip_packet->m_pkthdr.csum_data = sum;
+  } else
+    to->ioip_packet->m_pkthdr.csum_flags = 0;
+
   /*
    * More mbuf flags and interface pointer must be set later
    */
@@ -285,9 +355,87 @@ AROS_UFH3(BOOL, m_copy_to_mbuf,
   AROS_USERFUNC_EXIT
 }
 
-struct TagItem buffermanagement[3] = {
+/*
+ * SANA-II DMA hook for received packets: return the data area of the
+ * first cluster reserved for the request, if a packet of the interface
+ * MTU fits in it. The driver then places the packet there itself instead of calling
+ * m_copy_to_mbuf(), and ioip_dma_packet() detaches it on reply.
+ *
+ * Returning NULL makes the driver fall back to the copy hook.
+ *
+ * NOTE: this WILL be called from INTERRUPTS.
+ */
+AROS_UFH1(ULONG *, m_dma_to_mbuf,
+   AROS_UFHA(struct IOIPReq *, to, A0))
+{
+  AROS_USERFUNC_INIT
+  register struct mbuf *m = to->ioip_reserved;
+
+  if (m == NULL || (m = m->m_next) == NULL || !(m->m_flags & M_EXT)
+      || to->ioip_s2.ios2_DataLength > m->m_ext.ext_size
+      || to->ioip_if->ss_if.if_mtu > m->m_ext.ext_size)
+    return NULL;
+
+  to->ioip_flags |= IOIPF_DMA;
+  return mtod(m, ULONG *);
+  AROS_USERFUNC_EXIT
+}
+
+/*
+ * SANA-II DMA hook for sent packets: when the whole packet is in one
+ * longword aligned mbuf the driver may transmit straight from it.
+ * The mbuf is not freed before the request has been replied.
+ * A checksum left to the interface has to be filled in first.
+ *
+ * NOTE: this WILL be called from INTERRUPTS.
+ */
+AROS_UFH1(ULONG *, m_dma_from_mbuf,
+   AROS_UFHA(struct IOIPReq *, from, A0))
+{
+  AROS_USERFUNC_INIT
+  register struct mbuf *m = from->ioip_packet;
+
+  if (m == NULL || m->m_next != NULL || (mtod(m, IPTR) & 3))
+    return NULL;
+
+  if ((m->m_pkthdr.csum_flags & CSUM_DELAY_DATA)
+      && !(from->ioip_s2.ios2_Req.io_Flags & SANA2IOF_CSUM)) {
+    in_delayed_cksum(m);
+    m->m_pkthdr.csum_flags &= ~CSUM_DELAY_DATA;
+  }
+  return mtod(m, ULONG *);
+  AROS_USERFUNC_EXIT
+}
+
+/*
+ * Detach a packet the driver wrote with m_dma_to_mbuf(). The cluster
+ * mbuf becomes the head of the packet (the header mbuf stays reserved),
+ * so the data is not moved.
+ */
+void
+ioip_dma_packet(struct IOIPReq *s2rp)
+{
+  register struct mbuf *m = s2rp->ioip_reserved;
+  register struct mbuf *n = m->m_next;
+
+  s2rp->ioip_flags &= ~IOIPF_DMA;
+
+  m->m_next = n->m_next;
+  n->m_next = NULL;
+  n->m_flags |= M_PKTHDR;
+  n->m_len = n->m_pkthdr.len = s2rp->ioip_s2.ios2_DataLength;
+  n->m_pkthdr.rcvif = NULL;
+  n->m_pkthdr.header = NULL;
+  n->m_pkthdr.csum_flags = 0;
+
+  s2rp->ioip_packet = n;
+}
+
+struct TagItem buffermanagement[5] = {
     { S2_CopyToBuff,   (IPTR)AROS_ASMSYMNAME(m_copy_to_mbuf) },
     { S2_CopyFromBuff, (IPTR)AROS_ASMSYMNAME(m_copy_from_mbuf) },
+    { S2_DMACopyToBuff32,   (IPTR)AROS_ASMSYMNAME(m_dma_to_mbuf) },
+    { S2_DMACopyFromBuff32, (IPTR)AROS_ASMSYMNAME(m_dma_from_mbuf) },
     { TAG_END, }
 };
 
@@ -30,6 +30,8 @@ extern struct TagItem buffermanagement[];
 
 BOOL
 ioip_alloc_mbuf(struct IOIPReq *s2rp, ULONG MTU);
+void
+ioip_dma_packet(struct IOIPReq *s2rp);
 
 /*
  * Allocate a new Sana-II IORequest for this task
@@ -62,116 +62,353 @@
 #include <sys/malloc.h>
 #include <sys/mbuf.h>
 
+#include <netinet/in.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CKSUM_NEON
+#endif
+
 #include <netinet/in_cksum_protos.h>
 
 /*
- * Checksum routine for Internet Protocol family headers (Portable Version).
+ * Checksum routines for Internet Protocol family headers.
  *
  * This routine is very heavily used in the network
  * code and should be modified for each CPU to be as fast as possible.
+ *
+ * The data is added up 32 bits at a time into a 64 bit accumulator, so
+ * the carries have to be folded back only once at the end.  With SSE2
+ * or NEON 64 bytes are added per iteration, each 32 bit word widened
+ * into one of two 64 bit lanes.
+ *
+ * The ones complement sum does not depend on the byte order, the words
+ * are added as they are in memory.  A block starting at an odd offset
+ * into the packet just has its sum byte swapped before it is added to
+ * the rest, swapping is the same as multiplying by 256 modulo 0xffff.
  */
 
-#define ADDCARRY(x)  (x > 65535 ? x -= 65535 : x)
-#define REDUCE {l_util.l = sum; sum = l_util.s[0] + l_util.s[1]; ADDCARRY(sum);}
+#define CKSUM_SWAP(s)	((((s) << 8) | ((s) >> 8)) & 0xffff)
 
-int
-in_cksum(m, len)
-	register struct mbuf *m;
-	register int len;
+static __inline u_int
+cksum_fold(sum)
+	u_int64_t sum;
 {
-	register u_short *w;
-	register int sum = 0;
-	register int mlen = 0;
-	int byte_swapped = 0;
+	sum = (sum >> 32) + (sum & 0xffffffff);
+	sum = (sum >> 32) + (sum & 0xffffffff);
+	sum = (sum >> 16) + (sum & 0xffff);
+	sum = (sum >> 16) + (sum & 0xffff);
+	return ((u_int)sum);
+}
 
+/*
+ * Add up the 32 bit words in the first len & ~3 bytes at the longword
+ * aligned address p.  If d is not NULL the data is copied there as
+ * well, d must be aligned the same way as p.
+ */
+static __inline u_int64_t
+cksum_words(p, d, len)
+	const u_char *p;
+	u_char *d;
+	int len;
+{
+	const u_int32_t *w = (const u_int32_t *)p;
+	u_int32_t *dw = (u_int32_t *)d;
+	u_int64_t sum = 0;
+
+#if defined(__SSE2__)
+	if (len >= 64) {
+		__m128i zero = _mm_setzero_si128();
+		__m128i acc = zero, a, b, c, e;
+		u_int64_t lanes[2];
+
+		do {
+			a = _mm_loadu_si128((const __m128i *)w);
+			b = _mm_loadu_si128((const __m128i *)w + 1);
+			c = _mm_loadu_si128((const __m128i *)w + 2);
+			e = _mm_loadu_si128((const __m128i *)w + 3);
+			if (dw != NULL) {
+				_mm_storeu_si128((__m128i *)dw, a);
+				_mm_storeu_si128((__m128i *)dw + 1, b);
+				_mm_storeu_si128((__m128i *)dw + 2, c);
+				_mm_storeu_si128((__m128i *)dw + 3, e);
+				dw += 16;
+			}
+			acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(a, zero));
+			acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(a, zero));
+			acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(b, zero));
+			acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(b, zero));
+			acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(c, zero));
+			acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(c, zero));
+			acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(e, zero));
+			acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(e, zero));
+			w += 16;
+			len -= 64;
+		} while (len >= 64);
+		_mm_storeu_si128((__m128i *)lanes, acc);
+		sum = lanes[0] + lanes[1];
+	}
+#elif defined(CKSUM_NEON)
+	if (len >= 64) {
+		uint64x2_t acc = vdupq_n_u64(0);
+		uint32x4_t a, b, c, e;
+
+		do {
+			a = vld1q_u32(w);
+			b = vld1q_u32(w + 4);
+			c = vld1q_u32(w + 8);
+			e = vld1q_u32(w + 12);
+			if (dw != NULL) {
+				vst1q_u32(dw, a);
+				vst1q_u32(dw + 4, b);
+				vst1q_u32(dw + 8, c);
+				vst1q_u32(dw + 12, e);
+				dw += 16;
+			}
+			acc = vpadalq_u32(acc, a);
+			acc = vpadalq_u32(acc, b);
+			acc = vpadalq_u32(acc, c);
+			acc = vpadalq_u32(acc, e);
+			w += 16;
+			len -= 64;
+		} while (len >= 64);
+		sum = vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+	}
+#endif
+	if (dw != NULL) {
+		while (len >= 4) {
+			sum += *dw++ = *w++;
+			len -= 4;
+		}
+		return (sum);
+	}
+	/*
+	 * Unroll the loop to make overhead from
+	 * branches &c small.
+	 */
+	while (len >= 32) {
+		sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
+		sum += w[4]; sum += w[5]; sum += w[6]; sum += w[7];
+		w += 8;
+		len -= 32;
+	}
+	while (len >= 4) {
+		sum += *w++;
+		len -= 4;
+	}
+	return (sum);
+}
+
+/*
+ * Ones complement sum of len bytes at buf, folded to 16 bits but not
+ * complemented, as if buf started at an even offset of the packet.
+ * If dst is not NULL the data is copied there at the same time.
+ */
+static u_int
+cksum_data(p, d, len)
+	const u_char *p;
+	u_char *d;
+	int len;
+{
+	u_int64_t sum = 0;
+	int odd = 0, n;
 	union {
-		char	c[2];
+		u_char	c[2];
 		u_short	s;
 	} s_util;
-	union {
-		u_short s[2];
-		long	l;
-	} l_util;
 
-	for (;m && len; m = m->m_next) {
-		if (m->m_len == 0)
-			continue;
-		w = mtod(m, u_short *);
-		if (mlen == -1) {
+	if (len <= 0)
+		return (0);
+	/*
+	 * Force to even boundary, the first byte is then the second
+	 * half of a word and the sum comes out byte swapped.
+	 */
+	if (1 & (long)p) {
+		s_util.c[0] = 0;
+		s_util.c[1] = *p;
+		if (d != NULL)
+			*d++ = *p;
+		sum = s_util.s;
+		p++;
+		len--;
+		odd = 1;
+	}
+	if ((2 & (long)p) && len >= 2) {
+		if (d != NULL) {
+			d[0] = p[0];
+			d[1] = p[1];
+			d += 2;
+		}
+		sum += *(const u_short *)p;
+		p += 2;
+		len -= 2;
+	}
+	if (len >= 4) {
+		n = len & ~3;
+		if (d != NULL && ((long)d & 3) != 0) {
 			/*
-			 * The first byte of this mbuf is the continuation
-			 * of a word spanning between this mbuf and the
-			 * last mbuf.
-			 *
-			 * s_util.c[0] is already saved when scanning previous 
-			 * mbuf.
+			 * Destination aligned differently, the copy is
+			 * left to bcopy() and the words are added while
+			 * they are still in the cache.
 			 */
-			s_util.c[1] = *(char *)w;
-			sum += s_util.s;
-			w = (u_short *)((char *)w + 1);
-			mlen = m->m_len - 1;
-			len--;
+			bcopy(p, d, n);
+			sum += cksum_words(p, NULL, n);
 		} else
-			mlen = m->m_len;
+			sum += cksum_words(p, d, n);
+		p += n;
+		if (d != NULL)
+			d += n;
+		len -= n;
+	}
+	if (len >= 2) {
+		if (d != NULL) {
+			d[0] = p[0];
+			d[1] = p[1];
+			d += 2;
+		}
+		sum += *(const u_short *)p;
+		p += 2;
+		len -= 2;
+	}
+	if (len) {
+		/* The odd byte is the first half of a word */
+		s_util.c[0] = *p;
+		s_util.c[1] = 0;
+		if (d != NULL)
+			*d = *p;
+		sum += s_util.s;
+	}
+	n = cksum_fold(sum);
+	return (odd ? CKSUM_SWAP(n) : n);
+}
+
+u_int
+in_cksumdata(buf, len)
+	const void *buf;
+	int len;
+{
+	return (cksum_data(buf, NULL, len));
+}
+
+/*
+ * Copy len bytes from src to dst and return the sum of the data, the
+ * same as in_cksumdata(src, len) would.  Used where a packet is copied
+ * anyway, so it is read only once.
+ */
+u_int
+in_cksum_copy(src, dst, len)
+	const void *src;
+	void *dst;
+	int len;
+{
+	return (cksum_data(src, dst, len));
+}
+
+/*
+ * Sum of len bytes of the mbuf chain starting off bytes into it, folded
+ * to 16 bits but not complemented.
+ */
+u_int
+in_cksum_skip(m, len, off)
+	register struct mbuf *m;
+	register int len;
+	int off;
+{
+	u_int64_t sum = 0;
+	u_int s;
+	int mlen, done = 0;
+
+	for (; m && off >= m->m_len; m = m->m_next)
+		off -= m->m_len;
+	for (; m && len; m = m->m_next, off = 0) {
+		mlen = m->m_len - off;
+		if (mlen <= 0)
+			continue;
 		if (len < mlen)
 			mlen = len;
+		s = in_cksumdata(mtod(m, u_char *) + off, mlen);
+		/* Continues a word spanning from the last mbuf */
+		if (done & 1)
+			s = CKSUM_SWAP(s);
+		sum += s;
+		done += mlen;
 		len -= mlen;
-		/*
-		 * Force to even boundary.
-		 */
-		if ((1 & (long) w) && (mlen > 0)) {
-			REDUCE;
-			sum <<= 8;
-			s_util.c[0] = *(u_char *)w;
-			w = (u_short *)((char *)w + 1);
-			mlen--;
-			byte_swapped = 1;
-		}
-		/*
-		 * Unroll the loop to make overhead from
-		 * branches &c small.
-		 */
-		while ((mlen -= 32) >= 0) {
-			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
-			sum += w[4]; sum += w[5]; sum += w[6]; sum += w[7];
-			sum += w[8]; sum += w[9]; sum += w[10]; sum += w[11];
-			sum += w[12]; sum += w[13]; sum += w[14]; sum += w[15];
-			w += 16;
-		}
-		mlen += 32;
-		while ((mlen -= 8) >= 0) {
-			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
-			w += 4;
-		}
-		mlen += 8;
-		if (mlen == 0 && byte_swapped == 0)
-			continue;
-		REDUCE;
-		while ((mlen -= 2) >= 0) {
-			sum += *w++;
-		}
-		if (byte_swapped) {
-			REDUCE;
-			sum <<= 8;
-			byte_swapped = 0;
-			if (mlen == -1) {
-				s_util.c[1] = *(char *)w;
-				sum += s_util.s;
-				mlen = 0;
-			} else
-				mlen = -1;
-		} else if (mlen == -1)
-			s_util.c[0] = *(char *)w;
 	}
 	if (len)
 		printf("cksum: out of data\n");
-	if (mlen == -1) {
-		/* The last mbuf has odd # of bytes. Follow the
-		   standard (the odd byte may be shifted left by 8 bits
-		   or not as determined by endian-ness of the machine) */
-		s_util.c[1] = 0;
-		sum += s_util.s;
+	return (cksum_fold(sum));
+}
+
+int
+in_cksum(m, len)
+	register struct mbuf *m;
+	register int len;
+{
+	return (~in_cksum_skip(m, len, 0) & 0xffff);
+}
+
+/*
+ * Sum of three 32 bit words in network byte order, used for the TCP and
+ * UDP pseudo header: in_pseudo(src, dst, htonl(proto + len)).
+ */
+u_int
+in_pseudo(a, b, c)
+	u_int32_t a, b, c;
+{
+	return (cksum_fold((u_int64_t)a + b + c));
+}
+
+/*
+ * Check a received TCP or UDP datagram against the sum the interface
+ * computed while copying it (CSUM_FRAME), using the pseudo header words
+ * as for in_pseudo().  Zero if the checksum is correct.
+ */
+int
+in_cksum_frame(m, a, b, c)
+	struct mbuf *m;
+	u_int32_t a, b, c;
+{
+	return (~cksum_fold((u_int64_t)m->m_pkthdr.csum_data + a + b + c) &
+	    0xffff);
+}
+
+/*
+ * Fill in the TCP or UDP checksum of an outgoing datagram that was left
+ * to the interface (CSUM_DELAY_DATA in the packet header).  The IP
+ * header must be complete apart from its own checksum, the length of
+ * the datagram is taken from the packet header.
+ */
+void
+in_delayed_cksum(m)
+	struct mbuf *m;
+{
+	struct ip *ip = mtod(m, struct ip *);
+	int hlen = ip->ip_hl << 2;
+	int len = m->m_pkthdr.len - hlen;
+	u_short csum;
+	u_char *p = (u_char *)&csum;
+	int off, i;
+
+	csum = ~cksum_fold((u_int64_t)in_cksum_skip(m, len, hlen) +
+	    in_pseudo(ip->ip_src.s_addr, ip->ip_dst.s_addr,
+	    htonl(ip->ip_p + len)));
+	if (m->m_pkthdr.csum_flags & CSUM_UDP) {
+		off = hlen + 6;			/* uh_sum */
+		if (csum == 0)
+			csum = 0xffff;
+	} else
+		off = hlen + 16;		/* th_sum */
+
+	/* The transport header may follow options in another mbuf */
+	for (i = 0; i < sizeof(csum); i++) {
+		while (off >= m->m_len) {
+			off -= m->m_len;
+			m = m->m_next;
+		}
+		mtod(m, u_char *)[off++] = p[i];
 	}
-	REDUCE;
-	return (~sum & 0xffff);
 }
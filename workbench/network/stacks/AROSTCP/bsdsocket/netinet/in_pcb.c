@@ -312,7 +312,7 @@ in_pcbconnect(inp, nam)
 
 	if (in_pcblookuphash(inp->inp_pcbinfo, sin->sin_addr, sin->sin_port,
 	    inp->inp_laddr.s_addr ? inp->inp_laddr : ifaddr->sin_addr,
-	    inp->inp_lport) != NULL)
+	    inp->inp_lport, 0) != NULL)
 		return (EADDRINUSE);
 	if (inp->inp_laddr.s_addr == INADDR_ANY) {
 		if (inp->inp_lport == 0)
@@ -354,6 +354,9 @@ in_pcbdetach(inp)
 	ip_freemoptions(inp->inp_moptions);
 #endif
 	s = splnet();
+	if (inp->inp_pcbinfo->lasthit == inp)
+		inp->inp_pcbinfo->lasthit = NULL;
+	inp->inp_pcbinfo->hashcount--;
 	LIST_REMOVE(inp, inp_hash);
 	LIST_REMOVE(inp, inp_list);
 	splx(s);
@@ -558,15 +561,21 @@ in_pcblookup(head, faddr, fport_arg, laddr, lport_arg, flags)
 
 /*
  * Lookup PCB in hash list.
+ *
+ * An exact match is cached in pcbinfo->lasthit for INP_LASTHIT().  With
+ * INPLOOKUP_WILDCARD a listening or unconnected PCB bound to the local
+ * port is returned if there is no exact match, one bound to laddr is
+ * preferred over one bound to INADDR_ANY.
  */
 struct inpcb *
-in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg)
+in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg, flags)
 	struct inpcbinfo *pcbinfo;
 	struct in_addr faddr, laddr;
 	u_int fport_arg, lport_arg;
+	int flags;
 {
 	struct inpcbhead *head;
-	register struct inpcb *inp;
+	register struct inpcb *inp, *local_wild = NULL;
 	u_short fport = fport_arg, lport = lport_arg;
 	int s;
 
@@ -574,7 +583,8 @@ in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg)
 	/*
 	 * First look for an exact match.
 	 */
-	head = &pcbinfo->hashbase[(faddr.s_addr + lport + fport) % pcbinfo->hashsize];
+	head = &pcbinfo->hashbase[INP_PCBHASH(faddr.s_addr, lport, fport,
+	    pcbinfo->hashmask)];
 
 	for (inp = head->lh_first; inp != NULL; inp = inp->inp_hash.le_next) {
 		if (inp->inp_faddr.s_addr != faddr.s_addr ||
@@ -590,10 +600,67 @@ in_pcblookuphash(pcbinfo, faddr, fport_arg, laddr, lport_arg)
 			LIST_REMOVE(inp, inp_hash);
 			LIST_INSERT_HEAD(head, inp, inp_hash);
 		}
-		break;
+		pcbinfo->lasthit = inp;
+		splx(s);
+		return (inp);
+	}
+	if ((flags & INPLOOKUP_WILDCARD) == 0) {
+		splx(s);
+		return (NULL);
+	}
+	/*
+	 * ...and if that fails, look for a PCB that is not connected.
+	 */
+	head = &pcbinfo->hashbase[INP_PCBHASH(INADDR_ANY, lport, 0,
+	    pcbinfo->hashmask)];
+
+	for (inp = head->lh_first; inp != NULL; inp = inp->inp_hash.le_next) {
+		if (inp->inp_faddr.s_addr != INADDR_ANY ||
+		    inp->inp_fport != 0 ||
+		    inp->inp_lport != lport)
+			continue;
+		if (inp->inp_laddr.s_addr == laddr.s_addr)
+			break;
+		if (inp->inp_laddr.s_addr == INADDR_ANY && local_wild == NULL)
+			local_wild = inp;
 	}
 	splx(s);
-	return (inp);
+	return (inp != NULL ? inp : local_wild);
+}
+
+/*
+ * Double the number of hash chains, called at splnet when the chains
+ * have become too long.  If memory is short we simply carry on with
+ * the old table.
+ */
+static void
+in_pcbhashgrow(pcbinfo)
+	struct inpcbinfo *pcbinfo;
+{
+	struct inpcbhead *hashbase, *head;
+	struct inpcb *inp;
+	u_long hashmask, i;
+
+	hashmask = (pcbinfo->hashmask << 1) | 1;
+	hashbase = bsd_malloc((hashmask + 1) * sizeof(*hashbase), M_PCB,
+	    M_NOWAIT);
+	if (hashbase == NULL)
+		return;
+	for (i = 0; i <= hashmask; i++)
+		LIST_INIT(&hashbase[i]);
+
+	/*
+	 * Every PCB on the protocol list is also on a hash chain.
+	 */
+	for (inp = pcbinfo->listhead->lh_first; inp != NULL;
+	    inp = inp->inp_list.le_next) {
+		head = &hashbase[INP_PCBHASH(inp->inp_faddr.s_addr,
+		    inp->inp_lport, inp->inp_fport, hashmask)];
+		LIST_INSERT_HEAD(head, inp, inp_hash);
+	}
+	bsd_free(pcbinfo->hashbase, M_PCB);
+	pcbinfo->hashbase = hashbase;
+	pcbinfo->hashmask = hashmask;
 }
 
 /*
@@ -603,26 +670,32 @@ void
 in_pcbinshash(inp)
 	struct inpcb *inp;
 {
+	struct inpcbinfo *pcbinfo = inp->inp_pcbinfo;
 	struct inpcbhead *head;
 
-	head = &inp->inp_pcbinfo->hashbase[(inp->inp_faddr.s_addr +
-		inp->inp_lport + inp->inp_fport) % inp->inp_pcbinfo->hashsize];
+	head = &pcbinfo->hashbase[INP_PCBHASH(inp->inp_faddr.s_addr,
+	    inp->inp_lport, inp->inp_fport, pcbinfo->hashmask)];
 
 	LIST_INSERT_HEAD(head, inp, inp_hash);
+
+	if (++pcbinfo->hashcount > 2 * (pcbinfo->hashmask + 1) &&
+	    pcbinfo->hashmask + 1 < INP_PCBHASHMAX)
+		in_pcbhashgrow(pcbinfo);
 }
 
 void
 in_pcbrehash(inp)
 	struct inpcb *inp;
 {
+	struct inpcbinfo *pcbinfo = inp->inp_pcbinfo;
 	struct inpcbhead *head;
 	int s;
 
 	s = splnet();
 	LIST_REMOVE(inp, inp_hash);
 
-	head = &inp->inp_pcbinfo->hashbase[(inp->inp_faddr.s_addr +
-		inp->inp_lport + inp->inp_fport) % inp->inp_pcbinfo->hashsize];
+	head = &pcbinfo->hashbase[INP_PCBHASH(inp->inp_faddr.s_addr,
+	    inp->inp_lport, inp->inp_fport, pcbinfo->hashmask)];
 
 	LIST_INSERT_HEAD(head, inp, inp_hash);
 	splx(s);
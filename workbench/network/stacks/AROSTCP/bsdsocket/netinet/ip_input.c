@@ -239,10 +239,18 @@ next:
 		}
 		ip = mtod(m, struct ip *);
 	}
-	if (ip->ip_sum = in_cksum(m, hlen)) {
+	if ((m->m_pkthdr.csum_flags & CSUM_IP_CHECKED) == 0 &&
+	    (ip->ip_sum = in_cksum(m, hlen))) {
 		ipstat.ips_badsum++;
 		goto bad;
 	}
+	/*
+	 * The sum of the whole datagram equals the sum of the transport
+	 * data once the header is known to be correct, but not when the
+	 * options are going to be changed or removed.
+	 */
+	if (hlen > sizeof (struct ip))
+		m->m_pkthdr.csum_flags &= ~CSUM_FRAME;
 
 	/*
 	 * Convert fields to host representation.
@@ -266,6 +274,7 @@ next:
 		goto bad;
 	}
 	if (m->m_pkthdr.len > ip->ip_len) {
+		m->m_pkthdr.csum_flags &= ~CSUM_FRAME;
 		if (m->m_len == m->m_pkthdr.len) {
 			m->m_len = ip->ip_len;
 			m->m_pkthdr.len = ip->ip_len;
@@ -343,6 +352,8 @@ ours:
 	 * but it's not worth the time; just let them time out.)
 	 */
 	if (ip->ip_off &~ IP_DF) {
+		/* The checksum states are for this fragment only */
+		m->m_pkthdr.csum_flags &= ~(CSUM_FRAME | CSUM_DATA_VALID);
 		if (m->m_flags & M_EXT) {		/* XXX */
 			if ((m = m_pullup(m, sizeof (struct ip))) == 0) {
 				ipstat.ips_toosmall++;
@@ -93,7 +93,7 @@ int	STKARGFUN ip_output(void *args, ...)
 	register struct ifnet *ifp;
 	register struct mbuf *m = m0;
 	register int hlen = sizeof (struct ip);
-	int len, off, error = 0;
+	int len, off, error = 0, sw_csum;
 	struct route iproute;
 	struct sockaddr_in *dst;
 	struct in_ifaddr *ia;
@@ -316,6 +316,20 @@ sendit:
 	/* Run through list of hooks */
         pfil_run_hooks(m, ifp, MIAMIPFBPT_IP);
 
+	/*
+	 * Compute the checksums the interface does not do itself,
+	 * all of them if the datagram has to be fragmented.
+	 */
+	m->m_pkthdr.csum_flags &= CSUM_DELAY_DATA;
+	if ((u_short)ip->ip_len <= ifp->if_mtu) {
+		m->m_pkthdr.csum_flags |= CSUM_IP;
+		sw_csum = m->m_pkthdr.csum_flags & ~ifp->if_hwassist;
+	} else
+		sw_csum = m->m_pkthdr.csum_flags;
+	if (sw_csum & CSUM_DELAY_DATA)
+		in_delayed_cksum(m);
+	m->m_pkthdr.csum_flags &= ~sw_csum;
+
 	/*
 	 * If small enough for interface, can just send directly.
 	 */
@@ -323,7 +337,8 @@ sendit:
 		ip->ip_len = htons((u_short)ip->ip_len);
 		ip->ip_off = htons((u_short)ip->ip_off);
 		ip->ip_sum = 0;
-		ip->ip_sum = in_cksum(m, hlen);
+		if (sw_csum & CSUM_IP)
+			ip->ip_sum = in_cksum(m, hlen);
 		error = (*ifp->if_output)(ifp, m,
 				(struct sockaddr *)dst, ro->ro_rt);
 		goto done;
@@ -452,6 +467,7 @@ ip_insertoptions(m, opt, phlen)
 		if (n == 0)
 			return (m);
 		n->m_pkthdr.len = m->m_pkthdr.len + optlen;
+		n->m_pkthdr.csum_flags = m->m_pkthdr.csum_flags;
 		m->m_len -= sizeof(struct ip);
 		m->m_data += sizeof(struct ip);
 		n->m_next = m;
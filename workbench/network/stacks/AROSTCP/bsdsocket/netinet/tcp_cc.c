@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2025 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Pluggable congestion control.
+ *
+ * tcp_input() and the retransmit timer only decide *when* the window
+ * has to change (new data acked, loss detected, recovery finished,
+ * restart after idle), the algorithm attached to the connection
+ * decides by how much.  The default for new connections is selected
+ * with the TCP_CONGESTION configuration variable, a socket can pick its
+ * own with the TCP_CONGESTION socket option.
+ *
+ * NewReno is the classic 4.4BSD behaviour, CUBIC follows RFC 8312 with
+ * integer arithmetic: windows are in bytes and times in milliseconds
+ * of tcp_ts_getticks().
+ */
+
+#include <conf.h>
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/malloc.h>
+#include <sys/mbuf.h>
+#include <sys/socket.h>
+#include <sys/socketvar.h>
+#include <sys/protosw.h>
+#include <sys/errno.h>
+#include <sys/queue.h>
+
+#include <net/route.h>
+
+#include <netinet/in.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <netinet/in_pcb.h>
+#include <netinet/ip_var.h>
+#include <netinet/tcp.h>
+#include <netinet/tcp_fsm.h>
+#include <netinet/tcp_seq.h>
+#include <netinet/tcp_timer.h>
+#include <netinet/tcp_var.h>
+#include <netinet/tcpip.h>
+
+int	tcp_cc_default = 1;		/* CUBIC */
+
+/*
+ * NewReno.
+ */
+static void
+newreno_init(tp)
+	struct tcpcb *tp;
+{
+}
+
+/*
+ * When new data is acked, open the congestion window.
+ * If the window gives us less than ssthresh packets
+ * in flight, open exponentially (maxseg per packet).
+ * Otherwise open linearly: maxseg per window
+ * (maxseg^2 / cwnd per packet).
+ */
+static void
+newreno_ack_received(tp, acked)
+	struct tcpcb *tp;
+	u_long acked;
+{
+	register u_int cw = tp->snd_cwnd;
+	register u_int incr = tp->t_maxseg;
+
+	if (cw > tp->snd_ssthresh)
+		incr = incr * incr / cw;
+	tp->snd_cwnd = MIN(cw + incr, TCP_MAXWIN<<tp->snd_scale);
+}
+
+/*
+ * We know we're losing at the current window size so do congestion
+ * avoidance: set ssthresh to half the current window.  After a timeout
+ * also close the window to one segment, i.e. slow start.
+ */
+static void
+newreno_cong_signal(tp, type)
+	struct tcpcb *tp;
+	int type;
+{
+	u_int win = MIN(tp->snd_wnd, tp->snd_cwnd) / 2 / tp->t_maxseg;
+
+	if (win < 2)
+		win = 2;
+	tp->snd_ssthresh = win * tp->t_maxseg;
+	if (type == CC_RTO)
+		tp->snd_cwnd = tp->t_maxseg;
+}
+
+static void
+newreno_post_recovery(tp)
+	struct tcpcb *tp;
+{
+	if (tp->snd_cwnd > tp->snd_ssthresh)
+		tp->snd_cwnd = tp->snd_ssthresh;
+}
+
+/*
+ * We have been idle for "a while" and no acks are expected to clock
+ * out any data we send -- slow start to get ack "clock" running again.
+ */
+static void
+newreno_after_idle(tp)
+	struct tcpcb *tp;
+{
+	tp->snd_cwnd = tp->t_maxseg;
+}
+
+static struct tcp_cc_algo newreno = {
+	"newreno",
+	newreno_init,
+	newreno_ack_received,
+	newreno_cong_signal,
+	newreno_post_recovery,
+	newreno_after_idle
+};
+
+/*
+ * CUBIC, RFC 8312.  After a reduction the window grows along
+ *
+ *	W(t) = C * (t - K)^3 + W_max
+ *
+ * with C = 0.4 segments/s^3 and K the time it takes to get back to
+ * W_max, first concave up to W_max and then convex beyond it.  The
+ * window is never allowed to grow slower than Reno would (W_est).
+ */
+#define	CUBIC_BETA_NUM	7		/* beta = 0.7 */
+#define	CUBIC_BETA_DEN	10
+#define	CUBIC_MAXDELTA	60000		/* clamp |t - K| to a minute */
+
+static u_long
+cubic_cbrt(x)
+	u_int64_t x;
+{
+	u_int64_t y = 0, b;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		y <<= 1;
+		b = 3 * y * (y + 1) + 1;
+		if ((x >> s) >= b) {
+			x -= b << s;
+			y++;
+		}
+	}
+	return ((u_long)y);
+}
+
+static void
+cubic_init(tp)
+	struct tcpcb *tp;
+{
+	tp->t_cc_wmax = 0;
+	tp->t_cc_wlastmax = 0;
+	tp->t_cc_k = 0;
+	tp->t_cc_epoch = 0;
+	tp->t_cc_wtcp = 0;
+}
+
+static void
+cubic_ack_received(tp, acked)
+	struct tcpcb *tp;
+	u_long acked;
+{
+	u_long cw = tp->snd_cwnd;
+	u_long mss = tp->t_maxseg;
+	u_long now, target;
+	int64_t d, w;
+	u_long incr;
+
+	/* Slow start is the same as Reno */
+	if (cw <= tp->snd_ssthresh) {
+		newreno_ack_received(tp, acked);
+		return;
+	}
+
+	now = tcp_ts_getticks();
+	if (tp->t_cc_epoch == 0) {
+		tp->t_cc_epoch = now ? now : 1;
+		if (cw < tp->t_cc_wmax)
+			/* K = cbrt((W_max - cwnd) / C), in ms */
+			tp->t_cc_k = cubic_cbrt((u_int64_t)(tp->t_cc_wmax - cw) *
+			    2500000000ULL / mss);
+		else {
+			tp->t_cc_k = 0;
+			tp->t_cc_wmax = cw;
+		}
+		tp->t_cc_wtcp = cw;
+	}
+
+	/* Where the curve will be one rtt from now */
+	d = (int64_t)(now - tp->t_cc_epoch) + (int64_t)tp->t_rttbest -
+	    (int64_t)tp->t_cc_k;
+	if (d > CUBIC_MAXDELTA)
+		d = CUBIC_MAXDELTA;
+	else if (d < -CUBIC_MAXDELTA)
+		d = -CUBIC_MAXDELTA;
+	w = (int64_t)tp->t_cc_wmax +
+	    (d * d * d / 1000) * 4 * (int64_t)mss / 10000000;
+	if (w < (int64_t)cw)
+		target = cw;
+	else if (w > (int64_t)(cw + cw / 2))
+		target = cw + cw / 2;
+	else
+		target = (u_long)w;
+
+	/* TCP friendly region, W_est grows by 3(1-beta)/(1+beta) per rtt */
+	tp->t_cc_wtcp += (u_int64_t)acked * mss * 9 / (17 * tp->t_cc_wtcp);
+	if (tp->t_cc_wtcp > target)
+		target = tp->t_cc_wtcp;
+
+	if (target > cw) {
+		incr = (u_int64_t)(target - cw) * mss / cw;
+		tp->snd_cwnd = MIN(cw + incr, TCP_MAXWIN<<tp->snd_scale);
+	}
+}
+
+static void
+cubic_cong_signal(tp, type)
+	struct tcpcb *tp;
+	int type;
+{
+	u_long cw = tp->snd_cwnd;
+	u_long mss = tp->t_maxseg;
+
+	/* Fast convergence: release bandwidth to newer flows */
+	if (cw < tp->t_cc_wlastmax) {
+		tp->t_cc_wlastmax = cw;
+		tp->t_cc_wmax = cw / 20 * (CUBIC_BETA_DEN + CUBIC_BETA_NUM);
+	} else
+		tp->t_cc_wlastmax = tp->t_cc_wmax = cw;
+
+	tp->snd_ssthresh = MAX(cw / CUBIC_BETA_DEN * CUBIC_BETA_NUM, 2 * mss);
+	tp->t_cc_epoch = 0;
+	if (type == CC_RTO)
+		tp->snd_cwnd = mss;
+}
+
+static void
+cubic_post_recovery(tp)
+	struct tcpcb *tp;
+{
+	tp->snd_cwnd = tp->snd_ssthresh;
+	tp->t_cc_epoch = 0;
+}
+
+static void
+cubic_after_idle(tp)
+	struct tcpcb *tp;
+{
+	tp->snd_cwnd = tp->t_maxseg;
+	tp->t_cc_epoch = 0;
+}
+
+static struct tcp_cc_algo cubic = {
+	"cubic",
+	cubic_init,
+	cubic_ack_received,
+	cubic_cong_signal,
+	cubic_post_recovery,
+	cubic_after_idle
+};
+
+/*
+ * In the order of the TCP_CONGESTION configuration variable.
+ */
+struct tcp_cc_algo *tcp_cc_algos[] = {
+	&newreno,
+	&cubic,
+	NULL
+};
+
+/*
+ * Attach the default algorithm to a new connection.
+ */
+void
+tcp_cc_init(tp)
+	struct tcpcb *tp;
+{
+	int i = tcp_cc_default;
+
+	if (i < 0 || i >= sizeof(tcp_cc_algos) / sizeof(tcp_cc_algos[0]) - 1)
+		i = 0;
+	tp->t_cc = tcp_cc_algos[i];
+	(*tp->t_cc->cc_init)(tp);
+}
+
+struct tcp_cc_algo *
+tcp_cc_lookup(name)
+	const char *name;
+{
+	struct tcp_cc_algo **cc;
+
+	for (cc = tcp_cc_algos; *cc; cc++)
+		if (strcmp((*cc)->name, name) == 0)
+			return (*cc);
+	return (NULL);
+}
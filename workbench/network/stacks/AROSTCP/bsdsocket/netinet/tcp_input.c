@@ -85,6 +85,9 @@ struct inpcbinfo tcbinfo;
 #include <kern/uipc_socket2_protos.h>
 //#include <netinet/tcp_subr_protos.h>
 
+static void	 tcp_rtt_update __P((struct tcpcb *, struct tcpopt *, tcp_seq));
+static void	 tcp_newreno_partial_ack __P((struct tcpcb *, struct tcpiphdr *));
+
 /*
  * Insert segment ti into reassembly queue of tcp with
  * control block tp.  Return TH_FIN if reassembly now includes
@@ -174,6 +177,7 @@ tcp_reass(tp, ti, m)
         }
         tcpstat.tcps_rcvoopack++;
         tcpstat.tcps_rcvoobyte += ti->ti_len;
+        tp->t_rcvoopack++;
 
         /*
          * While we overlap succeeding segments trim them or,
@@ -295,7 +299,13 @@ void tcp_input(void *arg, ...)
 	bzero(ti->ti_x1, sizeof(ti->ti_x1));
 	ti->ti_len = (u_short)tlen;
 	HTONS(ti->ti_len);
-	ti->ti_sum = in_cksum(m, len);
+	if (m->m_pkthdr.csum_flags & CSUM_DATA_VALID)
+		ti->ti_sum = 0;
+	else if (m->m_pkthdr.csum_flags & CSUM_FRAME)
+		ti->ti_sum = in_cksum_frame(m, ti->ti_src.s_addr,
+		    ti->ti_dst.s_addr, htonl(IPPROTO_TCP + tlen));
+	else
+		ti->ti_sum = in_cksum(m, len);
 	if (ti->ti_sum) {
 		tcpstat.tcps_rcvbadsum++;
 		goto drop;
@@ -361,15 +371,15 @@ void tcp_input(void *arg, ...)
 	 */
 findpcb:
 	/*
-	 * First look for an exact match.
+	 * Segments of a transfer usually arrive back to back, so try
+	 * the connection of the previous segment first.  Otherwise
+	 * look for an exact match, or a listening socket.
 	 */
-	inp = in_pcblookuphash(&tcbinfo, ti->ti_src, ti->ti_sport,
+	inp = INP_LASTHIT(&tcbinfo, ti->ti_src, ti->ti_sport,
 	    ti->ti_dst, ti->ti_dport);
-	/*
-	 * ...and if that fails, do a wildcard search.
-	 */
 	if (inp == NULL) {
-		inp = in_pcblookup(&tcb, ti->ti_src, ti->ti_sport,
+		++tcpstat.tcps_pcbcachemiss;
+		inp = in_pcblookuphash(&tcbinfo, ti->ti_src, ti->ti_sport,
 		    ti->ti_dst, ti->ti_dport, INPLOOKUP_WILDCARD);
 	}
 
@@ -381,6 +391,7 @@ findpcb:
 	 */
 	if (inp == NULL)
 		goto dropwithreset;
+	INP_PREFETCH(inp);
 	tp = intotcpcb(inp);
 	if (tp == 0)
 		goto dropwithreset;
@@ -433,6 +444,8 @@ findpcb:
 			tp = intotcpcb(inp);
 			tp->t_state = TCPS_LISTEN;
 			tp->t_flags |= tp0->t_flags & (TF_NOPUSH|TF_NOOPT);
+			tp->t_cc = tp0->t_cc;
+			(*tp->t_cc->cc_init)(tp);
 
 			/* Compute proper scaling value from buffer space */
 			while (tp->request_r_scale < TCP_MAX_WINSHIFT &&
@@ -504,17 +517,15 @@ findpcb:
 		if (ti->ti_len == 0) {
 			if (SEQ_GT(ti->ti_ack, tp->snd_una) &&
 			    SEQ_LEQ(ti->ti_ack, tp->snd_max) &&
-			    tp->snd_cwnd >= tp->snd_wnd) {
+			    tp->snd_cwnd >= tp->snd_wnd &&
+			    !IN_FASTRECOVERY(tp) &&
+			    tp->snd_numholes == 0 &&
+			    (to.to_flag & TOF_SACK) == 0) {
 				/*
 				 * this is a pure ack for outstanding data.
 				 */
 				++tcpstat.tcps_predack;
-				if ((to.to_flag & TOF_TS) != 0)
-					tcp_xmit_timer(tp,
-					    tcp_now - to.to_tsecr + 1);
-				else if (tp->t_rtt &&
-					    SEQ_GT(ti->ti_ack, tp->t_rtseq))
-					tcp_xmit_timer(tp, tp->t_rtt);
+				tcp_rtt_update(tp, &to, ti->ti_ack);
 				acked = ti->ti_ack - tp->snd_una;
 				tcpstat.tcps_rcvackpack++;
 				tcpstat.tcps_rcvackbyte += acked;
@@ -536,7 +547,7 @@ findpcb:
 				else if (tp->t_timer[TCPT_PERSIST] == 0)
 					tp->t_timer[TCPT_REXMT] = tp->t_rxtcur;
 
-				if (so->so_snd.sb_flags & SB_NOTIFY)
+				if (sb_notify(so, &so->so_snd))
 					sowwakeup(so);
 				if (so->so_snd.sb_cc)
 					(void) tcp_output(tp);
@@ -1203,6 +1214,16 @@ trimthenstep6:
 	case TCPS_LAST_ACK:
 	case TCPS_TIME_WAIT:
 
+		/*
+		 * Bring the SACK scoreboard up to date before deciding
+		 * whether this is a duplicate ack, the holes drive the
+		 * retransmissions during recovery.
+		 */
+		if (TCP_SACK_ENABLED(tp) &&
+		    ((to.to_flag & TOF_SACK) || tp->snd_numholes > 0) &&
+		    SEQ_LEQ(ti->ti_ack, tp->snd_max))
+			tcp_sack_doack(tp, &to, ti->ti_ack);
+
 		if (SEQ_LEQ(ti->ti_ack, tp->snd_una)) {
 			if (ti->ti_len == 0 && tiwin == tp->snd_wnd) {
 				tcpstat.tcps_rcvdupack++;
@@ -1229,21 +1250,46 @@ trimthenstep6:
 				 * so bump cwnd by the amount in the receiver
 				 * to keep a constant cwnd packets in the
 				 * network.
+				 *
+				 * With SACK the scoreboard tells exactly what
+				 * is missing, and tcp_output() keeps the
+				 * estimated data in flight (pipe) at cwnd
+				 * instead (RFC 6675).  An ack that does not
+				 * get past snd_recover belongs to a loss we
+				 * already reacted to (RFC 6582).
 				 */
-				if (tp->t_timer[TCPT_REXMT] == 0 ||
-				    ti->ti_ack != tp->snd_una)
+				if (ti->ti_ack != tp->snd_una ||
+				    (tp->t_timer[TCPT_REXMT] == 0 &&
+				     !IN_FASTRECOVERY(tp)))
 					tp->t_dupacks = 0;
-				else if (++tp->t_dupacks == tcprexmtthresh) {
+				else if (IN_FASTRECOVERY(tp)) {
+					if (!TCP_SACK_ENABLED(tp))
+						tp->snd_cwnd += tp->t_maxseg;
+					(void) tcp_output(tp);
+					goto drop;
+				} else if (++tp->t_dupacks == tcprexmtthresh) {
 					tcp_seq onxt = tp->snd_nxt;
-					u_int win =
-					    MIN(tp->snd_wnd, tp->snd_cwnd) / 2 /
-						tp->t_maxseg;
 
-					if (win < 2)
-						win = 2;
-					tp->snd_ssthresh = win * tp->t_maxseg;
+					if (SEQ_LEQ(ti->ti_ack, tp->snd_recover)) {
+						tp->t_dupacks = 0;
+						break;
+					}
+					CC_CONG_SIGNAL(tp, CC_NDUPACK);
+					tp->t_flags |= TF_FASTRECOVERY;
+					tp->snd_recover = tp->snd_max;
+					tp->t_recoveries++;
+					tcpstat.tcps_fastrecovery++;
 					tp->t_timer[TCPT_REXMT] = 0;
 					tp->t_rtt = 0;
+					if (TCP_SACK_ENABLED(tp)) {
+						tcpstat.tcps_sack_recovery++;
+						tcp_sack_startrecovery(tp);
+						tp->snd_cwnd =
+						    tcp_sack_pipe(tp) + tp->t_maxseg;
+						(void) tcp_output(tp);
+						tp->snd_cwnd = tp->snd_ssthresh;
+						goto drop;
+					}
 					tp->snd_nxt = ti->ti_ack;
 					tp->snd_cwnd = tp->t_maxseg;
 					(void) tcp_output(tp);
@@ -1252,22 +1298,15 @@ trimthenstep6:
 					if (SEQ_GT(onxt, tp->snd_nxt))
 						tp->snd_nxt = onxt;
 					goto drop;
-				} else if (tp->t_dupacks > tcprexmtthresh) {
-					tp->snd_cwnd += tp->t_maxseg;
-					(void) tcp_output(tp);
-					goto drop;
 				}
 			} else
 				tp->t_dupacks = 0;
 			break;
 		}
 		/*
-		 * If the congestion window was inflated to account
-		 * for the other side's cached packets, retract it.
+		 * The window inflated for the other side's cached
+		 * packets is deflated when recovery ends, below.
 		 */
-		if (tp->t_dupacks > tcprexmtthresh &&
-		    tp->snd_cwnd > tp->snd_ssthresh)
-			tp->snd_cwnd = tp->snd_ssthresh;
 		tp->t_dupacks = 0;
 		if (SEQ_GT(ti->ti_ack, tp->snd_max)) {
 			tcpstat.tcps_rcvacktoomuch++;
@@ -1302,10 +1341,7 @@ process_ACK:
 		 * timer backoff (cf., Phil Karn's retransmit alg.).
 		 * Recompute the initial retransmit timer.
 		 */
-		if (to.to_flag & TOF_TS)
-			tcp_xmit_timer(tp, tcp_now - to.to_tsecr + 1);
-		else if (tp->t_rtt && SEQ_GT(ti->ti_ack, tp->t_rtseq))
-			tcp_xmit_timer(tp,tp->t_rtt);
+		tcp_rtt_update(tp, &to, ti->ti_ack);
 
 		/*
 		 * If all outstanding data is acked, stop retransmit
@@ -1327,20 +1363,26 @@ process_ACK:
 			goto step6;
 
 		/*
-		 * When new data is acked, open the congestion window.
-		 * If the window gives us less than ssthresh packets
-		 * in flight, open exponentially (maxseg per packet).
-		 * Otherwise open linearly: maxseg per window
-		 * (maxseg^2 / cwnd per packet).
+		 * During fast recovery an ack below snd_recover means
+		 * another segment of the same window was lost: send
+		 * it without leaving recovery.  Once everything
+		 * outstanding at the time of the loss is acked, let
+		 * the congestion control deflate the window.  Outside
+		 * of recovery new data opens the window.
 		 */
-		{
-		register u_int cw = tp->snd_cwnd;
-		register u_int incr = tp->t_maxseg;
-
-		if (cw > tp->snd_ssthresh)
-			incr = incr * incr / cw;
-		tp->snd_cwnd = MIN(cw + incr, TCP_MAXWIN<<tp->snd_scale);
-		}
+		if (IN_FASTRECOVERY(tp)) {
+			if (SEQ_LT(ti->ti_ack, tp->snd_recover)) {
+				tcpstat.tcps_partialack++;
+				if (TCP_SACK_ENABLED(tp))
+					needoutput = 1;
+				else
+					tcp_newreno_partial_ack(tp, ti);
+			} else {
+				tp->t_flags &= ~TF_FASTRECOVERY;
+				CC_POST_RECOVERY(tp);
+			}
+		} else
+			CC_ACK_RECEIVED(tp, acked);
 		if (acked > so->so_snd.sb_cc) {
 			tp->snd_wnd -= so->so_snd.sb_cc;
 			sbdrop(&so->so_snd, (int)so->so_snd.sb_cc);
@@ -1350,7 +1392,7 @@ process_ACK:
 			tp->snd_wnd -= acked;
 			ourfinisacked = 0;
 		}
-		if (so->so_snd.sb_flags & SB_NOTIFY)
+		if (sb_notify(so, &so->so_snd))
 			sowwakeup(so);
 		tp->snd_una = ti->ti_ack;
 		if (SEQ_LT(tp->snd_nxt, tp->snd_una))
@@ -1517,7 +1559,18 @@ dodata:							/* XXX */
 	 */
 	if ((ti->ti_len || (tiflags&TH_FIN)) &&
 	    TCPS_HAVERCVDFIN(tp->t_state) == 0) {
+		tcp_seq save_start = ti->ti_seq;
+		int save_len = ti->ti_len;
+
 		TCP_REASS(tp, ti, m, so, tiflags);
+		/*
+		 * Keep the blocks we report to the peer in step with
+		 * the reassembly queue.
+		 */
+		if (TCP_SACK_ENABLED(tp) && save_len > 0 &&
+		    (tp->t_segq != NULL || tp->rcv_numsacks > 0))
+			tcp_update_sack_list(tp, save_start,
+			    save_start + save_len);
 		/*
 		 * Note the amount of data that peer has sent into
 		 * our window, in order to estimate the sender's
@@ -1733,6 +1786,25 @@ tcp_dooptions(tp, cp, cnt, ti, to)
 				tp->ts_recent_age = tcp_now;
 			}
 			break;
+		case TCPOPT_SACK_PERMITTED:
+			if (optlen != TCPOLEN_SACK_PERMITTED)
+				continue;
+			if (!(ti->ti_flags & TH_SYN))
+				continue;
+			to->to_flag |= TOF_SACKPERM;
+			if (tcp_do_sack)
+				tp->t_flags |= TF_SACK_PERMIT;
+			break;
+		case TCPOPT_SACK:
+			if (optlen <= TCPOLEN_SACKHDR ||
+			    (optlen - TCPOLEN_SACKHDR) % TCPOLEN_SACK != 0)
+				continue;
+			if (ti->ti_flags & TH_SYN)
+				continue;
+			to->to_flag |= TOF_SACK;
+			to->to_nsacks = (optlen - TCPOLEN_SACKHDR) / TCPOLEN_SACK;
+			to->to_sacks = cp + 2;
+			break;
 		case TCPOPT_CC:
 			if (optlen != TCPOLEN_CC)
 				continue;
@@ -1811,6 +1883,64 @@ tcp_pulloutofband(so, ti, m)
 	panic("tcp_pulloutofband");
 }
 
+/*
+ * Take an rtt sample from this ack.  A timestamp echo measures any
+ * segment, retransmitted or not, in milliseconds; without timestamps
+ * the single timed segment is used as before.  The smoothed estimate
+ * is still kept in slow timeout ticks.
+ */
+static void
+tcp_rtt_update(tp, to, ack)
+	struct tcpcb *tp;
+	struct tcpopt *to;
+	tcp_seq ack;
+{
+	u_long ms;
+
+	if ((to->to_flag & TOF_TS) != 0 && to->to_tsecr != 0 &&
+	    (ms = tcp_ts_getticks() - to->to_tsecr) <=
+	    TCPTV_REXMTMAX * (1000 / PR_SLOWHZ))
+		;
+	else if (tp->t_rtt && SEQ_GT(ack, tp->t_rtseq))
+		ms = (tp->t_rtt - 1) * (1000 / PR_SLOWHZ);
+	else
+		return;
+
+	tp->t_rttlast = ms;
+	if (tp->t_rttbest == 0 || ms < tp->t_rttbest)
+		tp->t_rttbest = ms;
+	tcp_xmit_timer(tp, ms * PR_SLOWHZ / 1000 + 1);
+}
+
+/*
+ * NewReno partial ack, RFC 6582: retransmit the first unacknowledged
+ * segment straight away and deflate the window by the amount of new
+ * data acked, so that roughly ssthresh worth of data stays in flight.
+ */
+static void
+tcp_newreno_partial_ack(tp, ti)
+	struct tcpcb *tp;
+	struct tcpiphdr *ti;
+{
+	tcp_seq onxt = tp->snd_nxt;
+	u_long ocwnd = tp->snd_cwnd;
+	u_long acked = ti->ti_ack - tp->snd_una;
+
+	tp->t_timer[TCPT_REXMT] = 0;
+	tp->t_rtt = 0;
+	tp->snd_nxt = ti->ti_ack;
+	tp->snd_cwnd = tp->t_maxseg + acked;
+	(void) tcp_output(tp);
+	tp->snd_cwnd = ocwnd;
+	if (SEQ_GT(onxt, tp->snd_nxt))
+		tp->snd_nxt = onxt;
+	if (tp->snd_cwnd > acked)
+		tp->snd_cwnd -= acked;
+	else
+		tp->snd_cwnd = 0;
+	tp->snd_cwnd += tp->t_maxseg;
+}
+
 /*
  * Collect new round-trip time estimate
  * and update averages and current timeout.
@@ -86,6 +86,7 @@ tcp_output(tp)
 	int idle, sendalot;
 	struct rmxp_tao *taop;
 	struct rmxp_tao tao_noncached;
+	struct sackhole *p;
 
 	/*
 	 * Determine length of data that should be transmitted,
@@ -100,12 +101,30 @@ tcp_output(tp)
 		 * expected to clock out any data we send --
 		 * slow start to get ack "clock" running again.
 		 */
-		tp->snd_cwnd = tp->t_maxseg;
+		CC_AFTER_IDLE(tp);
 again:
 	sendalot = 0;
 	off = tp->snd_nxt - tp->snd_una;
 	win = MIN(tp->snd_wnd, tp->snd_cwnd);
 
+	/*
+	 * During SACK recovery cwnd limits the data estimated to be in
+	 * the network (pipe), not the data sent since snd_una.  Holes
+	 * the scoreboard considers lost go first, then new data.
+	 */
+	p = NULL;
+	if (IN_FASTRECOVERY(tp) && TCP_SACK_ENABLED(tp)) {
+		long cwin = (long)tp->snd_cwnd - (long)tcp_sack_pipe(tp);
+
+		if (cwin < 0)
+			cwin = 0;
+		if (cwin >= tp->t_maxseg && (p = tcp_sack_output(tp)) != NULL) {
+			off = p->rxmit - tp->snd_una;
+			win = off + MIN(cwin, (long)(p->end - p->rxmit));
+		} else
+			win = MIN(tp->snd_wnd, off + cwin);
+	}
+
 	flags = tcp_outflags[tp->t_state];
 	/*
 	 * Get standard flags, and add SYN or FIN if requested by 'hidden'
@@ -190,7 +209,8 @@ again:
 		len = tp->t_maxseg;
 		sendalot = 1;
 	}
-	if (SEQ_LT(tp->snd_nxt + len, tp->snd_una + so->so_snd.sb_cc))
+	if (p != NULL ||
+	    SEQ_LT(tp->snd_nxt + len, tp->snd_una + so->so_snd.sb_cc))
 		flags &= ~TH_FIN;
 
 	win = sbspace(&so->so_rcv);
@@ -212,7 +232,7 @@ again:
 		    (tp->t_flags & TF_NOPUSH) == 0 &&
 		    len + off >= so->so_snd.sb_cc)
 			goto send;
-		if (tp->t_force)
+		if (tp->t_force || p != NULL)
 			goto send;
 		if (len >= tp->max_sndwnd / 2 && tp->max_sndwnd > 0)
 			goto send;
@@ -326,6 +346,17 @@ send:
 					tp->request_r_scale);
 				optlen += 4;
 			}
+
+			if (tcp_do_sack &&
+			    ((flags & TH_ACK) == 0 ||
+			    (tp->t_flags & TF_SACK_PERMIT))) {
+				*((u_int32_t *) (opt + optlen)) = htonl(
+					TCPOPT_NOP << 24 |
+					TCPOPT_NOP << 16 |
+					TCPOPT_SACK_PERMITTED << 8 |
+					TCPOLEN_SACK_PERMITTED);
+				optlen += 4;
+			}
 		}
  	}
 
@@ -342,7 +373,7 @@ send:
 
  		/* Form timestamp option as shown in appendix A of RFC 1323. */
  		*lp++ = htonl(TCPOPT_TSTAMP_HDR);
- 		*lp++ = htonl(tcp_now);
+ 		*lp++ = htonl(tcp_ts_getticks());
  		*lp   = htonl(tp->ts_recent);
  		optlen += TCPOLEN_TSTAMP_APPA;
  	}
@@ -436,6 +467,14 @@ send:
 		}
  	}
 
+	/*
+	 * Report the out of order data we are holding, RFC 2018.
+	 */
+	if (TCP_SACK_ENABLED(tp) && tp->rcv_numsacks > 0 &&
+	    (tp->t_flags & TF_NOOPT) == 0 &&
+	    (flags & (TH_SYN|TH_RST)) == 0)
+		optlen = tcp_sack_option(tp, opt, optlen);
+
  	hdrlen += optlen;
 
 	/*
@@ -467,9 +506,14 @@ send:
 	if (len) {
 		if (tp->t_force && len == 1)
 			tcpstat.tcps_sndprobe++;
-		else if (SEQ_LT(tp->snd_nxt, tp->snd_max)) {
+		else if (p != NULL || SEQ_LT(tp->snd_nxt, tp->snd_max)) {
 			tcpstat.tcps_sndrexmitpack++;
 			tcpstat.tcps_sndrexmitbyte += len;
+			tp->t_sndrexmitpack++;
+			if (p != NULL) {
+				tcpstat.tcps_sack_rexmitpack++;
+				tcpstat.tcps_sack_rexmitbyte += len;
+			}
 		} else {
 			tcpstat.tcps_sndpack++;
 			tcpstat.tcps_sndbyte += len;
@@ -556,7 +600,9 @@ send:
 	 * case, since we know we aren't doing a retransmission.
 	 * (retransmit and persist are mutually exclusive...)
 	 */
-	if (len || (flags & (TH_SYN|TH_FIN)) || tp->t_timer[TCPT_PERSIST])
+	if (p != NULL)
+		ti->ti_seq = htonl(p->rxmit);
+	else if (len || (flags & (TH_SYN|TH_FIN)) || tp->t_timer[TCPT_PERSIST])
 		ti->ti_seq = htonl(tp->snd_nxt);
 	else
 		ti->ti_seq = htonl(tp->snd_max);
@@ -590,13 +636,11 @@ send:
 		tp->snd_up = tp->snd_una;		/* drag it along */
 
 	/*
-	 * Put TCP length in extended header, and then
-	 * checksum extended header and data.
+	 * The checksum is filled in by ip_output() or the interface
+	 * once the IP header is complete.
 	 */
-	if (len + optlen)
-		ti->ti_len = htons((u_short)(sizeof (struct tcphdr) +
-		    optlen + len));
-	ti->ti_sum = in_cksum(m, (int)(hdrlen + len));
+	ti->ti_sum = 0;
+	m->m_pkthdr.csum_flags = CSUM_TCP;
 
 	/*
 	 * In transmit state, time the transmission and arrange for
@@ -605,6 +649,15 @@ send:
 	if (tp->t_force == 0 || tp->t_timer[TCPT_PERSIST] == 0) {
 		tcp_seq startseq = tp->snd_nxt;
 
+		/*
+		 * A retransmission from a SACK hole only moves the
+		 * hole's own pointer, and is never timed.
+		 */
+		if (p != NULL) {
+			p->rxmit += len;
+			goto timer;
+		}
+
 		/*
 		 * Advance snd_nxt over sequence space of this segment.
 		 */
@@ -630,6 +683,7 @@ send:
 			}
 		}
 
+timer:
 		/*
 		 * Set retransmit timer if not currently set,
 		 * and not doing an ack or a keep-alive probe.
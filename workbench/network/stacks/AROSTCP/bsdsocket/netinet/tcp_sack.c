@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2025 The AROS Dev Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/*
+ * Selective acknowledgements, RFC 2018, and SACK based loss recovery,
+ * RFC 6675.
+ *
+ * As a receiver we remember which blocks of out of order data are
+ * sitting in the reassembly queue and report them on every ack.
+ *
+ * As a sender we keep a scoreboard of the holes the peer has reported,
+ * i.e. the sequence ranges below the highest SACKed byte (snd_fack)
+ * that have not arrived.  During fast recovery tcp_output() uses it to
+ * pick what to retransmit next, and tcp_sack_pipe() to estimate how
+ * much data is still in the network.  The scoreboard is a small array
+ * in the tcpcb kept in sequence order; if it fills up a neighbouring
+ * hole is widened instead, which only makes us retransmit a little more.
+ */
+
+#include <conf.h>
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/malloc.h>
+#include <sys/mbuf.h>
+#include <sys/socket.h>
+#include <sys/socketvar.h>
+#include <sys/protosw.h>
+#include <sys/errno.h>
+#include <sys/queue.h>
+
+#include <net/route.h>
+
+#include <netinet/in.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <netinet/in_pcb.h>
+#include <netinet/ip_var.h>
+#include <netinet/tcp.h>
+#include <netinet/tcp_fsm.h>
+#include <netinet/tcp_seq.h>
+#include <netinet/tcp_timer.h>
+#include <netinet/tcp_var.h>
+#include <netinet/tcpip.h>
+
+int	tcp_do_sack = 1;
+
+extern int tcprexmtthresh;
+
+/*
+ * Update the receiver's list of SACK blocks after the segment
+ * [rcv_start, rcv_end) has been passed to tcp_reass().  Blocks that
+ * rcv_nxt has moved past are dropped, and the new block, merged with
+ * any it touches, goes first as RFC 2018 asks.
+ */
+void
+tcp_update_sack_list(tp, rcv_start, rcv_end)
+	struct tcpcb *tp;
+	tcp_seq rcv_start, rcv_end;
+{
+	struct sackblk head, saved[MAX_SACK_BLKS];
+	int i, j, n = 0;
+
+	if (SEQ_LT(rcv_start, tp->rcv_nxt))
+		rcv_start = tp->rcv_nxt;
+	head.start = rcv_start;
+	head.end = rcv_end;
+
+	for (i = 0; i < tp->rcv_numsacks; i++) {
+		struct sackblk *sb = &tp->sackblks[i];
+
+		if (SEQ_LEQ(sb->end, tp->rcv_nxt))
+			continue;
+		if (SEQ_LT(head.start, head.end) &&
+		    SEQ_LEQ(sb->start, head.end) &&
+		    SEQ_GEQ(sb->end, head.start)) {
+			if (SEQ_LT(sb->start, head.start))
+				head.start = sb->start;
+			if (SEQ_GT(sb->end, head.end))
+				head.end = sb->end;
+			continue;
+		}
+		saved[n++] = *sb;
+	}
+
+	i = 0;
+	if (SEQ_LT(head.start, head.end))
+		tp->sackblks[i++] = head;
+	for (j = 0; j < n && i < MAX_SACK_BLKS; j++)
+		tp->sackblks[i++] = saved[j];
+	tp->rcv_numsacks = i;
+}
+
+/*
+ * Append a SACK option with as many of the receiver's blocks as fit
+ * after the optlen bytes of options already in opt.  Returns the new
+ * length of the options.
+ */
+int
+tcp_sack_option(tp, opt, optlen)
+	struct tcpcb *tp;
+	u_char *opt;
+	int optlen;
+{
+	u_char *cp = opt + optlen;
+	u_int32_t seq;
+	int i, nsack;
+
+	nsack = ((int)TCP_MAXOLEN - optlen - 4) / TCPOLEN_SACK;
+	if (nsack > tp->rcv_numsacks)
+		nsack = tp->rcv_numsacks;
+	if (nsack > TCP_MAX_SACK)
+		nsack = TCP_MAX_SACK;
+	if (nsack <= 0)
+		return (optlen);
+
+	*cp++ = TCPOPT_NOP;
+	*cp++ = TCPOPT_NOP;
+	*cp++ = TCPOPT_SACK;
+	*cp++ = TCPOLEN_SACKHDR + nsack * TCPOLEN_SACK;
+	for (i = 0; i < nsack; i++) {
+		seq = htonl(tp->sackblks[i].start);
+		bcopy((char *)&seq, (char *)cp, sizeof(seq));
+		cp += sizeof(seq);
+		seq = htonl(tp->sackblks[i].end);
+		bcopy((char *)&seq, (char *)cp, sizeof(seq));
+		cp += sizeof(seq);
+	}
+	tcpstat.tcps_sack_sndblocks += nsack;
+	return (optlen + 4 + nsack * TCPOLEN_SACK);
+}
+
+static void
+tcp_sack_removehole(tp, i)
+	struct tcpcb *tp;
+	int i;
+{
+	tp->snd_numholes--;
+	if (i < tp->snd_numholes)
+		bcopy((char *)&tp->snd_holes[i + 1], (char *)&tp->snd_holes[i],
+		    (tp->snd_numholes - i) * sizeof(struct sackhole));
+}
+
+/*
+ * Insert the hole [start, end) at index i.  When the scoreboard is full
+ * the hole before it is extended over the new one instead, or for the
+ * first slot the hole after it, so no unacknowledged data is lost from
+ * the scoreboard.
+ */
+static void
+tcp_sack_inserthole(tp, i, start, end, rxmit)
+	struct tcpcb *tp;
+	int i;
+	tcp_seq start, end, rxmit;
+{
+	struct sackhole *h;
+
+	if (tp->snd_numholes == TCP_SACK_MAXHOLES) {
+		if (i > 0) {
+			h = &tp->snd_holes[i - 1];
+			if (SEQ_GT(end, h->end))
+				h->end = end;
+		} else {
+			h = &tp->snd_holes[0];
+			if (SEQ_LT(start, h->start)) {
+				h->start = start;
+				h->rxmit = rxmit;
+			}
+		}
+		return;
+	}
+	if (i < tp->snd_numholes)
+		bcopy((char *)&tp->snd_holes[i], (char *)&tp->snd_holes[i + 1],
+		    (tp->snd_numholes - i) * sizeof(struct sackhole));
+	h = &tp->snd_holes[i];
+	h->start = start;
+	h->end = end;
+	h->rxmit = rxmit;
+	tp->snd_numholes++;
+}
+
+/*
+ * Update the scoreboard from an incoming ack: drop what the cumulative
+ * ack covers, then take out of the holes whatever the SACK blocks in
+ * the options report as received.  New holes open up between the
+ * previous highest SACKed byte and a block above it.
+ */
+void
+tcp_sack_doack(tp, to, th_ack)
+	struct tcpcb *tp;
+	struct tcpopt *to;
+	tcp_seq th_ack;
+{
+	struct sackblk sack[TCP_MAX_SACK], sb;
+	struct sackhole *h;
+	u_int32_t seq;
+	int i, j, n = 0;
+
+	while (tp->snd_numholes > 0 &&
+	       SEQ_LEQ(tp->snd_holes[0].end, th_ack))
+		tcp_sack_removehole(tp, 0);
+	if (tp->snd_numholes > 0) {
+		h = &tp->snd_holes[0];
+		if (SEQ_LT(h->start, th_ack))
+			h->start = th_ack;
+		if (SEQ_LT(h->rxmit, h->start))
+			h->rxmit = h->start;
+	} else
+		tp->snd_fack = th_ack;
+	if (SEQ_LT(tp->snd_fack, th_ack))
+		tp->snd_fack = th_ack;
+
+	if ((to->to_flag & TOF_SACK) == 0)
+		return;
+
+	/* Collect the blocks that make sense, in sequence order */
+	for (i = 0; i < to->to_nsacks && n < TCP_MAX_SACK; i++) {
+		bcopy((char *)to->to_sacks + i * TCPOLEN_SACK,
+		    (char *)&seq, sizeof(seq));
+		sb.start = ntohl(seq);
+		bcopy((char *)to->to_sacks + i * TCPOLEN_SACK + 4,
+		    (char *)&seq, sizeof(seq));
+		sb.end = ntohl(seq);
+		if (SEQ_LEQ(sb.end, sb.start) ||
+		    SEQ_LEQ(sb.start, th_ack) ||
+		    SEQ_GT(sb.end, tp->snd_max))
+			continue;
+		for (j = n; j > 0 && SEQ_LT(sb.start, sack[j - 1].start); j--)
+			sack[j] = sack[j - 1];
+		sack[j] = sb;
+		n++;
+	}
+	tcpstat.tcps_sack_rcvblocks += n;
+
+	for (i = 0; i < n; i++) {
+		sb = sack[i];
+
+		if (SEQ_GEQ(sb.start, tp->snd_fack)) {
+			if (SEQ_GT(sb.start, tp->snd_fack))
+				tcp_sack_inserthole(tp, tp->snd_numholes,
+				    tp->snd_fack, sb.start, tp->snd_fack);
+			tp->snd_fack = sb.end;
+			continue;
+		}
+		if (SEQ_GT(sb.end, tp->snd_fack))
+			tp->snd_fack = sb.end;
+
+		for (j = 0; j < tp->snd_numholes; ) {
+			h = &tp->snd_holes[j];
+			if (SEQ_LEQ(h->end, sb.start)) {
+				j++;
+				continue;
+			}
+			if (SEQ_GEQ(h->start, sb.end))
+				break;
+			if (SEQ_LEQ(sb.start, h->start)) {
+				if (SEQ_GEQ(sb.end, h->end)) {
+					/* Whole hole filled */
+					tcp_sack_removehole(tp, j);
+					continue;
+				}
+				/* Front of the hole filled */
+				h->start = sb.end;
+				if (SEQ_LT(h->rxmit, h->start))
+					h->rxmit = h->start;
+			} else if (SEQ_GEQ(sb.end, h->end)) {
+				/* Tail of the hole filled, the block may
+				 * reach into the next ones as well */
+				h->end = sb.start;
+				if (SEQ_GT(h->rxmit, h->end))
+					h->rxmit = h->end;
+				j++;
+				continue;
+			} else {
+				/* Block inside the hole, split it */
+				tcp_seq end = h->end;
+				tcp_seq rxmit = h->rxmit;
+
+				h->end = sb.start;
+				if (SEQ_GT(h->rxmit, h->end))
+					h->rxmit = h->end;
+				tcp_sack_inserthole(tp, j + 1, sb.end, end,
+				    SEQ_GT(rxmit, sb.end) ? rxmit : sb.end);
+			}
+			break;
+		}
+	}
+}
+
+/*
+ * Forget everything the peer told us, after a retransmit timeout.
+ */
+void
+tcp_free_sackholes(tp)
+	struct tcpcb *tp;
+{
+	tp->snd_numholes = 0;
+	tp->snd_fack = tp->snd_una;
+}
+
+/*
+ * RFC 6675 IsLost(): a hole is taken as lost when enough data above it
+ * has been SACKed.  The first hole is always lost once recovery has
+ * started, the dup acks told us so.
+ */
+static int
+tcp_sack_islost(tp, i)
+	struct tcpcb *tp;
+	int i;
+{
+	return (i == 0 || (long)(tp->snd_fack - tp->snd_holes[i].end) >
+	    (long)((tcprexmtthresh - 1) * tp->t_maxseg));
+}
+
+/*
+ * The next hole to retransmit from, or NULL if everything that is
+ * considered lost has been retransmitted.
+ */
+struct sackhole *
+tcp_sack_output(tp)
+	struct tcpcb *tp;
+{
+	struct socket *so = tp->t_inpcb->inp_socket;
+	struct sackhole *h;
+	int i;
+
+	for (i = 0; i < tp->snd_numholes; i++) {
+		h = &tp->snd_holes[i];
+		if (!tcp_sack_islost(tp, i))
+			break;
+		if (SEQ_LT(h->rxmit, h->end) &&
+		    SEQ_LT(h->rxmit, tp->snd_una + so->so_snd.sb_cc))
+			return (h);
+	}
+	return (NULL);
+}
+
+/*
+ * RFC 6675 pipe: the data still in the network.  That is everything
+ * sent above snd_fack, the parts of holes not yet considered lost, and
+ * whatever has been retransmitted from the holes.
+ */
+u_long
+tcp_sack_pipe(tp)
+	struct tcpcb *tp;
+{
+	struct sackhole *h;
+	u_long pipe = tp->snd_max - tp->snd_fack;
+	int i;
+
+	for (i = 0; i < tp->snd_numholes; i++) {
+		h = &tp->snd_holes[i];
+		pipe += h->rxmit - h->start;
+		if (!tcp_sack_islost(tp, i))
+			pipe += h->end - h->rxmit;
+	}
+	return (pipe);
+}
+
+/*
+ * Entering fast recovery.  If the peer has not sent any SACK blocks
+ * yet, make the first unacknowledged segment a hole so that it is
+ * still retransmitted first.
+ */
+void
+tcp_sack_startrecovery(tp)
+	struct tcpcb *tp;
+{
+	tcp_seq end;
+
+	if (tp->snd_numholes > 0)
+		return;
+	end = tp->snd_una + tp->t_maxseg;
+	if (SEQ_GT(end, tp->snd_max))
+		end = tp->snd_max;
+	tcp_sack_inserthole(tp, 0, tp->snd_una, end, tp->snd_una);
+	if (SEQ_LT(tp->snd_fack, end))
+		tp->snd_fack = end;
+}
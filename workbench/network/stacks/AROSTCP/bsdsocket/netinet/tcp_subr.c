@@ -100,13 +100,27 @@ tcp_init()
 	tcp_cleartaocache();
 	LIST_INIT(&tcb);
 	tcbinfo.listhead = &tcb;
-	tcbinfo.hashbase = phashinit(TCBHASHSIZE, M_PCB, &tcbinfo.hashsize);
+	tcbinfo.hashbase = hashinit(TCBHASHSIZE, M_PCB, &tcbinfo.hashmask);
 	if (max_protohdr < sizeof(struct tcpiphdr))
 		max_protohdr = sizeof(struct tcpiphdr);
 	if (max_linkhdr + sizeof(struct tcpiphdr) > MHLEN)
 		panic("tcp_init");
 }
 
+/*
+ * Clock for RFC 7323 timestamps and rtt samples: milliseconds since
+ * the system was started.  Unlike tcp_now it is fine grained enough
+ * to measure rtts on a LAN and does not depend on the slow timeout.
+ */
+u_long
+tcp_ts_getticks()
+{
+	struct timeval tv;
+
+	GetUpTime(&tv);
+	return (tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
 /*
  * Create template to be used to send tcp packets on a connection.
  * Call after host entry created, allocates an mbuf and fills
@@ -216,7 +230,7 @@ tcp_respond(tp, ti, m, ack, seq, flags)
 		ti->ti_win = htons((u_short)win);
 	ti->ti_urp = 0;
 	ti->ti_sum = 0;
-	ti->ti_sum = in_cksum(m, tlen);
+	m->m_pkthdr.csum_flags = CSUM_TCP;
 	((struct ip *)ti)->ip_len = tlen;
 	((struct ip *)ti)->ip_ttl = ip_defttl;
 #ifdef TCPDEBUG
@@ -266,6 +280,7 @@ tcp_newtcpcb(inp)
 	    TCPTV_MIN, TCPTV_REXMTMAX);
 	tp->snd_cwnd = TCP_MAXWIN << TCP_MAX_WINSHIFT;
 	tp->snd_ssthresh = TCP_MAXWIN << TCP_MAX_WINSHIFT;
+	tcp_cc_init(tp);
 	inp->inp_ip.ip_ttl = ip_defttl;
 	inp->inp_ppcb = (caddr_t)tp;
 	return (tp);
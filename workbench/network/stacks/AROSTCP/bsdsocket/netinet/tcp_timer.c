@@ -248,21 +248,21 @@ tcp_timers(tp, timer)
 		 * drops but still "push" the network to take advantage
 		 * of improving conditions, we switch from exponential
 		 * to linear window opening at some threshhold size.
-		 * For a threshhold, we use half the current window
-		 * size, truncated to a multiple of the mss.
+		 * The threshhold is chosen by the congestion control
+		 * algorithm of the connection.
 		 *
-		 * (the minimum cwnd that will give us exponential
-		 * growth is 2 mss.  We don't allow the threshhold
-		 * to go below this.)
+		 * A timeout also ends any fast recovery in progress.
+		 * Whatever the peer reported with SACK may have been
+		 * reneged, so the scoreboard is thrown away, and acks
+		 * for data sent before the timeout must not start a
+		 * new recovery (RFC 6582).
 		 */
-		{
-		u_int win = MIN(tp->snd_wnd, tp->snd_cwnd) / 2 / tp->t_maxseg;
-		if (win < 2)
-			win = 2;
-		tp->snd_cwnd = tp->t_maxseg;
-		tp->snd_ssthresh = win * tp->t_maxseg;
+		tp->t_flags &= ~TF_FASTRECOVERY;
+		tcp_free_sackholes(tp);
+		tp->snd_recover = tp->snd_max;
 		tp->t_dupacks = 0;
-		}
+		tp->t_rtos++;
+		CC_CONG_SIGNAL(tp, CC_RTO);
 		(void) tcp_output(tp);
 		break;
 
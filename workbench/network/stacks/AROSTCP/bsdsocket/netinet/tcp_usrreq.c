@@ -525,6 +525,27 @@ tcp_ctloutput(op, so, level, optname, mp)
 				tp->t_flags &= ~TF_NOPUSH;
 			break;
 
+		case TCP_CONGESTION:
+		    {
+			char name[TCP_CA_NAME_MAX];
+			struct tcp_cc_algo *cc;
+
+			if (m == NULL || m->m_len <= 0) {
+				error = EINVAL;
+				break;
+			}
+			i = MIN(m->m_len, TCP_CA_NAME_MAX - 1);
+			bcopy(mtod(m, caddr_t), name, i);
+			name[i] = '\0';
+			if ((cc = tcp_cc_lookup(name)) == NULL)
+				error = EINVAL;
+			else if (cc != tp->t_cc) {
+				tp->t_cc = cc;
+				(*cc->cc_init)(tp);
+			}
+			break;
+		    }
+
 		default:
 			error = ENOPROTOOPT;
 			break;
@@ -550,6 +571,12 @@ tcp_ctloutput(op, so, level, optname, mp)
 		case TCP_NOPUSH:
 			*mtod(m, int *) = tp->t_flags & TF_NOPUSH;
 			break;
+		case TCP_CONGESTION:
+			bzero(mtod(m, caddr_t), TCP_CA_NAME_MAX);
+			strncpy(mtod(m, char *), tp->t_cc->name,
+			    TCP_CA_NAME_MAX - 1);
+			m->m_len = TCP_CA_NAME_MAX;
+			break;
 		default:
 			error = ENOPROTOOPT;
 			break;
@@ -100,7 +100,7 @@ udp_init()
 {
 	LIST_INIT(&udb);
 	udbinfo.listhead = &udb;
-	udbinfo.hashbase = phashinit(UDBHASHSIZE, M_PCB, &udbinfo.hashsize);
+	udbinfo.hashbase = hashinit(UDBHASHSIZE, M_PCB, &udbinfo.hashmask);
 }
 
 void udp_input(void *args, ...)
@@ -156,6 +156,7 @@ void udp_input(void *args, ...)
 			goto bad;
 		}
 		m_adj(m, len - ip->ip_len);
+		m->m_pkthdr.csum_flags &= ~CSUM_FRAME;
 		/* ip->ip_len = len; */
 	}
 	/*
@@ -168,9 +169,16 @@ void udp_input(void *args, ...)
 	 * Checksum extended UDP header and data.
 	 */
 	if (udpcksum && uh->uh_sum) {
-		bzero(((struct ipovly *)ip)->ih_x1, 9);
-		((struct ipovly *)ip)->ih_len = uh->uh_ulen;
-		uh->uh_sum = in_cksum(m, len + sizeof (struct ip));
+		if (m->m_pkthdr.csum_flags & CSUM_DATA_VALID)
+			uh->uh_sum = 0;
+		else if (m->m_pkthdr.csum_flags & CSUM_FRAME)
+			uh->uh_sum = in_cksum_frame(m, ip->ip_src.s_addr,
+			    ip->ip_dst.s_addr, htonl(IPPROTO_UDP + len));
+		else {
+			bzero(((struct ipovly *)ip)->ih_x1, 9);
+			((struct ipovly *)ip)->ih_len = uh->uh_ulen;
+			uh->uh_sum = in_cksum(m, len + sizeof (struct ip));
+		}
 		if (uh->uh_sum) {
 			udpstat.udps_badsum++;
 			m_freem(m);
@@ -268,16 +276,16 @@ void udp_input(void *args, ...)
 		return;
 	}
 	/*
-	 * Locate pcb for datagram. First look for an exact match.
+	 * Locate pcb for datagram. First try the one the previous
+	 * datagram went to, then look for an exact match and finally
+	 * for an unconnected socket bound to the port.
 	 */
-	inp = in_pcblookuphash(&udbinfo, ip->ip_src, uh->uh_sport,
+	inp = INP_LASTHIT(&udbinfo, ip->ip_src, uh->uh_sport,
 	    ip->ip_dst, uh->uh_dport);
-	/*
-	 * ...and if that fails, do a wildcard search.
-	 */
 	if (inp == NULL) {
-		inp = in_pcblookup(&udb, ip->ip_src, uh->uh_sport, ip->ip_dst,
-		    uh->uh_dport, INPLOOKUP_WILDCARD);
+		udpstat.udpps_pcbcachemiss++;
+		inp = in_pcblookuphash(&udbinfo, ip->ip_src, uh->uh_sport,
+		    ip->ip_dst, uh->uh_dport, INPLOOKUP_WILDCARD);
 	}
 	if (inp == NULL) {
 		udpstat.udps_noport++;
@@ -289,6 +297,7 @@ void udp_input(void *args, ...)
 		icmp_error(m, ICMP_UNREACH, ICMP_UNREACH_PORT, 0, 0);
 		return;
 	}
+	INP_PREFETCH(inp);
 
 	/*
 	 * Construct sockaddr format source address.
@@ -469,13 +478,12 @@ udp_output(void *arg, ...)
 	ui->ui_ulen = ui->ui_len;
 
 	/*
-	 * Stuff checksum and output datagram.
+	 * Output datagram, the checksum is filled in by ip_output()
+	 * or the interface.
 	 */
 	ui->ui_sum = 0;
-	if (udpcksum) {
-	    if ((ui->ui_sum = in_cksum(m, sizeof (struct udpiphdr) + len)) == 0)
-		ui->ui_sum = 0xffff;
-	}
+	if (udpcksum)
+		m->m_pkthdr.csum_flags = CSUM_UDP;
 	((struct ip *)ui)->ip_len = sizeof (struct udpiphdr) + len;
 	((struct ip *)ui)->ip_ttl = inp->inp_ip.ip_ttl;	/* XXX */
 	((struct ip *)ui)->ip_tos = inp->inp_ip.ip_tos;	/* XXX */
@@ -1,2 +1,3 @@
+void * hashinit(int elements, int type, u_long *hashmask);
 void * phashinit(int elements, int type, u_long *nentries);
 
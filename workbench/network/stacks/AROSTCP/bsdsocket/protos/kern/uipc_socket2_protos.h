@@ -22,9 +22,6 @@ void socantsendmore(struct socket * so);
 
 void socantrcvmore(struct socket * so);
 
-void sbselqueue(struct sockbuf * sb,
-               struct SocketBase * cp);
-
 int sbwait(struct sockbuf * sb,
            struct SocketBase * cp);
 
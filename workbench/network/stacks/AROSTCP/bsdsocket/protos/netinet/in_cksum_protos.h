@@ -2,6 +2,27 @@
 in_cksum.c
  */
 
+u_int in_cksumdata(const void * buf,
+                   int len);
+
+u_int in_cksum_copy(const void * src,
+                    void * dst,
+                    int len);
+
+u_int in_cksum_skip(register struct mbuf * m,
+                    register int len,
+                    int off);
+
 int in_cksum(register struct mbuf * m,
              register int len);
 
+u_int in_pseudo(u_int32_t a,
+                u_int32_t b,
+                u_int32_t c);
+
+int in_cksum_frame(struct mbuf * m,
+                   u_int32_t a,
+                   u_int32_t b,
+                   u_int32_t c);
+
+void in_delayed_cksum(struct mbuf * m);
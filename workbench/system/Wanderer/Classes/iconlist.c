@@ -541,6 +541,25 @@ static void IconList_GetIconImageOffsets(struct IconList_DATA *data, struct Icon
         *offsety += ((data->icld_IconAreaLargestHeight - entry->ie_AreaHeight)/2);
 }
 
+///IconList_GetInfoTextWidths()
+/* (Re)measure the date/time/size strings only when they, or the font used to render them, changed */
+static void IconList_GetInfoTextWidths(struct IconList_DATA *data, struct IconEntry *entry)
+{
+    if (entry->ie_TxtBuf_InfoFont == data->icld_IconInfoFont)
+        return;
+
+    SetFont(data->icld_BufferRastPort, data->icld_IconInfoFont);
+
+    entry->ie_TxtBuf_SIZEWidth = (entry->ie_TxtBuf_SIZE) ? TextLength(data->icld_BufferRastPort, entry->ie_TxtBuf_SIZE, strlen(entry->ie_TxtBuf_SIZE)) : 0;
+    entry->ie_TxtBuf_TIMEWidth = (entry->ie_TxtBuf_TIME) ? TextLength(data->icld_BufferRastPort, entry->ie_TxtBuf_TIME, strlen(entry->ie_TxtBuf_TIME)) : 0;
+    entry->ie_TxtBuf_DATEWidth = (entry->ie_TxtBuf_DATE) ? TextLength(data->icld_BufferRastPort, entry->ie_TxtBuf_DATE, strlen(entry->ie_TxtBuf_DATE)) : 0;
+
+    entry->ie_TxtBuf_InfoFont = data->icld_IconInfoFont;
+}
+///
+
+static IPTR IconList__LabelFunc_CreateLabel(Object *obj, struct IconList_DATA *data, struct IconEntry *entry);
+
 ///IconList_GetIconLabelRectangle()
 static void IconList_GetIconLabelRectangle(Object *obj, struct IconList_DATA *data, struct IconEntry *entry, struct Rectangle *rect)
 {
@@ -566,11 +585,16 @@ static void IconList_GetIconLabelRectangle(Object *obj, struct IconList_DATA *da
     }
     
     /* Get entry box width including text width */
+    if ((entry->ie_IconListEntry.label != NULL) && (entry->ie_TxtBuf_LabelFont != data->icld_IconLabelFont))
+    {
+        /* Label font changed since the label was split - redo it */
+        IconList__LabelFunc_CreateLabel(obj, data, entry);
+    }
+
     if ((entry->ie_IconListEntry.label != NULL) && (entry->ie_TxtBuf_DisplayedLabel != NULL))
     {
         ULONG curlabel_TotalLines;
-        SetFont(data->icld_BufferRastPort, data->icld_IconLabelFont);
-        
+
         rect->MinX = 0;
         rect->MaxX = (((data->icld__Option_LabelTextHorizontalPadding + data->icld__Option_LabelTextBorderWidth) * 2) + entry->ie_TxtBuf_DisplayedLabelWidth + outline_offset) - 1;
     
@@ -592,11 +616,10 @@ static void IconList_GetIconLabelRectangle(Object *obj, struct IconList_DATA *da
             ((data->icld_SortFlags & MUIV_IconList_Sort_BySize) || (data->icld_SortFlags & MUIV_IconList_Sort_ByDate))
         )
         {
-            SetFont(data->icld_BufferRastPort, data->icld_IconInfoFont);
+            IconList_GetInfoTextWidths(data, entry);
 
             if( (data->icld_SortFlags & MUIV_IconList_Sort_BySize) && !(data->icld_SortFlags & MUIV_IconList_Sort_ByDate) )
             {
-                entry->ie_TxtBuf_SIZEWidth = TextLength(data->icld_BufferRastPort, entry->ie_TxtBuf_SIZE, strlen(entry->ie_TxtBuf_SIZE));
                 textwidth = entry->ie_TxtBuf_SIZEWidth;
             }
             else
@@ -605,12 +628,10 @@ static void IconList_GetIconLabelRectangle(Object *obj, struct IconList_DATA *da
                 {
                     if( entry->ie_Flags & ICONENTRY_FLAG_TODAY )
                     {
-                        entry->ie_TxtBuf_TIMEWidth = TextLength(data->icld_BufferRastPort, entry->ie_TxtBuf_TIME, strlen(entry->ie_TxtBuf_TIME));
                         textwidth = entry->ie_TxtBuf_TIMEWidth;
                     }
                     else
                     {
-                        entry->ie_TxtBuf_DATEWidth = TextLength(data->icld_BufferRastPort, entry->ie_TxtBuf_DATE, strlen(entry->ie_TxtBuf_DATE));
                         textwidth = entry->ie_TxtBuf_DATEWidth;
                     }
                 }
@@ -1375,6 +1396,12 @@ static IPTR IconList__LabelFunc_CreateLabel(Object *obj, struct IconList_DATA *d
         entry->ie_TxtBuf_DisplayedLabel = NULL;
         entry->ie_SplitParts = 0;
     }
+    entry->ie_TxtBuf_DisplayedLabelWidth = 0;
+
+    /* Remember which font the label is measured with, so it is only redone when that changes */
+    entry->ie_TxtBuf_LabelFont = data->icld_IconLabelFont;
+    if ((data->icld_BufferRastPort) && (data->icld_IconLabelFont))
+        SetFont(data->icld_BufferRastPort, data->icld_IconLabelFont);
 
     if (data->icld__Option_LabelTextMultiLine > 1)
     {
@@ -1924,6 +1951,11 @@ IPTR IconList__MUIM_IconList_RethinkDimensions(struct IClass *CLASS, Object *obj
 /*
  * This function executes the layouting when AutoSort is enabled. This means all icons are layouted regardless if
  * they have Provided position or not.
+ *
+ * The layout is always redone for all icons. The position of an icon depends on all icons before it, in grid mode
+ * also on the largest icon of the whole list, and a new view size moves the wrapping points. With the label and
+ * info text widths cached per entry, each icon only costs a few additions here; the sorting and redrawing done
+ * around it cost far more.
  */
 
 static VOID IconList_Layout_FullAutoLayout(struct IClass *CLASS, Object *obj)
@@ -4656,6 +4688,9 @@ IPTR IconList__MUIM_IconList_UpdateEntry(struct IClass *CLASS, Object *obj, stru
     /* Update file info block */
     if(message->fib != NULL)
     {
+        /* Info text may change with it, measure it again on next layout */
+        message->entry->ie_TxtBuf_InfoFont = NULL;
+
         if (!(message->entry->ie_FileInfoBlock))
         {
             if ((message->entry->ie_FileInfoBlock = AllocMem(sizeof(struct FileInfoBlock), MEMF_CLEAR)) != NULL)
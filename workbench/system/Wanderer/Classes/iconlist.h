@@ -133,7 +133,9 @@ struct IconEntry
     UBYTE                       *ie_TxtBuf_SIZE;
     ULONG                       ie_TxtBuf_SIZEWidth;
     UBYTE                       *ie_TxtBuf_PROT;
-
+    struct TextFont             *ie_TxtBuf_LabelFont;           /* Font the displayed label was split/measured with */
+    struct TextFont             *ie_TxtBuf_InfoFont;            /* Font the DATE/TIME/SIZE widths were measured with,
+                                                                        NULL if the strings changed since */
 
     APTR                        *ie_User1;                      /* Pointer to data provided by user */
 };